@@ -12,7 +12,8 @@ IPEX_DEFINE_DISPATCH(decode_attention_opt_kernel_stub);
 // output: [bs, num_heads, cur_len, head_size_v]
 // kv_cache: [max_positions, beam_batch, kv_num_heads, head_size]
 // beam_idx: [bs, offset+1]
-// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1]
+// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1], or empty to
+//   let the kernel plan num_kv_splits
 at::Tensor decode_attention_forward_cpu(
     at::Tensor& query,
     at::Tensor& output,
@@ -37,7 +38,8 @@ at::Tensor decode_attention_forward_cpu(
 // query: [bs, cur_len, num_heads, head_size]
 // output: [bs, num_heads, cur_len, head_size_v]
 // kv_cache: [max_positions, beam_batch, kv_num_heads, head_size]
-// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1]
+// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1], or empty to
+//   let the kernel plan num_kv_splits
 at::Tensor decode_attention_opt_forward_cpu(
     at::Tensor& query,
     at::Tensor& output,
@@ -44,6 +44,10 @@ using decode_attention_opt_kernel_fn = at::Tensor (*)(
     const double scaling,
     const double logit_cap,
     int64_t offset);
+// A kv_cache quantized to int8 or fp8-e4m3fn holds the per-token float scale
+// behind the head_size values of each row, i.e. its last dim is head_size +
+// kKVCacheScaleBytes. An fp8-e5m2 kv_cache is a plain cast without scales.
+constexpr int64_t kKVCacheScaleBytes = sizeof(float);
 IPEX_DECLARE_DISPATCH(decode_attention_kernel_fn, decode_attention_kernel_stub);
 IPEX_DECLARE_DISPATCH(
     decode_attention_opt_kernel_fn,
@@ -21,6 +21,11 @@ IPEX_DEFINE_DISPATCH(mergedemb_distribute_forward_merge_kernel_stub);
  *    since 1 ranks results might need to be lookuped in other ranks.
  * 2. mergedemb_distribute_forward_merge_cpu will reduce the val tensors got
  * from other ranks (indicate by idx tensors and ofs tensors)
+ *
+ * The lookup can also run on a group of tables (a slice of indices, offsets
+ * and row_offset) at a time, so that the local lookup of group i + 1 overlaps
+ * with the all to all of group i. In that case table_begin tells the merge
+ * where the group starts in the [local BS, num tables, emb_dim] output.
  */
 
 std::tuple<std::vector<Tensor>, std::vector<Tensor>, std::vector<Tensor>>
@@ -51,13 +56,14 @@ void mergedemb_distribute_forward_merge_cpu(
     const TensorList& idx,
     const TensorList& val,
     const TensorList& ofs,
-    const int64_t num_emb) {
+    const int64_t num_emb,
+    const int64_t table_begin) {
   // return None
   RECORD_FUNCTION(
       "ipex::mergedemb_distribute_forward_merge_cpu",
       c10::ArrayRef<c10::IValue>({}));
   return mergedemb_distribute_forward_merge_kernel_stub(
-      kCPU, output, idx, val, ofs, num_emb);
+      kCPU, output, idx, val, ofs, num_emb, table_begin);
 }
 
 IPEX_DEFINE_DISPATCH(mergedemb_distribute_backward_local_kernel_stub);
@@ -130,7 +136,7 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       torch_ipex::cpu::mergedemb_distribute_forward_local_cpu);
   // forward merge
   m.def(
-      "mergedemb_distribute_forward_merge(Tensor output, Tensor[] idx, Tensor[] val, Tensor[] ofs, int num_emb) -> ()");
+      "mergedemb_distribute_forward_merge(Tensor output, Tensor[] idx, Tensor[] val, Tensor[] ofs, int num_emb, int table_begin=0) -> ()");
   m.impl(
       "mergedemb_distribute_forward_merge",
       c10::DispatchKey::CPU,
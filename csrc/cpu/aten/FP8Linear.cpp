@@ -1,3 +1,4 @@
+#include "cpu/kernels/OpContext.h"
 #include "csrc/utils/CustomOperatorRegistration.h"
 #include "fp8_utils.h"
 #include "ideep/IDeepConversions.h"
@@ -146,6 +147,24 @@ at::Tensor fp8_linear(
   return res;
 }
 
+/**
+ * FP8 linear with the weight prepacked by ipex_prepack::fp8_linear_prepack.
+ * The weight layout, the scales and the oneDNN primitives live in the op
+ * context, so a call only binds the input/output memory and executes.
+ *
+ *@param input FP8 activation, [..., in_features]
+ *@param op_context data handle of an IpexFp8LinearOpContext
+ *@param out_dtype output dtype, float by default
+ */
+at::Tensor fp8_linear_prepacked(
+    const at::Tensor& input,
+    const at::Tensor& op_context,
+    c10::optional<at::ScalarType> out_dtype) {
+  return reinterpret_cast<IpexFp8LinearOpContext*>(
+             op_context.data_ptr<int64_t>()[0])
+      ->run(input, out_dtype);
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -154,6 +173,10 @@ namespace {
 IPEX_LIBRARY_FRAGMENT() {
   IPEX_OP_REGISTER_DISPATCH(
       "fp8_linear", torch_ipex::cpu::fp8_linear, c10::DispatchKey::CPU);
+  IPEX_OP_REGISTER_DISPATCH(
+      "ipex_fp8_linear",
+      torch_ipex::cpu::fp8_linear_prepacked,
+      c10::DispatchKey::CPU);
 }
 
 } // namespace
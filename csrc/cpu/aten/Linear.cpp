@@ -412,6 +412,27 @@ at::Tensor woq_linear_pack_weight(
           lowp_mode,
           weight_format);
     }
+    if (is_lowbit(weight_dtype)) {
+      if ((weight_dtype == WOQ_DTYPE_INT2 && K % 4) ||
+          (block_k % 4 && lowp_mode == LOWP_MODE_INT8)) {
+        // These cases are not supported by kernel
+        return weight;
+      }
+      // INT2 weight holds 4 values per uint8 along K while INT3 weight holds
+      // one value per uint8. They are packed to 2-bit and 1-bit planes by the
+      // kernel. N is padded to the nearest multiple of block_n.
+      int64_t N_padded = N % block_n ? N / block_n * block_n + block_n : N;
+      at::Tensor weight_padded =
+          at::pad(weight, {0, 0, 0, N_padded - N}, "constant", 0);
+      return woq_tpp_gemm_packB_stub(
+          kCPU,
+          weight_padded,
+          weight_dtype,
+          block_n,
+          block_k,
+          lowp_mode,
+          weight_format);
+    }
     if (N % block_n) {
       at::Tensor weight_padded =
           at::pad(weight, {0, 0, 0, block_n - N % block_n}, "constant", 0);
@@ -545,6 +566,62 @@ at::Tensor woq_linear_kernel(
   return y;
 }
 
+// WOQ linear with lowp_mode INT8 whose activation has already been quantized
+// per M or per M x K block, e.g., by rmsnorm_dynamic_quant. `self` is the
+// int8/uint8 activation and the output is in `out_dtype`.
+at::Tensor woq_linear_quantized_input_kernel(
+    const at::Tensor& self,
+    const at::Tensor& scale_a,
+    const at::Tensor& zp_a,
+    at::ScalarType out_dtype,
+    const at::Tensor& weight,
+    int64_t weight_dtype,
+    const std::vector<at::Tensor>& scales_list,
+    const std::vector<at::Tensor>& zps_list,
+    const std::vector<at::Tensor>& bias_list,
+    int64_t group_size,
+    int64_t act_quant_mode,
+    const c10::optional<at::Tensor>& compensation) {
+  int64_t quant_w_mode = zps_list[0].defined()
+      ? (group_size > 0 ? QUANT_W_PER_K_BLOCK : QUANT_W_PER_CHANNEL)
+      : (group_size > 0 ? QUANT_W_PER_K_BLOCK_SYM : QUANT_W_PER_CHANNEL_SYM);
+#define CALL_QUANTIZED_A_KERNEL(kernel) \
+  kernel(                               \
+      kCPU,                             \
+      self,                             \
+      scale_a,                          \
+      zp_a,                             \
+      out_dtype,                        \
+      weight,                           \
+      scales_list,                      \
+      zps_list,                         \
+      bias_list,                        \
+      weight_dtype,                     \
+      WOQ_FUSE_NONE,                    \
+      std::vector<at::Tensor>(),        \
+      act_quant_mode,                   \
+      quant_w_mode,                     \
+      group_size,                       \
+      compensation);
+
+  if (act_quant_mode == QUANT_A_PER_M ||
+      act_quant_mode == QUANT_A_PER_M_SYM) {
+    return CALL_QUANTIZED_A_KERNEL(
+        woq_int8_gemm_pre_m_block_quantized_a_kernel_stub);
+  } else if (
+      act_quant_mode == QUANT_A_PER_M_K_BLOCK ||
+      act_quant_mode == QUANT_A_PER_M_K_BLOCK_SYM) {
+    return CALL_QUANTIZED_A_KERNEL(
+        woq_int8_gemm_pre_m_k_block_quantized_a_kernel_stub);
+  }
+#undef CALL_QUANTIZED_A_KERNEL
+  TORCH_CHECK(
+      false,
+      "WOQ linear: quantized input requires per-M or per-M-K-block "
+      "activation quantization, got act_quant_mode = ",
+      act_quant_mode);
+}
+
 at::Tensor woq_linear_forward(
     const at::Tensor& input,
     const at::Tensor& op_context) {
@@ -570,6 +647,8 @@ at::Tensor woq_linear_forward_v2(
       {"int8", WOQ_DTYPE_INT8},
       {"int4", WOQ_DTYPE_INT4},
       {"nf4", WOQ_DTYPE_NF4},
+      {"int2", WOQ_DTYPE_INT2},
+      {"int3", WOQ_DTYPE_INT3},
   };
   TORCH_CHECK(
       WOQ_DTYPE_MAP.find(weight_dtype) != WOQ_DTYPE_MAP.end(),
@@ -800,6 +879,21 @@ at::Tensor woq_linear_mul_forward(
       ->run_binary(input, "mul", others);
 }
 
+at::Tensor woq_linear_quantized_input_forward(
+    const at::Tensor& input,
+    const at::Tensor& scale,
+    const c10::optional<at::Tensor>& zero_point,
+    at::ScalarType out_dtype,
+    const at::Tensor& op_context) {
+  return reinterpret_cast<IpexWoqLinearOpContext*>(
+             op_context.data_ptr<int64_t>()[0])
+      ->run_quantized_input(
+          input,
+          scale,
+          zero_point.has_value() ? zero_point.value() : at::Tensor(),
+          out_dtype);
+}
+
 IPEX_DEFINE_DISPATCH(dequant_nf4_stub);
 at::Tensor dequantize_nf4(
     const at::Tensor& t,
@@ -1097,6 +1191,13 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "woq_linear_mul",
       c10::DispatchKey::AutocastCPU,
       torch_ipex::autocast::woq_linear_mul_forward);
+  m.def(
+      "woq_linear_quantized_input(Tensor input, Tensor scale, "
+      "Tensor? zero_point, ScalarType out_dtype, Tensor W_prepack) -> Tensor");
+  m.impl(
+      "woq_linear_quantized_input",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::woq_linear_quantized_input_forward);
   // the version without op_context
   IPEX_OP_REGISTER_DISPATCH(
       "woq_linear",
@@ -129,6 +129,13 @@ at::Tensor woq_linear_mul_forward(
     const at::Tensor& op_context,
     const std::vector<at::Tensor>& others);
 
+at::Tensor woq_linear_quantized_input_forward(
+    const at::Tensor& input,
+    const at::Tensor& scale,
+    const c10::optional<at::Tensor>& zero_point,
+    at::ScalarType out_dtype,
+    const at::Tensor& op_context);
+
 at::Tensor woq_linear_pack_weight(
     const at::Tensor& weight,
     int64_t weight_dtype,
@@ -161,6 +168,20 @@ at::Tensor woq_linear_kernel(
     const c10::optional<at::Tensor>& compensation = c10::nullopt,
     const c10::optional<at::Tensor>& g_idx = c10::nullopt);
 
+at::Tensor woq_linear_quantized_input_kernel(
+    const at::Tensor& self,
+    const at::Tensor& scale_a,
+    const at::Tensor& zp_a,
+    at::ScalarType out_dtype,
+    const at::Tensor& weight,
+    int64_t weight_dtype,
+    const std::vector<at::Tensor>& scales_list,
+    const std::vector<at::Tensor>& zps_list,
+    const std::vector<at::Tensor>& bias_list,
+    int64_t group_size,
+    int64_t act_quant_mode,
+    const c10::optional<at::Tensor>& compensation = c10::nullopt);
+
 at::Tensor woq_linear_unary_kernel(
     const at::Tensor& self,
     const at::Tensor& weight,
@@ -266,6 +287,25 @@ using woq_int8_gemm_kernel_fn = at::Tensor (*)(
     int64_t,
     const c10::optional<at::Tensor>&);
 
+// int8 GEMM with activation already quantized: (x_q, scale_a, zp_a,
+// out_dtype), followed by the same arguments as woq_int8_gemm_kernel_fn
+using woq_int8_gemm_quantized_a_kernel_fn = at::Tensor (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    const at::Tensor&,
+    at::ScalarType,
+    const at::Tensor&,
+    const std::vector<at::Tensor>&,
+    const std::vector<at::Tensor>&,
+    const std::vector<at::Tensor>&,
+    const int,
+    int64_t,
+    const std::vector<at::Tensor>&,
+    int64_t,
+    int64_t,
+    int64_t,
+    const c10::optional<at::Tensor>&);
+
 using woq_tpp_gemm_packB_fn =
     at::Tensor (*)(const at::Tensor&, int, size_t, size_t, int64_t, int64_t);
 
@@ -301,6 +341,12 @@ IPEX_DECLARE_DISPATCH(
 IPEX_DECLARE_DISPATCH(
     woq_int8_gemm_kernel_fn,
     woq_int8_gemm_pre_m_k_block_kernel_stub);
+IPEX_DECLARE_DISPATCH(
+    woq_int8_gemm_quantized_a_kernel_fn,
+    woq_int8_gemm_pre_m_block_quantized_a_kernel_stub);
+IPEX_DECLARE_DISPATCH(
+    woq_int8_gemm_quantized_a_kernel_fn,
+    woq_int8_gemm_pre_m_k_block_quantized_a_kernel_stub);
 IPEX_DECLARE_DISPATCH(woq_tpp_gemm_packB_fn, woq_tpp_gemm_packB_stub);
 IPEX_DECLARE_DISPATCH(woq_tpp_gemm_unpackB_fn, woq_tpp_gemm_unpackB_stub);
 IPEX_DECLARE_DISPATCH(
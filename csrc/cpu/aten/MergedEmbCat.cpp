@@ -9,6 +9,7 @@ using namespace at;
 
 IPEX_DEFINE_DISPATCH(merged_embeddingbag_cat_fw_stub);
 IPEX_DEFINE_DISPATCH(qmerged_embeddingbag_cat_fw_stub);
+IPEX_DEFINE_DISPATCH(merged_embeddingbag_cat_interaction_linear_fw_stub);
 
 Tensor merged_embeddingbag_cat_forward(
     const TensorList& weights,
@@ -19,6 +20,33 @@ Tensor merged_embeddingbag_cat_forward(
       kCPU, weights, indices, offsets, dense);
 }
 
+/**
+ * DLRM inference fusion of merged_embeddingbag_cat_forward +
+ * interaction_forward + the first top MLP linear (with optional relu).
+ * The looked-up rows and the interaction output stay in per-thread buffers,
+ * only the [batch_size, out_features] MLP output is materialized.
+ *
+ * @param weights embedding tables, each [num_rows, emb_dim]
+ * @param indices indices for each table
+ * @param offsets offsets for each table (sum pooling)
+ * @param dense dense feature [batch_size, emb_dim]
+ * @param mlp_weight weight of the first top MLP layer,
+ * [out_features, emb_dim + (num_tables + 1) * num_tables / 2]
+ * @param mlp_bias optional bias of the first top MLP layer
+ * @param fuse_relu whether to apply relu on the MLP output
+ */
+Tensor merged_embeddingbag_cat_interaction_linear_forward(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    const Tensor& mlp_weight,
+    const c10::optional<Tensor>& mlp_bias,
+    bool fuse_relu) {
+  return merged_embeddingbag_cat_interaction_linear_fw_stub(
+      kCPU, weights, indices, offsets, dense, mlp_weight, mlp_bias, fuse_relu);
+}
+
 Tensor dil_qmerged_embeddingbag_cat(
     const TensorList& qweights,
     const TensorList& indices,
@@ -42,6 +70,14 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "merged_embeddingbag_cat_forward",
       c10::DispatchKey::CPU,
       torch_ipex::cpu::merged_embeddingbag_cat_forward);
+  m.def(
+      "merged_embeddingbag_cat_interaction_linear_forward(Tensor[] weights, "
+      "Tensor[] indices, Tensor[] offsets, Tensor dense, Tensor mlp_weight, "
+      "Tensor? mlp_bias, bool fuse_relu) -> Tensor");
+  m.impl(
+      "merged_embeddingbag_cat_interaction_linear_forward",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::merged_embeddingbag_cat_interaction_linear_forward);
 }
 
 } // namespace
\ No newline at end of file
@@ -32,6 +32,15 @@ Tensor qmerged_embedding_cat_fw_impl(
     const Tensor& qdense,
     double o_scale);
 
+Tensor merged_embedding_cat_interaction_linear_fw_impl(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    const Tensor& mlp_weight,
+    const c10::optional<Tensor>& mlp_bias,
+    bool fuse_relu);
+
 } // namespace
 
 using merged_embeddingbag_cat_fw_fn = Tensor (*)(
@@ -47,6 +56,15 @@ using qmerged_embeddingbag_cat_fw_fn = Tensor (*)(
     const Tensor&,
     double o_scale);
 
+using merged_embeddingbag_cat_interaction_linear_fw_fn = Tensor (*)(
+    const TensorList&,
+    const TensorList&,
+    const TensorList&,
+    const Tensor&,
+    const Tensor&,
+    const c10::optional<Tensor>&,
+    bool);
+
 IPEX_DECLARE_DISPATCH(
     merged_embeddingbag_cat_fw_fn,
     merged_embeddingbag_cat_fw_stub);
@@ -55,5 +73,9 @@ IPEX_DECLARE_DISPATCH(
     qmerged_embeddingbag_cat_fw_fn,
     qmerged_embeddingbag_cat_fw_stub);
 
+IPEX_DECLARE_DISPATCH(
+    merged_embeddingbag_cat_interaction_linear_fw_fn,
+    merged_embeddingbag_cat_interaction_linear_fw_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
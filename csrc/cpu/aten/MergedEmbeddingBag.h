@@ -247,7 +247,8 @@ void mergedemb_distribute_forward_merge_cpu(
     const TensorList& idx,
     const TensorList& val,
     const TensorList& ofs,
-    const int64_t num_emb);
+    const int64_t num_emb,
+    const int64_t table_begin);
 
 void mergedemb_distribute_backward_merge_adagrad_update_cpu(
     const TensorList& idx,
@@ -329,6 +330,7 @@ using mergedemb_distribute_forward_merge_kernel_fn = void (*)(
     const TensorList&,
     const TensorList&,
     const TensorList&,
+    const int64_t,
     const int64_t);
 IPEX_DECLARE_DISPATCH(
     mergedemb_distribute_forward_merge_kernel_fn,
@@ -15,6 +15,7 @@ at::Tensor call_AllReduce(const at::Tensor& self) {
 }
 
 IPEX_DEFINE_DISPATCH(mixtral_moe_tpp_kernel_stub);
+IPEX_DEFINE_DISPATCH(deepseek_moe_tpp_kernel_stub);
 IPEX_DEFINE_DISPATCH(mixtral_moe_woq_kernel_stub);
 IPEX_DEFINE_DISPATCH(deepseek_moe_woq_kernel_stub);
 IPEX_DEFINE_DISPATCH(mixtral_moe_kernel_stub);
@@ -91,32 +92,16 @@ at::Tensor deepseek_moe_tpp(
     bool is_distributed) {
   RECORD_FUNCTION("ipex::deepseek_moe_tpp", c10::ArrayRef<c10::IValue>({}));
 
-  auto output = at::zeros_like(hidden_states);
-  int num_experts = gate_wei.size();
-  std::vector<long> expert_selected;
-  std::vector<std::vector<long>> expert_idx, expert_top_x;
-  std::tie(expert_selected, expert_idx, expert_top_x) =
-      get_expert_topx_idx(topk_ids, num_experts);
-  for (auto i = 0; i < num_experts; i++) {
-    if (expert_selected[i] == 0)
-      continue;
-    auto idx =
-        torch::from_blob(expert_idx[i].data(), {expert_selected[i]}, at::kLong);
-    auto top_x = torch::from_blob(
-        expert_top_x[i].data(), {expert_selected[i]}, at::kLong);
-    output = mixtral_moe_tpp_kernel_stub(
-        kCPU,
-        hidden_states,
-        top_x,
-        idx,
-        gate_wei[i],
-        up_wei[i],
-        down_wei[i],
-        tpp_fallback,
-        routing_weights,
-        output,
-        is_distributed);
-  }
+  auto output = deepseek_moe_tpp_kernel_stub(
+      kCPU,
+      hidden_states,
+      topk_ids,
+      gate_wei,
+      up_wei,
+      down_wei,
+      tpp_fallback,
+      routing_weights,
+      is_distributed);
   if (is_distributed) {
     call_AllReduce(output);
   }
@@ -12,6 +12,7 @@ IPEX_DEFINE_DISPATCH(punica_bgmv_expand_kernel_stub);
 IPEX_DEFINE_DISPATCH(punica_sgmv_expand_kernel_stub);
 IPEX_DEFINE_DISPATCH(punica_bgmv_expand_slice_kernel_stub);
 IPEX_DEFINE_DISPATCH(punica_sgmv_expand_slice_kernel_stub);
+IPEX_DEFINE_DISPATCH(punica_bgmv_shrink_expand_slice_kernel_stub);
 
 at::Tensor punica_bgmv_shrink_forward_cpu(
     at::Tensor& out,
@@ -100,6 +101,30 @@ at::Tensor punica_sgmv_expand_slice_forward_cpu(
   return out;
 }
 
+at::Tensor punica_bgmv_shrink_expand_slice_forward_cpu(
+    at::Tensor& out,
+    at::Tensor& input,
+    at::Tensor& lora_a_weights,
+    at::Tensor& lora_b_weights,
+    at::Tensor& indicies,
+    const double scale,
+    int64_t slice_offset,
+    int64_t slice_size,
+    bool add_inputs) {
+  punica_bgmv_shrink_expand_slice_kernel_stub(
+      kCPU,
+      out,
+      input,
+      lora_a_weights,
+      lora_b_weights,
+      indicies,
+      scale,
+      slice_offset,
+      slice_size,
+      add_inputs);
+  return out;
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -147,4 +172,11 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       c10::DispatchKey::CPU);
 }
 
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  IPEX_OP_REGISTER_DISPATCH(
+      "punica_bgmv_shrink_expand_slice",
+      torch_ipex::cpu::punica_bgmv_shrink_expand_slice_forward_cpu,
+      c10::DispatchKey::CPU);
+}
+
 } // namespace
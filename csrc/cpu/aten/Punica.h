@@ -56,6 +56,17 @@ void punica_sgmv_expand_slice(
     int64_t slice_offset,
     int64_t slice_size,
     bool add_inputs);
+
+void punica_bgmv_shrink_expand_slice(
+    at::Tensor& out,
+    at::Tensor& input,
+    at::Tensor& lora_a_weights,
+    at::Tensor& lora_b_weights,
+    at::Tensor& indicies,
+    const double scale,
+    int64_t slice_offset,
+    int64_t slice_size,
+    bool add_inputs);
 } // namespace
 
 using punica_bgmv_shrink_fn = void (*)(
@@ -107,6 +118,17 @@ using punica_sgmv_expand_slice_fn = void (*)(
     int64_t slice_size,
     bool add_inputs);
 
+using punica_bgmv_shrink_expand_slice_fn = void (*)(
+    at::Tensor& out,
+    at::Tensor& input,
+    at::Tensor& lora_a_weights,
+    at::Tensor& lora_b_weights,
+    at::Tensor& indicies,
+    const double scale,
+    int64_t slice_offset,
+    int64_t slice_size,
+    bool add_inputs);
+
 IPEX_DECLARE_DISPATCH(punica_bgmv_shrink_fn, punica_bgmv_shrink_kernel_stub);
 
 IPEX_DECLARE_DISPATCH(punica_sgmv_shrink_fn, punica_sgmv_shrink_kernel_stub);
@@ -123,5 +145,9 @@ IPEX_DECLARE_DISPATCH(
     punica_sgmv_expand_slice_fn,
     punica_sgmv_expand_slice_kernel_stub);
 
+IPEX_DECLARE_DISPATCH(
+    punica_bgmv_shrink_expand_slice_fn,
+    punica_bgmv_shrink_expand_slice_kernel_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
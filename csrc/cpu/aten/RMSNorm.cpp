@@ -7,6 +7,7 @@ namespace cpu {
 
 IPEX_DEFINE_DISPATCH(rmsnorm_kernel_stub);
 IPEX_DEFINE_DISPATCH(add_rmsnorm_kernel_stub);
+IPEX_DEFINE_DISPATCH(rmsnorm_dynamic_quant_kernel_stub);
 
 at::Tensor dil_RMSNorm(
     const at::Tensor& input,
@@ -26,6 +27,22 @@ at::Tensor add_RMSNorm(
   return add_rmsnorm_kernel_stub(kCPU, input, input1, b, eps, add_back);
 }
 
+// RMSNorm with the dynamic activation quantization of the WOQ int8 GEMM
+// fused in. Only the modes that quantize each row independently can be
+// fused: QUANT_A_PER_M(_SYM) and QUANT_A_PER_M_K_BLOCK(_SYM).
+std::tuple<at::Tensor, at::Tensor, at::Tensor> rmsnorm_dynamic_quant(
+    const at::Tensor& input,
+    const at::Tensor& b,
+    double eps,
+    int64_t quant_a_mode,
+    int64_t quant_block_k) {
+  RECORD_FUNCTION(
+      "ipex::rmsnorm_dynamic_quant", c10::ArrayRef<c10::IValue>({}));
+
+  return rmsnorm_dynamic_quant_kernel_stub(
+      kCPU, input, b, eps, quant_a_mode, quant_block_k);
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -37,5 +54,12 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
   m.def(
       "add_rmsnorm(Tensor input, Tensor input1, Tensor weight, float eps, bool add_back) -> Tensor");
   m.impl("add_rmsnorm", c10::DispatchKey::CPU, torch_ipex::cpu::add_RMSNorm);
+  m.def(
+      "rmsnorm_dynamic_quant(Tensor input, Tensor weight, float eps, "
+      "int quant_a_mode, int quant_block_k) -> (Tensor, Tensor, Tensor)");
+  m.impl(
+      "rmsnorm_dynamic_quant",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::rmsnorm_dynamic_quant);
 }
 } // namespace
\ No newline at end of file
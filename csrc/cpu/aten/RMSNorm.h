@@ -11,6 +11,13 @@ at::Tensor dil_RMSNorm(
     const at::Tensor& b,
     double eps);
 
+std::tuple<at::Tensor, at::Tensor, at::Tensor> rmsnorm_dynamic_quant(
+    const at::Tensor& input,
+    const at::Tensor& b,
+    double eps,
+    int64_t quant_a_mode,
+    int64_t quant_block_k);
+
 namespace {
 
 at::Tensor rmsnorm_kernel_impl(
@@ -24,6 +31,15 @@ at::Tensor add_rmsnorm_kernel_impl(
     const at::Tensor& b,
     float eps,
     bool add_back); // if true, store sum in input1
+
+// returns (quantized input, scales, zero points)
+std::tuple<at::Tensor, at::Tensor, at::Tensor>
+rmsnorm_dynamic_quant_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& b,
+    float eps,
+    int64_t quant_a_mode,
+    int64_t quant_block_k);
 } // namespace
 
 using rms_norm_kernel_fn =
@@ -34,9 +50,19 @@ using add_rms_norm_kernel_fn = at::Tensor (*)(
     const at::Tensor&,
     float,
     bool);
+using rms_norm_dynamic_quant_kernel_fn =
+    std::tuple<at::Tensor, at::Tensor, at::Tensor> (*)(
+        const at::Tensor&,
+        const at::Tensor&,
+        float,
+        int64_t,
+        int64_t);
 
 IPEX_DECLARE_DISPATCH(rms_norm_kernel_fn, rmsnorm_kernel_stub);
 IPEX_DECLARE_DISPATCH(add_rms_norm_kernel_fn, add_rmsnorm_kernel_stub);
+IPEX_DECLARE_DISPATCH(
+    rms_norm_dynamic_quant_kernel_fn,
+    rmsnorm_dynamic_quant_kernel_stub);
 
 } // namespace cpu
 } // namespace torch_ipex
@@ -12,6 +12,8 @@ namespace cpu {
 
 IPEX_DEFINE_DISPATCH(roi_align_forward_kernel_stub);
 IPEX_DEFINE_DISPATCH(roi_align_backward_kernel_stub);
+IPEX_DEFINE_DISPATCH(roi_align_linear_forward_kernel_stub);
+IPEX_DEFINE_DISPATCH(roi_align_linear_prepack_kernel_stub);
 
 at::Tensor ROIAlign_forward_impl(
     const at::Tensor& input,
@@ -73,6 +75,43 @@ at::Tensor ROIAlign_backward_impl(
       is_channels_last);
 }
 
+at::Tensor ROIAlign_linear_forward_impl(
+    const at::Tensor& input,
+    const at::Tensor& rois,
+    double spatial_scale,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    bool fuse_relu,
+    const c10::optional<at::Tensor>& packed_weight) {
+#if defined(IPEX_DISP_OP)
+  printf("torch_ipex::ROIAlign_linear_forward\n");
+#endif
+  RECORD_FUNCTION(
+      "torch_ipex::ROIAlign_linear_forward", c10::ArrayRef<c10::IValue>({}));
+
+  return roi_align_linear_forward_kernel_stub(
+      kCPU,
+      input,
+      rois,
+      spatial_scale,
+      pooled_height,
+      pooled_width,
+      sampling_ratio,
+      aligned,
+      weight,
+      bias,
+      fuse_relu,
+      packed_weight);
+}
+
+at::Tensor ROIAlign_linear_prepack_impl(const at::Tensor& weight) {
+  return roi_align_linear_prepack_kernel_stub(kCPU, weight);
+}
+
 at::Tensor ROIAlign_backward(
     const at::Tensor& grad,
     const at::Tensor& rois,
@@ -293,6 +332,18 @@ IPEX_TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "ROIAlign_backward",
       c10::DispatchKey::CPU,
       torch_ipex::cpu::ROIAlign_backward_impl);
+  // inference only fusion with the first linear of the box head
+  m.def(
+      "ROIAlign_linear_forward(Tensor input, Tensor rois, float spatial_scale, int pooled_height, int pooled_width, int sampling_ratio, bool aligned, Tensor weight, Tensor? bias, bool fuse_relu, Tensor? packed_weight=None) -> Tensor");
+  m.impl(
+      "ROIAlign_linear_forward",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::ROIAlign_linear_forward_impl);
+  m.def("ROIAlign_linear_prepack(Tensor weight) -> Tensor");
+  m.impl(
+      "ROIAlign_linear_prepack",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::ROIAlign_linear_prepack_impl);
 }
 
 IPEX_TORCH_LIBRARY_FRAGMENT(torchvision, m) {
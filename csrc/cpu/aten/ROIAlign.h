@@ -30,6 +30,26 @@ at::Tensor ROIAlign_backward_impl(
     bool aligned,
     bool is_channels_last);
 
+// Fused roi_align + linear for the box head of detection inference:
+// linear(roi_align(input, rois).flatten(1), weight, bias) with optional relu,
+// without materializing the pooled [num_rois, C, ph, pw] tensor.
+at::Tensor ROIAlign_linear_forward_impl(
+    const at::Tensor& input,
+    const at::Tensor& rois,
+    double spatial_scale,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    bool fuse_relu,
+    const c10::optional<at::Tensor>& packed_weight);
+
+// Packs the weight of ROIAlign_linear_forward once so that the box head does
+// not pack it again on every call.
+at::Tensor ROIAlign_linear_prepack_impl(const at::Tensor& weight);
+
 class IPEXROIAlignOp : public torch::autograd::Function<IPEXROIAlignOp> {
  public:
   // forward function without autograd overhead, will go this way when only do
@@ -211,6 +231,21 @@ at::Tensor roi_align_backward_kernel_impl(
     bool aligned,
     bool is_channels_last);
 
+at::Tensor roi_align_linear_forward_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& rois,
+    double spatial_scale,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    bool fuse_relu,
+    const c10::optional<at::Tensor>& packed_weight);
+
+at::Tensor roi_align_linear_prepack_kernel_impl(const at::Tensor& weight);
+
 } // namespace
 
 using roi_align_forward_kernel_fn = at::Tensor (*)(
@@ -242,5 +277,26 @@ IPEX_DECLARE_DISPATCH(
     roi_align_backward_kernel_fn,
     roi_align_backward_kernel_stub);
 
+using roi_align_linear_forward_kernel_fn = at::Tensor (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    double,
+    int64_t,
+    int64_t,
+    int64_t,
+    bool,
+    const at::Tensor&,
+    const c10::optional<at::Tensor>&,
+    bool,
+    const c10::optional<at::Tensor>&);
+IPEX_DECLARE_DISPATCH(
+    roi_align_linear_forward_kernel_fn,
+    roi_align_linear_forward_kernel_stub);
+
+using roi_align_linear_prepack_kernel_fn = at::Tensor (*)(const at::Tensor&);
+IPEX_DECLARE_DISPATCH(
+    roi_align_linear_prepack_kernel_fn,
+    roi_align_linear_prepack_kernel_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <ATen/FunctionalTensorWrapper.h>
 #include <torch/all.h>
 #include <torch/csrc/autograd/function.h>
+#include "Linear.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -13,6 +14,7 @@ namespace cpu {
 IPEX_DEFINE_DISPATCH(rotary_position_embedding_kernel_stub);
 IPEX_DEFINE_DISPATCH(rotary_position_embedding_deepseek_kernel_stub);
 IPEX_DEFINE_DISPATCH(rotary_position_embedding_deepseek_v2_kernel_stub);
+IPEX_DEFINE_DISPATCH(rotary_position_embedding_cache_kernel_stub);
 
 std::tuple<at::Tensor, at::Tensor, at::Tensor>
 rotary_position_embedding_forward_cpu(
@@ -64,6 +66,128 @@ rotary_position_embedding_deepseek_v2_forward_cpu(
       kCPU, q, k_pe, t_emb_pos, t_pos, N, H, offset, rotary_ndims);
 }
 
+static void check_kv_cache_dtype(const std::string& kv_cache_dtype) {
+  TORCH_CHECK(
+      kv_cache_dtype == "fp8" || kv_cache_dtype == "fp8_e5m2" ||
+          kv_cache_dtype == "auto",
+      "not supported kv_cache_dtype");
+}
+
+// RoPE on the fused qkv [..., F] with the rotated key and the value written
+// into the paged KV cache at slot_mapping, returns query [..., N, H]
+at::Tensor rotary_position_embedding_cache_forward_cpu(
+    at::Tensor& t_in,
+    at::Tensor& t_emb_pos,
+    at::Tensor& t_pos,
+    int64_t N, // N: number of head, H: head size
+    int64_t H,
+    int64_t offset,
+    int64_t rotary_ndims,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& slot_mapping,
+    const std::string& kv_cache_dtype,
+    double k_scale,
+    double v_scale) {
+  RECORD_FUNCTION(
+      "ipex::rotary_position_embedding_cache", c10::ArrayRef<c10::IValue>({}));
+  check_kv_cache_dtype(kv_cache_dtype);
+  auto F = t_in.size(-1);
+  auto qkv = t_in.reshape({-1, F}).contiguous();
+  auto pos = t_pos.reshape({-1});
+  auto slots = slot_mapping.reshape({-1});
+  auto out_sizes = t_in.sizes().vec();
+  out_sizes.back() = N;
+  out_sizes.push_back(H);
+  auto query = at::empty(out_sizes, t_in.options());
+  auto query_2d = query.view({-1, N * H});
+  rotary_position_embedding_cache_kernel_stub(
+      kCPU,
+      qkv,
+      t_emb_pos,
+      pos,
+      N,
+      H,
+      offset,
+      rotary_ndims,
+      key_cache,
+      value_cache,
+      slots,
+      k_scale,
+      v_scale,
+      query_2d);
+  return query;
+}
+
+#ifdef USE_LIBXSMM
+// Bytes of qkv produced per round of QKV GEMM + RoPE/cache write. A round
+// is rotated and scattered to the KV cache while its qkv is still in L2.
+static constexpr int64_t kRopeCacheChunkBytes = 1 << 20;
+
+// WOQ QKV projection + RoPE + KV cache write. The GEMM runs over chunks of
+// tokens and each chunk is consumed right after it is produced, so qkv is
+// never written back to and read again from memory. Decode batches are a
+// single chunk.
+at::Tensor woq_linear_rotary_position_embedding_cache_forward_cpu(
+    const at::Tensor& input,
+    const at::Tensor& op_context,
+    at::Tensor& t_emb_pos,
+    at::Tensor& t_pos,
+    int64_t N, // N: number of head, H: head size
+    int64_t H,
+    int64_t offset,
+    int64_t rotary_ndims,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& slot_mapping,
+    const std::string& kv_cache_dtype,
+    double k_scale,
+    double v_scale) {
+  RECORD_FUNCTION(
+      "ipex::woq_linear_rotary_position_embedding_cache",
+      c10::ArrayRef<c10::IValue>({}));
+  check_kv_cache_dtype(kv_cache_dtype);
+  auto K = input.size(-1);
+  auto num_tokens = input.numel() / K;
+  auto F = reinterpret_cast<IpexWoqLinearOpContext*>(
+               op_context.data_ptr<int64_t>()[0])
+               ->get_weight_shape()[0];
+  auto x = input.reshape({num_tokens, K});
+  auto pos = t_pos.reshape({-1});
+  auto slots = slot_mapping.reshape({-1});
+  auto out_sizes = input.sizes().vec();
+  out_sizes.back() = N;
+  out_sizes.push_back(H);
+  auto query = at::empty(out_sizes, input.options());
+  auto query_2d = query.view({num_tokens, N * H});
+  int64_t chunk = std::max<int64_t>(
+      kRopeCacheChunkBytes / (F * input.element_size()), 32);
+  for (int64_t t0 = 0; t0 < num_tokens; t0 += chunk) {
+    auto len = std::min(chunk, num_tokens - t0);
+    auto qkv = woq_linear_forward(x.narrow(0, t0, len), op_context);
+    auto pos_chunk = pos.narrow(0, t0, len);
+    auto slots_chunk = slots.narrow(0, t0, len);
+    auto query_chunk = query_2d.narrow(0, t0, len);
+    rotary_position_embedding_cache_kernel_stub(
+        kCPU,
+        qkv,
+        t_emb_pos,
+        pos_chunk,
+        N,
+        H,
+        offset,
+        rotary_ndims,
+        key_cache,
+        value_cache,
+        slots_chunk,
+        k_scale,
+        v_scale,
+        query_chunk);
+  }
+  return query;
+}
+#endif
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -88,5 +212,26 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "rotary_position_embedding_deepseek_v2",
       c10::DispatchKey::CPU,
       torch_ipex::cpu::rotary_position_embedding_deepseek_v2_forward_cpu);
+  m.def(
+      "rotary_position_embedding_cache(Tensor t_in, Tensor t_emb_pos, "
+      "Tensor t_pos, int N, int H, int offset, int rotary_ndims, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor slot_mapping, "
+      "str kv_cache_dtype, float k_scale, float v_scale) -> Tensor");
+  m.impl(
+      "rotary_position_embedding_cache",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::rotary_position_embedding_cache_forward_cpu);
+#ifdef USE_LIBXSMM
+  m.def(
+      "woq_linear_rotary_position_embedding_cache(Tensor input, "
+      "Tensor W_prepack, Tensor t_emb_pos, Tensor t_pos, int N, int H, "
+      "int offset, int rotary_ndims, Tensor(a!) key_cache, "
+      "Tensor(b!) value_cache, Tensor slot_mapping, str kv_cache_dtype, "
+      "float k_scale, float v_scale) -> Tensor");
+  m.impl(
+      "woq_linear_rotary_position_embedding_cache",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::woq_linear_rotary_position_embedding_cache_forward_cpu);
+#endif
 }
 } // namespace
@@ -39,6 +39,21 @@ rotary_position_embedding_deepseek_v2_kernel_impl(
     int64_t H,
     int64_t offset,
     int64_t rotary_ndims);
+
+void rotary_position_embedding_cache_kernel_impl(
+    at::Tensor& t_in,
+    at::Tensor& t_emb_pos,
+    at::Tensor& t_pos,
+    int64_t N, // N: number of head, H: head size
+    int64_t H,
+    int64_t offset,
+    int64_t rotary_ndims,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& slot_mapping,
+    double k_scale,
+    double v_scale,
+    at::Tensor& query);
 } // namespace
 
 using rotary_position_embedding_kernel_fn =
@@ -85,5 +100,24 @@ IPEX_DECLARE_DISPATCH(
     rotary_position_embedding_deepseek_v2_kernel_fn,
     rotary_position_embedding_deepseek_v2_kernel_stub);
 
+using rotary_position_embedding_cache_kernel_fn = void (*)(
+    at::Tensor& t_in,
+    at::Tensor& t_emb_pos,
+    at::Tensor& t_pos,
+    int64_t N, // N: number of head, H: head size
+    int64_t H,
+    int64_t offset,
+    int64_t rotary_ndims,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& slot_mapping,
+    double k_scale,
+    double v_scale,
+    at::Tensor& query);
+
+IPEX_DECLARE_DISPATCH(
+    rotary_position_embedding_cache_kernel_fn,
+    rotary_position_embedding_cache_kernel_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
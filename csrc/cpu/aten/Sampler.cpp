@@ -0,0 +1,57 @@
+#include "Sampler.h"
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+IPEX_DEFINE_DISPATCH(fused_sampler_kernel_stub);
+
+// logits: [bs, vocab_size]
+// input_ids: [bs, seq_len], tokens seen so far, for repetition_penalty
+// uniform: [bs], random numbers in [0, 1) used for sampling, drawn with
+//   the default generator when not given
+// Returns the next tokens [bs], see `fused_sampler_kernel_impl`.
+at::Tensor fused_sampler_forward_cpu(
+    const at::Tensor& logits,
+    const c10::optional<at::Tensor>& input_ids,
+    double temperature,
+    double repetition_penalty,
+    int64_t top_k,
+    double top_p,
+    const c10::optional<at::Tensor>& uniform) {
+  RECORD_FUNCTION("ipex::fused_sampler", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(logits.dim() == 2, "fused_sampler: logits should be 2D");
+  auto u = uniform.has_value()
+      ? uniform.value().to(at::kDouble).contiguous()
+      : at::rand({logits.size(0)}, logits.options().dtype(at::kDouble));
+  TORCH_CHECK(
+      u.numel() == logits.size(0),
+      "fused_sampler: expect one random number per row of logits");
+  return fused_sampler_kernel_stub(
+      kCPU,
+      logits.contiguous(),
+      input_ids,
+      temperature,
+      repetition_penalty,
+      top_k,
+      top_p,
+      u);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "fused_sampler(Tensor logits, Tensor? input_ids, float temperature, \
+       float repetition_penalty, int top_k, float top_p, Tensor? uniform=None) \
+       -> (Tensor)");
+  m.impl(
+      "fused_sampler",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::fused_sampler_forward_cpu);
+}
+} // namespace
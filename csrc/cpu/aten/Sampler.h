@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+at::Tensor fused_sampler_forward_cpu(
+    const at::Tensor& logits,
+    const c10::optional<at::Tensor>& input_ids,
+    double temperature,
+    double repetition_penalty,
+    int64_t top_k,
+    double top_p,
+    const c10::optional<at::Tensor>& uniform);
+} // namespace
+
+using fused_sampler_kernel_fn = at::Tensor (*)(
+    const at::Tensor& logits,
+    const c10::optional<at::Tensor>& input_ids,
+    double temperature,
+    double repetition_penalty,
+    int64_t top_k,
+    double top_p,
+    const at::Tensor& uniform);
+IPEX_DECLARE_DISPATCH(fused_sampler_kernel_fn, fused_sampler_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -15,6 +15,7 @@ namespace cpu {
 
 IPEX_DEFINE_DISPATCH(selective_scan_kernel_stub);
 IPEX_DEFINE_DISPATCH(selective_state_update_kernel_stub);
+IPEX_DEFINE_DISPATCH(causal_conv1d_selective_state_update_kernel_stub);
 
 /**
  * Does selective scan algorithm in Mamba Paper.
@@ -95,6 +96,56 @@ at::Tensor selective_state_update(
       kCPU, state, x, dt, A, B, C, D, z, dt_bias, dt_softplus);
 }
 
+/**
+ * Mamba2 decode step, causal_conv1d_update with SiLU over the xBC channels
+ * followed by selective_state_update on the split x, B and C, the head h uses
+ * the group h / (nheads / ngroups).
+ * @param hidden_states: (batch, conv_dim), the xBC channels of the new token,
+ * conv_dim = nheads * head_dim + 2 * ngroups * dstate
+ * @param conv_states: (batch, conv_dim, state_len), updated in place
+ * @param conv_weights: (conv_dim, width)
+ * @param conv_bias: (conv_dim,) or None
+ * @param ssm_state: (batch, nheads, head_dim, dstate), updated in place
+ * @param dt: (batch, nheads, head_dim)
+ * @param A: (nheads, head_dim, dstate), fp32
+ * @param D: (nheads, head_dim) or None, fp32
+ * @param z: (batch, nheads, head_dim) or None
+ * @param dt_bias: (nheads, head_dim) or None, fp32
+ * @param dt_softplus: bool
+ * @param ngroups: number of B/C groups
+ * @return: out: (batch, nheads, head_dim)
+ */
+at::Tensor causal_conv1d_selective_state_update(
+    const at::Tensor& hidden_states,
+    const at::Tensor& conv_states,
+    const at::Tensor& conv_weights,
+    const c10::optional<at::Tensor>& conv_bias,
+    const at::Tensor& ssm_state,
+    const at::Tensor& dt,
+    const at::Tensor& A,
+    const c10::optional<at::Tensor>& D,
+    const c10::optional<at::Tensor>& z,
+    const c10::optional<at::Tensor>& dt_bias,
+    bool dt_softplus,
+    int64_t ngroups) {
+  RECORD_FUNCTION(
+      "causal_conv1d_selective_state_update", c10::ArrayRef<c10::IValue>({}));
+  return causal_conv1d_selective_state_update_kernel_stub(
+      kCPU,
+      hidden_states,
+      conv_states,
+      conv_weights,
+      conv_bias,
+      ssm_state,
+      dt,
+      A,
+      D,
+      z,
+      dt_bias,
+      dt_softplus,
+      ngroups);
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -113,6 +164,12 @@ IPEX_TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "selective_state_update",
       c10::DispatchKey::CPU,
       torch_ipex::cpu::selective_state_update);
+  m.def(
+      "causal_conv1d_selective_state_update(Tensor hidden_states, Tensor conv_states, Tensor conv_weights, Tensor? conv_bias, Tensor ssm_state, Tensor dt, Tensor A, Tensor? D, Tensor? z, Tensor? dt_bias, bool dt_softplus, int ngroups) -> (Tensor)");
+  m.impl(
+      "causal_conv1d_selective_state_update",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::causal_conv1d_selective_state_update);
 }
 
 } // namespace
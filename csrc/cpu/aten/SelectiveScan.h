@@ -28,6 +28,19 @@ at::Tensor selective_state_update(
     const c10::optional<at::Tensor>& z,
     const c10::optional<at::Tensor>& dt_bias,
     bool dt_softplus);
+at::Tensor causal_conv1d_selective_state_update(
+    const at::Tensor& hidden_states,
+    const at::Tensor& conv_states,
+    const at::Tensor& conv_weights,
+    const c10::optional<at::Tensor>& conv_bias,
+    const at::Tensor& ssm_state,
+    const at::Tensor& dt,
+    const at::Tensor& A,
+    const c10::optional<at::Tensor>& D,
+    const c10::optional<at::Tensor>& z,
+    const c10::optional<at::Tensor>& dt_bias,
+    bool dt_softplus,
+    int64_t ngroups);
 
 using selective_scan_kernel_fn = std::tuple<at::Tensor, at::Tensor> (*)(
     const at::Tensor& u,
@@ -51,10 +64,26 @@ using selective_state_update_fn = at::Tensor (*)(
     const c10::optional<at::Tensor>& z,
     const c10::optional<at::Tensor>& dt_bias,
     bool dt_softplus);
+using causal_conv1d_selective_state_update_fn = at::Tensor (*)(
+    const at::Tensor& hidden_states,
+    const at::Tensor& conv_states,
+    const at::Tensor& conv_weights,
+    const c10::optional<at::Tensor>& conv_bias,
+    const at::Tensor& ssm_state,
+    const at::Tensor& dt,
+    const at::Tensor& A,
+    const c10::optional<at::Tensor>& D,
+    const c10::optional<at::Tensor>& z,
+    const c10::optional<at::Tensor>& dt_bias,
+    bool dt_softplus,
+    int64_t ngroups);
 IPEX_DECLARE_DISPATCH(selective_scan_kernel_fn, selective_scan_kernel_stub);
 IPEX_DECLARE_DISPATCH(
     selective_state_update_fn,
     selective_state_update_kernel_stub);
+IPEX_DECLARE_DISPATCH(
+    causal_conv1d_selective_state_update_fn,
+    causal_conv1d_selective_state_update_kernel_stub);
 
 } // namespace cpu
 } // namespace torch_ipex
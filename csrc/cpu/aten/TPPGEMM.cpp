@@ -15,6 +15,7 @@ IPEX_DEFINE_DISPATCH(tpp_linear_relu_kernel_stub);
 IPEX_DEFINE_DISPATCH(tpp_linear_add_kernel_stub);
 IPEX_DEFINE_DISPATCH(tpp_linear_mul_kernel_stub);
 IPEX_DEFINE_DISPATCH(tpp_linear_add_add_kernel_stub);
+IPEX_DEFINE_DISPATCH(tpp_linear_topk_kernel_stub);
 IPEX_DEFINE_DISPATCH(tpp_gelu_tanh_bf16_kernel_stub);
 
 void tpp_gelu_tanh_bf16_forward_cpu(
@@ -116,6 +117,16 @@ at::Tensor tpp_linear_add_add_forward_cpu(
       kCPU, t_in, t_in1, t_in2, t_wt, t_bias, scale);
 }
 
+std::tuple<at::Tensor, at::Tensor> tpp_linear_topk_forward_cpu(
+    const at::Tensor& t_in,
+    const at::Tensor& t_wt,
+    int64_t k,
+    c10::optional<int64_t> out_features) {
+  auto vocab_size = t_wt.size(0) * t_wt.size(3);
+  return tpp_linear_topk_kernel_stub(
+      kCPU, t_in, t_wt, k, out_features.value_or(vocab_size));
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -211,5 +222,14 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       torch_ipex::cpu::tpp_linear_mul_forward_cpu);
 }
 
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "tpp_linear_topk(Tensor t_in, Tensor t_wt, int k, int? out_features=None)-> (Tensor values, Tensor indices)");
+  m.impl(
+      "tpp_linear_topk",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::tpp_linear_topk_forward_cpu);
+}
+
 } // namespace
 #endif
\ No newline at end of file
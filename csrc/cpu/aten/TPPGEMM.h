@@ -73,6 +73,12 @@ at::Tensor tpp_linear_add_add_forward_cpu(
     double scale,
     c10::optional<int64_t> out_features);
 
+std::tuple<at::Tensor, at::Tensor> tpp_linear_topk_forward_cpu(
+    const at::Tensor& t_in,
+    const at::Tensor& t_wt,
+    int64_t k,
+    c10::optional<int64_t> out_features);
+
 void tpp_gelu_tanh_bf16_forward_cpu(
     at::BFloat16* in,
     at::BFloat16* out,
@@ -127,6 +133,12 @@ using tpp_linear_add_add_kernel_impl_fn = at::Tensor (*)(
     const at::Tensor&,
     double);
 
+using tpp_linear_topk_kernel_impl_fn = std::tuple<at::Tensor, at::Tensor> (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    int64_t,
+    int64_t);
+
 using tpp_gelu_tanh_bf16_kernel_impl_fn =
     void (*)(at::BFloat16*, at::BFloat16*, int, int, int, int);
 
@@ -155,6 +167,9 @@ IPEX_DECLARE_DISPATCH(
 IPEX_DECLARE_DISPATCH(
     tpp_linear_add_add_kernel_impl_fn,
     tpp_linear_add_add_kernel_stub);
+IPEX_DECLARE_DISPATCH(
+    tpp_linear_topk_kernel_impl_fn,
+    tpp_linear_topk_kernel_stub);
 IPEX_DECLARE_DISPATCH(
     tpp_gelu_tanh_bf16_kernel_impl_fn,
     tpp_gelu_tanh_bf16_kernel_stub);
@@ -4,7 +4,13 @@
 #include <aten/MaskedMultiHeadAttention.h>
 #include <torch/all.h>
 #include <torch/csrc/autograd/function.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "../../utils/isa_utils.h"
 #include "vec/vec.h"
 
@@ -194,10 +200,8 @@ struct Unroll<1> {
 namespace {
 // [NOTE] TODO list for this kernel:
 //   1. tune the value for BLOCK_N
-//   2. planning for {batches, num_heads, num_kv_splits}
-//      and use actual num_kv_splits for small seq length
-//   3. try fast impl of `.tanh()`
-//   4. provide amx kernel for index_gemm_kernel_nn when M = 16
+//   2. try fast impl of `.tanh()`
+//   3. provide amx kernel for index_gemm_kernel_nn when M = 16
 //
 inline void fill_stub(float* __restrict__ out, float val, int size) {
   using Vec = at::vec::Vectorized<float>;
@@ -225,6 +229,102 @@ inline void copy_stub(
     out[d] = static_cast<scalar_t>(acc[d] * s);
   }
 }
+// int8 and fp8-e4m3fn caches keep a per-token scale behind each row,
+// see `kKVCacheScaleBytes`
+template <typename cache_t>
+constexpr bool kv_cache_has_scale() {
+  return std::is_same_v<cache_t, int8_t> ||
+      std::is_same_v<cache_t, at::Float8_e4m3fn>;
+}
+template <typename cache_t>
+constexpr int kv_cache_row_size(int head_size) {
+  constexpr int scale_bytes = static_cast<int>(kKVCacheScaleBytes);
+  return head_size + (kv_cache_has_scale<cache_t>() ? scale_bytes : 0);
+}
+template <typename scalar_t, typename cache_t>
+inline void dequant_stub(
+    scalar_t* __restrict__ out,
+    const cache_t* __restrict__ in,
+    float s,
+    int size) {
+  for (int d = 0; d < size; ++d) {
+    out[d] = static_cast<scalar_t>(static_cast<float>(in[d]) * s);
+  }
+}
+#if defined(CPU_CAPABILITY_AVX512)
+template <typename scalar_t>
+inline void dequant_stub(
+    scalar_t* __restrict__ out,
+    const int8_t* __restrict__ in,
+    float s,
+    int size) {
+  using bVec = at::vec::Vectorized<scalar_t>;
+  using fVec = at::vec::Vectorized<float>;
+  const fVec s_fvec = fVec(s);
+  int d = 0;
+  for (; d <= size - bVec::size(); d += bVec::size()) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)(in + d));
+    __m512i x0 = _mm512_cvtepi8_epi32(_mm256_castsi256_si128(x));
+    __m512i x1 = _mm512_cvtepi8_epi32(_mm256_extracti128_si256(x, 1));
+    fVec a_fvec0 = fVec(_mm512_cvtepi32_ps(x0)) * s_fvec;
+    fVec a_fvec1 = fVec(_mm512_cvtepi32_ps(x1)) * s_fvec;
+    bVec out_bvec = convert_from_float_ext<scalar_t>(a_fvec0, a_fvec1);
+    out_bvec.store(out + d);
+  }
+  for (; d < size; ++d) {
+    out[d] = static_cast<scalar_t>(static_cast<float>(in[d]) * s);
+  }
+}
+template <typename scalar_t>
+inline void dequant_stub(
+    scalar_t* __restrict__ out,
+    const at::Float8_e4m3fn* __restrict__ in,
+    float s,
+    int size) {
+  using bVec = at::vec::Vectorized<scalar_t>;
+  using fVec = at::vec::Vectorized<float>;
+  const fVec s_fvec = fVec(s);
+  int d = 0;
+  for (; d <= size - bVec::size(); d += bVec::size()) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)(in + d));
+    __m512i y = kernel::cvt_e4m3_bf16_intrinsic_with_denorm(x);
+    __m512 y0 = kernel::_mm512_cvtpbh_ps(_mm512_castsi512_si256(y));
+    __m512 y1 = kernel::_mm512_cvtpbh_ps(_mm512_extracti64x4_epi64(y, 1));
+    fVec a_fvec0 = fVec(y0) * s_fvec;
+    fVec a_fvec1 = fVec(y1) * s_fvec;
+    bVec out_bvec = convert_from_float_ext<scalar_t>(a_fvec0, a_fvec1);
+    out_bvec.store(out + d);
+  }
+  for (; d < size; ++d) {
+    out[d] = static_cast<scalar_t>(static_cast<float>(in[d]) * s);
+  }
+}
+#endif
+// Dequantize `n_size` rows of the kv cache into `tile` [n_size, head_size],
+// rows are picked by `indices` when given, or read consecutively otherwise.
+template <typename scalar_t, typename cache_t, typename index_t>
+inline void dequant_kv_tile(
+    scalar_t* __restrict__ tile,
+    const cache_t* __restrict__ kv_cache,
+    const index_t* __restrict__ indices,
+    int n_size,
+    int head_size,
+    int ld,
+    int max_tokens) {
+  for (int n = 0; n < n_size; ++n) {
+    int idx = n;
+    if (indices != nullptr) {
+      idx = indices[n];
+      TORCH_CHECK(idx < max_tokens, "token index out of scope!");
+    }
+    const cache_t* row = kv_cache + int64_t(idx) * ld;
+    float s = 1.f;
+    if constexpr (kv_cache_has_scale<cache_t>()) {
+      std::memcpy(&s, row + head_size, sizeof(float));
+    }
+    dequant_stub<scalar_t>(tile + n * head_size, row, s, head_size);
+  }
+}
 // GEMM handles query @ key (indexed) x scale
 //   A : [M, K]
 //   B : [N, K] indexed
@@ -1315,6 +1415,71 @@ void gemm_kernel_nn(
     }
   }
 }
+// Merge the partial results of the kv splits into output, per (batch, head).
+// NB: logits[b][h][0] is used as acc, since for the first kv split:
+//   m_delta = std::exp(-inf) = 0
+//   e_logic = std::exp(0) = 1
+//   acc = acc * m_delta + tv * e_logic = tv
+// When there are fewer (batch, head) pairs than threads, head_size_v is
+// split as well and every part recomputes the (cheap) split weights.
+template <typename scalar_t>
+void decode_attention_merge_kv_splits(
+    scalar_t* __restrict__ output,
+    float* __restrict__ attn_logits,
+    int batch_heads,
+    int head_size_v,
+    int num_kv_splits) {
+  using Vec = at::vec::Vectorized<float>;
+  // smallest part of head_size_v worth a task of its own
+  constexpr int BLOCK_V = 64;
+  const int stride_l1 = num_kv_splits * (head_size_v + 1);
+  const int stride_l2 = head_size_v + 1;
+  const int num_threads = at::get_num_threads();
+  int num_v_blocks = 1;
+  if (batch_heads < num_threads) {
+    num_v_blocks = std::min(
+        div_up(head_size_v, BLOCK_V), div_up(num_threads, batch_heads));
+  }
+  const int v_block_size =
+      div_up(div_up(head_size_v, num_v_blocks), Vec::size()) * Vec::size();
+  num_v_blocks = div_up(head_size_v, v_block_size);
+  // parallel on [batches * num_heads, num_v_blocks]
+  parallel_for(batch_heads * num_v_blocks, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      const int bh = i / num_v_blocks;
+      const int v_start = (i % num_v_blocks) * v_block_size;
+      const int v_size = std::min(v_block_size, head_size_v - v_start);
+      float* __restrict__ acc = attn_logits + bh * stride_l1;
+      float s_prime = 0.f;
+      float m_prime = -std::numeric_limits<scalar_t>::infinity();
+      // update acc with from each kv_split
+      for (int kv_id = 0; kv_id < num_kv_splits; ++kv_id) {
+        float* __restrict__ tv = acc + kv_id * stride_l2;
+        const float tlogic = tv[head_size_v];
+        float m_i = std::max(tlogic, m_prime);
+        float m_delta = std::exp(m_prime - m_i);
+        float e_logic = std::exp(tlogic - m_i);
+        if (kv_id != 0) {
+          at::vec::map2<float>(
+              [m_delta, e_logic](Vec x, Vec y) {
+                return x * Vec(m_delta) + y * Vec(e_logic);
+              },
+              acc + v_start,
+              acc + v_start,
+              tv + v_start,
+              v_size);
+        }
+        s_prime = s_prime * m_delta + e_logic;
+        m_prime = m_i;
+      }
+      copy_stub<scalar_t>(
+          output + bh * head_size_v + v_start,
+          acc + v_start,
+          1 / s_prime,
+          v_size);
+    }
+  });
+}
 template <typename scalar_t, typename index_t>
 void decode_attention_kernel_impl(
     scalar_t* __restrict__ output,
@@ -1340,8 +1505,6 @@ void decode_attention_kernel_impl(
   const int stride_q1 = head_size;
   const int stride_kv0 = num_heads * head_size;
   const int stride_kv1 = head_size;
-  const int stride_l1 = num_kv_splits * (head_size_v + 1);
-  const int stride_l2 = head_size_v + 1;
   const bool has_logit_cap = logit_cap > 0;
   float rlogit_cap = has_logit_cap ? 1 / logit_cap : 0.f;
   // parallel on [batches, num_heads, num_kv_splits]
@@ -1424,7 +1587,7 @@ void decode_attention_kernel_impl(
             /* ldc */ 1,
             /* mtt */ max_total_num_tokens);
       } // loop with KV blocks
-      float s = 1 / s_prime;
+      float s = std::fabs(s_prime) < 1e-9 ? 0 : 1 / s_prime;
       at::vec::map<float>(
           [s](Vec out) { return out * Vec(s); }, v_prime, v_prime, head_size_v);
       v_prime[head_size_v] = m_prime + std::log(s_prime);
@@ -1432,41 +1595,8 @@ void decode_attention_kernel_impl(
       data_index_step(bs, batches, head_id, num_heads, kv_id, num_kv_splits);
     }
   });
-  // parallel on [batches, num_heads]
-  parallel_for(batches * num_heads, [&](int begin, int end) {
-    // NB: here we use logits[b][h][0] as acc, since
-    // for the first kv split (kv_id == 0):
-    //   m_delta = std::exp(-inf) = 0
-    //   e_logic = std::exp(0) = 1
-    //   acc = acc * m_delta + tv * e_logic = tv
-    for (int i = begin; i < end; ++i) {
-      float* __restrict__ acc = attn_logits + i * stride_l1;
-      float s_prime = 0.f;
-      float m_prime = -std::numeric_limits<scalar_t>::infinity();
-      // update acc with from each kv_split
-      for (int kv_id = 0; kv_id < num_kv_splits; ++kv_id) {
-        float* __restrict__ tv = acc + kv_id * stride_l2;
-        const float tlogic = (acc + kv_id * stride_l2)[head_size_v];
-        float m_i = std::max(tlogic, m_prime);
-        float m_delta = std::exp(m_prime - m_i);
-        float e_logic = std::exp(tlogic - m_i);
-        if (kv_id != 0) {
-          at::vec::map2<float>(
-              [m_delta, e_logic](Vec x, Vec y) {
-                return x * Vec(m_delta) + y * Vec(e_logic);
-              },
-              acc,
-              acc,
-              tv,
-              head_size_v);
-        }
-        s_prime = s_prime * m_delta + e_logic;
-        m_prime = m_i;
-      }
-      copy_stub<scalar_t>(
-          output + i * head_size_v, acc, 1 / s_prime, head_size_v);
-    }
-  });
+  decode_attention_merge_kv_splits<scalar_t>(
+      output, attn_logits, batches * num_heads, head_size_v, num_kv_splits);
 }
 
 template <typename scalar_t>
@@ -1492,8 +1622,6 @@ void decode_attention_opt_kernel_impl(
   const int stride_q1 = head_size;
   const int stride_kv0 = num_heads * head_size;
   const int stride_kv1 = head_size;
-  const int stride_l1 = num_kv_splits * (head_size_v + 1);
-  const int stride_l2 = head_size_v + 1;
   const bool has_logit_cap = logit_cap > 0;
   float rlogit_cap = has_logit_cap ? 1 / logit_cap : 0.f;
   // parallel on [batches, num_heads, num_kv_splits]
@@ -1574,7 +1702,7 @@ void decode_attention_opt_kernel_impl(
             /* ldc */ 1,
             /* mtt */ max_total_num_tokens);
       } // loop with KV blocks
-      float s = 1 / s_prime;
+      float s = std::fabs(s_prime) < 1e-9 ? 0 : 1 / s_prime;
       at::vec::map<float>(
           [s](Vec out) { return out * Vec(s); }, v_prime, v_prime, head_size_v);
       v_prime[head_size_v] = m_prime + std::log(s_prime);
@@ -1582,48 +1710,15 @@ void decode_attention_opt_kernel_impl(
       data_index_step(bs, batches, head_id, num_heads, kv_id, num_kv_splits);
     }
   });
-  // parallel on [batches, num_heads]
-  parallel_for(batches * num_heads, [&](int begin, int end) {
-    // NB: here we use logits[b][h][0] as acc, since
-    // for the first kv split (kv_id == 0):
-    //   m_delta = std::exp(-inf) = 0
-    //   e_logic = std::exp(0) = 1
-    //   acc = acc * m_delta + tv * e_logic = tv
-    for (int i = begin; i < end; ++i) {
-      float* __restrict__ acc = attn_logits + i * stride_l1;
-      float s_prime = 0.f;
-      float m_prime = -std::numeric_limits<scalar_t>::infinity();
-      // update acc with from each kv_split
-      for (int kv_id = 0; kv_id < num_kv_splits; ++kv_id) {
-        float* __restrict__ tv = acc + kv_id * stride_l2;
-        const float tlogic = (acc + kv_id * stride_l2)[head_size_v];
-        float m_i = std::max(tlogic, m_prime);
-        float m_delta = std::exp(m_prime - m_i);
-        float e_logic = std::exp(tlogic - m_i);
-        if (kv_id != 0) {
-          at::vec::map2<float>(
-              [m_delta, e_logic](Vec x, Vec y) {
-                return x * Vec(m_delta) + y * Vec(e_logic);
-              },
-              acc,
-              acc,
-              tv,
-              head_size_v);
-        }
-        s_prime = s_prime * m_delta + e_logic;
-        m_prime = m_i;
-      }
-      copy_stub<scalar_t>(
-          output + i * head_size_v, acc, 1 / s_prime, head_size_v);
-    }
-  });
+  decode_attention_merge_kv_splits<scalar_t>(
+      output, attn_logits, batches * num_heads, head_size_v, num_kv_splits);
 }
-template <typename scalar_t, typename index_t>
+template <typename scalar_t, typename index_t, typename cache_t = scalar_t>
 void decode_attention_grouped_kernel_impl(
     scalar_t* __restrict__ output,
     float* __restrict__ attn_logits,
     const scalar_t* __restrict__ query,
-    const scalar_t* __restrict__ kv_cache,
+    const cache_t* __restrict__ kv_cache,
     const index_t* __restrict__ beam_idx,
     int seq_len_kv,
     int batches,
@@ -1644,8 +1739,10 @@ void decode_attention_grouped_kernel_impl(
   // strides
   const int stride_q0 = num_heads * head_size;
   const int stride_q1 = head_size;
-  const int stride_kv0 = num_heads_kv * head_size;
-  const int stride_kv1 = head_size;
+  const int stride_kv0 = num_heads_kv * kv_cache_row_size<cache_t>(head_size);
+  const int stride_kv1 = kv_cache_row_size<cache_t>(head_size);
+  // a quantized cache is dequantized by tiles of BLOCK_N tokens
+  constexpr bool dequant_kv = !std::is_same_v<cache_t, scalar_t>;
   const int stride_l0 = num_heads * num_kv_splits * (head_size_v + 1);
   const int stride_l1 = num_kv_splits * (head_size_v + 1);
   const int stride_l2 = head_size_v + 1;
@@ -1666,6 +1763,10 @@ void decode_attention_grouped_kernel_impl(
     static thread_local float s_prime[BLOCK_H];
     static thread_local float m_prime[BLOCK_H];
     static thread_local float m_delta[BLOCK_H];
+    static thread_local std::vector<scalar_t> kv_tile;
+    if (dequant_kv) {
+      kv_tile.resize(BLOCK_N * head_size);
+    }
     for (int i = begin; i < end; ++i) {
       const int h_start = head_id * num_heads_per_block;
       const int h_end = std::min(h_start + num_heads_per_block, num_heads);
@@ -1690,19 +1791,42 @@ void decode_attention_grouped_kernel_impl(
       for (int n = kv_start; n < kv_end; n += BLOCK_N) {
         int n_size = std::min(BLOCK_N, kv_end - n);
         // calculate Q @ K
-        index_gemm_kernel_nt<scalar_t, index_t>(
-            /* A   */ q_ptr,
-            /* B   */ kv_cache + head_kv_id * stride_kv1,
-            /* C   */ s_i,
-            /* ind */ beam_idx + bs * beam_stride0 + n,
-            /* scl */ scaling,
-            /* M   */ h_size,
-            /* N   */ n_size,
-            /* K   */ head_size,
-            /* lda */ stride_q1,
-            /* ldb */ stride_kv0,
-            /* ldc */ BLOCK_N,
-            /* mtt */ max_total_num_tokens);
+        if constexpr (dequant_kv) {
+          dequant_kv_tile(
+              kv_tile.data(),
+              kv_cache + head_kv_id * stride_kv1,
+              beam_idx + bs * beam_stride0 + n,
+              n_size,
+              head_size,
+              stride_kv0,
+              max_total_num_tokens);
+          gemm_kernel_nt<scalar_t>(
+              /* A   */ q_ptr,
+              /* B   */ kv_tile.data(),
+              /* C   */ s_i,
+              /* scl */ scaling,
+              /* M   */ h_size,
+              /* N   */ n_size,
+              /* K   */ head_size,
+              /* lda */ stride_q1,
+              /* ldb */ head_size,
+              /* ldc */ BLOCK_N,
+              /* mtt */ n_size);
+        } else {
+          index_gemm_kernel_nt<scalar_t, index_t>(
+              /* A   */ q_ptr,
+              /* B   */ kv_cache + head_kv_id * stride_kv1,
+              /* C   */ s_i,
+              /* ind */ beam_idx + bs * beam_stride0 + n,
+              /* scl */ scaling,
+              /* M   */ h_size,
+              /* N   */ n_size,
+              /* K   */ head_size,
+              /* lda */ stride_q1,
+              /* ldb */ stride_kv0,
+              /* ldc */ BLOCK_N,
+              /* mtt */ max_total_num_tokens);
+        }
         if (has_logit_cap) {
           at::vec::map<float>(
               [logit_cap, rlogit_cap](Vec x) {
@@ -1737,19 +1861,34 @@ void decode_attention_grouped_kernel_impl(
           m_prime[h] = m_i;
         }
         // caculate V' <- s_delta @ V + V' * m_delta
-        index_gemm_kernel_nn(
-            /* A   */ s_delta,
-            /* B   */ kv_cache + head_kv_id * stride_kv1,
-            /* C   */ v_prime,
-            /* ind */ beam_idx + bs * beam_stride0 + n,
-            /* scl */ m_delta,
-            /* M   */ h_size,
-            /* N   */ head_size_v,
-            /* K   */ n_size,
-            /* lda */ BLOCK_N,
-            /* ldb */ stride_kv0,
-            /* ldc */ stride_l1,
-            /* mtt */ max_total_num_tokens);
+        if constexpr (dequant_kv) {
+          gemm_kernel_nn(
+              /* A   */ s_delta,
+              /* B   */ kv_tile.data(),
+              /* C   */ v_prime,
+              /* scl */ m_delta,
+              /* M   */ h_size,
+              /* N   */ head_size_v,
+              /* K   */ n_size,
+              /* lda */ BLOCK_N,
+              /* ldb */ head_size,
+              /* ldc */ stride_l1,
+              /* mtt */ n_size);
+        } else {
+          index_gemm_kernel_nn(
+              /* A   */ s_delta,
+              /* B   */ kv_cache + head_kv_id * stride_kv1,
+              /* C   */ v_prime,
+              /* ind */ beam_idx + bs * beam_stride0 + n,
+              /* scl */ m_delta,
+              /* M   */ h_size,
+              /* N   */ head_size_v,
+              /* K   */ n_size,
+              /* lda */ BLOCK_N,
+              /* ldb */ stride_kv0,
+              /* ldc */ stride_l1,
+              /* mtt */ max_total_num_tokens);
+        }
       } // loop with KV blocks
       for (int h = 0; h < h_size; ++h) {
         float s = std::fabs(s_prime[h]) < 1e-9 ? 0 : 1 / s_prime[h];
@@ -1765,44 +1904,15 @@ void decode_attention_grouped_kernel_impl(
       data_index_step(bs, batches, head_id, num_blocks, kv_id, num_kv_splits);
     }
   });
-  // parallel on [batches, num_heads]
-  parallel_for(batches * num_heads, [&](int begin, int end) {
-    // NB: same as above
-    for (int i = begin; i < end; ++i) {
-      float* __restrict__ acc = attn_logits + i * stride_l1;
-      float s_prime = 0.f;
-      float m_prime = -std::numeric_limits<scalar_t>::infinity();
-      // update acc with from each kv_split
-      for (int kv_id = 0; kv_id < num_kv_splits; ++kv_id) {
-        float* __restrict__ tv = acc + kv_id * stride_l2;
-        const float tlogic = (acc + kv_id * stride_l2)[head_size_v];
-        float m_i = std::max(tlogic, m_prime);
-        float m_delta = std::exp(m_prime - m_i);
-        float e_logic = std::exp(tlogic - m_i);
-        if (kv_id != 0) {
-          at::vec::map2<float>(
-              [m_delta, e_logic](Vec x, Vec y) {
-                return x * Vec(m_delta) + y * Vec(e_logic);
-              },
-              acc,
-              acc,
-              tv,
-              head_size_v);
-        }
-        s_prime = s_prime * m_delta + e_logic;
-        m_prime = m_i;
-      }
-      copy_stub<scalar_t>(
-          output + i * head_size_v, acc, 1 / s_prime, head_size_v);
-    }
-  });
+  decode_attention_merge_kv_splits<scalar_t>(
+      output, attn_logits, batches * num_heads, head_size_v, num_kv_splits);
 }
-template <typename scalar_t>
+template <typename scalar_t, typename cache_t = scalar_t>
 void decode_attention_grouped_opt_kernel_impl(
     scalar_t* __restrict__ output,
     float* __restrict__ attn_logits,
     const scalar_t* __restrict__ query,
-    const scalar_t* __restrict__ kv_cache,
+    const cache_t* __restrict__ kv_cache,
     int seq_len_kv,
     int batches,
     int num_heads,
@@ -1821,9 +1931,12 @@ void decode_attention_grouped_opt_kernel_impl(
   // strides
   const int stride_q0 = num_heads * head_size;
   const int stride_q1 = head_size;
-  const int stride_kv0 = num_heads_kv * head_size * batches;
-  const int stride_kv1 = num_heads_kv * head_size;
-  const int stride_kv2 = head_size;
+  const int row_size = kv_cache_row_size<cache_t>(head_size);
+  const int stride_kv0 = num_heads_kv * row_size * batches;
+  const int stride_kv1 = num_heads_kv * row_size;
+  const int stride_kv2 = row_size;
+  // a quantized cache is dequantized by tiles of BLOCK_N tokens
+  constexpr bool dequant_kv = !std::is_same_v<cache_t, scalar_t>;
   const int stride_l0 = num_heads * num_kv_splits * (head_size_v + 1);
   const int stride_l1 = num_kv_splits * (head_size_v + 1);
   const int stride_l2 = head_size_v + 1;
@@ -1844,6 +1957,10 @@ void decode_attention_grouped_opt_kernel_impl(
     static thread_local float s_prime[BLOCK_H];
     static thread_local float m_prime[BLOCK_H];
     static thread_local float m_delta[BLOCK_H];
+    static thread_local std::vector<scalar_t> kv_tile;
+    if (dequant_kv) {
+      kv_tile.resize(BLOCK_N * head_size);
+    }
     for (int i = begin; i < end; ++i) {
       const int h_start = head_id * num_heads_per_block;
       const int h_end = std::min(h_start + num_heads_per_block, num_heads);
@@ -1867,18 +1984,36 @@ void decode_attention_grouped_opt_kernel_impl(
       // loop over K and V sequence with BLOCK_N
       for (int n = kv_start; n < kv_end; n += BLOCK_N) {
         int n_size = std::min(BLOCK_N, kv_end - n);
+        const cache_t* __restrict__ k_ptr = kv_cache +
+            head_kv_id * stride_kv2 + n * stride_kv0 + bs * stride_kv1;
+        const scalar_t* __restrict__ kv_ptr;
+        int ld_kv;
+        if constexpr (dequant_kv) {
+          dequant_kv_tile<scalar_t, cache_t, int>(
+              kv_tile.data(),
+              k_ptr,
+              nullptr,
+              n_size,
+              head_size,
+              stride_kv0,
+              max_total_num_tokens);
+          kv_ptr = kv_tile.data();
+          ld_kv = head_size;
+        } else {
+          kv_ptr = k_ptr;
+          ld_kv = stride_kv0;
+        }
         // calculate Q @ K
         gemm_kernel_nt<scalar_t>(
             /* A   */ q_ptr,
-            /* B   */ kv_cache + head_kv_id * stride_kv2 + n * stride_kv0 +
-                bs * stride_kv1,
+            /* B   */ kv_ptr,
             /* C   */ s_i,
             /* scl */ scaling,
             /* M   */ h_size,
             /* N   */ n_size,
             /* K   */ head_size,
             /* lda */ stride_q1,
-            /* ldb */ stride_kv0,
+            /* ldb */ ld_kv,
             /* ldc */ BLOCK_N,
             /* mtt */ max_total_num_tokens);
         if (has_logit_cap) {
@@ -1917,15 +2052,14 @@ void decode_attention_grouped_opt_kernel_impl(
         // caculate V' <- s_delta @ V + V' * m_delta
         gemm_kernel_nn(
             /* A   */ s_delta,
-            /* B   */ kv_cache + head_kv_id * stride_kv2 + n * stride_kv0 +
-                bs * stride_kv1,
+            /* B   */ kv_ptr,
             /* C   */ v_prime,
             /* scl */ m_delta,
             /* M   */ h_size,
             /* N   */ head_size_v,
             /* K   */ n_size,
             /* lda */ BLOCK_N,
-            /* ldb */ stride_kv0,
+            /* ldb */ ld_kv,
             /* ldc */ stride_l1,
             /* mtt */ max_total_num_tokens);
       } // loop with KV blocks
@@ -1943,43 +2077,200 @@ void decode_attention_grouped_opt_kernel_impl(
       data_index_step(bs, batches, head_id, num_blocks, kv_id, num_kv_splits);
     }
   });
-  // parallel on [batches, num_heads]
-  parallel_for(batches * num_heads, [&](int begin, int end) {
-    // NB: same as above
-    for (int i = begin; i < end; ++i) {
-      float* __restrict__ acc = attn_logits + i * stride_l1;
-      float s_prime = 0.f;
-      float m_prime = -std::numeric_limits<scalar_t>::infinity();
-      // update acc with from each kv_split
-      for (int kv_id = 0; kv_id < num_kv_splits; ++kv_id) {
-        float* __restrict__ tv = acc + kv_id * stride_l2;
-        const float tlogic = (acc + kv_id * stride_l2)[head_size_v];
-        float m_i = std::max(tlogic, m_prime);
-        float m_delta = std::exp(m_prime - m_i);
-        float e_logic = std::exp(tlogic - m_i);
-        if (kv_id != 0) {
-          at::vec::map2<float>(
-              [m_delta, e_logic](Vec x, Vec y) {
-                return x * Vec(m_delta) + y * Vec(e_logic);
-              },
-              acc,
-              acc,
-              tv,
-              head_size_v);
-        }
-        s_prime = s_prime * m_delta + e_logic;
-        m_prime = m_i;
+  decode_attention_merge_kv_splits<scalar_t>(
+      output, attn_logits, batches * num_heads, head_size_v, num_kv_splits);
+}
+// Chooses num_kv_splits when the caller does not provide attn_logits.
+// Calls are bucketed by {floor(log2(seq_len_kv)), parallel tasks without
+// kv splitting, threads, head_size_v}; the first calls of a bucket time a few
+// candidates around the count that just fills all threads, after which the
+// fastest one is kept. IPEX_DECODE_NUM_KV_SPLITS pins the count instead.
+class KvSplitPlanner {
+ public:
+  static KvSplitPlanner& get() {
+    static KvSplitPlanner planner;
+    return planner;
+  }
+  // returns the number of kv splits to use, and the candidate slot to
+  // report the elapsed time to (-1 when the bucket is tuned)
+  int plan(int seq_len_kv, int tasks, int head_size_v, int& slot) {
+    slot = -1;
+    if (fixed_splits_ > 0) {
+      return std::min(fixed_splits_, std::max(seq_len_kv, 1));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Bucket& bucket = buckets_[key(seq_len_kv, tasks, head_size_v)];
+    if (bucket.num_candidates == 0) {
+      init_candidates(bucket, seq_len_kv, tasks);
+    }
+    if (bucket.best >= 0) {
+      return bucket.candidates[bucket.best];
+    }
+    slot = bucket.next;
+    bucket.next = (bucket.next + 1) % bucket.num_candidates;
+    return bucket.candidates[slot];
+  }
+  void record(int seq_len_kv, int tasks, int head_size_v, int slot, double t) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Bucket& bucket = buckets_[key(seq_len_kv, tasks, head_size_v)];
+    if (bucket.best >= 0) {
+      return;
+    }
+    // keep the minimum, the first run of a candidate may pay page faults
+    bucket.time[slot] = std::min(bucket.time[slot], t);
+    if (++bucket.trials < kTrials * bucket.num_candidates) {
+      return;
+    }
+    bucket.best = 0;
+    for (int i = 1; i < bucket.num_candidates; ++i) {
+      if (bucket.time[i] < bucket.time[bucket.best]) {
+        bucket.best = i;
       }
-      copy_stub<scalar_t>(
-          output + i * head_size_v, acc, 1 / s_prime, head_size_v);
     }
-  });
+  }
+
+ private:
+  static constexpr int kMaxCandidates = 4;
+  static constexpr int kTrials = 3;
+  // a split shorter than this is not worth its merge cost
+  static constexpr int kMinSplitSize = 64;
+  struct Bucket {
+    int candidates[kMaxCandidates];
+    double time[kMaxCandidates];
+    int num_candidates = 0;
+    int next = 0;
+    int trials = 0;
+    int best = -1;
+  };
+  KvSplitPlanner() {
+    const char* env = std::getenv("IPEX_DECODE_NUM_KV_SPLITS");
+    fixed_splits_ = env ? std::atoi(env) : 0;
+  }
+  static int64_t key(int seq_len_kv, int tasks, int head_size_v) {
+    int64_t log2_len = 0;
+    while ((int64_t(1) << (log2_len + 1)) <= seq_len_kv) {
+      ++log2_len;
+    }
+    int64_t threads = at::get_num_threads();
+    return (((log2_len << 16 | threads) << 20 | tasks) << 16) | head_size_v;
+  }
+  static void init_candidates(Bucket& bucket, int seq_len_kv, int tasks) {
+    const int max_splits = std::max(1, seq_len_kv / kMinSplitSize);
+    const int base = std::min(
+        std::max(div_up(at::get_num_threads(), std::max(tasks, 1)), 1),
+        max_splits);
+    for (int splits : {base, base / 2, base * 2, base * 4}) {
+      splits = std::min(std::max(splits, 1), max_splits);
+      bool seen = false;
+      for (int i = 0; i < bucket.num_candidates; ++i) {
+        seen |= bucket.candidates[i] == splits;
+      }
+      if (!seen) {
+        bucket.time[bucket.num_candidates] =
+            std::numeric_limits<double>::max();
+        bucket.candidates[bucket.num_candidates++] = splits;
+      }
+    }
+    // nothing to choose from
+    if (bucket.num_candidates == 1) {
+      bucket.best = 0;
+    }
+  }
+  int fixed_splits_;
+  std::mutex mutex_;
+  std::unordered_map<int64_t, Bucket> buckets_;
+};
+
+// Scratch for the partial results of the kv splits, kept per calling
+// thread so that decode steps do not allocate it again.
+inline float* get_attn_logits_scratch(int64_t size) {
+  static thread_local at::Tensor scratch;
+  if (!scratch.defined() || scratch.numel() < size) {
+    scratch = at::empty({size}, at::kFloat);
+  }
+  return scratch.data_ptr<float>();
 }
+
+// Runs kernel(attn_logits, num_kv_splits) with the caller provided
+// attn_logits, or with planned kv splits over the scratch when it is empty.
+template <typename Kernel>
+void run_with_kv_splits(
+    at::Tensor& attn_logits,
+    int bs,
+    int num_heads,
+    int head_size_v,
+    int seq_len_kv,
+    int tasks,
+    const Kernel& kernel) {
+  if (attn_logits.numel() > 0) {
+    CHECK_EQ(attn_logits.size(1), num_heads);
+    CHECK_EQ(attn_logits.size(-1), head_size_v + 1);
+    CHECK_EQ(attn_logits.scalar_type(), at::kFloat);
+    kernel(attn_logits.data_ptr<float>(), attn_logits.size(2));
+    return;
+  }
+  auto& planner = KvSplitPlanner::get();
+  int slot;
+  const int num_kv_splits =
+      planner.plan(seq_len_kv, tasks, head_size_v, slot);
+  float* scratch = get_attn_logits_scratch(
+      int64_t(bs) * num_heads * num_kv_splits * (head_size_v + 1));
+  if (slot < 0) {
+    kernel(scratch, num_kv_splits);
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  kernel(scratch, num_kv_splits);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  planner.record(seq_len_kv, tasks, head_size_v, slot, elapsed.count());
+}
+
+// Calls kernel(cache_t{}) with the element type of the kv cache, which is
+// either the query dtype or one of the quantized cache dtypes.
+template <typename scalar_t, typename Kernel>
+void dispatch_kv_cache_type(
+    const at::Tensor& kv_cache,
+    int head_size,
+    const Kernel& kernel) {
+  auto check_row_size = [&](auto cache_v) {
+    using cache_t = decltype(cache_v);
+    TORCH_CHECK(
+        kv_cache.size(-1) == kv_cache_row_size<cache_t>(head_size),
+        "decode_attention: unexpected last dim of kv_cache ",
+        kv_cache.size(-1),
+        " for head size ",
+        head_size,
+        " and kv_cache dtype ",
+        kv_cache.scalar_type());
+    kernel(cache_v);
+  };
+  switch (kv_cache.scalar_type()) {
+    case at::kChar:
+      check_row_size(int8_t());
+      break;
+    case at::kFloat8_e4m3fn:
+      check_row_size(at::Float8_e4m3fn());
+      break;
+    case at::kFloat8_e5m2:
+      check_row_size(at::Float8_e5m2());
+      break;
+    default:
+      TORCH_CHECK(
+          kv_cache.scalar_type() == c10::CppTypeToScalarType<scalar_t>::value,
+          "decode_attention: unsupported kv_cache dtype ",
+          kv_cache.scalar_type());
+      check_row_size(scalar_t());
+  }
+}
+
 // query: [bs*cur_len, num_heads, head_size]
 // output: [bs*cur_len, num_heads, head_size_v]
-// kv_cache: [max_positions, beam_batch, kv_num_heads, head_size]
+// kv_cache: [max_positions, beam_batch, kv_num_heads, head_size], quantized
+//   caches go through the grouped kernel, see `kKVCacheScaleBytes`
 // beam_idx: [bs, offset+1]
-// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1]
+// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1], or empty to
+//   plan num_kv_splits and use the per-thread scratch
 at::Tensor decode_attention(
     at::Tensor& query,
     at::Tensor& output,
@@ -1999,54 +2290,71 @@ at::Tensor decode_attention(
   int num_heads = query.size(-2);
   int num_heads_kv = kv_cache.size(2);
   int head_size = query.size(-1);
-  int head_size_v = attn_logits.size(-1) - 1;
-  int num_kv_splits = attn_logits.size(2);
+  int head_size_v = output.size(-1);
+  const bool quant_kv = kv_cache.scalar_type() != query.scalar_type();
   int beam_stride0 = beam_idx.stride(0);
-  CHECK_EQ(attn_logits.size(1), num_heads);
-  CHECK_EQ(attn_logits.scalar_type(), at::kFloat);
+  // parallel tasks of the kernel without kv splitting
+  const int num_groups = std::max(num_heads / num_heads_kv, 1);
+  const int tasks = bs * div_up(num_heads, std::min(16, num_groups));
   // make sure all the indices have the same data type
   const auto index_dtype = beam_idx.scalar_type();
   AT_DISPATCH_REDUCED_FLOATING_TYPES(
       query.scalar_type(), "decode_attention_kernel", [&] {
         AT_DISPATCH_INDEX_TYPES(index_dtype, "decode_attention_indices", [&] {
-          if (num_heads == num_heads_kv) {
-            // MHA
-            decode_attention_kernel_impl<scalar_t, index_t>(
-                output.data_ptr<scalar_t>(),
-                attn_logits.data_ptr<float>(),
-                query.data_ptr<scalar_t>(),
-                kv_cache.data_ptr<scalar_t>(),
-                beam_idx.data_ptr<index_t>(),
-                offset,
-                bs,
-                num_heads,
-                head_size,
-                head_size_v,
-                num_kv_splits,
-                scaling,
-                logit_cap,
-                max_total_num_tokens,
-                beam_stride0);
-          } else {
-            // GQA/MQA/MLA
-            decode_attention_grouped_kernel_impl<scalar_t, index_t>(
-                output.data_ptr<scalar_t>(),
-                attn_logits.data_ptr<float>(),
-                query.data_ptr<scalar_t>(),
-                kv_cache.data_ptr<scalar_t>(),
-                beam_idx.data_ptr<index_t>(),
-                offset,
-                bs,
-                num_heads,
-                num_heads_kv,
-                head_size,
-                head_size_v,
-                num_kv_splits,
-                scaling,
-                logit_cap,
-                max_total_num_tokens,
-                beam_stride0);
-          }
+          run_with_kv_splits(
+              attn_logits,
+              bs,
+              num_heads,
+              head_size_v,
+              offset,
+              tasks,
+              [&](float* logits, int num_kv_splits) {
+                if (num_heads == num_heads_kv && !quant_kv) {
+                  // MHA
+                  decode_attention_kernel_impl<scalar_t, index_t>(
+                      output.data_ptr<scalar_t>(),
+                      logits,
+                      query.data_ptr<scalar_t>(),
+                      kv_cache.data_ptr<scalar_t>(),
+                      beam_idx.data_ptr<index_t>(),
+                      offset,
+                      bs,
+                      num_heads,
+                      head_size,
+                      head_size_v,
+                      num_kv_splits,
+                      scaling,
+                      logit_cap,
+                      max_total_num_tokens,
+                      beam_stride0);
+                } else {
+                  // GQA/MQA/MLA
+                  dispatch_kv_cache_type<scalar_t>(
+                      kv_cache, head_size, [&](auto cache_v) {
+                        using cache_t = decltype(cache_v);
+                        decode_attention_grouped_kernel_impl<
+                            scalar_t,
+                            index_t,
+                            cache_t>(
+                            output.data_ptr<scalar_t>(),
+                            logits,
+                            query.data_ptr<scalar_t>(),
+                            kv_cache.data_ptr<cache_t>(),
+                            beam_idx.data_ptr<index_t>(),
+                            offset,
+                            bs,
+                            num_heads,
+                            num_heads_kv,
+                            head_size,
+                            head_size_v,
+                            num_kv_splits,
+                            scaling,
+                            logit_cap,
+                            max_total_num_tokens,
+                            beam_stride0);
+                      });
+                }
+              });
         });
       });
   return output;
@@ -2054,8 +2362,10 @@ at::Tensor decode_attention(
 
 // query: [bs*cur_len, num_heads, head_size]
 // output: [bs*cur_len, num_heads, head_size_v]
-// kv_cache: [max_positions, beam_batch, kv_num_heads, head_size]
-// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1]
+// kv_cache: [max_positions, beam_batch, kv_num_heads, head_size], quantized
+//   caches go through the grouped kernel, see `kKVCacheScaleBytes`
+// attn_logits: [bs, num_heads, num_kv_splits, head_size_v + 1], or empty to
+//   plan num_kv_splits and use the per-thread scratch
 at::Tensor decode_attention_opt(
     at::Tensor& query,
     at::Tensor& output,
@@ -2074,47 +2384,62 @@ at::Tensor decode_attention_opt(
   int num_heads = query.size(-2);
   int num_heads_kv = kv_cache.size(2);
   int head_size = query.size(-1);
-  int head_size_v = attn_logits.size(-1) - 1;
-  int num_kv_splits = attn_logits.size(2);
-  CHECK_EQ(attn_logits.size(1), num_heads);
-  CHECK_EQ(attn_logits.scalar_type(), at::kFloat);
-  // make sure all the indices have the same data type
+  int head_size_v = output.size(-1);
+  const bool quant_kv = kv_cache.scalar_type() != query.scalar_type();
+  // parallel tasks of the kernel without kv splitting
+  const int num_groups = std::max(num_heads / num_heads_kv, 1);
+  const int tasks = bs * div_up(num_heads, std::min(6, num_groups));
   AT_DISPATCH_REDUCED_FLOATING_TYPES(
       query.scalar_type(), "decode_attention_kernel", [&] {
-        if (num_heads == num_heads_kv) {
-          // MHA
-          decode_attention_opt_kernel_impl<scalar_t>(
-              output.data_ptr<scalar_t>(),
-              attn_logits.data_ptr<float>(),
-              query.data_ptr<scalar_t>(),
-              kv_cache.data_ptr<scalar_t>(),
-              offset,
-              bs,
-              num_heads,
-              head_size,
-              head_size_v,
-              num_kv_splits,
-              scaling,
-              logit_cap,
-              max_total_num_tokens);
-        } else {
-          // GQA/MQA/MLA
-          decode_attention_grouped_opt_kernel_impl<scalar_t>(
-              output.data_ptr<scalar_t>(),
-              attn_logits.data_ptr<float>(),
-              query.data_ptr<scalar_t>(),
-              kv_cache.data_ptr<scalar_t>(),
-              offset,
-              bs,
-              num_heads,
-              num_heads_kv,
-              head_size,
-              head_size_v,
-              num_kv_splits,
-              scaling,
-              logit_cap,
-              max_total_num_tokens);
-        }
+        run_with_kv_splits(
+            attn_logits,
+            bs,
+            num_heads,
+            head_size_v,
+            offset,
+            tasks,
+            [&](float* logits, int num_kv_splits) {
+              if (num_heads == num_heads_kv && !quant_kv) {
+                // MHA
+                decode_attention_opt_kernel_impl<scalar_t>(
+                    output.data_ptr<scalar_t>(),
+                    logits,
+                    query.data_ptr<scalar_t>(),
+                    kv_cache.data_ptr<scalar_t>(),
+                    offset,
+                    bs,
+                    num_heads,
+                    head_size,
+                    head_size_v,
+                    num_kv_splits,
+                    scaling,
+                    logit_cap,
+                    max_total_num_tokens);
+              } else {
+                // GQA/MQA/MLA
+                dispatch_kv_cache_type<scalar_t>(
+                    kv_cache, head_size, [&](auto cache_v) {
+                      using cache_t = decltype(cache_v);
+                      decode_attention_grouped_opt_kernel_impl<
+                          scalar_t,
+                          cache_t>(
+                          output.data_ptr<scalar_t>(),
+                          logits,
+                          query.data_ptr<scalar_t>(),
+                          kv_cache.data_ptr<cache_t>(),
+                          offset,
+                          bs,
+                          num_heads,
+                          num_heads_kv,
+                          head_size,
+                          head_size_v,
+                          num_kv_splits,
+                          scaling,
+                          logit_cap,
+                          max_total_num_tokens);
+                    });
+              }
+            });
       });
   return output;
 }
@@ -111,6 +111,13 @@ static inline Tensor expand_values_if_needed(const Tensor& values) {
   return values;
 }
 
+/**
+ * Sparse backward with deduplicated indices. Instead of one gradient row per
+ * occurrence, the occurrences are grouped by row (stable sort of indices),
+ * the gradient is accumulated once per unique row and a coalesced sparse COO
+ * gradient is returned, so the optimizer step and gradient allreduce only
+ * touch every row once.
+ */
 template <typename T>
 static inline Tensor embedding_bag_sparse_backward_sum_fast(
     const Tensor grad,
@@ -121,43 +128,80 @@ static inline Tensor embedding_bag_sparse_backward_sum_fast(
 
   int64_t indices_size0 = indices.size(0);
   int64_t ddim = grad.size(1);
-  Tensor index_grad = empty({indices_size0, ddim}, grad.options());
   int grad_stride0 = grad.stride(0);
+  auto weight_size = std::array<SymInt, 2>{{num_weights, ddim}};
+  auto dense_options = grad.options();
 
+  if (indices_size0 == 0) {
+    return _sparse_coo_tensor_unsafe_symint(
+        empty({1, 0}, indices.options()),
+        empty_symint({c10::SymInt(0), c10::SymInt(ddim)}, dense_options),
+        weight_size);
+  }
+
+  // bag id of every occurrence
   auto offsets_accessor = offsets.accessor<int64_t, 1>();
   auto offset_numel = offsets.numel();
-
-  T* gradout_data = index_grad.data_ptr<T>();
-  T* grad_data = grad.data_ptr<T>();
+  std::vector<int64_t> occurrence_to_bag(indices_size0);
   parallel_for(0, offset_numel, 16, [&](int64_t start, int64_t end) {
     for (auto mb = start; mb < end; mb++) {
       int64_t select_off_start = offsets_accessor[mb];
       int64_t select_off_end =
           (mb < (offset_numel - 1) ? offsets_accessor[mb + 1] : indices_size0);
-      auto grad_block = grad_data + grad_stride0 * mb;
       for (int64_t s = select_off_start; s < select_off_end; s++) {
-        move_ker((T*)(gradout_data + ddim * s), (T*)grad_block, ddim);
+        occurrence_to_bag[s] = mb;
       }
     }
   });
 
-  int64_t num_features = index_grad.size(-1);
-  auto weight_size = std::array<SymInt, 2>{{num_weights, num_features}};
-  auto dense_options = index_grad.options();
-
-  if (index_grad.numel() == 0) {
-    return _sparse_coo_tensor_unsafe_symint(
-        empty({1, 0}, indices.options()),
-        empty_symint({c10::SymInt(0), std::move(num_features)}, dense_options),
-        weight_size);
+  // group occurrences of the same row together
+  Tensor sorted_indices, sorted_order;
+  std::tie(sorted_indices, sorted_order) =
+      indices.sort(/*stable=*/true, /*dim=*/0, /*descending=*/false);
+  auto sorted_indices_data = sorted_indices.data_ptr<int64_t>();
+  auto sorted_order_data = sorted_order.data_ptr<int64_t>();
+  std::vector<int64_t> segment_start;
+  segment_start.reserve(indices_size0 + 1);
+  segment_start.push_back(0);
+  for (int64_t i = 1; i < indices_size0; i++) {
+    if (sorted_indices_data[i] != sorted_indices_data[i - 1]) {
+      segment_start.push_back(i);
+    }
   }
+  int64_t unique_indices = segment_start.size();
+  segment_start.push_back(indices_size0);
 
-  auto index = indices.reshape({1, -1});
-  auto values =
-      index_grad.reshape_symint({c10::SymInt(-1), std::move(num_features)});
+  Tensor uniq = empty({1, unique_indices}, indices.options());
+  Tensor values = empty({unique_indices, ddim}, dense_options);
+  auto uniq_data = uniq.data_ptr<int64_t>();
+  T* values_data = values.data_ptr<T>();
+  T* grad_data = grad.data_ptr<T>();
+  // every unique row is owned by one thread, no atomics needed
+  parallel_for(0, unique_indices, 16, [&](int64_t start, int64_t end) {
+    std::vector<float> temp_grad(ddim);
+    float* temp_output = temp_grad.data();
+    for (int64_t u = start; u < end; u++) {
+      int64_t seg_start = segment_start[u];
+      int64_t seg_end = segment_start[u + 1];
+      uniq_data[u] = sorted_indices_data[seg_start];
+      T* out_ptr = values_data + u * ddim;
+      if (seg_end - seg_start == 1) {
+        auto bag = occurrence_to_bag[sorted_order_data[seg_start]];
+        move_ker(out_ptr, (T*)(grad_data + grad_stride0 * bag), ddim);
+        continue;
+      }
+      zero_ker(temp_output, ddim);
+      for (int64_t j = seg_start; j < seg_end; j++) {
+        auto bag = occurrence_to_bag[sorted_order_data[j]];
+        add_ker(temp_output, (T*)(grad_data + grad_stride0 * bag), ddim);
+      }
+      move_ker(out_ptr, temp_output, ddim);
+    }
+  });
 
   return _sparse_coo_tensor_unsafe_symint(
-      index, values, weight_size, values.scalar_type());
+             uniq, values, weight_size, values.scalar_type())
+      ._coalesced_(true);
 }
 
 static inline int64_t count_and_map_uniq(
@@ -6,6 +6,7 @@
 #include <aten/MaskedMultiHeadAttention.h>
 #include <torch/all.h>
 #include <torch/csrc/autograd/function.h>
+#include <cstring>
 #include <limits>
 #include "../../utils/isa_utils.h"
 #include "vec/vec.h"
@@ -393,6 +394,21 @@ inline void reduce_head(
     qk_sum_vec = _mm512_fmadd_ps(q1_vec_fp32, k1_vec_fp32, qk_sum_vec);
   }
   attn_w_pos[0] += _mm512_reduce_add_ps(qk_sum_vec);
+#elif defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX2_VNNI)
+  auto vec_size = 16; // 128/8
+  auto qk_sum_vec = _mm256_setzero_ps();
+  for (hsi = 0; hsi <= head_size - vec_size; hsi += vec_size) {
+    auto q0_vec_fp32 = _loadu(q_ptr_start + hsi);
+    auto q1_vec_fp32 = _loadu(q_ptr_start + hsi + 8);
+    // load 16 e5m2 key from k_ptr_start and convert to 2 x 8 float32 values
+    auto k_vec_ = torch_ipex::cpu::kernel::_mm256_cvte5m2_fp16(
+        _mm_loadu_si128((__m128i*)&k_ptr_start[hsi]));
+    auto k0_vec_fp32 = _mm256_cvtph_ps(_mm256_castsi256_si128(k_vec_));
+    auto k1_vec_fp32 = _mm256_cvtph_ps(_mm256_extracti128_si256(k_vec_, 1));
+    qk_sum_vec = _mm256_fmadd_ps(q0_vec_fp32, k0_vec_fp32, qk_sum_vec);
+    qk_sum_vec = _mm256_fmadd_ps(q1_vec_fp32, k1_vec_fp32, qk_sum_vec);
+  }
+  attn_w_pos[0] += _reduce_add_ps(qk_sum_vec);
 #endif
   for (; hsi < head_size; hsi++) {
     attn_w_pos[0] += q_ptr_start[hsi] * static_cast<float>(k_ptr_start[hsi]);
@@ -772,6 +788,155 @@ inline void mul_attenion_weights_and_value_of_head(
 }
 #endif
 
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX2_VNNI)
+// 256-bit variants for AVX2 only machines, on top of the vec256 perf kernels
+template <>
+inline void reduce_head(
+    const float* q_ptr_start,
+    const float* k_ptr_start,
+    float* attn_w_pos,
+    int64_t head_size,
+    bool store_key,
+    float* k_cache_start) {
+  torch_ipex::cpu::kernel::_reduce_head(
+      q_ptr_start,
+      k_ptr_start,
+      attn_w_pos,
+      head_size,
+      store_key,
+      k_cache_start);
+}
+
+template <>
+inline void reduce_head(
+    const at::BFloat16* q_ptr_start,
+    const at::BFloat16* k_ptr_start,
+    float* attn_w_pos,
+    int64_t head_size,
+    bool store_key,
+    at::BFloat16* k_cache_start) {
+  torch_ipex::cpu::kernel::_reduce_head(
+      q_ptr_start,
+      k_ptr_start,
+      attn_w_pos,
+      head_size,
+      store_key,
+      k_cache_start);
+}
+
+template <>
+inline void reduce_head(
+    const at::Half* q_ptr_start,
+    const at::Half* k_ptr_start,
+    float* attn_w_pos,
+    int64_t head_size,
+    bool store_key,
+    at::Half* k_cache_start) {
+  torch_ipex::cpu::kernel::_reduce_head(
+      q_ptr_start,
+      k_ptr_start,
+      attn_w_pos,
+      head_size,
+      store_key,
+      k_cache_start);
+}
+
+template <>
+inline void mul_attenion_weights_and_value_of_head(
+    float& attn_w,
+    const float* v_ptr_start,
+    float* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    float* v_cache_start,
+    bool accumulate) {
+  torch_ipex::cpu::kernel::_mul_and_accumulate(
+      attn_w,
+      v_ptr_start,
+      attn_out_start,
+      head_size,
+      store_value,
+      v_cache_start,
+      accumulate);
+}
+
+template <>
+inline void mul_attenion_weights_and_value_of_head(
+    float& attn_w,
+    const at::BFloat16* v_ptr_start,
+    at::BFloat16* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    at::BFloat16* v_cache_start,
+    bool accumulate) {
+  torch_ipex::cpu::kernel::_mul_and_accumulate(
+      attn_w,
+      v_ptr_start,
+      attn_out_start,
+      head_size,
+      store_value,
+      v_cache_start,
+      accumulate);
+}
+
+template <>
+inline void mul_attenion_weights_and_value_of_head(
+    float& attn_w,
+    const at::BFloat16* v_ptr_start,
+    float* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    at::BFloat16* v_cache_start,
+    bool accumulate) {
+  torch_ipex::cpu::kernel::_mul_and_accumulate(
+      attn_w,
+      v_ptr_start,
+      attn_out_start,
+      head_size,
+      store_value,
+      v_cache_start,
+      accumulate);
+}
+
+template <>
+inline void mul_attenion_weights_and_value_of_head(
+    float& attn_w,
+    const at::Half* v_ptr_start,
+    at::Half* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    at::Half* v_cache_start,
+    bool accumulate) {
+  torch_ipex::cpu::kernel::_mul_and_accumulate(
+      attn_w,
+      v_ptr_start,
+      attn_out_start,
+      head_size,
+      store_value,
+      v_cache_start,
+      accumulate);
+}
+
+template <>
+inline void mul_attenion_weights_and_value_of_head(
+    float& attn_w,
+    const at::Half* v_ptr_start,
+    float* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    at::Half* v_cache_start,
+    bool accumulate) {
+  torch_ipex::cpu::kernel::_mul_and_accumulate(
+      attn_w,
+      v_ptr_start,
+      attn_out_start,
+      head_size,
+      store_value,
+      v_cache_start,
+      accumulate);
+}
+#endif
+
 #if defined(CPU_CAPABILITY_AVX512_FP16)
 inline void mul_attenion_weights_and_value_of_head_half(
     at::Half& attn_w,
@@ -990,6 +1155,31 @@ inline void mul_attenion_weights_and_value_of_head<
       _mm512_storeu_ps(attn_out_start + hsi + 16, attn_out1_vec_new);
     }
   }
+#elif defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX2_VNNI)
+  auto vec_size = 16; // 128/8
+  auto attn_w_vec_fp32 = _mm256_set1_ps(attn_w);
+  for (hsi = 0; hsi <= head_size - vec_size; hsi += vec_size) {
+    // load 16 e5m2 values from v_ptr_start and convert to 2 x 8 float32 values
+    auto v_vec_ = torch_ipex::cpu::kernel::_mm256_cvte5m2_fp16(
+        _mm_loadu_si128((__m128i*)&v_ptr_start[hsi]));
+    auto v0_vec_fp32 = _mm256_cvtph_ps(_mm256_castsi256_si128(v_vec_));
+    auto v1_vec_fp32 = _mm256_cvtph_ps(_mm256_extracti128_si256(v_vec_, 1));
+    if (accumulate) {
+      auto attn_out0_vec_fp32 = _mm256_loadu_ps(attn_out_start + hsi);
+      auto attn_out1_vec_fp32 = _mm256_loadu_ps(attn_out_start + hsi + 8);
+      auto attn_out0_vec_new =
+          _mm256_fmadd_ps(attn_w_vec_fp32, v0_vec_fp32, attn_out0_vec_fp32);
+      auto attn_out1_vec_new =
+          _mm256_fmadd_ps(attn_w_vec_fp32, v1_vec_fp32, attn_out1_vec_fp32);
+      _mm256_storeu_ps(attn_out_start + hsi, attn_out0_vec_new);
+      _mm256_storeu_ps(attn_out_start + hsi + 8, attn_out1_vec_new);
+    } else {
+      auto attn_out0_vec_new = _mm256_mul_ps(attn_w_vec_fp32, v0_vec_fp32);
+      auto attn_out1_vec_new = _mm256_mul_ps(attn_w_vec_fp32, v1_vec_fp32);
+      _mm256_storeu_ps(attn_out_start + hsi, attn_out0_vec_new);
+      _mm256_storeu_ps(attn_out_start + hsi + 8, attn_out1_vec_new);
+    }
+  }
 #endif
   for (; hsi < head_size; hsi++) {
     if (accumulate) {
@@ -1117,6 +1307,72 @@ inline void copy_key_value(
   }
 }
 
+template <typename CT>
+inline CT quantize_kv_value(float x) {
+  if constexpr (std::is_same_v<CT, int8_t>) {
+    x = std::min(std::max(x, -127.f), 127.f);
+    return static_cast<int8_t>(std::nearbyint(x));
+  } else {
+    return static_cast<CT>(x);
+  }
+}
+
+// Writes kv and k_pe of the new tokens into a latent cache quantized to CT
+// (int8 or fp8-e4m3fn). Each row gets one scale, from the absmax of its
+// values, stored behind it (see `kKVCacheScaleBytes`).
+template <typename T, typename CT>
+inline void quantize_key_value(
+    at::Tensor& kv_cache,
+    const at::Tensor& kv,
+    const at::Tensor& k_pe,
+    int beam_batch,
+    long offset) {
+  RECORD_FUNCTION("ipex::quantize_key_value", c10::ArrayRef<c10::IValue>({}));
+  constexpr float qmax = std::is_same_v<CT, int8_t> ? 127.f : 448.f;
+  auto bs = kv.size(0);
+  auto seq_len = kv.size(1);
+  auto kv_head_size = kv.size(-1);
+  auto k_pe_head_size = k_pe.size(-1);
+  auto k_pe_stride_b = k_pe.stride(0);
+  auto k_pe_stride_s = k_pe.stride(1);
+  auto head_size = kv_head_size + k_pe_head_size;
+  auto row_size = kv_cache.size(-1);
+  auto kv_cache_ptr = kv_cache.data_ptr<CT>();
+  auto kv_ptr = kv.data_ptr<T>();
+  auto k_pe_ptr = k_pe.data_ptr<T>();
+  auto token_stride = beam_batch * row_size;
+  auto beam_size = beam_batch / bs;
+#pragma omp parallel for collapse(2)
+  for (auto si = 0; si < seq_len; si++) {
+    for (auto bi = 0; bi < bs; bi++) {
+      auto cache_stride = offset == 0
+          ? si * token_stride + bi * beam_size * row_size
+          : (si + offset) * token_stride + bi * row_size;
+      auto kv_start = kv_ptr + (bi * seq_len + si) * kv_head_size;
+      auto k_pe_start = k_pe_ptr + bi * k_pe_stride_b + si * k_pe_stride_s;
+      float amax = 0.f;
+      for (auto d = 0; d < kv_head_size; d++) {
+        amax = std::max(amax, std::abs(static_cast<float>(kv_start[d])));
+      }
+      for (auto d = 0; d < k_pe_head_size; d++) {
+        amax = std::max(amax, std::abs(static_cast<float>(k_pe_start[d])));
+      }
+      float scale = amax > 0.f ? amax / qmax : 1.f;
+      float rscale = 1.f / scale;
+      auto cache_start = kv_cache_ptr + cache_stride;
+      for (auto d = 0; d < kv_head_size; d++) {
+        cache_start[d] =
+            quantize_kv_value<CT>(static_cast<float>(kv_start[d]) * rscale);
+      }
+      for (auto d = 0; d < k_pe_head_size; d++) {
+        cache_start[kv_head_size + d] =
+            quantize_kv_value<CT>(static_cast<float>(k_pe_start[d]) * rscale);
+      }
+      std::memcpy(cache_start + head_size, &scale, sizeof(float));
+    }
+  }
+}
+
 /*
  *The scale-dot product for indirect access kv chache and fuse
  *matmul+div+add+softmax to improve data reuse
@@ -2271,6 +2527,311 @@ scale_dot_product_for_indirect_access_kv_cache_half(
 }
 #endif
 
+// Longest window of query tokens (e.g. the draft tokens verified by
+// speculative decoding) attended in one pass over the indirect access kv
+// cache. Longer windows are decoded token by token.
+constexpr int64_t kMaxMultiQueryLen = 16;
+
+/*
+ *The scale-dot product for a short window of query tokens appended to the
+ *indirect access kv cache, e.g. the draft tokens verified by speculative
+ *decoding. Every key/value row of the cache is loaded once for all the query
+ *tokens of the window and the i-th query token only attends to the past
+ *tokens and to the first i + 1 tokens of the window.
+ *@param  query Query embeeding with the of [beam_size*batch, cur_len, head_num,
+ *head_size]
+ *@param  key Key embeeding with the of [beam_size*batch, cur_len, kv_head_num,
+ *head_size]
+ *@param  value Key embeeding with the of [beam_size*batch, cur_len,
+ *kv_head_num, head_size]
+ *@param  key_cache Cache past key embeeding with the of [max_len,
+ *beam_size*batch, kv_head_num, head_size]
+ *@param  value_chache Cache past value embeeding with the of [max_len,
+ *beam_size*batch, kv_head_num, head_size]
+ *@param  beam_idx Beam info for every token [max_len, beam_size*batch]
+ *@param  offset  The length of decoded(past) token.
+ *@param  scale_factor the sqrt(head_dim).
+ *@param  attention_mask Which is combined mask for padding mask and casual
+ *mask.
+ *@return attn_outs, None, key_cache, value_cache, beam_idx
+ */
+template <typename QT, typename VT, typename KCT, typename VCT>
+std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
+multi_query_scale_dot_product_for_indirect_access_kv_cache(
+    at::Tensor query,
+    at::Tensor key,
+    at::Tensor value,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& beam_idx,
+    const int64_t offset,
+    const double scale_factor,
+    at::Tensor& attention_mask) {
+  RECORD_FUNCTION(
+      "ipex::multi_query_scale_dot_product_for_indirect_access_kv_cache",
+      c10::ArrayRef<c10::IValue>({}));
+  int beam_batch = beam_idx.size(1);
+  auto bs = query.size(0);
+  auto cur_len = query.size(1);
+  auto head_num = query.size(2);
+  auto head_size = query.size(3);
+  auto kv_head = key.size(2);
+  auto group_size = head_num / kv_head;
+  auto seq_len = offset + cur_len;
+  auto b_ptr = beam_idx.data_ptr<long>();
+  auto max_cache_size = beam_idx.size(0);
+  auto prompt_len = b_ptr[(max_cache_size - 2) * beam_batch];
+  auto prompt_bs = b_ptr[(max_cache_size - 1) * beam_batch];
+  auto beam_size = 1;
+  if (prompt_bs != 0) {
+    beam_size = beam_batch / prompt_bs;
+  }
+  // the beam of the cache row holding every past token, resolved once for
+  // all the query tokens of the window
+  std::vector<long> past_beam(bs * offset);
+  for (auto bi = 0; bi < bs; bi++) {
+    auto past_beam_start = past_beam.data() + bi * offset;
+    std::fill(
+        past_beam_start,
+        past_beam_start + offset,
+        bi / beam_size * beam_size);
+    if (beam_size > 1 && offset > prompt_len) {
+      past_beam_start[offset - 1] = b_ptr[(offset - 1) * beam_batch + bi];
+      for (auto ti = offset - 2; ti >= prompt_len; ti--) {
+        past_beam_start[ti] = b_ptr[ti * beam_batch + past_beam_start[ti + 1]];
+      }
+    }
+  }
+  query = query.contiguous();
+  key = key.contiguous();
+  value = value.contiguous();
+  auto q_ptr = query.data_ptr<QT>();
+  auto k_ptr = key.data_ptr<QT>();
+  auto v_ptr = value.data_ptr<VT>();
+  auto k_cache_ptr = key_cache.data_ptr<KCT>();
+  auto v_cache_ptr = value_cache.data_ptr<VCT>();
+  auto mask_ptr = attention_mask.data_ptr<QT>();
+  auto mask_head_num = attention_mask.size(1);
+  auto mask_dim2 = attention_mask.size(2);
+  auto mask_bs_stride = mask_head_num * mask_dim2 * seq_len;
+
+  auto qStrideB = query.stride(0);
+  auto qStrideS = query.stride(1);
+  auto qStrideH = query.stride(2);
+  auto kStrideB = key.stride(0);
+  auto kStrideS = key.stride(1);
+  auto vStrideB = value.stride(0);
+  auto vStrideS = value.stride(1);
+  auto kcStrideS = key_cache.stride(0);
+  auto kcStrideB = key_cache.stride(1);
+  auto kcStrideH = key_cache.stride(2);
+  auto vcStrideS = value_cache.stride(0);
+  auto vcStrideB = value_cache.stride(1);
+  auto vcStrideH = value_cache.stride(2);
+
+  // only split the sequence when batch x kv heads can not feed all threads
+  auto thread_numbers = omp_get_max_threads();
+  auto min_kv_split_size = 64L;
+  auto kv_split = std::min(
+      (thread_numbers + bs * kv_head - 1) / (bs * kv_head),
+      (seq_len + min_kv_split_size - 1) / min_kv_split_size);
+  kv_split = std::max(kv_split, 1L);
+  auto kv_split_size = (seq_len + kv_split - 1) / kv_split;
+  kv_split = (seq_len + kv_split_size - 1) / kv_split_size;
+
+  {
+    RECORD_FUNCTION(
+        "ipex::mq_iakv_sdp::copy_key_value", c10::ArrayRef<c10::IValue>({}));
+    // the window of the current beam goes to its own beam of the cache
+#pragma omp parallel for collapse(2)
+    for (auto bi = 0; bi < bs; bi++) {
+      for (auto qi = 0; qi < cur_len; qi++) {
+        move_and_convert(
+            k_ptr + bi * kStrideB + qi * kStrideS,
+            k_cache_ptr + (offset + qi) * kcStrideS + bi * kcStrideB,
+            kv_head * head_size);
+        move_and_convert(
+            v_ptr + bi * vStrideB + qi * vStrideS,
+            v_cache_ptr + (offset + qi) * vcStrideS + bi * vcStrideB,
+            kv_head * head_size);
+      }
+    }
+  }
+  auto attn_weights = at::empty({bs, head_num, cur_len, seq_len}, at::kFloat);
+  auto attn_w_ptr = attn_weights.data_ptr<float>();
+  auto attn_w_strideH = attn_weights.stride(1);
+  {
+    RECORD_FUNCTION(
+        "ipex::mq_iakv_sdp::matmul(query, key)",
+        c10::ArrayRef<c10::IValue>({}));
+#pragma omp parallel for collapse(3)
+    for (auto split_id = 0; split_id < kv_split; split_id++) {
+      for (auto bi = 0; bi < bs; bi++) {
+        for (auto kv_hi = 0; kv_hi < kv_head; kv_hi++) {
+          auto k_start = split_id * kv_split_size;
+          auto k_end = std::min(k_start + kv_split_size, seq_len);
+          auto hi = kv_hi * group_size;
+          for (auto ti = k_start; ti < k_end; ti++) {
+            auto beam = ti < offset ? past_beam[bi * offset + ti] : bi;
+            auto kc_head_start = k_cache_ptr + ti * kcStrideS +
+                beam * kcStrideB + kv_hi * kcStrideH;
+            // key ti is seen by the query tokens from ti - offset on
+            for (auto qi = std::max(ti - offset, 0L); qi < cur_len; qi++) {
+              auto q_ptr_start =
+                  q_ptr + bi * qStrideB + qi * qStrideS + hi * qStrideH;
+              auto attn_w_pos = attn_w_ptr +
+                  (bi * head_num + hi) * attn_w_strideH + qi * seq_len + ti;
+              reduce_head<QT, KCT, KCT>(
+                  q_ptr_start,
+                  group_size,
+                  kc_head_start,
+                  attn_w_pos,
+                  attn_w_strideH,
+                  head_size,
+                  false,
+                  nullptr);
+            }
+          }
+        }
+      }
+    }
+  }
+  {
+    RECORD_FUNCTION(
+        "ipex::mq_iakv_sdp::div_add_softmax", c10::ArrayRef<c10::IValue>({}));
+#pragma omp parallel for collapse(3)
+    for (auto bi = 0; bi < bs; bi++) {
+      for (auto hi = 0; hi < head_num; hi++) {
+        for (auto qi = 0; qi < cur_len; qi++) {
+          // causal inside the window
+          auto len = offset + qi + 1;
+          auto attn_w_query_start =
+              attn_w_ptr + (bi * head_num + hi) * attn_w_strideH + qi * seq_len;
+          auto mask_ptr_start = mask_ptr + bi * mask_bs_stride +
+              (hi % mask_head_num) * mask_dim2 * seq_len +
+              (qi % mask_dim2) * seq_len;
+          auto max_val = -100000.0f;
+#if defined(CPU_CAPABILITY_AVX512)
+          torch_ipex::cpu::kernel::
+              _dil_div_add_reduce_max_fusion_kernel<float, QT>(
+                  attn_w_query_start,
+                  mask_ptr_start,
+                  scale_factor,
+                  len,
+                  attn_w_query_start,
+                  max_val);
+          torch_ipex::cpu::kernel::_dil_exp_reduce_sum_fusion_kernel(
+              attn_w_query_start, len, attn_w_query_start, max_val);
+          torch_ipex::cpu::kernel::_dil_normalization_kernel<float>(
+              attn_w_query_start, max_val, len, attn_w_query_start);
+#else
+          for (auto si = 0; si < len; si++) {
+            attn_w_query_start[si] =
+                attn_w_query_start[si] / scale_factor + mask_ptr_start[si];
+            if (attn_w_query_start[si] > max_val) {
+              max_val = attn_w_query_start[si];
+            }
+          }
+          float sum = 0.0f;
+          for (auto si = 0; si < len; si++) {
+            attn_w_query_start[si] = exp(attn_w_query_start[si] - max_val);
+            sum += attn_w_query_start[si];
+          }
+          for (auto si = 0; si < len; si++) {
+            attn_w_query_start[si] = attn_w_query_start[si] / sum;
+          }
+#endif
+        }
+      }
+    }
+  }
+  auto private_attn_outs =
+      at::empty({kv_split, bs, cur_len, head_num, head_size}, at::kFloat);
+  auto private_attn_out_flag =
+      at::zeros({kv_split, bs, cur_len, head_num}, at::kByte);
+  auto private_attn_out_ptr = private_attn_outs.data_ptr<float>();
+  auto flag_ptr = private_attn_out_flag.data_ptr<uint8_t>();
+  auto attn_outs_stride_privT = private_attn_outs.stride(0);
+  auto attn_outs_stride_privB = private_attn_outs.stride(1);
+  auto attn_outs_stride_privS = private_attn_outs.stride(2);
+  auto attn_outs_stride_privH = private_attn_outs.stride(3);
+  {
+    RECORD_FUNCTION(
+        "ipex::mq_iakv_sdp::matmul(attn_w, value)",
+        c10::ArrayRef<c10::IValue>({}));
+#pragma omp parallel for collapse(3)
+    for (auto split_id = 0; split_id < kv_split; split_id++) {
+      for (auto bi = 0; bi < bs; bi++) {
+        for (auto kv_hi = 0; kv_hi < kv_head; kv_hi++) {
+          auto v_start = split_id * kv_split_size;
+          auto v_end = std::min(v_start + kv_split_size, seq_len);
+          auto hi = kv_hi * group_size;
+          for (auto vi = v_start; vi < v_end; vi++) {
+            auto beam = vi < offset ? past_beam[bi * offset + vi] : bi;
+            auto v_cache_head_start = v_cache_ptr + vi * vcStrideS +
+                beam * vcStrideB + kv_hi * vcStrideH;
+            for (auto qi = std::max(vi - offset, 0L); qi < cur_len; qi++) {
+              auto attn_w_query_start = attn_w_ptr +
+                  (bi * head_num + hi) * attn_w_strideH + qi * seq_len + vi;
+              auto priv_offset = split_id * attn_outs_stride_privT +
+                  bi * attn_outs_stride_privB + qi * attn_outs_stride_privS +
+                  hi * attn_outs_stride_privH;
+              mul_attenion_weights_and_value_of_head<VCT, float, VCT>(
+                  attn_w_query_start,
+                  attn_w_strideH,
+                  v_cache_head_start,
+                  private_attn_out_ptr + priv_offset,
+                  head_size,
+                  group_size,
+                  head_size,
+                  false,
+                  nullptr,
+                  flag_ptr + priv_offset / head_size);
+            }
+          }
+        }
+      }
+    }
+  }
+  auto attn_outs =
+      at::empty({bs, head_num, cur_len, head_size}, value.options());
+  auto attn_out_ptr = attn_outs.data_ptr<VT>();
+  {
+    RECORD_FUNCTION(
+        "ipex::mq_iakv_sdp::reduction_private_result",
+        c10::ArrayRef<c10::IValue>({}));
+#pragma omp parallel for collapse(3)
+    for (auto bi = 0; bi < bs; bi++) {
+      for (auto hi = 0; hi < head_num; hi++) {
+        for (auto qi = 0; qi < cur_len; qi++) {
+          auto priv_offset = bi * attn_outs_stride_privB +
+              qi * attn_outs_stride_privS + hi * attn_outs_stride_privH;
+          auto split0_head_start = private_attn_out_ptr + priv_offset;
+          if (flag_ptr[priv_offset / head_size] == 0) {
+            torch_ipex::cpu::kernel::zero_ker(split0_head_start, head_size);
+          }
+          for (auto split_id = 1; split_id < kv_split; split_id++) {
+            auto split_offset = split_id * attn_outs_stride_privT + priv_offset;
+            if (flag_ptr[split_offset / head_size] == 0) {
+              continue;
+            }
+            torch_ipex::cpu::kernel::add_ker<float, float>(
+                split0_head_start,
+                private_attn_out_ptr + split_offset,
+                head_size);
+          }
+          auto attn_outs_start = attn_out_ptr +
+              (bi * head_num + hi) * cur_len * head_size + qi * head_size;
+          torch_ipex::cpu::kernel::move_ker<VT, float>(
+              attn_outs_start, split0_head_start, head_size);
+        }
+      }
+    }
+  }
+  return std::make_tuple(
+      attn_outs, at::Tensor(), key_cache, value_cache, beam_idx);
+}
+
 std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
 zero_copy_kv_cache_masked_multihead_self_attention_kernel_impl(
     at::Tensor query,
@@ -2429,6 +2990,151 @@ zero_copy_kv_cache_masked_multihead_self_attention_kernel_impl(
       attention_mask);
 }
 
+std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
+zero_copy_kv_cache_multi_query_mha(
+    at::Tensor query,
+    at::Tensor key,
+    at::Tensor value,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& beam_idx,
+    const int64_t offset,
+    const double scale_attn,
+    at::Tensor& attention_mask) {
+  assert(
+      key.scalar_type() == at::kBFloat16 || key.scalar_type() == at::kFloat ||
+      key.scalar_type() == at::kHalf);
+  if (key_cache.scalar_type() == at::ScalarType::Float8_e5m2 &&
+      query.scalar_type() == at::kBFloat16 &&
+      value.scalar_type() == at::kBFloat16) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        at::BFloat16,
+        at::BFloat16,
+        at::Float8_e5m2,
+        at::Float8_e5m2>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  } else if (
+      query.scalar_type() == at::kFloat && value.scalar_type() == at::kFloat) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        float,
+        float,
+        float,
+        float>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  } else if (
+      query.scalar_type() == at::kFloat &&
+      value.scalar_type() == at::kBFloat16) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        float,
+        at::BFloat16,
+        float,
+        at::BFloat16>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  } else if (
+      key.scalar_type() == at::kBFloat16 && value.scalar_type() == at::kFloat) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        at::BFloat16,
+        float,
+        at::BFloat16,
+        float>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  } else if (
+      query.scalar_type() == at::kHalf && value.scalar_type() == at::kHalf) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        at::Half,
+        at::Half,
+        at::Half,
+        at::Half>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  } else if (
+      query.scalar_type() == at::kFloat && value.scalar_type() == at::kHalf) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        float,
+        at::Half,
+        float,
+        at::Half>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  } else if (
+      query.scalar_type() == at::kHalf && value.scalar_type() == at::kFloat) {
+    return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+        at::Half,
+        float,
+        at::Half,
+        float>(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        beam_idx,
+        offset,
+        scale_attn,
+        attention_mask);
+  }
+  return multi_query_scale_dot_product_for_indirect_access_kv_cache<
+      at::BFloat16,
+      at::BFloat16,
+      at::BFloat16,
+      at::BFloat16>(
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      beam_idx,
+      offset,
+      scale_attn,
+      attention_mask);
+}
+
 std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
 first_token_masked_mha(
     at::Tensor query,
@@ -2726,6 +3432,19 @@ masked_multihead_self_attention_kernel_impl(
           offset,
           scale_attn,
           attention_mask_v);
+    // the multi-query kernel indexes the cache rows of earlier steps, a
+    // negative offset keeps the per-token path
+    if (offset > 0 && cur_len <= kMaxMultiQueryLen)
+      return zero_copy_kv_cache_multi_query_mha(
+          query,
+          key,
+          value,
+          key_cache,
+          value_cache,
+          beam_idx,
+          offset,
+          scale_attn,
+          attention_mask_v);
     // just a  funcationality path,need to optimize
     auto tokens_outs = std::vector<at::Tensor>(cur_len);
     for (auto i = 0; i < cur_len; i++) {
@@ -2908,6 +3627,12 @@ deepseekv2_mla_kernel_impl(
   }
   auto attention_mask_v = attn_mask.value().contiguous();
   attention_mask_v = attention_mask_v.to(query.dtype());
+  // int8 / fp8-e4m3fn latent cache with per-token scales
+  const bool quant_cache = kv_cache.scalar_type() == at::kChar ||
+      kv_cache.scalar_type() == at::kFloat8_e4m3fn;
+  TORCH_CHECK(
+      !quant_cache || kv_head_num == 1,
+      "quantized kv_cache of ipex::deepseekv2_mla_kernel_impl expects a single kv head");
   if (offset == 0) {
     max_positions =
         max_positions > cur_len ? max_positions : max_positions + cur_len;
@@ -2915,6 +3640,13 @@ deepseekv2_mla_kernel_impl(
       kv_cache = at::empty(
           {max_positions, beam_batch, kv_head_num, kv_head_size},
           kv.options().dtype(at::kFloat8_e5m2));
+    } else if (quant_cache) {
+      kv_cache = at::empty(
+          {max_positions,
+           beam_batch,
+           kv_head_num,
+           kv_head_size + kKVCacheScaleBytes},
+          kv.options().dtype(kv_cache.scalar_type()));
     } else {
       kv_cache = at::empty(
           {max_positions, beam_batch, kv_head_num, kv_head_size}, kv.options());
@@ -2939,7 +3671,7 @@ deepseekv2_mla_kernel_impl(
   } else if (offset > 0 && offset + cur_len > cache_size) {
     auto new_cache_size = cache_size * 2;
     auto new_kv_cache = at::empty(
-        {new_cache_size, beam_batch, kv_head_num, kv_head_size},
+        {new_cache_size, beam_batch, kv_head_num, kv_cache.size(-1)},
         kv_cache.options());
     auto new_beam_idx =
         at::zeros({new_cache_size + 2, beam_batch}, beam_idx.options());
@@ -2959,7 +3691,19 @@ deepseekv2_mla_kernel_impl(
     beam_idx = new_beam_idx;
   }
 
-  if (kv_cache.scalar_type() == at::ScalarType::Float8_e5m2 &&
+  if (quant_cache) {
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kBFloat16, at::kHalf, kv.scalar_type(), "quantize_key_value", [&] {
+          if (kv_cache.scalar_type() == at::kChar) {
+            quantize_key_value<scalar_t, int8_t>(
+                kv_cache, kv, k_pe, beam_batch, offset);
+          } else {
+            quantize_key_value<scalar_t, at::Float8_e4m3fn>(
+                kv_cache, kv, k_pe, beam_batch, offset);
+          }
+        });
+  } else if (
+      kv_cache.scalar_type() == at::ScalarType::Float8_e5m2 &&
       kv.scalar_type() == at::ScalarType::BFloat16) {
     copy_key_value<at::BFloat16, at::Float8_e5m2>(
         kv_cache, kv, k_pe, beam_batch, offset);
@@ -3024,11 +3768,10 @@ deepseekv2_mla_kernel_impl(
   }
 
   at::Tensor attn_output;
-  auto num_kv_splits = 8;
   auto attn_outs =
       at::empty({kv_bs * cur_len, q_head_num, kv.size(-1)}, q.options());
-  auto attn_weights =
-      at::empty({kv_bs, q_head_num, num_kv_splits, kv.size(-1) + 1});
+  // empty, the kernel plans num_kv_splits and keeps its own scratch
+  auto attn_weights = at::empty({0}, at::kFloat);
 
   auto b_ptr = beam_idx.data_ptr<long>();
   auto max_cache_size = beam_idx.size(0);
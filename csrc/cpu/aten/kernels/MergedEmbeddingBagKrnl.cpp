@@ -4,6 +4,7 @@
 #include <ATen/cpu/vec/vec.h>
 #include <aten/MergedEmbCat.h>
 #include <aten/MergedEmbeddingBag.h>
+#include <aten/utils/mkl_gemm.h>
 #include <torch/all.h>
 #include "autocast/autocast_mode.h"
 #include "vec/merged_emb_utils.hpp"
@@ -490,6 +491,216 @@ Tensor merged_embedding_cat_fw_impl(
   return output;
 }
 
+template <typename data_t, typename index_t>
+void merged_embeddingbag_cat_interaction_linear(
+    data_t* o_ptr,
+    data_t** w_ptr,
+    index_t** indices_ptr,
+    index_t** offsets_ptr,
+    data_t* d_ptr,
+    const data_t* mlp_w_ptr,
+    const data_t* mlp_b_ptr,
+    int64_t num_batch,
+    int64_t num_emb,
+    int64_t emb_dim,
+    int64_t out_dim,
+    bool fuse_relu,
+    std::vector<int64_t> last_offsets) {
+  using acc_t = at::opmath_type<data_t>;
+  using Vec = at::vec::Vectorized<acc_t>;
+  const int64_t num_feature = num_emb + 1;
+  const int64_t interact_dim = num_feature * (num_feature - 1) / 2;
+  const int64_t act_dim = emb_dim + interact_dim;
+  // small batches are the latency critical case, shrink the batch block so
+  // that every thread still gets a block to work on
+  constexpr int64_t max_b_block = 32;
+  const int64_t num_threads = at::get_num_threads();
+  const int64_t b_block = std::max<int64_t>(
+      1, std::min(max_b_block, (num_batch - 1) / num_threads + 1));
+  const int64_t n_b_blocks = (num_batch - 1) / b_block + 1;
+  at::parallel_for(0, n_b_blocks, 1, [&](int64_t begin, int64_t end) {
+    // per-thread buffers, all of them stay in L1/L2:
+    //   cat_buf: [b_block, num_feature, emb_dim] looked-up rows (dense first)
+    //   act_buf: [b_block, act_dim] dense + flat triangle, i.e. the GEMM A
+    //   acc_buf: [b_block, out_dim] GEMM accumulation
+    std::vector<data_t> cat_buf(b_block * num_feature * emb_dim);
+    std::vector<data_t> act_buf(b_block * act_dim);
+    std::vector<acc_t> acc_buf(b_block * out_dim);
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t bs_begin = b * b_block;
+      const int64_t bs_end = std::min(num_batch, (b + 1) * b_block);
+      const int64_t bs = bs_end - bs_begin;
+      // (1) embedding lookup into the per-thread cat buffer
+      copy_dense(
+          bs_begin,
+          bs_end,
+          num_emb,
+          emb_dim,
+          &d_ptr[bs_begin * emb_dim],
+          cat_buf.data());
+      for (int64_t m = 0; m < num_emb; ++m) {
+        // avoid offsets not include last batch
+        const index_t last_offset = bs_end == num_batch ? last_offsets[m] : -1;
+        embeddingbag_kern(
+            bs_begin,
+            bs_end,
+            num_emb,
+            emb_dim,
+            last_offset,
+            indices_ptr[m],
+            offsets_ptr[m],
+            w_ptr[m],
+            &cat_buf[(m + 1) * emb_dim],
+            /*result_stride=*/num_feature * emb_dim,
+            SUM);
+      }
+      // (2) dot interaction, written as flat triangle right behind the dense
+      // feature, same layout as interaction_forward
+      for (int64_t i = 0; i < bs; ++i) {
+        const data_t* feat = &cat_buf[i * num_feature * emb_dim];
+        data_t* act = &act_buf[i * act_dim];
+        std::memcpy(act, feat, emb_dim * sizeof(data_t));
+        data_t* flat = act + emb_dim;
+        int64_t offset = 0;
+        for (int64_t f1 = 1; f1 < num_feature; ++f1) {
+          const data_t* v1 = feat + f1 * emb_dim;
+          for (int64_t f2 = 0; f2 < f1; ++f2) {
+            acc_t dot = at::vec::map2_reduce_all<data_t>(
+                [](Vec x, Vec y) { return x * y; },
+                [](Vec x, Vec y) { return x + y; },
+                v1,
+                feat + f2 * emb_dim,
+                emb_dim);
+            flat[offset++] = static_cast<data_t>(dot);
+          }
+        }
+      }
+      // (3) first top MLP layer on the block: act [bs, K] x mlp_w^T [K, N]
+      _mkl_gemm(
+          CblasRowMajor,
+          CblasNoTrans,
+          CblasTrans,
+          bs,
+          out_dim,
+          act_dim,
+          acc_t(1),
+          act_buf.data(),
+          act_dim,
+          mlp_w_ptr,
+          act_dim,
+          acc_t(0),
+          acc_buf.data(),
+          out_dim);
+      // (4) epilogue: bias + optional relu, only the MLP output reaches DRAM
+      for (int64_t i = 0; i < bs; ++i) {
+        const acc_t* acc = &acc_buf[i * out_dim];
+        data_t* out = &o_ptr[(bs_begin + i) * out_dim];
+        for (int64_t n = 0; n < out_dim; ++n) {
+          acc_t v = acc[n];
+          if (mlp_b_ptr != nullptr) {
+            v += static_cast<acc_t>(mlp_b_ptr[n]);
+          }
+          if (fuse_relu && v < acc_t(0)) {
+            v = acc_t(0);
+          }
+          out[n] = static_cast<data_t>(v);
+        }
+      }
+    }
+  });
+}
+
+Tensor merged_embedding_cat_interaction_linear_fw_impl(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense,
+    const Tensor& mlp_weight,
+    const c10::optional<Tensor>& mlp_bias,
+    bool fuse_relu) {
+  RECORD_FUNCTION(__FUNCTION__, c10::ArrayRef<c10::IValue>({}));
+  int64_t batch_size = dense.size(0);
+  int64_t emb_dim = dense.size(1);
+  int64_t num_emb = weights.size();
+  int64_t num_feature = num_emb + 1;
+  int64_t act_dim = emb_dim + num_feature * (num_feature - 1) / 2;
+
+  TORCH_CHECK(num_emb > 0);
+  TORCH_CHECK(num_emb == indices.size() && num_emb == offsets.size());
+  TORCH_CHECK(dense.dim() == 2 && dense.is_contiguous());
+  TORCH_CHECK(
+      mlp_weight.dim() == 2 && mlp_weight.size(1) == act_dim,
+      "merged_embeddingbag_cat_interaction_linear: expect mlp_weight with ",
+      act_dim,
+      " input features, but got ",
+      mlp_weight.sizes());
+  auto data_type = dense.scalar_type();
+  TORCH_CHECK(
+      data_type == at::kFloat || data_type == at::kBFloat16 ||
+          data_type == at::kHalf,
+      "merged_embeddingbag_cat_interaction_linear: only support float, ",
+      "bfloat16 and half");
+  auto mlp_w = mlp_weight.to(data_type).contiguous();
+  Tensor mlp_b;
+  if (mlp_bias.has_value() && mlp_bias.value().defined()) {
+    mlp_b = mlp_bias.value().to(data_type).contiguous();
+    TORCH_CHECK(mlp_b.numel() == mlp_w.size(0));
+  }
+  int64_t out_dim = mlp_w.size(0);
+
+  auto index_type = indices[0].scalar_type();
+  std::vector<int64_t> last_offsets(num_emb, -1);
+  for (int i = 0; i < num_emb; i++) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        indices[i].is_contiguous() && indices[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        offsets[i].is_contiguous() && offsets[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        weights[i].is_contiguous() && weights[i].scalar_type() == data_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        weights[i].dim() == 2 && weights[i].size(1) == emb_dim);
+    // handle last offsets
+    last_offsets[i] = indices[i].numel();
+  }
+
+  Tensor output = at::empty({batch_size, out_dim}, dense.options());
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kBFloat16,
+      at::kHalf,
+      data_type,
+      "merged_embeddingbag_cat_interaction_linear",
+      [&] {
+        AT_DISPATCH_INDEX_TYPES(
+            index_type, "merged_embeddingbag_cat_interaction_linear", [&] {
+              scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+              scalar_t* weights_ptr[num_emb];
+              index_t* indices_ptr[num_emb];
+              index_t* offsets_ptr[num_emb];
+              for (int i = 0; i < num_emb; i++) {
+                weights_ptr[i] = weights[i].data_ptr<scalar_t>();
+                indices_ptr[i] = indices[i].data_ptr<index_t>();
+                offsets_ptr[i] = offsets[i].data_ptr<index_t>();
+              }
+              merged_embeddingbag_cat_interaction_linear<scalar_t, index_t>(
+                  output.data_ptr<scalar_t>(),
+                  weights_ptr,
+                  indices_ptr,
+                  offsets_ptr,
+                  dense_ptr,
+                  mlp_w.data_ptr<scalar_t>(),
+                  mlp_b.defined() ? mlp_b.data_ptr<scalar_t>() : nullptr,
+                  batch_size,
+                  num_emb,
+                  emb_dim,
+                  out_dim,
+                  fuse_relu,
+                  last_offsets);
+            });
+      });
+  return output;
+}
+
 template <typename data_t, typename index_t>
 void merged_embeddingbag(
     data_t** o_ptr,
@@ -829,6 +1040,8 @@ void mergedemb_distribute_forward_merge(
     const int64_t world_size,
     const int64_t num_emb,
     const int64_t emb_dim,
+    const int64_t total_emb,
+    const int64_t table_begin,
     index_t** idx_ptr,
     data_t** val_ptr,
     int64_t** ofs_ptr,
@@ -851,7 +1064,11 @@ void mergedemb_distribute_forward_merge(
     }
     auto emb_cache = cache.cache();
     for (auto& [key, value] : emb_cache) {
-      data_t* dest = &res_ptr[key * emb_dim]; // EMBRES
+      // key is (local batch id * num_emb + table id) inside current table
+      // group, map it to the row in output with all tables
+      const int64_t row =
+          (key / num_emb) * total_emb + table_begin + key % num_emb;
+      data_t* dest = &res_ptr[row * emb_dim]; // EMBRES
       move_ker<data_t, acc_t>(dest, value, emb_dim);
     }
   }
@@ -862,10 +1079,21 @@ void mergedemb_distribute_forward_merge_kernel_impl(
     const TensorList& idx,
     const TensorList& val,
     const TensorList& ofs,
-    const int64_t num_emb) {
+    const int64_t num_emb,
+    const int64_t table_begin) {
   RECORD_FUNCTION(__FUNCTION__, c10::ArrayRef<c10::IValue>({}));
   int64_t world_size = idx.size();
+  int64_t total_emb = output.size(1);
   int64_t emb_dim = output.size(2);
+  TORCH_CHECK(
+      table_begin >= 0 && table_begin + num_emb <= total_emb,
+      "mergedemb_distribute_forward_merge: tables [",
+      table_begin,
+      ", ",
+      table_begin + num_emb,
+      ") out of range of output with ",
+      total_emb,
+      " tables");
   AT_DISPATCH_FLOATING_TYPES_AND2(
       at::kBFloat16,
       at::kHalf,
@@ -889,6 +1117,8 @@ void mergedemb_distribute_forward_merge_kernel_impl(
                   world_size,
                   num_emb,
                   emb_dim,
+                  total_emb,
+                  table_begin,
                   idx_ptr,
                   val_ptr,
                   ofs_ptr,
@@ -907,6 +1137,9 @@ IPEX_REGISTER_DISPATCH(
 IPEX_REGISTER_DISPATCH(
     merged_embeddingbag_cat_fw_stub,
     &merged_embedding_cat_fw_impl);
+IPEX_REGISTER_DISPATCH(
+    merged_embeddingbag_cat_interaction_linear_fw_stub,
+    &merged_embedding_cat_interaction_linear_fw_impl);
 IPEX_REGISTER_DISPATCH(
     mergedemb_distribute_forward_local_kernel_stub,
     &mergedemb_distribute_forward_local_kernel_impl);
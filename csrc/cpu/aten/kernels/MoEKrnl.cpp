@@ -10,6 +10,8 @@
 #include <immintrin.h>
 #include <torch/csrc/autograd/function.h>
 #include <algorithm>
+#include <memory>
+#include <tuple>
 #include "tpp/kernels/TPPGEMMKrnl.h"
 #include "vec/vec.h"
 
@@ -198,6 +200,321 @@ at::Tensor mixtral_moe_tpp_kernl_impl(
   return output;
 }
 
+// TPP kernels of one expert block of the fused MoE. Blocks have 1..64 rows
+// depending on how many tokens the expert received, one set per row count.
+template <typename T>
+struct FusedMoEBlockKernels {
+  FusedMoEBlockKernels(
+      long rows,
+      long C,
+      long Nc,
+      long Hk,
+      long I,
+      long Nc_d,
+      long Hk_d,
+      int b_vnni)
+      : gate_up(
+            rows,
+            Hk,
+            C / Nc,
+            C / Nc,
+            Hk * (C / Nc),
+            C,
+            Hk,
+            I,
+            0.0,
+            0,
+            Nc,
+            b_vnni),
+        silu(rows, Hk, I, I),
+        mul(rows, Hk, I, I),
+        down(
+            rows,
+            Hk_d,
+            I / Nc_d,
+            I / Nc_d,
+            Hk_d * (I / Nc_d),
+            I,
+            Hk_d,
+            C,
+            0.0,
+            0,
+            Nc_d,
+            b_vnni) {}
+  torch_ipex::tpp::BrgemmTPP<T, T> gate_up;
+  torch_ipex::tpp::SiLUFwdTPP<T> silu;
+  torch_ipex::tpp::MulTPP<T, T> mul;
+  torch_ipex::tpp::BrgemmTPP<T, T> down;
+};
+
+// All experts of a MoE layer in one parallel region. The (token, k) slots
+// are grouped by expert, then every (expert, 64-row block, output block)
+// tile of gate/up and of down is one work item, so that threads are not
+// bound to an expert and idle while a popular one is still running. Each
+// output element comes from a single brgemm and the tokens are combined in
+// k order, so the result does not depend on the thread count.
+template <typename T>
+at::Tensor fused_moe_tpp(
+    const at::Tensor& hidden_states,
+    const std::vector<long>& expert_offsets,
+    const std::vector<long>& slot_token,
+    const std::vector<long>& slot_pos,
+    const std::vector<at::Tensor>& gate_wei,
+    const std::vector<at::Tensor>& up_wei,
+    const std::vector<at::Tensor>& down_wei,
+    const at::Tensor& routing_weights,
+    int b_vnni) {
+  RECORD_FUNCTION("ipex::fused_moe_tpp", c10::ArrayRef<c10::IValue>({}));
+  constexpr long BSb = 64L;
+  long num_experts = gate_wei.size();
+  long num_tokens = hidden_states.size(0);
+  long C = hidden_states.size(1);
+  long topk = routing_weights.size(1);
+  long M = slot_token.size();
+
+  auto gate_sizes = gate_wei[0].sizes().vec();
+  auto down_sizes = down_wei[0].sizes().vec();
+  long Nk = gate_sizes[0], Nc = gate_sizes[1], Hk = gate_sizes[3];
+  long I = Nk * Hk;
+  long Nk_d = down_sizes[0], Nc_d = down_sizes[1], Hk_d = down_sizes[3];
+  TORCH_CHECK(
+      C % Nc == 0 && I % Nc_d == 0 && Nk_d * Hk_d == C,
+      "fused_moe_tpp: expert weights are not blocked for hidden size ",
+      C);
+
+  std::vector<T*> gate_ptr(num_experts), up_ptr(num_experts),
+      down_ptr(num_experts);
+  std::vector<at::Tensor> weights_V;
+  for (long e = 0; e < num_experts; e++) {
+    if (expert_offsets[e + 1] == expert_offsets[e])
+      continue;
+    TORCH_CHECK(
+        gate_wei[e].sizes() == gate_sizes && up_wei[e].sizes() == gate_sizes &&
+            down_wei[e].sizes() == down_sizes,
+        "fused_moe_tpp: all experts should have the same weight blocking");
+    auto gate_e = gate_wei[e], up_e = up_wei[e], down_e = down_wei[e];
+    weights_V.push_back(
+        torch_ipex::tpp::wt_tensor_for_fwd(Nk, Hk, Nc, C / Nc, gate_e));
+    gate_ptr[e] = weights_V.back().data_ptr<T>();
+    weights_V.push_back(
+        torch_ipex::tpp::wt_tensor_for_fwd(Nk, Hk, Nc, C / Nc, up_e));
+    up_ptr[e] = weights_V.back().data_ptr<T>();
+    weights_V.push_back(torch_ipex::tpp::wt_tensor_for_fwd(
+        Nk_d, Hk_d, Nc_d, I / Nc_d, down_e));
+    down_ptr[e] = weights_V.back().data_ptr<T>();
+  }
+
+  // (expert, first row, rows) of every block, with kernels for its size
+  std::vector<std::tuple<long, long, long>> blocks;
+  std::vector<std::unique_ptr<FusedMoEBlockKernels<T>>> kernels(BSb + 1);
+  for (long e = 0; e < num_experts; e++) {
+    for (long s = expert_offsets[e]; s < expert_offsets[e + 1]; s += BSb) {
+      long rows = std::min(BSb, expert_offsets[e + 1] - s);
+      blocks.emplace_back(e, s, rows);
+      if (!kernels[rows]) {
+        kernels[rows] = std::make_unique<FusedMoEBlockKernels<T>>(
+            rows, C, Nc, Hk, I, Nc_d, Hk_d, b_vnni);
+      }
+    }
+  }
+  long num_blocks = blocks.size();
+
+  auto t_in = hidden_states.contiguous();
+  auto t_x = at::empty({M, C}, t_in.options());
+  auto t_act = at::empty({M, I}, t_in.options());
+  auto t_up = at::empty({M, I}, t_in.options());
+  auto t_y = at::empty({M, C}, t_in.options());
+  auto output = at::empty({num_tokens, C}, t_in.options());
+  auto t_w = routing_weights.to(at::kFloat).contiguous();
+  auto in = t_in.data_ptr<T>();
+  auto x = t_x.data_ptr<T>();
+  auto act = t_act.data_ptr<T>();
+  auto up = t_up.data_ptr<T>();
+  auto y = t_y.data_ptr<T>();
+  auto out = output.data_ptr<T>();
+  auto w = t_w.data_ptr<float>();
+
+#pragma omp parallel
+  {
+#pragma omp for
+    for (long i = 0; i < M; i++) {
+      torch_ipex::cpu::kernel::move_ker<T, T>(
+          x + i * C, in + slot_token[i] * C, C);
+    }
+
+    // AMX tiles only have to be set up again when the block shape changes
+    long cfg_rows = -1;
+    bool configured = false;
+#pragma omp for schedule(dynamic)
+    for (long n = 0; n < num_blocks * Nk; n++) {
+      long e, s, rows, nk = n % Nk;
+      std::tie(e, s, rows) = blocks[n / Nk];
+      auto& k = *kernels[rows];
+      if (rows != cfg_rows) {
+        k.gate_up.config();
+        cfg_rows = rows;
+        configured = true;
+      }
+      auto act_blk = act + s * I + nk * Hk;
+      auto up_blk = up + s * I + nk * Hk;
+      k.gate_up(x + s * C, gate_ptr[e] + nk * C * Hk, act_blk, Nc, true);
+      k.gate_up(x + s * C, up_ptr[e] + nk * C * Hk, up_blk, Nc, true);
+      k.silu(act_blk, act_blk);
+      k.mul(act_blk, up_blk, act_blk);
+    }
+
+    cfg_rows = -1;
+#pragma omp for schedule(dynamic)
+    for (long n = 0; n < num_blocks * Nk_d; n++) {
+      long e, s, rows, nk = n % Nk_d;
+      std::tie(e, s, rows) = blocks[n / Nk_d];
+      auto& k = *kernels[rows];
+      if (rows != cfg_rows) {
+        k.down.config();
+        cfg_rows = rows;
+        configured = true;
+      }
+      k.down(
+          act + s * I,
+          down_ptr[e] + nk * I * Hk_d,
+          y + s * C + nk * Hk_d,
+          Nc_d,
+          true);
+    }
+    if (configured)
+      kernels[std::get<2>(blocks[0])]->down.release();
+
+    std::vector<float> acc(C);
+#pragma omp for
+    for (long t = 0; t < num_tokens; t++) {
+      std::fill(acc.begin(), acc.end(), 0.f);
+      for (long j = 0; j < topk; j++) {
+        float wt = w[t * topk + j];
+        auto y_row = y + slot_pos[t * topk + j] * C;
+        for (long c = 0; c < C; c++)
+          acc[c] += wt * static_cast<float>(y_row[c]);
+      }
+      for (long c = 0; c < C; c++)
+        out[t * C + c] = static_cast<T>(acc[c]);
+    }
+  }
+  return output;
+}
+
+at::Tensor deepseek_moe_tpp_kernel_impl(
+    const at::Tensor& hidden_states,
+    const at::Tensor& topk_ids,
+    const std::vector<at::Tensor>& gate_wei,
+    const std::vector<at::Tensor>& up_wei,
+    const std::vector<at::Tensor>& down_wei,
+    bool tpp_fallback,
+    const at::Tensor& routing_weights,
+    bool is_distributed) {
+  TORCH_CHECK(
+      hidden_states.dim() == 2 && topk_ids.dim() == 2 &&
+          routing_weights.sizes() == topk_ids.sizes(),
+      "deepseek_moe_tpp: expect 2D hidden_states and [tokens, top_k] ids and weights");
+  long num_experts = gate_wei.size();
+  TORCH_CHECK(
+      num_experts > 0 && up_wei.size() == gate_wei.size() &&
+          down_wei.size() == gate_wei.size(),
+      "deepseek_moe_tpp: expect gate, up and down weights of every expert");
+  long num_tokens = topk_ids.size(0);
+  long topk = topk_ids.size(1);
+
+  // Counting sort of the (token, k) slots by expert, tokens stay in order
+  auto t_ids = topk_ids.to(at::kLong).contiguous();
+  auto ids = t_ids.data_ptr<int64_t>();
+  std::vector<long> expert_offsets(num_experts + 1, 0);
+  for (long i = 0; i < num_tokens * topk; i++) {
+    TORCH_CHECK(
+        ids[i] >= 0 && ids[i] < num_experts,
+        "deepseek_moe_tpp: expert id ",
+        ids[i],
+        " out of range");
+    expert_offsets[ids[i] + 1]++;
+  }
+  long max_count = 0;
+  for (long e = 0; e < num_experts; e++) {
+    max_count = std::max(max_count, expert_offsets[e + 1] - expert_offsets[e]);
+    expert_offsets[e + 1] += expert_offsets[e];
+  }
+  std::vector<long> slot_token(num_tokens * topk), slot_idx(num_tokens * topk),
+      slot_pos(num_tokens * topk);
+  std::vector<long> next(expert_offsets.begin(), expert_offsets.end() - 1);
+  for (long i = 0; i < num_tokens * topk; i++) {
+    long pos = next[ids[i]]++;
+    slot_token[pos] = i / topk;
+    slot_idx[pos] = i % topk;
+    slot_pos[i] = pos;
+  }
+
+  auto dt = hidden_states.scalar_type();
+  bool fused = !tpp_fallback && max_count <= torch_ipex::tpp::FT_OPT_SIZE &&
+      (dt == at::kFloat || dt == at::kBFloat16 ||
+       (dt == at::kHalf && torch_ipex::utils::isa_has_amx_fp16_support()));
+  if (fused) {
+    if (dt == at::kFloat) {
+      return fused_moe_tpp<float>(
+          hidden_states,
+          expert_offsets,
+          slot_token,
+          slot_pos,
+          gate_wei,
+          up_wei,
+          down_wei,
+          routing_weights,
+          VNNI_OFF);
+    } else if (dt == at::kBFloat16) {
+      return fused_moe_tpp<at::BFloat16>(
+          hidden_states,
+          expert_offsets,
+          slot_token,
+          slot_pos,
+          gate_wei,
+          up_wei,
+          down_wei,
+          routing_weights,
+          VNNI_ON);
+    }
+    return fused_moe_tpp<at::Half>(
+        hidden_states,
+        expert_offsets,
+        slot_token,
+        slot_pos,
+        gate_wei,
+        up_wei,
+        down_wei,
+        routing_weights,
+        VNNI_ON);
+  }
+
+  // Experts with many tokens (prefill) re-block their weights for cache
+  // reuse in the per-expert TPP GEMMs, run them one by one.
+  auto output = at::zeros_like(hidden_states);
+  for (long e = 0; e < num_experts; e++) {
+    long count = expert_offsets[e + 1] - expert_offsets[e];
+    if (count == 0)
+      continue;
+    auto top_x = torch::from_blob(
+        slot_token.data() + expert_offsets[e], {count}, at::kLong);
+    auto idx = torch::from_blob(
+        slot_idx.data() + expert_offsets[e], {count}, at::kLong);
+    output = mixtral_moe_tpp_kernl_impl(
+        hidden_states,
+        top_x,
+        idx,
+        gate_wei[e],
+        up_wei[e],
+        down_wei[e],
+        tpp_fallback,
+        routing_weights,
+        output,
+        is_distributed);
+  }
+  return output;
+}
+
 at::Tensor mixtral_moe_kernl_impl(
     const at::Tensor& hidden_states,
     const at::Tensor& top_x,
@@ -571,6 +888,9 @@ void convert_e5m2_to_fp16_intrinsic(
 IPEX_REGISTER_DISPATCH(
     mixtral_moe_tpp_kernel_stub,
     &mixtral_moe_tpp_kernl_impl);
+IPEX_REGISTER_DISPATCH(
+    deepseek_moe_tpp_kernel_stub,
+    &deepseek_moe_tpp_kernel_impl);
 IPEX_REGISTER_DISPATCH(
     mixtral_moe_woq_kernel_stub,
     &mixtral_moe_woq_kernl_impl);
@@ -4,6 +4,7 @@
 #include <immintrin.h>
 #include <torch/csrc/autograd/function.h>
 #include <algorithm>
+#include <cstring>
 #include "autocast/autocast_mode.h"
 #include "cpu/kernels/Softmax.h"
 
@@ -367,17 +368,146 @@ at::Tensor nms_cpu_kernel</*scalar_t*/ float, /*sorted*/ true>(
 }
 #endif
 
-std::vector<at::Tensor> remove_empty(
-    std::vector<at::Tensor>& candidate,
-    int64_t start,
-    int64_t end) {
-  std::vector<at::Tensor> valid_candidate;
-  for (int64_t i = start; i < end; i++) {
-    if (candidate[i].defined()) {
-      valid_candidate.push_back(candidate[i]);
+/*
+ Suppression bitmask of sorted box i against all the boxes j > i: bit j of
+ mask_row is set when IoU(i, j) >= threshold. 64 boxes per word.
+*/
+template <typename scalar_t>
+inline void nms_suppression_mask_row(
+    const scalar_t* x1,
+    const scalar_t* y1,
+    const scalar_t* x2,
+    const scalar_t* y2,
+    const scalar_t* areas,
+    int64_t i,
+    int64_t ndets,
+    const float threshold,
+    const scalar_t bias,
+    uint64_t* mask_row) {
+  for (int64_t j = i + 1; j < ndets; j++) {
+    auto xx1 = std::max(x1[i], x1[j]);
+    auto yy1 = std::max(y1[i], y1[j]);
+    auto xx2 = std::min(x2[i], x2[j]);
+    auto yy2 = std::min(y2[i], y2[j]);
+    auto w = std::max(static_cast<scalar_t>(0), xx2 - xx1 + bias);
+    auto h = std::max(static_cast<scalar_t>(0), yy2 - yy1 + bias);
+    auto inter = w * h;
+    auto ovr = inter / (areas[i] + areas[j] - inter);
+    if (ovr >= threshold) {
+      mask_row[j >> 6] |= (uint64_t)1 << (j & 63);
+    }
+  }
+}
+
+#ifdef CPU_CAPABILITY_AVX512
+// IoU of box i against 16 boxes at a time, the compare mask is directly the
+// 16 bits of the suppression bitmask
+template <>
+inline void nms_suppression_mask_row<float>(
+    const float* x1,
+    const float* y1,
+    const float* x2,
+    const float* y2,
+    const float* areas,
+    int64_t i,
+    int64_t ndets,
+    const float threshold,
+    const float bias,
+    uint64_t* mask_row) {
+  __m512 m512_zero = _mm512_setzero_ps();
+  __m512 m512_bias = _mm512_set1_ps(bias);
+  __m512 m512_threshold = _mm512_set1_ps(threshold);
+  __m512 m512_ix1 = _mm512_set1_ps(x1[i]);
+  __m512 m512_iy1 = _mm512_set1_ps(y1[i]);
+  __m512 m512_ix2 = _mm512_set1_ps(x2[i]);
+  __m512 m512_iy2 = _mm512_set1_ps(y2[i]);
+  __m512 m512_iarea = _mm512_set1_ps(areas[i]);
+  // start from the 16-box group holding box i + 1 so that the 16 bits always
+  // land in one 64-bit word
+  for (int64_t j = ((i + 1) >> 4) << 4; j < ndets; j += 16) {
+    __mmask16 load_mask = ndets - j >= 16
+        ? (__mmask16)0xFFFF
+        : (__mmask16)((1 << (ndets - j)) - 1);
+    if (j <= i) {
+      // drop box i and the boxes before it
+      load_mask &= (__mmask16)(0xFFFF << (i + 1 - j));
+    }
+    __m512 m512_x1 = _mm512_maskz_loadu_ps(load_mask, x1 + j);
+    __m512 m512_y1 = _mm512_maskz_loadu_ps(load_mask, y1 + j);
+    __m512 m512_x2 = _mm512_maskz_loadu_ps(load_mask, x2 + j);
+    __m512 m512_y2 = _mm512_maskz_loadu_ps(load_mask, y2 + j);
+    __m512 m512_areas = _mm512_maskz_loadu_ps(load_mask, areas + j);
+
+    __m512 m512_w = _mm512_max_ps(
+        m512_zero,
+        _mm512_add_ps(
+            _mm512_sub_ps(
+                _mm512_min_ps(m512_ix2, m512_x2),
+                _mm512_max_ps(m512_ix1, m512_x1)),
+            m512_bias));
+    __m512 m512_h = _mm512_max_ps(
+        m512_zero,
+        _mm512_add_ps(
+            _mm512_sub_ps(
+                _mm512_min_ps(m512_iy2, m512_y2),
+                _mm512_max_ps(m512_iy1, m512_y1)),
+            m512_bias));
+    __m512 m512_inter = _mm512_mul_ps(m512_w, m512_h);
+    __m512 m512_over = _mm512_div_ps(
+        m512_inter,
+        _mm512_sub_ps(_mm512_add_ps(m512_iarea, m512_areas), m512_inter));
+    __mmask16 mask_sus = _mm512_mask_cmp_ps_mask(
+        load_mask, m512_over, m512_threshold, _CMP_GE_OS);
+    mask_row[j >> 6] |= (uint64_t)mask_sus << (j & 63);
+  }
+}
+#endif
+
+/*
+ Bitmask NMS for boxes already sorted in descending score order. The IoU
+ matrix is computed first (branch free, vectorized), the greedy sweep then
+ only ORs the bitmask of every kept box into the removed mask.
+*/
+template <typename scalar_t>
+void nms_bitmask_kernel(
+    const scalar_t* x1,
+    const scalar_t* y1,
+    const scalar_t* x2,
+    const scalar_t* y2,
+    int64_t ndets,
+    const float threshold,
+    const scalar_t bias,
+    std::vector<int64_t>& keep) {
+  const int64_t nwords = (ndets + 63) >> 6;
+  std::vector<scalar_t> areas(ndets);
+  for (int64_t i = 0; i < ndets; i++) {
+    areas[i] = (x2[i] - x1[i] + bias) * (y2[i] - y1[i] + bias);
+  }
+  std::vector<uint64_t> mask(ndets * nwords, 0);
+  for (int64_t i = 0; i < ndets; i++) {
+    nms_suppression_mask_row<scalar_t>(
+        x1,
+        y1,
+        x2,
+        y2,
+        areas.data(),
+        i,
+        ndets,
+        threshold,
+        bias,
+        &mask[i * nwords]);
+  }
+  std::vector<uint64_t> removed(nwords, 0);
+  for (int64_t i = 0; i < ndets; i++) {
+    if ((removed[i >> 6] >> (i & 63)) & 1) {
+      continue;
+    }
+    keep.push_back(i);
+    const uint64_t* mask_row = &mask[i * nwords];
+    for (int64_t w = i >> 6; w < nwords; w++) {
+      removed[w] |= mask_row[w];
     }
   }
-  return valid_candidate;
 }
 
 template <typename scalar_t>
@@ -398,20 +528,22 @@ batch_score_nms_kernel(
 
   auto nbatch_x_nscore =
       nbatch * nscore; // (number of batches) * (number of labels)
-  std::vector<at::Tensor> bboxes_out(nbatch_x_nscore);
-  std::vector<at::Tensor> scores_out(nbatch_x_nscore);
-  std::vector<at::Tensor> labels_out(nbatch_x_nscore);
+
+  // scores are channels last (label is the last dim), make every label of
+  // every image a contiguous row once instead of strided reads per label
+  auto dets_t = batch_dets.contiguous();
+  auto scores_t = batch_scores.transpose(1, 2).contiguous();
+  const scalar_t* dets_data = dets_t.data_ptr<scalar_t>();
+  const scalar_t* scores_data = scores_t.data_ptr<scalar_t>();
+  const scalar_t score_threshold = static_cast<scalar_t>(0.05);
+
+  // kept (score, box index) for every (image, label)
+  std::vector<std::vector<std::pair<scalar_t, int64_t>>> kept(nbatch_x_nscore);
 
 #ifdef _OPENMP
-#if (_OPENMP >= 201307)
-#pragma omp parallel for simd schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#else
 #pragma omp parallel for schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#endif
+    dynamic) if (omp_get_max_threads() > 1 && !omp_in_parallel())
 #endif
-  // skip background (i = 0)
   for (int index = 0; index < nbatch_x_nscore; index++) {
     // Parallel in the dimentaion of: batch * nscore
     auto bs = index / nscore;
@@ -422,84 +554,118 @@ batch_score_nms_kernel(
       continue;
     }
 
-    at::Tensor dets = batch_dets[bs].squeeze(
-        0); // dets for boxes per image: (num_bbox, 4); For example: (15130, 4)
-    at::Tensor scores =
-        batch_scores[bs].squeeze(0); // scores for boxes per image: (num_bbox,
-                                     // 81); For example: (15130, 81)
-
-    at::Tensor score = scores.slice(1, i, i + 1)
-                           .squeeze(1); // score for boxes per image per class:
-                                        // (num_bbox); For example: (15130)
-
-    at::Tensor mask_index = at::nonzero(score > 0.05).squeeze(1);
-    at::Tensor bboxes = at::index_select(dets, /*dim*/ 0, mask_index);
-    score = at::index_select(score, /*dim*/ 0, mask_index);
-
-    if (score.size(0) == 0) {
+    const scalar_t* score = scores_data + index * ndets;
+    const scalar_t* dets = dets_data + bs * ndets * 4;
+    std::vector<std::pair<scalar_t, int64_t>> candidate;
+    for (int64_t j = 0; j < ndets; j++) {
+      if (score[j] > score_threshold) {
+        candidate.emplace_back(score[j], j);
+      }
+    }
+    if (candidate.empty()) {
       continue;
     }
 
-    at::Tensor score_sliced, score_idx_sorted;
     // select max_output highest' score and bboxes
-    std::tie(score_sliced, score_idx_sorted) = at::topk(
-        score, (max_output > score.size(0)) ? score.size(0) : max_output, 0);
-    at::Tensor bboxes_sliced =
-        at::index_select(bboxes, /*dim*/ 0, score_idx_sorted);
-
-    at::Tensor keep = nms_cpu_kernel<scalar_t, /*sorted*/ true>(
-        bboxes_sliced, score_sliced, threshold, /*bias*/ 0);
-
-    bboxes_out[index] = at::index_select(bboxes_sliced, /*dim*/ 0, keep);
-    scores_out[index] = at::index_select(score_sliced, /*dim*/ 0, keep);
-    // TODO optimize the fill_
-    labels_out[index] = at::empty({keep.sizes()}).fill_(i);
+    int64_t ncandidate =
+        std::min(static_cast<int64_t>(max_output), (int64_t)candidate.size());
+    std::partial_sort(
+        candidate.begin(),
+        candidate.begin() + ncandidate,
+        candidate.end(),
+        [](const std::pair<scalar_t, int64_t>& a,
+           const std::pair<scalar_t, int64_t>& b) {
+          return a.first > b.first ||
+              (a.first == b.first && a.second < b.second);
+        });
+    candidate.resize(ncandidate);
+
+    std::vector<scalar_t> x1(ncandidate), y1(ncandidate), x2(ncandidate),
+        y2(ncandidate);
+    for (int64_t j = 0; j < ncandidate; j++) {
+      const scalar_t* box = dets + candidate[j].second * 4;
+      x1[j] = box[0];
+      y1[j] = box[1];
+      x2[j] = box[2];
+      y2[j] = box[3];
+    }
+    std::vector<int64_t> keep;
+    nms_bitmask_kernel<scalar_t>(
+        x1.data(),
+        y1.data(),
+        x2.data(),
+        y2.data(),
+        ncandidate,
+        threshold,
+        /*bias*/ 0,
+        keep);
+    auto& kept_index = kept[index];
+    kept_index.reserve(keep.size());
+    for (auto k : keep) {
+      kept_index.push_back(candidate[k]);
+    }
   }
 
-  std::vector<at::Tensor> output_bboxes_(nbatch);
-  std::vector<at::Tensor> output_labels_(nbatch);
-  std::vector<at::Tensor> output_scores_(nbatch);
-  std::vector<at::Tensor> output_length_(nbatch);
+  // Post process to get the top max_output(number) for each Batchsize, the
+  // result of one image is in ascending score order
+  std::vector<std::vector<std::tuple<scalar_t, int64_t, int64_t>>> selected(
+      nbatch);
 #ifdef _OPENMP
-#if (_OPENMP >= 201307)
-#pragma omp parallel for simd schedule( \
-    static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#else
 #pragma omp parallel for schedule( \
     static) if (omp_get_max_threads() > 1 && !omp_in_parallel())
-#endif
 #endif
   for (int bs = 0; bs < nbatch; bs++) {
-    // Post process the tensors to get the top max_output(number) for each
-    // Batchsize
-    std::vector<at::Tensor> valid_bboxes_out =
-        remove_empty(bboxes_out, bs * nscore, (bs + 1) * nscore);
-    std::vector<at::Tensor> valid_scores_out =
-        remove_empty(scores_out, bs * nscore, (bs + 1) * nscore);
-    std::vector<at::Tensor> valid_labels_out =
-        remove_empty(labels_out, bs * nscore, (bs + 1) * nscore);
-
-    at::Tensor bboxes_out_ = at::cat(valid_bboxes_out, 0);
-    at::Tensor labels_out_ = at::cat(valid_labels_out, 0);
-    at::Tensor scores_out_ = at::cat(valid_scores_out, 0);
-
-    std::tuple<at::Tensor, at::Tensor> sort_result = scores_out_.sort(0);
-    at::Tensor max_ids = std::get<1>(sort_result);
-    max_ids = max_ids.slice(
-        /*dim*/ 0,
-        /*start*/
-        std::max(max_ids.size(0) - max_output, static_cast<int64_t>(0)),
-        /*end*/ max_ids.size(0));
-    output_bboxes_[bs] = bboxes_out_.index_select(/*dim*/ 0, /*index*/ max_ids);
-    output_labels_[bs] = labels_out_.index_select(/*dim*/ 0, /*index*/ max_ids);
-    output_scores_[bs] = scores_out_.index_select(/*dim*/ 0, /*index*/ max_ids);
-    output_length_[bs] = torch::tensor(max_ids.size(0), {torch::kInt32});
+    // (score, label, box index)
+    auto& merged = selected[bs];
+    for (int64_t i = 1; i < nscore; i++) {
+      for (auto& kept_box : kept[bs * nscore + i]) {
+        merged.emplace_back(kept_box.first, i, kept_box.second);
+      }
+    }
+    auto by_score = [](const std::tuple<scalar_t, int64_t, int64_t>& a,
+                       const std::tuple<scalar_t, int64_t, int64_t>& b) {
+      return std::get<0>(a) < std::get<0>(b);
+    };
+    if (merged.size() > static_cast<size_t>(max_output)) {
+      std::nth_element(
+          merged.begin(),
+          merged.end() - max_output,
+          merged.end(),
+          by_score);
+      merged.erase(merged.begin(), merged.end() - max_output);
+    }
+    std::sort(merged.begin(), merged.end(), by_score);
+  }
+
+  std::vector<int64_t> output_offset(nbatch + 1, 0);
+  for (int bs = 0; bs < nbatch; bs++) {
+    output_offset[bs + 1] = output_offset[bs] + selected[bs].size();
+  }
+  auto total = output_offset[nbatch];
+  at::Tensor output_bboxes = at::empty({total, 4}, batch_dets.options());
+  at::Tensor output_labels = at::empty({total}, at::kFloat);
+  at::Tensor output_scores = at::empty({total}, batch_scores.options());
+  at::Tensor output_length = at::empty({nbatch}, at::kInt);
+  auto bboxes_data = output_bboxes.data_ptr<scalar_t>();
+  auto labels_data = output_labels.data_ptr<float>();
+  auto out_scores_data = output_scores.data_ptr<scalar_t>();
+  auto length_data = output_length.data_ptr<int32_t>();
+  for (int bs = 0; bs < nbatch; bs++) {
+    const scalar_t* dets = dets_data + bs * ndets * 4;
+    int64_t offset = output_offset[bs];
+    for (auto& box : selected[bs]) {
+      std::memcpy(
+          bboxes_data + offset * 4,
+          dets + std::get<2>(box) * 4,
+          4 * sizeof(scalar_t));
+      labels_data[offset] = static_cast<float>(std::get<1>(box));
+      out_scores_data[offset] = std::get<0>(box);
+      offset++;
+    }
+    length_data[bs] = static_cast<int32_t>(selected[bs].size());
   }
   return std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor>(
-      at::cat(output_bboxes_),
-      at::cat(output_labels_),
-      at::cat(output_scores_),
-      at::stack(output_length_));
+      output_bboxes, output_labels, output_scores, output_length);
 }
 
 template <typename scalar_t>
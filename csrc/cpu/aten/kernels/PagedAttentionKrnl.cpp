@@ -98,7 +98,8 @@ void scaled_convert<at::BFloat16, at::Float8_e5m2>(
     size_t len,
     float scale) {
   size_t idx_offset = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   torch_ipex::cpu::kernel::cvt_e5m2_bf16_intrinsic(src_ptr, dst_ptr, len);
 #else
   for (size_t i = 0; i < len; i++) {
@@ -114,7 +115,8 @@ void scaled_convert<float, at::Float8_e5m2>(
     size_t len,
     float scale) {
   size_t idx_offset = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   torch_ipex::cpu::kernel::cvt_e5m2_fp32_intrinsic(src_ptr, dst_ptr, len);
 #else
   for (size_t i = 0; i < len; i++) {
@@ -207,7 +209,8 @@ void reduce_head(
     float* attn_w_pos,
     int64_t head_size) {
   attn_w_pos[0] = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   torch_ipex::cpu::kernel::_reduce_head<QT, KT, KT>(
       q_ptr_start, k_cache_start, attn_w_pos, head_size, false, nullptr);
 #else
@@ -225,7 +228,8 @@ void reduce_head(
     float* attn_w_pos,
     int attn_w_stride,
     int64_t head_size) {
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   for (auto i = 0; i < kv_head_group_size; i++) {
     attn_w_pos[i * attn_w_stride] = 0;
     torch_ipex::cpu::kernel::_reduce_head<QT, KT, KT>(
@@ -313,6 +317,69 @@ inline void _mul_and_accumulate_e5m2(
     }
   }
 }
+#elif defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX2_VNNI)
+void _reduce_head_e5m2(
+    const at::BFloat16* q_ptr_start,
+    const at::Float8_e5m2* k_ptr_start,
+    float* attn_w_pos,
+    int64_t head_size) {
+  using namespace torch_ipex::cpu::kernel;
+  auto hsi = 0;
+  auto vec_size = 16;
+  auto qk_sum_vec = _mm256_setzero_ps();
+  for (hsi = 0; hsi <= head_size - vec_size; hsi += vec_size) {
+    auto k_vec_ =
+        _mm256_cvte5m2_fp16(_mm_loadu_si128((__m128i*)&k_ptr_start[hsi]));
+    auto k_vec0 = _mm256_cvtph_ps(_mm256_castsi256_si128(k_vec_));
+    auto k_vec1 = _mm256_cvtph_ps(_mm256_extracti128_si256(k_vec_, 1));
+    auto q_vec0 = _loadu(q_ptr_start + hsi);
+    auto q_vec1 = _loadu(q_ptr_start + hsi + 8);
+    qk_sum_vec = _mm256_fmadd_ps(q_vec0, k_vec0, qk_sum_vec);
+    qk_sum_vec = _mm256_fmadd_ps(q_vec1, k_vec1, qk_sum_vec);
+  }
+  attn_w_pos[0] += _reduce_add_ps(qk_sum_vec);
+  for (; hsi < head_size; hsi++) {
+    attn_w_pos[0] += q_ptr_start[hsi] * (float)k_ptr_start[hsi];
+  }
+}
+
+inline void _mul_and_accumulate_e5m2(
+    const float& attn_w,
+    const at::Float8_e5m2* v_ptr_start,
+    float* attn_out_start,
+    int64_t head_size,
+    int accumulated) {
+  using namespace torch_ipex::cpu::kernel;
+  auto hsi = 0;
+  auto vec_size = 16;
+  auto attn_w_vec = _mm256_set1_ps(attn_w);
+  for (hsi = 0; hsi <= head_size - vec_size; hsi += vec_size) {
+    auto v_vec_ =
+        _mm256_cvte5m2_fp16(_mm_loadu_si128((__m128i*)&v_ptr_start[hsi]));
+    auto v_vec0 = _mm256_cvtph_ps(_mm256_castsi256_si128(v_vec_));
+    auto v_vec1 = _mm256_cvtph_ps(_mm256_extracti128_si256(v_vec_, 1));
+    if (accumulated) {
+      auto attn_out_vec0 = _loadu(attn_out_start + hsi);
+      auto attn_out_vec1 = _loadu(attn_out_start + hsi + 8);
+      _storeu(
+          attn_out_start + hsi,
+          _mm256_fmadd_ps(attn_w_vec, v_vec0, attn_out_vec0));
+      _storeu(
+          attn_out_start + hsi + 8,
+          _mm256_fmadd_ps(attn_w_vec, v_vec1, attn_out_vec1));
+    } else {
+      _storeu(attn_out_start + hsi, _mm256_mul_ps(attn_w_vec, v_vec0));
+      _storeu(attn_out_start + hsi + 8, _mm256_mul_ps(attn_w_vec, v_vec1));
+    }
+  }
+  for (; hsi < head_size; hsi++) {
+    if (accumulated) {
+      attn_out_start[hsi] += attn_w * (float)v_ptr_start[hsi];
+    } else {
+      attn_out_start[hsi] = attn_w * (float)v_ptr_start[hsi];
+    }
+  }
+}
 #endif
 
 template <>
@@ -323,7 +390,8 @@ void reduce_head<at::BFloat16, at::Float8_e5m2>(
     float* attn_w_pos,
     int attn_w_stride,
     int64_t head_size) {
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   for (auto i = 0; i < kv_head_group_size; i++) {
     attn_w_pos[i * attn_w_stride] = 0;
     _reduce_head_e5m2(
@@ -351,7 +419,8 @@ void reduce_head<at::BFloat16, at::Float8_e5m2>(
     float* attn_w_pos,
     int64_t head_size) {
   attn_w_pos[0] = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   _reduce_head_e5m2(q_ptr_start, k_cache_start, attn_w_pos, head_size);
 #else
   for (auto hsi = 0; hsi < head_size; hsi++) {
@@ -371,7 +440,8 @@ inline void mul_attenion_weights_and_value_of_head(
     int64_t head_size,
     bool accumulated) {
   auto hsi = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   for (auto i = 0; i < kv_head_group_size; i++) {
     torch_ipex::cpu::kernel::_mul_and_accumulate<CT, OT, CT>(
         attn_w[i * attn_w_stride],
@@ -408,7 +478,8 @@ inline void mul_attenion_weights_and_value_of_head<float, at::Float8_e5m2>(
     int64_t head_size,
     bool accumulated) {
   auto hsi = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   for (auto i = 0; i < kv_head_group_size; i++) {
     _mul_and_accumulate_e5m2(
         attn_w[i * attn_w_stride],
@@ -440,7 +511,8 @@ inline void mul_attenion_weights_and_value_of_head(
     int64_t head_size,
     bool accumulated) {
   auto hsi = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   torch_ipex::cpu::kernel::_mul_and_accumulate<CT, OT, CT>(
       attn_w,
       v_cache_start,
@@ -468,7 +540,8 @@ inline void mul_attenion_weights_and_value_of_head<float, at::Float8_e5m2>(
     int64_t head_size,
     bool accumulated) {
   auto hsi = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   _mul_and_accumulate_e5m2(
       attn_w, v_cache_start, attn_out_start, head_size, accumulated);
 #else
@@ -492,7 +565,8 @@ mul_attenion_weights_and_value_of_head(
     bool accumulated) {
   const auto vec_size = at::vec::Vectorized<OT>::size();
   auto hsi = 0;
-#if defined(CPU_CAPABILITY_AVX512)
+#if defined(CPU_CAPABILITY_AVX512) || defined(CPU_CAPABILITY_AVX2) || \
+    defined(CPU_CAPABILITY_AVX2_VNNI)
   torch_ipex::cpu::kernel::_mul_and_accumulate<CT, OT, CT>(
       attn_w,
       v_cache_start,
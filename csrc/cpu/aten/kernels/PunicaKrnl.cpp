@@ -30,36 +30,186 @@ namespace cpu {
 
 namespace {
 
-template <typename T1, typename T2>
-void _dot(
-    const T1* intput,
-    const T2* weight,
-    T1* out,
-    int64_t len,
-    const double scale,
+// Tokens are grouped by LoRA adapter and every adapter runs one GEMM over
+// all of its tokens, BLOCK_M tokens x BLOCK_N outputs at a time, instead of
+// one dot product per token and output. The weights of an adapter are then
+// read once per BLOCK_M tokens.
+constexpr int64_t kLoraBlockM = 32;
+constexpr int64_t kLoraBlockN = 64;
+
+// Token ids sorted by LoRA adapter, the tokens of lora_ids[i] are
+// token_ids[seg_starts[i], seg_starts[i + 1]). Tokens with a negative LoRA
+// index do not apply any LoRA and are left out.
+struct LoraSegments {
+  std::vector<int64_t> token_ids;
+  std::vector<int64_t> seg_starts;
+  std::vector<int64_t> lora_ids;
+};
+
+// bgmv: counting sort of the tokens by their LoRA index, stable so that the
+// tokens of an adapter stay in order and are contiguous for sgmv-like batches
+inline LoraSegments group_tokens_by_lora(
+    const int64_t* indicies,
+    int64_t batch_size,
+    int64_t num_lora) {
+  LoraSegments segs;
+  std::vector<int64_t> counts(num_lora + 1, 0);
+  for (int64_t bs = 0; bs < batch_size; bs++) {
+    auto lora = indicies[bs];
+    TORCH_CHECK(lora < num_lora, "LoRA index ", lora, " out of range");
+    if (lora >= 0) {
+      counts[lora + 1]++;
+    }
+  }
+  for (int64_t i = 0; i < num_lora; i++) {
+    counts[i + 1] += counts[i];
+  }
+  segs.token_ids.resize(counts[num_lora]);
+  std::vector<int64_t> pos(counts.begin(), counts.end() - 1);
+  for (int64_t bs = 0; bs < batch_size; bs++) {
+    if (indicies[bs] >= 0) {
+      segs.token_ids[pos[indicies[bs]]++] = bs;
+    }
+  }
+  for (int64_t i = 0; i < num_lora; i++) {
+    if (counts[i + 1] > counts[i]) {
+      segs.seg_starts.push_back(counts[i]);
+      segs.lora_ids.push_back(i);
+    }
+  }
+  segs.seg_starts.push_back(counts[num_lora]);
+  return segs;
+}
+
+// sgmv: the tokens of a sequence are contiguous and share one LoRA index
+inline LoraSegments group_seqs_by_lora(
+    const int64_t* indicies,
+    const int64_t* seq_lens,
+    int64_t num_seqs,
+    int64_t num_lora) {
+  LoraSegments segs;
+  int64_t offset = 0;
+  for (int64_t seq_id = 0; seq_id < num_seqs; seq_id++) {
+    auto lora = indicies[seq_id];
+    TORCH_CHECK(lora < num_lora, "LoRA index ", lora, " out of range");
+    if (lora >= 0 && seq_lens[seq_id] > 0) {
+      segs.seg_starts.push_back(segs.token_ids.size());
+      segs.lora_ids.push_back(lora);
+      for (int64_t s = 0; s < seq_lens[seq_id]; s++) {
+        segs.token_ids.push_back(offset + s);
+      }
+    }
+    offset += seq_lens[seq_id];
+  }
+  segs.seg_starts.push_back(segs.token_ids.size());
+  return segs;
+}
+
+/*
+ *out[t, out_offset + n] (+)= scale * sum_k input[t, k] * weights[lora(t), n,
+ *k] for every token t of segs, as one GEMM per LoRA adapter.
+ *@param input [bs, lda] or [1, lda] if broadcast_input
+ *@param weights [num_lora, N, K]
+ *@param out [bs, ldc]
+ */
+template <typename T>
+void lora_grouped_gemm(
+    const LoraSegments& segs,
+    const T* input,
+    int64_t lda,
+    bool broadcast_input,
+    const T* weights,
+    int64_t N,
+    int64_t K,
+    T* out,
+    int64_t ldc,
+    int64_t out_offset,
+    float scale,
     bool add_inputs) {
-  using namespace torch_ipex::cpu::kernel;
-  int64_t hsi = 0;
-  float out_f32 = 0;
-#if defined(CPU_CAPABILITY_AVX512)
-  int64_t vec_size = 16; // 512/32
-  auto qk_sum_vec = _mm512_setzero_ps();
-  for (hsi = 0; hsi <= len - vec_size; hsi += vec_size) {
-    auto q_vec = _loadu(intput + hsi);
-    auto k_vec = _loadu(weight + hsi);
-    qk_sum_vec = _mm512_fmadd_ps(q_vec, k_vec, qk_sum_vec);
+  int64_t num_segs = segs.lora_ids.size();
+  if (num_segs == 0 || N == 0) {
+    return;
   }
-  out_f32 += _mm512_reduce_add_ps(qk_sum_vec);
-#endif
-  for (; hsi < len; hsi++) {
-    out_f32 +=
-        static_cast<float>(intput[hsi]) * static_cast<float>(weight[hsi]);
+  auto num_blocks_m = [&](int64_t seg) {
+    auto len = segs.seg_starts[seg + 1] - segs.seg_starts[seg];
+    return (len + kLoraBlockM - 1) / kLoraBlockM;
+  };
+  int64_t total_blocks_m = 0;
+  for (int64_t seg = 0; seg < num_segs; seg++) {
+    total_blocks_m += num_blocks_m(seg);
   }
-  if (add_inputs) {
-    out[0] += static_cast<T1>(out_f32 * scale);
-  } else {
-    out[0] = static_cast<T1>(out_f32 * scale);
+  // split N finer when there are too few tokens to feed all threads
+  int64_t block_n = std::min(kLoraBlockN, N);
+  while (block_n > 16 &&
+         total_blocks_m * ((N + block_n - 1) / block_n) <
+             at::get_num_threads()) {
+    block_n /= 2;
   }
+  int64_t num_blocks_n = (N + block_n - 1) / block_n;
+  // (segment, first token) of every M block
+  std::vector<std::pair<int64_t, int64_t>> blocks_m;
+  blocks_m.reserve(total_blocks_m);
+  for (int64_t seg = 0; seg < num_segs; seg++) {
+    for (int64_t mb = 0; mb < num_blocks_m(seg); mb++) {
+      blocks_m.emplace_back(seg, segs.seg_starts[seg] + mb * kLoraBlockM);
+    }
+  }
+
+  at::parallel_for(
+      0, total_blocks_m * num_blocks_n, 1, [&](int64_t begin, int64_t end) {
+        std::vector<T> A_buf;
+        std::vector<float> C_buf(kLoraBlockM * block_n);
+        for (int64_t i = begin; i < end; i++) {
+          auto seg = blocks_m[i / num_blocks_n].first;
+          auto m_start = blocks_m[i / num_blocks_n].second;
+          auto m_size =
+              std::min(kLoraBlockM, segs.seg_starts[seg + 1] - m_start);
+          auto n_start = (i % num_blocks_n) * block_n;
+          auto n_size = std::min(block_n, N - n_start);
+          const int64_t* ids = segs.token_ids.data() + m_start;
+          // a broadcast input row gives the same result for every token
+          auto gemm_m = broadcast_input ? 1 : m_size;
+          // read A in place if the tokens of the block are contiguous
+          const T* A = input + (broadcast_input ? 0 : ids[0] * lda);
+          int64_t lda_ = lda;
+          if (gemm_m > 1 && ids[m_size - 1] - ids[0] != m_size - 1) {
+            A_buf.resize(kLoraBlockM * K);
+            for (int64_t m = 0; m < m_size; m++) {
+              std::copy_n(input + ids[m] * lda, K, A_buf.data() + m * K);
+            }
+            A = A_buf.data();
+            lda_ = K;
+          }
+          const T* B = weights + segs.lora_ids[seg] * N * K + n_start * K;
+          _mkl_gemm(
+              CblasRowMajor,
+              CblasNoTrans,
+              CblasTrans,
+              gemm_m,
+              n_size,
+              K,
+              scale,
+              A,
+              lda_,
+              B,
+              K,
+              0.f,
+              C_buf.data(),
+              block_n);
+          for (int64_t m = 0; m < m_size; m++) {
+            T* out_start = out + ids[m] * ldc + out_offset + n_start;
+            const float* c_start =
+                C_buf.data() + (broadcast_input ? 0 : m * block_n);
+            for (int64_t n = 0; n < n_size; n++) {
+              float val = c_start[n];
+              if (add_inputs) {
+                val += static_cast<float>(out_start[n]);
+              }
+              out_start[n] = static_cast<T>(val);
+            }
+          }
+        }
+      });
 }
 
 template <typename T>
@@ -94,19 +244,20 @@ void punica_bgmv_expand_slice_kernel(
   T* input_ptr = input.data_ptr<T>();
   T* weights_ptr = weights.data_ptr<T>();
   bool limit = (input.size(0) == 1 && batch_size != 0);
-
-#pragma omp parallel for collapse(2) schedule(static, 1)
-  for (int64_t bs = 0; bs < batch_size; bs++) {
-    for (int64_t h = 0; h < hidden_size; h++) {
-      int64_t input_bs = limit ? 0 : bs;
-      int64_t weights_offset =
-          indicies_ptr[bs] * max_rank * hidden_size + h * max_rank;
-      T* weight_start = weights_ptr + weights_offset;
-      T* input_start = input_ptr + input_bs * input_size1;
-      T* out_start = out_ptr + bs * output_size1 + h + slice_offset;
-      _dot<T, T>(input_start, weight_start, out_start, max_rank, 1, add_inputs);
-    }
-  }
+  auto segs = group_tokens_by_lora(indicies_ptr, batch_size, num_lora);
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      limit,
+      weights_ptr,
+      hidden_size,
+      max_rank,
+      out_ptr,
+      output_size1,
+      slice_offset,
+      1.f,
+      add_inputs);
 }
 
 template <typename T>
@@ -142,32 +293,28 @@ void punica_sgmv_expand_slice_kernel(
   T* input_ptr = input.data_ptr<T>();
   T* weights_ptr = weights.data_ptr<T>();
   bool limit = (input.size(0) == 1 && batch_size != 0);
-  int64_t max_seq_len = seq_lens.max().item<int64_t>();
-  int64_t* seq_lens_ptr = seq_lens.data_ptr<int64_t>();
-  at::Tensor offsets = seq_lens.cumsum(0);
-  int64_t* offsets_ptr = offsets.data_ptr<int64_t>();
-  int64_t num_seqs = seq_lens.size(0);
-
-#pragma omp parallel for collapse(3) schedule(static, 1)
-  for (int64_t seq_id = 0; seq_id < num_seqs; seq_id++) {
-    for (int64_t h = 0; h < hidden_size; h++) {
-      for (int64_t s = 0; s < max_seq_len; s++) {
-        if (s > seq_lens_ptr[seq_id]) {
-          continue;
-        }
-        int64_t offset = seq_id == 0 ? 0 : offsets_ptr[seq_id - 1];
-        int64_t bs = offset + s;
-        int64_t input_bs = limit ? 0 : bs;
-        int64_t weights_offset =
-            indicies_ptr[seq_id] * max_rank * hidden_size + h * max_rank;
-        T* weight_start = weights_ptr + weights_offset;
-        T* input_start = input_ptr + input_bs * input_size1;
-        T* out_start = out_ptr + bs * output_size1 + h + slice_offset;
-        _dot<T, T>(
-            input_start, weight_start, out_start, max_rank, 1, add_inputs);
-      }
-    }
-  }
+  auto seq_lens_c = seq_lens.contiguous();
+  auto segs = group_seqs_by_lora(
+      indicies_ptr,
+      seq_lens_c.data_ptr<int64_t>(),
+      seq_lens_c.size(0),
+      num_lora);
+  TORCH_CHECK(
+      segs.token_ids.empty() || segs.token_ids.back() < batch_size,
+      "sum of seq_lens exceeds the number of tokens");
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      limit,
+      weights_ptr,
+      hidden_size,
+      max_rank,
+      out_ptr,
+      output_size1,
+      slice_offset,
+      1.f,
+      add_inputs);
 }
 
 template <typename T>
@@ -195,19 +342,20 @@ void punica_bgmv_shrink_kernel(
   T* out_ptr = out.data_ptr<T>();
   T* input_ptr = input.data_ptr<T>();
   T* weights_ptr = weights.data_ptr<T>();
-
-#pragma omp parallel for collapse(2) schedule(static, 1)
-  for (int64_t bs = 0; bs < batch_size; bs++) {
-    for (int64_t r = 0; r < max_rank; r++) {
-      int64_t weights_offset =
-          indicies_ptr[bs] * max_rank * hidden_size + r * hidden_size;
-      T* weight_start = weights_ptr + weights_offset;
-      T* input_start = input_ptr + bs * input_size1;
-      T* out_start = out_ptr + bs * output_size1 + r;
-      _dot<T, T>(
-          input_start, weight_start, out_start, hidden_size, scale, false);
-    }
-  }
+  auto segs = group_tokens_by_lora(indicies_ptr, batch_size, num_lora);
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      false,
+      weights_ptr,
+      max_rank,
+      hidden_size,
+      out_ptr,
+      output_size1,
+      0,
+      scale,
+      false);
 }
 
 template <typename T>
@@ -236,31 +384,28 @@ void punica_sgmv_shrink_kernel(
   T* out_ptr = out.data_ptr<T>();
   T* input_ptr = input.data_ptr<T>();
   T* weights_ptr = weights.data_ptr<T>();
-  int64_t max_seq_len = seq_lens.max().item<int64_t>();
-  int64_t* seq_lens_ptr = seq_lens.data_ptr<int64_t>();
-  at::Tensor offsets = seq_lens.cumsum(0);
-  int64_t* offsets_ptr = offsets.data_ptr<int64_t>();
-  int64_t num_seqs = seq_lens.size(0);
-
-#pragma omp parallel for collapse(3) schedule(static, 1)
-  for (int64_t seq_id = 0; seq_id < num_seqs; seq_id++) {
-    for (int64_t r = 0; r < max_rank; r++) {
-      for (int64_t s = 0; s < max_seq_len; s++) {
-        if (s > seq_lens_ptr[seq_id]) {
-          continue;
-        }
-        int64_t offset = seq_id == 0 ? 0 : offsets_ptr[seq_id - 1];
-        int64_t bs = offset + s;
-        int64_t weights_offset =
-            indicies_ptr[seq_id] * max_rank * hidden_size + r * hidden_size;
-        T* weight_start = weights_ptr + weights_offset;
-        T* input_start = input_ptr + bs * input_size1;
-        T* out_start = out_ptr + bs * output_size1 + r;
-        _dot<T, T>(
-            input_start, weight_start, out_start, hidden_size, scale, false);
-      }
-    }
-  }
+  auto seq_lens_c = seq_lens.contiguous();
+  auto segs = group_seqs_by_lora(
+      indicies_ptr,
+      seq_lens_c.data_ptr<int64_t>(),
+      seq_lens_c.size(0),
+      num_lora);
+  TORCH_CHECK(
+      segs.token_ids.empty() || segs.token_ids.back() < batch_size,
+      "sum of seq_lens exceeds the number of tokens");
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      false,
+      weights_ptr,
+      max_rank,
+      hidden_size,
+      out_ptr,
+      output_size1,
+      0,
+      scale,
+      false);
 }
 
 template <typename T>
@@ -289,20 +434,20 @@ void punica_bgmv_expand_kernel(
   T* input_ptr = input.data_ptr<T>();
   T* weights_ptr = weights.data_ptr<T>();
   bool limit = (input.size(0) == 1 && batch_size != 0);
-
-#pragma omp parallel for collapse(2) schedule(static, 1)
-  for (int64_t bs = 0; bs < batch_size; bs++) {
-    for (int64_t r = 0; r < max_rank; r++) {
-      int64_t input_bs = limit ? 0 : bs;
-      int64_t weights_offset =
-          indicies_ptr[bs] * max_rank * hidden_size + r * hidden_size;
-      T* weight_start = weights_ptr + weights_offset;
-      T* input_start = input_ptr + input_bs * input_size1;
-      T* out_start = out_ptr + bs * output_size1 + r;
-      _dot<T, T>(
-          input_start, weight_start, out_start, hidden_size, 1, add_inputs);
-    }
-  }
+  auto segs = group_tokens_by_lora(indicies_ptr, batch_size, num_lora);
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      limit,
+      weights_ptr,
+      max_rank,
+      hidden_size,
+      out_ptr,
+      output_size1,
+      0,
+      1.f,
+      add_inputs);
 }
 
 template <typename T>
@@ -332,32 +477,94 @@ void punica_sgmv_expand_kernel(
   T* input_ptr = input.data_ptr<T>();
   T* weights_ptr = weights.data_ptr<T>();
   bool limit = (input.size(0) == 1 && batch_size != 0);
-  int64_t max_seq_len = seq_lens.max().item<int64_t>();
-  int64_t* seq_lens_ptr = seq_lens.data_ptr<int64_t>();
-  at::Tensor offsets = seq_lens.cumsum(0);
-  int64_t* offsets_ptr = offsets.data_ptr<int64_t>();
-  int64_t num_seqs = seq_lens.size(0);
+  auto seq_lens_c = seq_lens.contiguous();
+  auto segs = group_seqs_by_lora(
+      indicies_ptr,
+      seq_lens_c.data_ptr<int64_t>(),
+      seq_lens_c.size(0),
+      num_lora);
+  TORCH_CHECK(
+      segs.token_ids.empty() || segs.token_ids.back() < batch_size,
+      "sum of seq_lens exceeds the number of tokens");
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      limit,
+      weights_ptr,
+      max_rank,
+      hidden_size,
+      out_ptr,
+      output_size1,
+      0,
+      1.f,
+      add_inputs);
+}
 
-#pragma omp parallel for collapse(3) schedule(static, 1)
-  for (int64_t seq_id = 0; seq_id < num_seqs; seq_id++) {
-    for (int64_t r = 0; r < max_rank; r++) {
-      for (int64_t s = 0; s < max_seq_len; s++) {
-        if (s > seq_lens_ptr[seq_id]) {
-          continue;
-        }
-        int64_t offset = seq_id == 0 ? 0 : offsets_ptr[seq_id - 1];
-        int64_t bs = offset + s;
-        int64_t input_bs = limit ? 0 : bs;
-        int64_t weights_offset =
-            indicies_ptr[seq_id] * max_rank * hidden_size + r * hidden_size;
-        T* weight_start = weights_ptr + weights_offset;
-        T* input_start = input_ptr + input_bs * input_size1;
-        T* out_start = out_ptr + bs * output_size1 + r;
-        _dot<T, T>(
-            input_start, weight_start, out_start, hidden_size, 1, add_inputs);
-      }
-    }
-  }
+template <typename T>
+void punica_bgmv_shrink_expand_slice_kernel(
+    at::Tensor&
+        out, // [bs, output_size1] output_size1 >= slice_offset + slice_size
+    at::Tensor& input, // [bs, input_size1]  input_size1  >= hidden_size
+    at::Tensor& lora_a_weights, // [num_lora, max_rank, hidden_size]
+    at::Tensor& lora_b_weights, // [num_lora, slice_size, max_rank]
+    at::Tensor& indicies, // [bs]
+    const double scale,
+    int64_t slice_offset,
+    int64_t slice_size,
+    bool add_inputs) {
+  int64_t num_lora = lora_a_weights.size(0);
+  int64_t max_rank = lora_a_weights.size(1);
+  int64_t hidden_size = lora_a_weights.size(2);
+  int64_t batch_size = out.size(0);
+  int64_t output_size1 = out.size(1);
+  int64_t input_size1 = input.size(1);
+  TORCH_CHECK(input_size1 >= hidden_size);
+  TORCH_CHECK(lora_b_weights.size(0) == num_lora);
+  TORCH_CHECK(lora_b_weights.size(1) == slice_size);
+  TORCH_CHECK(lora_b_weights.size(2) == max_rank);
+  TORCH_CHECK(slice_offset >= 0);
+  TORCH_CHECK(output_size1 >= slice_offset + slice_size);
+  TORCH_CHECK(batch_size == input.size(0));
+  TORCH_CHECK(batch_size == indicies.size(0));
+  TORCH_CHECK(input.is_contiguous());
+  TORCH_CHECK(lora_a_weights.is_contiguous());
+  TORCH_CHECK(lora_b_weights.is_contiguous());
+  TORCH_CHECK(indicies.is_contiguous());
+  TORCH_CHECK(out.is_contiguous());
+  int64_t* indicies_ptr = indicies.data_ptr<int64_t>();
+  T* out_ptr = out.data_ptr<T>();
+  T* input_ptr = input.data_ptr<T>();
+  // the tokens are grouped once for both GEMMs, the rank-r intermediate is
+  // only bs x max_rank and stays in cache between them
+  auto segs = group_tokens_by_lora(indicies_ptr, batch_size, num_lora);
+  std::vector<T> buffer(batch_size * max_rank);
+  lora_grouped_gemm<T>(
+      segs,
+      input_ptr,
+      input_size1,
+      false,
+      lora_a_weights.data_ptr<T>(),
+      max_rank,
+      hidden_size,
+      buffer.data(),
+      max_rank,
+      0,
+      scale,
+      false);
+  lora_grouped_gemm<T>(
+      segs,
+      buffer.data(),
+      max_rank,
+      false,
+      lora_b_weights.data_ptr<T>(),
+      slice_size,
+      max_rank,
+      out_ptr,
+      output_size1,
+      slice_offset,
+      1.f,
+      add_inputs);
 }
 
 void punica_bgmv_shrink_kernel_impl(
@@ -548,6 +755,56 @@ void punica_sgmv_expand_slice_kernel_impl(
         add_inputs);
   }
 }
+
+void punica_bgmv_shrink_expand_slice_kernel_impl(
+    at::Tensor& out, // [bs, output_size1]
+    at::Tensor& input, // [bs, input_size1]  input_size1  >= hidden_size
+    at::Tensor& lora_a_weights, // [num_lora, max_rank, hidden_size]
+    at::Tensor& lora_b_weights, // [num_lora, slice_size, max_rank]
+    at::Tensor& indicies, // [bs]
+    const double scale,
+    int64_t slice_offset,
+    int64_t slice_size,
+    bool add_inputs) {
+  RECORD_FUNCTION(
+      "ipex::punica_bgmv_shrink_expand_slice_kernel_impl",
+      c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      lora_a_weights.scalar_type() == out.scalar_type() &&
+          lora_b_weights.scalar_type() == out.scalar_type(),
+      "dtype of weight and out must be same");
+  TORCH_CHECK(
+      input.scalar_type() == out.scalar_type(),
+      "dtype of input and out must be same");
+  TORCH_CHECK(out.dim() == 2, "out must be 2D");
+  TORCH_CHECK(input.dim() == 2, "input must be 2D");
+  TORCH_CHECK(lora_a_weights.dim() == 3, "lora_a_weights must be 3D");
+  TORCH_CHECK(lora_b_weights.dim() == 3, "lora_b_weights must be 3D");
+  TORCH_CHECK(indicies.dim() == 1, "indicies must be 1D");
+  if (out.scalar_type() == at::kBFloat16) {
+    punica_bgmv_shrink_expand_slice_kernel<at::BFloat16>(
+        out,
+        input,
+        lora_a_weights,
+        lora_b_weights,
+        indicies,
+        scale,
+        slice_offset,
+        slice_size,
+        add_inputs);
+  } else if (out.scalar_type() == at::kHalf) {
+    punica_bgmv_shrink_expand_slice_kernel<at::Half>(
+        out,
+        input,
+        lora_a_weights,
+        lora_b_weights,
+        indicies,
+        scale,
+        slice_offset,
+        slice_size,
+        add_inputs);
+  }
+}
 } // namespace
 
 IPEX_REGISTER_DISPATCH(
@@ -573,5 +830,9 @@ IPEX_REGISTER_DISPATCH(
 IPEX_REGISTER_DISPATCH(
     punica_sgmv_expand_slice_kernel_stub,
     &punica_sgmv_expand_slice_kernel_impl);
+
+IPEX_REGISTER_DISPATCH(
+    punica_bgmv_shrink_expand_slice_kernel_stub,
+    &punica_bgmv_shrink_expand_slice_kernel_impl);
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
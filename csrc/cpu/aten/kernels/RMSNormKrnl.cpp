@@ -1,6 +1,7 @@
 #include <aten/RMSNorm.h>
 
 #include <torch/csrc/autograd/function.h>
+#include "aten/utils/woq_defines.h"
 #include "vec/vec.h"
 
 namespace torch_ipex {
@@ -62,6 +63,58 @@ void AddRMSNormKernelImpl(
     }
   });
 }
+
+template <typename T, typename T1>
+void RMSNormDynamicQuantKernelImpl(
+    const at::Tensor& a,
+    const at::Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    float eps,
+    int64_t block_k,
+    at::Tensor& Y_q,
+    at::Tensor& scales,
+    at::Tensor& zps) {
+  DCHECK(a.numel() == M * N);
+  const T* a_data = a.data_ptr<T>();
+  const T1* gamma_data = gamma.defined() ? gamma.data_ptr<T1>() : nullptr;
+  const int64_t Kc = (N + block_k - 1) / block_k;
+  float* scales_data = scales.data_ptr<float>();
+  int32_t* zps_data = zps.defined() ? zps.data_ptr<int32_t>() : nullptr;
+  at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
+    // one normalized row at a time, it stays in cache until quantized
+    std::vector<T> buf(N);
+    for (const auto i : c10::irange(start, end)) {
+      const T* a_ptr = a_data + i * N;
+      float* scale_ptr = scales_data + i * Kc;
+      if (zps_data) {
+        uint8_t* Y_ptr = Y_q.data_ptr<uint8_t>() + i * N;
+        kernel::_compute_rmsnorm_and_quantize<T, T1, uint8_t>(
+            a_ptr,
+            N,
+            eps,
+            gamma_data,
+            block_k,
+            buf.data(),
+            Y_ptr,
+            scale_ptr,
+            zps_data + i * Kc);
+      } else {
+        int8_t* Y_ptr = Y_q.data_ptr<int8_t>() + i * N;
+        kernel::_compute_rmsnorm_and_quantize<T, T1, int8_t>(
+            a_ptr,
+            N,
+            eps,
+            gamma_data,
+            block_k,
+            buf.data(),
+            Y_ptr,
+            scale_ptr,
+            nullptr);
+      }
+    }
+  });
+}
 #endif
 
 at::Tensor rmsnorm_kernel_impl(
@@ -217,9 +270,136 @@ at::Tensor add_rmsnorm_kernel_impl(
 #endif
 }
 
+std::tuple<at::Tensor, at::Tensor, at::Tensor>
+rmsnorm_dynamic_quant_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& b,
+    float eps,
+    int64_t quant_a_mode,
+    int64_t quant_block_k) {
+  const bool per_m =
+      quant_a_mode == QUANT_A_PER_M || quant_a_mode == QUANT_A_PER_M_SYM;
+  // per-tensor and per-K-block modes reduce across rows and cannot be
+  // computed while normalizing one row at a time
+  TORCH_CHECK(
+      per_m || quant_a_mode == QUANT_A_PER_M_K_BLOCK ||
+          quant_a_mode == QUANT_A_PER_M_K_BLOCK_SYM,
+      "rmsnorm_dynamic_quant: only per-M and per-M-K-block activation "
+      "quantization can be fused, got quant_a_mode = ",
+      quant_a_mode);
+  TORCH_CHECK(
+      per_m || quant_block_k > 0,
+      "rmsnorm_dynamic_quant: quant_block_k must be positive for per-M-K-block "
+      "quantization");
+  const bool is_sym_quant = !is_asymmetric_quant_a(quant_a_mode);
+  const auto input_shape = input.sizes();
+  const int64_t N = input_shape.back();
+  const int64_t M = N > 0 ? input.numel() / N : 0;
+  const int64_t block_k = per_m ? N : std::min(quant_block_k, N);
+  const int64_t Kc = block_k > 0 ? (N + block_k - 1) / block_k : 0;
+#if defined(CPU_CAPABILITY_AVX512)
+  auto X = input.contiguous();
+  at::Tensor Y_q = at::empty(
+      input_shape, X.options().dtype(is_sym_quant ? at::kChar : at::kByte));
+  at::Tensor scales = per_m ? at::empty({M}, X.options().dtype(at::kFloat))
+                            : at::empty({M, Kc}, X.options().dtype(at::kFloat));
+  at::Tensor zps = is_sym_quant
+      ? at::Tensor()
+      : at::empty(scales.sizes(), X.options().dtype(at::kInt));
+  if (M == 0 || N == 0) {
+    return std::make_tuple(Y_q, scales, zps);
+  }
+  if (input.scalar_type() == at::ScalarType::Float &&
+      b.scalar_type() == at::ScalarType::Float) {
+    RMSNormDynamicQuantKernelImpl<float, float>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::Float &&
+      b.scalar_type() == at::ScalarType::BFloat16) {
+    RMSNormDynamicQuantKernelImpl<float, at::BFloat16>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::Float &&
+      b.scalar_type() == at::ScalarType::Half) {
+    RMSNormDynamicQuantKernelImpl<float, at::Half>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::BFloat16 &&
+      b.scalar_type() == at::ScalarType::Float) {
+    RMSNormDynamicQuantKernelImpl<at::BFloat16, float>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::BFloat16 &&
+      b.scalar_type() == at::ScalarType::BFloat16) {
+    RMSNormDynamicQuantKernelImpl<at::BFloat16, at::BFloat16>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::BFloat16 &&
+      b.scalar_type() == at::ScalarType::Half) {
+    RMSNormDynamicQuantKernelImpl<at::BFloat16, at::Half>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::Half &&
+      b.scalar_type() == at::ScalarType::Half) {
+    RMSNormDynamicQuantKernelImpl<at::Half, at::Half>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::Half &&
+      b.scalar_type() == at::ScalarType::BFloat16) {
+    RMSNormDynamicQuantKernelImpl<at::Half, at::BFloat16>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else if (
+      input.scalar_type() == at::ScalarType::Half &&
+      b.scalar_type() == at::ScalarType::Float) {
+    RMSNormDynamicQuantKernelImpl<at::Half, float>(
+        X, b, M, N, eps, block_k, Y_q, scales, zps);
+  } else {
+    TORCH_CHECK(false, "Unsupported input type");
+  }
+  return std::make_tuple(Y_q, scales, zps);
+#else
+  auto input1 = input.to(at::kFloat);
+  auto variance = at::mean(at::pow(input1, 2), -1, true);
+  auto hidden_states = at::rsqrt(at::add(variance, eps));
+  auto Y = at::mul(b, at::mul(input1, hidden_states))
+               .to(input.scalar_type())
+               .to(at::kFloat)
+               .reshape({M, N});
+  // zero padding does not change the range, which always includes zero
+  auto Y_blocked =
+      at::pad(Y, {0, Kc * block_k - N}, "constant", 0).view({M, Kc, block_k});
+  auto min = at::clamp_max(std::get<0>(Y_blocked.min(-1)), 0);
+  auto max = at::clamp_min(std::get<0>(Y_blocked.max(-1)), 0);
+  auto scales = is_sym_quant
+      ? at::maximum(at::absolute(max), at::absolute(min)) / 127.0f
+      : (max - min) / 255.0f;
+  scales.masked_fill_(scales == 0, 1.0f);
+  at::Tensor zps, Y_q;
+  if (is_sym_quant) {
+    Y_q = at::clamp(at::round(Y_blocked / scales.unsqueeze(-1)), -128, 127);
+  } else {
+    zps = -at::round(min / scales);
+    Y_q = at::clamp(
+        at::round(Y_blocked / scales.unsqueeze(-1)) + zps.unsqueeze(-1),
+        0,
+        255);
+    zps = per_m ? zps.view({M}).to(at::kInt) : zps.to(at::kInt);
+  }
+  Y_q = Y_q.view({M, Kc * block_k})
+            .narrow(1, 0, N)
+            .to(is_sym_quant ? at::kChar : at::kByte)
+            .reshape(input_shape);
+  scales = per_m ? scales.view({M}) : scales;
+  return std::make_tuple(Y_q, scales, zps);
+#endif
+}
+
 } // namespace
 
 IPEX_REGISTER_DISPATCH(rmsnorm_kernel_stub, &rmsnorm_kernel_impl);
 IPEX_REGISTER_DISPATCH(add_rmsnorm_kernel_stub, &add_rmsnorm_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    rmsnorm_dynamic_quant_kernel_stub,
+    &rmsnorm_dynamic_quant_kernel_impl);
 } // namespace cpu
 } // namespace torch_ipex
@@ -3,6 +3,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec/vec.h>
 #include <aten/ROIAlign.h>
+#include <aten/utils/mkl_gemm.h>
 #include <torch/library.h>
 #include "autocast/autocast_mode.h"
 #include "utils/library.h"
@@ -352,6 +353,72 @@ inline void roi_align_single_framework_channels_last_forward<
   } // for ph
 }
 
+// Computes the sampling grid, the averaging count and the bilinear weights of
+// one ROI for the forward pass. pre_calc is resized in place so that a thread
+// can reuse it across the ROIs it handles.
+template <typename ACC_T>
+inline void roi_align_forward_pre_calc(
+    const ACC_T* offset_rois,
+    const ACC_T& spatial_scale,
+    int64_t height,
+    int64_t width,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    int64_t& roi_bin_grid_h,
+    int64_t& roi_bin_grid_w,
+    ACC_T& count,
+    std::vector<PreCalc<ACC_T>>& pre_calc) {
+  // Do not using rounding; this implementation detail is critical
+  ACC_T offset = aligned ? (ACC_T)0.5 : (ACC_T)0.0;
+  ACC_T roi_start_w = offset_rois[1] * spatial_scale - offset;
+  ACC_T roi_start_h = offset_rois[2] * spatial_scale - offset;
+  ACC_T roi_end_w = offset_rois[3] * spatial_scale - offset;
+  ACC_T roi_end_h = offset_rois[4] * spatial_scale - offset;
+
+  ACC_T roi_width = roi_end_w - roi_start_w;
+  ACC_T roi_height = roi_end_h - roi_start_h;
+  if (!aligned) {
+    // Force malformed ROIs to be 1x1
+    roi_width = std::max(roi_width, (ACC_T)1.);
+    roi_height = std::max(roi_height, (ACC_T)1.);
+  }
+
+  ACC_T bin_size_h =
+      static_cast<ACC_T>(roi_height) / static_cast<ACC_T>(pooled_height);
+  ACC_T bin_size_w =
+      static_cast<ACC_T>(roi_width) / static_cast<ACC_T>(pooled_width);
+
+  // We use roi_bin_grid to sample the grid and mimic integral
+  roi_bin_grid_h = (sampling_ratio > 0)
+      ? sampling_ratio
+      : ceil(roi_height / pooled_height); // e.g., = 2
+  roi_bin_grid_w =
+      (sampling_ratio > 0) ? sampling_ratio : ceil(roi_width / pooled_width);
+
+  // We do average (integral) pooling inside a bin
+  // When the grid is empty, output zeros.
+  count = std::max(roi_bin_grid_h * roi_bin_grid_w, (int64_t)1); // e.g. = 4
+
+  // we want to precalculate indices and weights shared by all channels,
+  // this is the key point of optimization
+  pre_calc.resize(
+      roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
+  pre_calc_for_bilinear_interpolate(
+      height,
+      width,
+      pooled_height,
+      pooled_width,
+      roi_start_h,
+      roi_start_w,
+      bin_size_h,
+      bin_size_w,
+      roi_bin_grid_h,
+      roi_bin_grid_w,
+      pre_calc);
+}
+
 template <typename T, typename ACC_T>
 void roi_align_forward_kernel_body(
     int64_t n_rois,
@@ -370,58 +437,25 @@ void roi_align_forward_kernel_body(
   // (n, c, ph, pw) is an element in the pooled output
   // can be parallelized using omp
   at::parallel_for(0, n_rois, 1, [&](int64_t begin, int64_t end) {
+    std::vector<PreCalc<ACC_T>> pre_calc;
     for (int64_t n = begin; n < end; n++) {
       const ACC_T* offset_rois = rois + n * 5;
       int64_t roi_batch_ind = offset_rois[0];
 
-      // Do not using rounding; this implementation detail is critical
-      ACC_T offset = aligned ? (ACC_T)0.5 : (ACC_T)0.0;
-      ACC_T roi_start_w = offset_rois[1] * spatial_scale - offset;
-      ACC_T roi_start_h = offset_rois[2] * spatial_scale - offset;
-      ACC_T roi_end_w = offset_rois[3] * spatial_scale - offset;
-      ACC_T roi_end_h = offset_rois[4] * spatial_scale - offset;
-
-      ACC_T roi_width = roi_end_w - roi_start_w;
-      ACC_T roi_height = roi_end_h - roi_start_h;
-      if (!aligned) {
-        // Force malformed ROIs to be 1x1
-        roi_width = std::max(roi_width, (ACC_T)1.);
-        roi_height = std::max(roi_height, (ACC_T)1.);
-      }
-
-      ACC_T bin_size_h =
-          static_cast<ACC_T>(roi_height) / static_cast<ACC_T>(pooled_height);
-      ACC_T bin_size_w =
-          static_cast<ACC_T>(roi_width) / static_cast<ACC_T>(pooled_width);
-
-      // We use roi_bin_grid to sample the grid and mimic integral
-      int64_t roi_bin_grid_h = (sampling_ratio > 0)
-          ? sampling_ratio
-          : ceil(roi_height / pooled_height); // e.g., = 2
-      int64_t roi_bin_grid_w = (sampling_ratio > 0)
-          ? sampling_ratio
-          : ceil(roi_width / pooled_width);
-
-      // We do average (integral) pooling inside a bin
-      // When the grid is empty, output zeros.
-      const ACC_T count =
-          std::max(roi_bin_grid_h * roi_bin_grid_w, (int64_t)1); // e.g. = 4
-
-      // we want to precalculate indices and weights shared by all channels,
-      // this is the key point of optimization
-      std::vector<PreCalc<ACC_T>> pre_calc(
-          roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
-      pre_calc_for_bilinear_interpolate(
+      int64_t roi_bin_grid_h, roi_bin_grid_w;
+      ACC_T count;
+      roi_align_forward_pre_calc<ACC_T>(
+          offset_rois,
+          spatial_scale,
           height,
           width,
           pooled_height,
           pooled_width,
-          roi_start_h,
-          roi_start_w,
-          bin_size_h,
-          bin_size_w,
+          sampling_ratio,
+          aligned,
           roi_bin_grid_h,
           roi_bin_grid_w,
+          count,
           pre_calc);
 
       if (is_channels_last) {
@@ -455,6 +489,187 @@ void roi_align_forward_kernel_body(
   });
 }
 
+// Bilinear pooling of one channels last ROI written in the flattened NCHW
+// order (c * ph * pw + p) expected by the following linear layer. The bins are
+// accumulated over all the channels at once with the weights of pre_calc, then
+// scattered into the GEMM input row.
+template <typename T, typename ACC_T>
+inline void roi_align_single_framework_channels_last_forward_to_row(
+    const T* input,
+    const ACC_T count,
+    int64_t channels,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t roi_bin_grid_h,
+    int64_t roi_bin_grid_w,
+    const std::vector<PreCalc<ACC_T>>& pre_calc,
+    ACC_T* sum,
+    T* row) {
+  const int64_t pooled_size = pooled_height * pooled_width;
+  int64_t pre_calc_index = 0;
+  for (int64_t p = 0; p < pooled_size; p++) {
+    std::fill(sum, sum + channels, ACC_T(0));
+    for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
+      for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
+        PreCalc<ACC_T> pc = pre_calc[pre_calc_index];
+        const T* in1 = input + pc.pos1 * channels;
+        const T* in2 = input + pc.pos2 * channels;
+        const T* in3 = input + pc.pos3 * channels;
+        const T* in4 = input + pc.pos4 * channels;
+#pragma omp simd
+        for (int64_t c = 0; c < channels; c++) {
+          sum[c] += pc.w1 * static_cast<ACC_T>(in1[c]) +
+              pc.w2 * static_cast<ACC_T>(in2[c]) +
+              pc.w3 * static_cast<ACC_T>(in3[c]) +
+              pc.w4 * static_cast<ACC_T>(in4[c]);
+        }
+        pre_calc_index += 1;
+      }
+    }
+    for (int64_t c = 0; c < channels; c++) {
+      row[c * pooled_size + p] = static_cast<T>(sum[c] / count);
+    }
+  }
+}
+
+// ROIs pooled per GEMM of the fused ROIAlign + linear, the MKL packed weight
+// is packed for exactly this M
+constexpr int64_t kRoiAlignLinearTile = 32;
+
+template <typename T>
+at::Tensor roi_align_linear_pack_weight(const at::Tensor& weight) {
+  auto out_features = weight.size(0), in_features = weight.size(1);
+  auto packed_weight = at::empty(
+      _mkl_gemm_pack_b_size<T>(kRoiAlignLinearTile, out_features, in_features),
+      weight.options().dtype(at::kByte));
+  _mkl_gemm_pack_b(
+      kRoiAlignLinearTile,
+      out_features,
+      in_features,
+      weight.data_ptr<T>(),
+      packed_weight.data_ptr());
+  return packed_weight;
+}
+
+/*
+ ROIAlign followed by the first linear layer of the box head,
+ i.e. linear(roi_align(input, rois).flatten(1), weight, bias).
+
+ Every thread pools kRoiAlignLinearTile ROIs at a time straight into the
+ rows of its own row-major (tile, C * ph * pw) tile, which is the A operand
+ of the GEMM, then multiplies the tile with the MKL packed weight and applies
+ bias and relu while writing the output rows. Neither the pooled
+ [num_rois, C, ph, pw] tensor nor a [num_rois, out_features] accumulator is
+ ever materialized. The last tile is zero padded so that every GEMM has the
+ M the weight was packed for.
+*/
+template <typename T, typename ACC_T>
+void roi_align_linear_forward_kernel_body(
+    int64_t n_rois,
+    const T* input,
+    const ACC_T& spatial_scale,
+    int64_t channels,
+    int64_t height,
+    int64_t width,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    const ACC_T* rois,
+    const void* packed_weight,
+    const T* bias,
+    int64_t out_features,
+    bool fuse_relu,
+    T* output,
+    bool is_channels_last) {
+  const int64_t pooled_size = pooled_height * pooled_width;
+  const int64_t in_features = channels * pooled_size;
+  const int64_t n_tiles =
+      (n_rois + kRoiAlignLinearTile - 1) / kRoiAlignLinearTile;
+  at::parallel_for(0, n_tiles, 1, [&](int64_t begin, int64_t end) {
+    std::vector<PreCalc<ACC_T>> pre_calc;
+    std::vector<ACC_T> sum(is_channels_last ? channels : 0);
+    std::vector<T> tile(kRoiAlignLinearTile * in_features);
+    std::vector<ACC_T> acc(kRoiAlignLinearTile * out_features);
+    for (int64_t t = begin; t < end; t++) {
+      const int64_t n_begin = t * kRoiAlignLinearTile;
+      const int64_t rows = std::min(kRoiAlignLinearTile, n_rois - n_begin);
+      for (int64_t r = 0; r < rows; r++) {
+        const ACC_T* offset_rois = rois + (n_begin + r) * 5;
+        int64_t roi_batch_ind = offset_rois[0];
+
+        int64_t roi_bin_grid_h, roi_bin_grid_w;
+        ACC_T count;
+        roi_align_forward_pre_calc<ACC_T>(
+            offset_rois,
+            spatial_scale,
+            height,
+            width,
+            pooled_height,
+            pooled_width,
+            sampling_ratio,
+            aligned,
+            roi_bin_grid_h,
+            roi_bin_grid_w,
+            count,
+            pre_calc);
+
+        if (is_channels_last) {
+          roi_align_single_framework_channels_last_forward_to_row<T, ACC_T>(
+              input + roi_batch_ind * height * width * channels,
+              count,
+              channels,
+              pooled_height,
+              pooled_width,
+              roi_bin_grid_h,
+              roi_bin_grid_w,
+              pre_calc,
+              sum.data(),
+              tile.data() + r * in_features);
+        } else {
+          // the NCHW pooled layout of one ROI already is the flattened row
+          roi_align_single_framework_forward<T, ACC_T>(
+              input + roi_batch_ind * channels * height * width,
+              count,
+              channels,
+              height,
+              width,
+              pooled_height,
+              pooled_width,
+              roi_bin_grid_h,
+              roi_bin_grid_w,
+              pre_calc,
+              tile.data() + r * in_features);
+        }
+      }
+      std::fill(tile.begin() + rows * in_features, tile.end(), T(0));
+
+      _mkl_gemm_compute_packed_b(
+          kRoiAlignLinearTile,
+          out_features,
+          in_features,
+          tile.data(),
+          packed_weight,
+          acc.data());
+
+      for (int64_t r = 0; r < rows; r++) {
+        const ACC_T* acc_row = acc.data() + r * out_features;
+        T* out_row = output + (n_begin + r) * out_features;
+        for (int64_t o = 0; o < out_features; o++) {
+          ACC_T val = acc_row[o];
+          if (bias != nullptr) {
+            val += static_cast<ACC_T>(bias[o]);
+          }
+          if (fuse_relu) {
+            val = std::max(val, ACC_T(0));
+          }
+          out_row[o] = static_cast<T>(val);
+        }
+      }
+    }
+  });
+}
+
 template <class T>
 inline void add(T* address, const T& val) {
   *address += val;
@@ -723,6 +938,114 @@ at::Tensor roi_align_forward_kernel_impl(
   return output;
 }
 
+at::Tensor roi_align_linear_forward_kernel_impl(
+    const at::Tensor& input,
+    const at::Tensor& rois,
+    double spatial_scale,
+    int64_t pooled_height,
+    int64_t pooled_width,
+    int64_t sampling_ratio,
+    bool aligned,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    bool fuse_relu,
+    const c10::optional<at::Tensor>& packed_weight) {
+  TORCH_CHECK(input.device().is_cpu(), "input must be a CPU tensor");
+  TORCH_CHECK(rois.device().is_cpu(), "rois must be a CPU tensor");
+  TORCH_CHECK(rois.size(1) == 5, "rois must have shape as Tensor[K, 5]");
+  TORCH_CHECK(
+      weight.dim() == 2 &&
+          weight.size(1) == input.size(1) * pooled_height * pooled_width,
+      "weight must have shape as Tensor[out_features, C * ph * pw]");
+  TORCH_CHECK(
+      weight.scalar_type() == input.scalar_type(),
+      "weight should have the same type as input");
+  TORCH_CHECK(
+      input.scalar_type() != at::ScalarType::Half,
+      "ROIAlign_linear_forward does not support Half");
+
+  auto num_rois = rois.size(0);
+  auto channels = input.size(1);
+  auto height = input.size(2);
+  auto width = input.size(3);
+  auto out_features = weight.size(0);
+
+  at::Tensor output = at::empty({num_rois, out_features}, input.options());
+  if (output.numel() == 0)
+    return output;
+
+  auto memory_format = input.suggest_memory_format();
+  bool is_channels_last = memory_format == at::MemoryFormat::ChannelsLast;
+  auto input_ = input.contiguous(memory_format), rois_ = rois.contiguous();
+  at::Tensor bias_;
+  if (bias.has_value() && bias.value().defined()) {
+    TORCH_CHECK(
+        bias.value().numel() == out_features,
+        "bias must have out_features elements");
+    bias_ = bias.value().contiguous().to(input.scalar_type());
+  }
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16,
+      input.scalar_type(),
+      "roi_align_linear_forward_kernel_impl",
+      [&] {
+        using accscalar_t = typename AccType<scalar_t>::type;
+        // without a weight from ROIAlign_linear_prepack, pack it for this call
+        at::Tensor packed_weight_;
+        if (packed_weight.has_value() && packed_weight.value().defined()) {
+          packed_weight_ = packed_weight.value();
+          TORCH_CHECK(
+              packed_weight_.scalar_type() == at::kByte &&
+                  packed_weight_.is_contiguous() &&
+                  packed_weight_.numel() ==
+                      (int64_t)_mkl_gemm_pack_b_size<scalar_t>(
+                          kRoiAlignLinearTile,
+                          out_features,
+                          weight.size(1)),
+              "packed_weight is not from ROIAlign_linear_prepack");
+        } else {
+          packed_weight_ =
+              roi_align_linear_pack_weight<scalar_t>(weight.contiguous());
+        }
+        roi_align_linear_forward_kernel_body<scalar_t, accscalar_t>(
+            num_rois,
+            input_.data_ptr<scalar_t>(),
+            spatial_scale,
+            channels,
+            height,
+            width,
+            pooled_height,
+            pooled_width,
+            sampling_ratio,
+            aligned,
+            rois_.data_ptr<accscalar_t>(),
+            packed_weight_.data_ptr(),
+            bias_.defined() ? bias_.data_ptr<scalar_t>() : nullptr,
+            out_features,
+            fuse_relu,
+            output.data_ptr<scalar_t>(),
+            is_channels_last);
+      });
+  return output;
+}
+
+at::Tensor roi_align_linear_prepack_kernel_impl(const at::Tensor& weight) {
+  TORCH_CHECK(weight.dim() == 2, "weight must have shape as Tensor[N, K]");
+  TORCH_CHECK(
+      weight.scalar_type() != at::ScalarType::Half,
+      "ROIAlign_linear_prepack does not support Half");
+  at::Tensor packed_weight;
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16,
+      weight.scalar_type(),
+      "roi_align_linear_prepack_kernel_impl",
+      [&] {
+        packed_weight =
+            roi_align_linear_pack_weight<scalar_t>(weight.contiguous());
+      });
+  return packed_weight;
+}
+
 at::Tensor roi_align_backward_kernel_impl(
     const at::Tensor& grad,
     const at::Tensor& rois,
@@ -792,6 +1115,12 @@ IPEX_REGISTER_DISPATCH(
 IPEX_REGISTER_DISPATCH(
     roi_align_backward_kernel_stub,
     &roi_align_backward_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    roi_align_linear_forward_kernel_stub,
+    &roi_align_linear_forward_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    roi_align_linear_prepack_kernel_stub,
+    &roi_align_linear_prepack_kernel_impl);
 
 } // namespace cpu
 } // namespace torch_ipex
@@ -664,6 +664,180 @@ std::tuple<at::Tensor, at::Tensor> ApplyDeepseekROPEV2Kernel(
   return std::make_tuple(query, key);
 }
 
+// Store `len` elements of the rotated key or of the value into one slot of
+// the KV cache, same conversion as reshape_and_cache does for the cache dtype.
+template <typename cache_t, typename T>
+inline void store_to_kv_cache(const T* src, cache_t* dst, int64_t len) {
+  torch_ipex::cpu::kernel::move_ker<cache_t, T>(dst, src, len);
+}
+
+template <>
+inline void store_to_kv_cache<at::Float8_e5m2, float>(
+    const float* src,
+    at::Float8_e5m2* dst,
+    int64_t len) {
+#if defined(CPU_CAPABILITY_AVX512)
+  torch_ipex::cpu::kernel::cvt_fp32_e5m2_rne_intrinsic(src, dst, len);
+#else
+  for (int64_t i = 0; i < len; i++) {
+    dst[i] = static_cast<at::Float8_e5m2>(src[i]);
+  }
+#endif
+}
+
+template <>
+inline void store_to_kv_cache<at::Float8_e5m2, at::BFloat16>(
+    const at::BFloat16* src,
+    at::Float8_e5m2* dst,
+    int64_t len) {
+#if defined(CPU_CAPABILITY_AVX512)
+  torch_ipex::cpu::kernel::cvt_bf16_e5m2_rne_intrinsic(src, dst, len);
+#else
+  for (int64_t i = 0; i < len; i++) {
+    dst[i] = static_cast<at::Float8_e5m2>(src[i]);
+  }
+#endif
+}
+
+// Rotate the first rotary_dim elements of one head and copy the rest
+template <typename T>
+inline void rotate_head(
+    T* in_ptr,
+    T* out_ptr,
+    float* sin_start,
+    float* cos_start,
+    int64_t H,
+    int64_t HR,
+    int64_t offset,
+    int64_t rotary_dim) {
+  if (offset != 1) {
+    torch_ipex::cpu::kernel::apply_rope_along_head_kernel<T>(
+        in_ptr, out_ptr, cos_start, sin_start, rotary_dim, offset);
+  } else {
+    RotateEveryTwo<T>(
+        in_ptr,
+        nullptr,
+        out_ptr,
+        nullptr,
+        sin_start,
+        cos_start,
+        HR,
+        offset,
+        /* calc_key */ false);
+  }
+  if (rotary_dim < H) {
+    torch_ipex::cpu::kernel::move_ker<T, T>(
+        out_ptr + rotary_dim, in_ptr + rotary_dim, H - rotary_dim);
+  }
+}
+
+/**
+ * Applies the Rotary Position Embedding to the output of a fused QKV
+ * projection and stores the rotated key and the value directly into their
+ * slots of the paged KV cache, instead of materializing key/value and copying
+ * them with reshape_and_cache afterwards.
+ *
+ * @param t_in The fused qkv tensor [T][F], T tokens with
+ * F = (N + 2 * N_KV) * H. Rows may be strided, e.g. the output of a linear
+ * with a padded N narrowed to F.
+ * @param t_emb_pos The rotary position embeddings [MP][HR], sin then cos.
+ * @param t_pos The position of each token [T].
+ * @param key_cache The key cache [num_blocks][N_KV][block_size][H].
+ * @param value_cache The value cache [num_blocks][N_KV][block_size][H].
+ * @param slot_mapping The cache slot of each token [T] in int32.
+ * @param query The output query [T][N][H].
+ */
+template <typename T, typename cache_t>
+void ApplyROPEAndCacheKernel(
+    at::Tensor& t_in,
+    at::Tensor& t_emb_pos,
+    at::Tensor& t_pos,
+    int64_t N, // N: number of head, H: head size
+    int64_t H,
+    int64_t offset,
+    int64_t rotary_dim,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& slot_mapping,
+    at::Tensor& query) {
+  auto num_tokens = t_in.size(0);
+  auto F = t_in.size(1);
+  auto in_stride_t = t_in.stride(0);
+  auto N_KV = (F - N * H) / (2 * H);
+  auto HR = t_emb_pos.size(1);
+  auto COFF = HR / 2;
+  auto block_size = key_cache.size(2);
+  auto cache_strideN = key_cache.stride(0);
+  auto cache_strideH = key_cache.stride(1);
+  auto cache_strideP = key_cache.stride(2);
+  auto in_ptr = t_in.data_ptr<T>();
+  auto emb_pos_ptr = t_emb_pos.data_ptr<float>();
+  auto pos_ptr = t_pos.data_ptr<long>();
+  auto slot_mapping_ptr = slot_mapping.data_ptr<int>();
+  auto query_ptr = query.data_ptr<T>();
+  auto key_cache_ptr = key_cache.data_ptr<cache_t>();
+  auto value_cache_ptr = value_cache.data_ptr<cache_t>();
+  constexpr bool rotate_in_cache = std::is_same<T, cache_t>::value;
+  at::parallel_for(0, num_tokens * N, 1, [&](int64_t start, int64_t end) {
+    // the rotated key only goes through this buffer if it must be converted
+    std::vector<T> key_buf(rotate_in_cache ? 0 : H);
+    for (int64_t i = start; i < end; i++) {
+      auto ti = i / N;
+      auto n = i % N;
+      auto in_offset_q = ti * in_stride_t + n * H;
+      auto p = pos_ptr[ti];
+      float* sin_start = emb_pos_ptr + p * HR;
+      float* cos_start = emb_pos_ptr + p * HR + COFF;
+      rotate_head<T>(
+          in_ptr + in_offset_q,
+          query_ptr + (ti * N + n) * H,
+          sin_start,
+          cos_start,
+          H,
+          HR,
+          offset,
+          rotary_dim);
+      if (n >= N_KV) {
+        continue;
+      }
+      auto slot = slot_mapping_ptr[ti];
+      if (slot < 0) {
+        // padding token, nothing to cache
+        continue;
+      }
+      auto cache_offset = slot / block_size * cache_strideN +
+          n * cache_strideH + slot % block_size * cache_strideP;
+      auto in_offset_k = ti * in_stride_t + N * H + n * H;
+      auto in_offset_v = in_offset_k + N_KV * H;
+      if constexpr (rotate_in_cache) {
+        rotate_head<T>(
+            in_ptr + in_offset_k,
+            key_cache_ptr + cache_offset,
+            sin_start,
+            cos_start,
+            H,
+            HR,
+            offset,
+            rotary_dim);
+      } else {
+        rotate_head<T>(
+            in_ptr + in_offset_k,
+            key_buf.data(),
+            sin_start,
+            cos_start,
+            H,
+            HR,
+            offset,
+            rotary_dim);
+        store_to_kv_cache<cache_t, T>(
+            key_buf.data(), key_cache_ptr + cache_offset, H);
+      }
+      store_to_kv_cache<cache_t, T>(
+          in_ptr + in_offset_v, value_cache_ptr + cache_offset, H);
+    }
+  });
+}
+
 std::tuple<at::Tensor, at::Tensor, at::Tensor>
 rotary_position_embedding_kernel_impl(
     at::Tensor& t_in,
@@ -762,6 +936,129 @@ rotary_position_embedding_deepseek_v2_kernel_impl(
     return std::make_tuple(at::Tensor(), at::Tensor());
   }
 }
+
+void rotary_position_embedding_cache_kernel_impl(
+    at::Tensor& t_in,
+    at::Tensor& t_emb_pos,
+    at::Tensor& t_pos,
+    int64_t N, // N: number of head, H: head size
+    int64_t H,
+    int64_t offset,
+    int64_t rotary_dim,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& slot_mapping,
+    double k_scale,
+    double v_scale,
+    at::Tensor& query) {
+  TORCH_CHECK(
+      t_in.dim() == 2 && t_in.stride(1) == 1,
+      "rotary_position_embedding_cache: expect qkv in "
+      "(num_tokens, qkv_hidden_size) with contiguous rows");
+  TORCH_CHECK(
+      t_in.size(1) > N * H && (t_in.size(1) - N * H) % (2 * H) == 0,
+      "rotary_position_embedding_cache: qkv hidden size ",
+      t_in.size(1),
+      " does not match ",
+      N,
+      " query heads of size ",
+      H);
+  TORCH_CHECK(
+      key_cache.scalar_type() == value_cache.scalar_type(),
+      "key_cache and value_cache should have the same data type");
+  TORCH_CHECK(
+      key_cache.size(1) == (t_in.size(1) - N * H) / (2 * H) &&
+          key_cache.size(3) == H,
+      "rotary_position_embedding_cache: expect KV cache in "
+      "(num_blocks, num_kv_heads, block_size, head_size)");
+  TORCH_CHECK(
+      t_pos.numel() == t_in.size(0) && slot_mapping.numel() == t_in.size(0),
+      "rotary_position_embedding_cache: expect one position and one slot per "
+      "token");
+  TORCH_CHECK(
+      query.is_contiguous() && query.scalar_type() == t_in.scalar_type(),
+      "rotary_position_embedding_cache: unexpected query output");
+  t_emb_pos = t_emb_pos.contiguous();
+  t_pos = t_pos.contiguous();
+  slot_mapping = slot_mapping.contiguous();
+  // k_scale/v_scale are not applied, same as reshape_and_cache
+  auto in_dtype = t_in.scalar_type();
+  auto cache_dtype = key_cache.scalar_type();
+  if (cache_dtype == at::kFloat8_e5m2 && in_dtype == at::kFloat) {
+    ApplyROPEAndCacheKernel<float, at::Float8_e5m2>(
+        t_in,
+        t_emb_pos,
+        t_pos,
+        N,
+        H,
+        offset,
+        rotary_dim,
+        key_cache,
+        value_cache,
+        slot_mapping,
+        query);
+  } else if (cache_dtype == at::kFloat8_e5m2 && in_dtype == at::kBFloat16) {
+    ApplyROPEAndCacheKernel<at::BFloat16, at::Float8_e5m2>(
+        t_in,
+        t_emb_pos,
+        t_pos,
+        N,
+        H,
+        offset,
+        rotary_dim,
+        key_cache,
+        value_cache,
+        slot_mapping,
+        query);
+  } else if (cache_dtype == at::kFloat && in_dtype == at::kFloat) {
+    ApplyROPEAndCacheKernel<float, float>(
+        t_in,
+        t_emb_pos,
+        t_pos,
+        N,
+        H,
+        offset,
+        rotary_dim,
+        key_cache,
+        value_cache,
+        slot_mapping,
+        query);
+  } else if (cache_dtype == at::kBFloat16 && in_dtype == at::kBFloat16) {
+    ApplyROPEAndCacheKernel<at::BFloat16, at::BFloat16>(
+        t_in,
+        t_emb_pos,
+        t_pos,
+        N,
+        H,
+        offset,
+        rotary_dim,
+        key_cache,
+        value_cache,
+        slot_mapping,
+        query);
+  } else if (cache_dtype == at::kHalf && in_dtype == at::kHalf) {
+    ApplyROPEAndCacheKernel<at::Half, at::Half>(
+        t_in,
+        t_emb_pos,
+        t_pos,
+        N,
+        H,
+        offset,
+        rotary_dim,
+        key_cache,
+        value_cache,
+        slot_mapping,
+        query);
+  } else {
+    TORCH_CHECK(
+        false,
+        "rotary_position_embedding_cache_kernel_impl: unsupported qkv dtype '",
+        in_dtype,
+        "' with KV cache dtype '",
+        cache_dtype,
+        "'");
+  }
+}
 } // anonymous namespace
 
 IPEX_REGISTER_DISPATCH(
@@ -774,6 +1071,9 @@ IPEX_REGISTER_DISPATCH(
 IPEX_REGISTER_DISPATCH(
     rotary_position_embedding_deepseek_v2_kernel_stub,
     &rotary_position_embedding_deepseek_v2_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    rotary_position_embedding_cache_kernel_stub,
+    &rotary_position_embedding_cache_kernel_impl);
 
 } // namespace cpu
 } // namespace torch_ipex
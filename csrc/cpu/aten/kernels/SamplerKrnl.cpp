@@ -0,0 +1,291 @@
+#include <ATen/Parallel.h>
+#include <aten/Sampler.h>
+#include <torch/all.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "vec/vec.h"
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// [NOTE]: Fused decoding sampler
+//
+//   Replaces the chain of logits processors of HF `generate(do_sample=True)`:
+//   repetition penalty -> temperature -> top-k -> top-p -> softmax ->
+//   multinomial, for one row of logits:
+//     1. convert the logits to float and penalize the seen tokens in place
+//     2. e = exp((x - max) / temperature) in place, with its sum and a
+//        histogram of e over the top bits of its float representation
+//     3. the histogram gives the bucket in which the k-th largest e, or the
+//        top_p mass, is reached; only e above that bucket are collected,
+//        sorted and cut exactly by top_k and top_p (radix select); like
+//        HF, top_k also keeps the tokens tied with the k-th largest
+//     4. the token is sampled from the kept mass with one uniform number
+//   Without top_k / top_p, step 3 is skipped and 4 scans the whole row.
+//
+// e is in [0, 1], so the bits of a positive float are monotonic in e and
+// bits >> 19 (8 exponent + 4 mantissa bits) fit in 2048 buckets.
+constexpr int kHistShift = 19;
+constexpr int kHistSize = 2048;
+
+inline int hist_bucket(float e) {
+  uint32_t bits;
+  std::memcpy(&bits, &e, sizeof(bits));
+  return bits >> kHistShift;
+}
+
+inline float bucket_lower_bound(int bucket) {
+  uint32_t bits = static_cast<uint32_t>(bucket) << kHistShift;
+  float e;
+  std::memcpy(&e, &bits, sizeof(e));
+  return e;
+}
+
+// HF RepetitionPenaltyLogitsProcessor, applied once per seen token: the
+// penalized value only depends on the original logit, so duplicates in
+// input_ids just write the same value again.
+template <typename scalar_t>
+inline void apply_repetition_penalty(
+    float* __restrict__ x,
+    const scalar_t* __restrict__ logits,
+    const int64_t* __restrict__ ids,
+    int64_t num_ids,
+    int64_t vocab_size,
+    float penalty) {
+  for (int64_t i = 0; i < num_ids; ++i) {
+    int64_t id = ids[i];
+    if (id < 0 || id >= vocab_size) {
+      continue;
+    }
+    float v = static_cast<float>(logits[id]);
+    x[id] = v < 0 ? v * penalty : v / penalty;
+  }
+}
+
+inline int64_t argmax_stub(const float* __restrict__ x, int64_t size) {
+  int64_t best = 0;
+  for (int64_t i = 1; i < size; ++i) {
+    if (x[i] > x[best]) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+template <typename scalar_t>
+int64_t sample_row(
+    const scalar_t* __restrict__ logits,
+    int64_t vocab_size,
+    const int64_t* __restrict__ ids,
+    int64_t num_ids,
+    float temperature,
+    float repetition_penalty,
+    int64_t top_k,
+    float top_p,
+    double u) {
+  using Vec = at::vec::Vectorized<float>;
+  static thread_local std::vector<float> buf;
+  static thread_local std::vector<std::pair<float, int64_t>> candidates;
+  buf.resize(vocab_size);
+  float* __restrict__ x = buf.data();
+  // 1. logits in float, with the repetition penalty
+  at::vec::convert(logits, x, vocab_size);
+  if (ids != nullptr && repetition_penalty != 1.f) {
+    apply_repetition_penalty(
+        x, logits, ids, num_ids, vocab_size, repetition_penalty);
+  }
+  if (temperature <= 0.f) {
+    return argmax_stub(x, vocab_size);
+  }
+  // 2. e = exp((x - max) / temperature), its sum and histogram
+  const float x_max = at::vec::reduce_all<float>(
+      [](Vec& a, Vec& b) { return at::vec::maximum(a, b); }, x, vocab_size);
+  const bool filter_k = top_k > 0 && top_k < vocab_size;
+  const bool filter_p = top_p < 1.f;
+  const bool need_mass = filter_p && !filter_k;
+  int64_t hist_count[kHistSize];
+  float hist_mass[kHistSize];
+  if (filter_k || filter_p) {
+    std::fill_n(hist_count, kHistSize, 0);
+    std::fill_n(hist_mass, kHistSize, 0.f);
+  }
+  const Vec vmax(x_max);
+  const Vec vrt(1.f / temperature);
+  Vec vsum(0.f);
+  int64_t d = 0;
+  for (; d <= vocab_size - Vec::size(); d += Vec::size()) {
+    Vec e = ((Vec::loadu(x + d) - vmax) * vrt).exp_u20();
+    e.store(x + d);
+    vsum += e;
+    if (filter_k || filter_p) {
+      for (int j = 0; j < Vec::size(); ++j) {
+        int b = hist_bucket(x[d + j]);
+        hist_count[b]++;
+        if (need_mass) {
+          hist_mass[b] += x[d + j];
+        }
+      }
+    }
+  }
+  float sum = at::vec::vec_reduce_all<float>(
+      [](Vec& a, Vec& b) { return a + b; }, vsum);
+  for (; d < vocab_size; ++d) {
+    x[d] = std::exp((x[d] - x_max) / temperature);
+    sum += x[d];
+    if (filter_k || filter_p) {
+      int b = hist_bucket(x[d]);
+      hist_count[b]++;
+      if (need_mass) {
+        hist_mass[b] += x[d];
+      }
+    }
+  }
+  if (!filter_k && !filter_p) {
+    // 4. sample from the whole row
+    const double target = u * sum;
+    double cum = 0;
+    int64_t last = 0;
+    for (int64_t i = 0; i < vocab_size; ++i) {
+      if (x[i] > 0.f) {
+        cum += x[i];
+        last = i;
+        if (cum > target) {
+          return i;
+        }
+      }
+    }
+    return last;
+  }
+  // 3. radix select: the highest bucket whose suffix holds top_k tokens or
+  // top_p of the mass, everything above its lower bound is a candidate
+  int cut = 0;
+  int64_t count = 0;
+  float mass = 0.f;
+  for (int b = kHistSize - 1; b >= 0; --b) {
+    count += hist_count[b];
+    mass += hist_mass[b];
+    if ((filter_k && count >= top_k) || (need_mass && mass >= top_p * sum)) {
+      cut = b;
+      break;
+    }
+  }
+  const float threshold = bucket_lower_bound(cut);
+  candidates.clear();
+  for (int64_t i = 0; i < vocab_size; ++i) {
+    if (x[i] >= threshold) {
+      candidates.emplace_back(x[i], i);
+    }
+  }
+  auto by_prob = [](const std::pair<float, int64_t>& a,
+                    const std::pair<float, int64_t>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  int64_t num_kept = candidates.size();
+  if (filter_k && num_kept > top_k) {
+    std::partial_sort(
+        candidates.begin(),
+        candidates.begin() + top_k,
+        candidates.end(),
+        by_prob);
+    // HF TopKLogitsWarper only removes tokens below the k-th largest
+    const float kth = candidates[top_k - 1].first;
+    auto ties_end = std::partition(
+        candidates.begin() + top_k,
+        candidates.end(),
+        [kth](const std::pair<float, int64_t>& c) { return c.first == kth; });
+    std::sort(candidates.begin() + top_k, ties_end, by_prob);
+    num_kept = ties_end - candidates.begin();
+  } else {
+    std::sort(candidates.begin(), candidates.end(), by_prob);
+  }
+  // top_p over the mass left by top_k, keeping at least one token
+  float kept_mass = 0.f;
+  if (filter_p) {
+    float total = filter_k ? 0.f : sum;
+    if (filter_k) {
+      for (int64_t i = 0; i < num_kept; ++i) {
+        total += candidates[i].first;
+      }
+    }
+    int64_t i = 0;
+    for (; i < num_kept && (i == 0 || kept_mass < top_p * total); ++i) {
+      kept_mass += candidates[i].first;
+    }
+    num_kept = i;
+  } else {
+    for (int64_t i = 0; i < num_kept; ++i) {
+      kept_mass += candidates[i].first;
+    }
+  }
+  // 4. sample from the kept tokens
+  const double target = u * kept_mass;
+  double cum = 0;
+  for (int64_t i = 0; i < num_kept; ++i) {
+    cum += candidates[i].first;
+    if (cum > target) {
+      return candidates[i].second;
+    }
+  }
+  return candidates[num_kept - 1].second;
+}
+
+// logits: [bs, vocab_size], contiguous
+// input_ids: [bs, seq_len]
+// uniform: [bs] double
+// Returns next tokens [bs] sampled as HF `generate` does with
+// RepetitionPenaltyLogitsProcessor, TemperatureLogitsWarper,
+// TopKLogitsWarper and TopPLogitsWarper. temperature <= 0 is greedy;
+// top_k <= 0 and top_p >= 1 disable the filters.
+at::Tensor fused_sampler_kernel_impl(
+    const at::Tensor& logits,
+    const c10::optional<at::Tensor>& input_ids,
+    double temperature,
+    double repetition_penalty,
+    int64_t top_k,
+    double top_p,
+    const at::Tensor& uniform) {
+  const int64_t bs = logits.size(0);
+  const int64_t vocab_size = logits.size(1);
+  auto next_tokens = at::empty({bs}, logits.options().dtype(at::kLong));
+  at::Tensor ids;
+  if (input_ids.has_value() && repetition_penalty != 1.0) {
+    ids = input_ids.value().to(at::kLong).contiguous();
+    TORCH_CHECK(
+        ids.dim() == 2 && ids.size(0) == bs,
+        "fused_sampler: input_ids should be [bs, seq_len]");
+  }
+  const int64_t* ids_ptr = ids.defined() ? ids.data_ptr<int64_t>() : nullptr;
+  const int64_t num_ids = ids.defined() ? ids.size(1) : 0;
+  const double* u_ptr = uniform.data_ptr<double>();
+  int64_t* out_ptr = next_tokens.data_ptr<int64_t>();
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kBFloat16, at::kHalf, logits.scalar_type(), "fused_sampler", [&] {
+        const scalar_t* logits_ptr = logits.data_ptr<scalar_t>();
+        at::parallel_for(0, bs, 1, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            out_ptr[i] = sample_row<scalar_t>(
+                logits_ptr + i * vocab_size,
+                vocab_size,
+                ids_ptr ? ids_ptr + i * num_ids : nullptr,
+                num_ids,
+                temperature,
+                repetition_penalty,
+                top_k,
+                top_p,
+                u_ptr[i]);
+          }
+        });
+      });
+  return next_tokens;
+}
+
+} // anonymous namespace
+
+IPEX_REGISTER_DISPATCH(fused_sampler_kernel_stub, &fused_sampler_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -1,4 +1,7 @@
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
 #include <aten/Conv.h>
+#include <aten/SelectiveScan.h>
 #include "mkl.h"
 #include "vec/vec.h"
 
@@ -6,6 +9,312 @@ namespace torch_ipex {
 namespace cpu {
 namespace {
 
+// Below this many (batch, dim) rows per thread the scan is also split along
+// the sequence, every chunk of at least kScanMinChunkLen steps.
+constexpr int64_t kScanRowsPerThread = 4;
+constexpr int64_t kScanMinChunkLen = 64;
+
+// Pointers and strides of the selective_scan operands, u/delta/out are
+// (batch, len, dim) and A is (dstate, dim).
+template <typename T>
+struct SelectiveScanParams {
+  SelectiveScanParams(
+      const at::Tensor& u,
+      const at::Tensor& delta,
+      const at::Tensor& A,
+      const at::Tensor& B,
+      const at::Tensor& C,
+      const c10::optional<at::Tensor>& D,
+      const c10::optional<at::Tensor>& z,
+      at::Tensor& out,
+      bool clamp_delta_A)
+      : delta_ptr(delta.data_ptr<float>()),
+        delta_strideB(delta.stride(0)),
+        delta_strideD(delta.stride(2)),
+        delta_strideL(delta.stride(1)),
+        u_ptr(u.data_ptr<T>()),
+        u_strideB(u.stride(0)),
+        u_strideD(u.stride(2)),
+        u_strideL(u.stride(1)),
+        A_ptr(A.data_ptr<float>()),
+        A_strideD(A.stride(1)),
+        A_strideS(A.stride(0)),
+        B_ptr(B.data_ptr<T>()),
+        B_dim(B.dim()),
+        B_stride0(B.stride(0)),
+        B_stride1(B.stride(1)),
+        B_stride2(B.dim() >= 3 ? B.stride(2) : 0),
+        B_stride3(B.dim() == 4 ? B.stride(3) : 0),
+        C_ptr(C.data_ptr<T>()),
+        C_dim(C.dim()),
+        C_stride0(C.stride(0)),
+        C_stride1(C.stride(1)),
+        C_stride2(C.dim() >= 3 ? C.stride(2) : 0),
+        C_stride3(C.dim() == 4 ? C.stride(3) : 0),
+        BC_group(B.dim() == 4 ? B.size(1) : 1),
+        D_ptr(D.has_value() ? D.value().data_ptr<float>() : nullptr),
+        z_ptr(z.has_value() ? z.value().data_ptr<T>() : nullptr),
+        z_strideB(z.has_value() ? z.value().stride(0) : 0),
+        z_strideD(z.has_value() ? z.value().stride(1) : 0),
+        z_strideL(z.has_value() ? z.value().stride(2) : 0),
+        out_ptr(out.data_ptr<T>()),
+        out_strideB(out.stride(0)),
+        out_strideD(out.stride(2)),
+        out_strideL(out.stride(1)),
+        dstate(A.size(0)),
+        clamp_delta_A(clamp_delta_A) {}
+
+  float B_at(int64_t bi, int64_t di, int64_t dsi, int64_t li) const {
+    if (B_dim == 2) { // dim x dstate
+      return B_ptr[di * B_stride0 + dsi * B_stride1];
+    } else if (B_dim == 3) { // batch x dstate x len
+      return B_ptr[bi * B_stride0 + dsi * B_stride1 + li * B_stride2];
+    } else { // batch x BC_group x dstate x len
+      return B_ptr
+          [bi * B_stride0 + int(di / BC_group) * B_stride1 + dsi * B_stride2 +
+           li * B_stride3];
+    }
+  }
+
+  float C_at(int64_t bi, int64_t di, int64_t dsi, int64_t li) const {
+    if (C_dim == 2) {
+      return C_ptr[di * C_stride0 + dsi * C_stride1];
+    } else if (C_dim == 3) {
+      return C_ptr[bi * C_stride0 + dsi * C_stride1 + li * C_stride2];
+    } else {
+      return C_ptr
+          [bi * C_stride0 + int(di / BC_group) * C_stride1 + dsi * C_stride2 +
+           li * C_stride3];
+    }
+  }
+
+  const float* delta_ptr;
+  int64_t delta_strideB, delta_strideD, delta_strideL;
+  const T* u_ptr;
+  int64_t u_strideB, u_strideD, u_strideL;
+  const float* A_ptr;
+  int64_t A_strideD, A_strideS;
+  const T* B_ptr;
+  int64_t B_dim, B_stride0, B_stride1, B_stride2, B_stride3;
+  const T* C_ptr;
+  int64_t C_dim, C_stride0, C_stride1, C_stride2, C_stride3;
+  int64_t BC_group;
+  const float* D_ptr;
+  const T* z_ptr;
+  int64_t z_strideB, z_strideD, z_strideL;
+  T* out_ptr;
+  int64_t out_strideB, out_strideD, out_strideL;
+  int64_t dstate;
+  bool clamp_delta_A;
+};
+
+/*
+ *Runs the recurrence x = exp(delta * A) * x + B * delta * u of row (bi, di)
+ *over the steps [l_begin, l_end).
+ *@param x dstate values with stride x_stride, updated in place
+ *@param decay if not null, returns the product of exp(delta * A) over the
+ *steps, i.e. how much of the initial x survives the chunk
+ *@param write_out also computes C * x + D * u, gated by silu(z), into out
+ */
+template <typename T>
+void selective_scan_row(
+    const SelectiveScanParams<T>& p,
+    int64_t bi,
+    int64_t di,
+    int64_t l_begin,
+    int64_t l_end,
+    float* x,
+    int64_t x_stride,
+    float* decay,
+    bool write_out) {
+  constexpr float threshold = 80.0f;
+  if (decay != nullptr) {
+    std::fill_n(decay, p.dstate, 1.0f);
+  }
+  for (auto li = l_begin; li < l_end; li++) {
+    float delta_val = p.delta_ptr
+        [bi * p.delta_strideB + di * p.delta_strideD + li * p.delta_strideL];
+    float u_val =
+        p.u_ptr[bi * p.u_strideB + di * p.u_strideD + li * p.u_strideL];
+    float dt_u_mul = delta_val * u_val;
+    float out_val = 0;
+    for (auto dsi = 0; dsi < p.dstate; dsi++) {
+      float deltaA_A_mul =
+          delta_val * p.A_ptr[p.A_strideD * di + dsi * p.A_strideS];
+      float deltaA = p.clamp_delta_A
+          ? std::exp(std::min(deltaA_A_mul, threshold))
+          : (deltaA_A_mul > threshold ? deltaA_A_mul
+                                      : std::exp(deltaA_A_mul));
+      float x_val =
+          x[dsi * x_stride] * deltaA + p.B_at(bi, di, dsi, li) * dt_u_mul;
+      if (decay != nullptr) {
+        decay[dsi] *= deltaA;
+      }
+      if (write_out) {
+        out_val += x_val * p.C_at(bi, di, dsi, li);
+      }
+      x[dsi * x_stride] = x_val;
+    }
+    if (write_out) {
+      if (p.D_ptr != nullptr) {
+        out_val += u_val * p.D_ptr[di];
+      }
+      if (p.z_ptr != nullptr) {
+        float z_val =
+            p.z_ptr[bi * p.z_strideB + di * p.z_strideD + li * p.z_strideL];
+        out_val *= z_val / (1 + expf(-z_val));
+      }
+      p.out_ptr
+          [bi * p.out_strideB + di * p.out_strideD + li * p.out_strideL] =
+          out_val;
+    }
+  }
+}
+
+/*
+ *Selective scan of all (batch, dim) rows, the final states go to x which is
+ *(batch, dstate, dim) and zero on entry.
+ *When there are too few rows to occupy all threads the sequence is cut into
+ *chunks and scanned in two passes:
+ *  1. every chunk but the last one is scanned from a zero state in parallel,
+ *     keeping its end state and decay; chunk 0 really starts from zero so it
+ *     writes its outputs right away
+ *  2. a prefix combine over the chunks turns the end states into the carry
+ *     states, end(c) = decay(c) * end(c - 1) + end(c)
+ *  3. chunks 1.. are scanned again in parallel from their carry states and
+ *     write the outputs, D and z are applied in the same pass
+ */
+template <typename T>
+void selective_scan_chunked(
+    const SelectiveScanParams<T>& p,
+    int64_t batch,
+    int64_t len,
+    int64_t dim,
+    float* x_ptr,
+    int64_t x_strideB,
+    int64_t x_strideD,
+    int64_t x_strideS) {
+  int64_t dstate = p.dstate;
+  int64_t rows = batch * dim;
+  int64_t num_threads = at::get_num_threads();
+  int64_t num_chunks = 1;
+  if (rows < num_threads * kScanRowsPerThread) {
+    num_chunks = std::min(
+        at::divup(num_threads * kScanRowsPerThread, rows),
+        len / kScanMinChunkLen);
+  }
+  if (num_chunks <= 1) {
+    at::parallel_for(0, rows, 1, [&](int64_t begin, int64_t end) {
+      for (auto i = begin; i < end; i++) {
+        auto bi = i / dim;
+        auto di = i % dim;
+        selective_scan_row<T>(
+            p,
+            bi,
+            di,
+            0,
+            len,
+            x_ptr + bi * x_strideB + di * x_strideD,
+            x_strideS,
+            nullptr,
+            true);
+      }
+    });
+    return;
+  }
+  auto chunk_len = at::divup(len, num_chunks);
+  num_chunks = at::divup(len, chunk_len);
+  // end states and decays of chunks [0, num_chunks - 1), each row contiguous
+  auto states = at::zeros({batch, num_chunks - 1, dim, dstate}, at::kFloat);
+  auto decays = at::empty({batch, num_chunks - 1, dim, dstate}, at::kFloat);
+  auto states_ptr = states.data_ptr<float>();
+  auto decays_ptr = decays.data_ptr<float>();
+  auto row_offset = [&](int64_t bi, int64_t ci, int64_t di) {
+    return ((bi * (num_chunks - 1) + ci) * dim + di) * dstate;
+  };
+
+  at::parallel_for(
+      0, batch * (num_chunks - 1) * dim, 1, [&](int64_t begin, int64_t end) {
+        for (auto i = begin; i < end; i++) {
+          auto bi = i / ((num_chunks - 1) * dim);
+          auto ci = i / dim % (num_chunks - 1);
+          auto di = i % dim;
+          auto offset = row_offset(bi, ci, di);
+          selective_scan_row<T>(
+              p,
+              bi,
+              di,
+              ci * chunk_len,
+              (ci + 1) * chunk_len,
+              states_ptr + offset,
+              1,
+              ci == 0 ? nullptr : decays_ptr + offset,
+              ci == 0);
+        }
+      });
+
+  at::parallel_for(0, rows, 1, [&](int64_t begin, int64_t end) {
+    using fVec = at::vec::Vectorized<float>;
+    for (auto i = begin; i < end; i++) {
+      auto bi = i / dim;
+      auto di = i % dim;
+      for (auto ci = 1; ci < num_chunks - 1; ci++) {
+        auto prev = states_ptr + row_offset(bi, ci - 1, di);
+        auto cur = states_ptr + row_offset(bi, ci, di);
+        auto decay = decays_ptr + row_offset(bi, ci, di);
+        at::vec::map3<float>(
+            [](fVec d, fVec h_prev, fVec h) { return d * h_prev + h; },
+            cur,
+            decay,
+            prev,
+            cur,
+            dstate);
+      }
+    }
+  });
+
+  at::parallel_for(
+      0, batch * (num_chunks - 1) * dim, 1, [&](int64_t begin, int64_t end) {
+        std::vector<float> x_buf(dstate);
+        for (auto i = begin; i < end; i++) {
+          auto bi = i / ((num_chunks - 1) * dim);
+          auto ci = i / dim % (num_chunks - 1) + 1;
+          auto di = i % dim;
+          auto carry = states_ptr + row_offset(bi, ci - 1, di);
+          auto l_end = std::min((ci + 1) * chunk_len, len);
+          if (ci == num_chunks - 1) {
+            // the last chunk leaves the final state in x
+            auto x_row = x_ptr + bi * x_strideB + di * x_strideD;
+            for (auto dsi = 0; dsi < dstate; dsi++) {
+              x_row[dsi * x_strideS] = carry[dsi];
+            }
+            selective_scan_row<T>(
+                p,
+                bi,
+                di,
+                ci * chunk_len,
+                l_end,
+                x_row,
+                x_strideS,
+                nullptr,
+                true);
+          } else {
+            std::copy_n(carry, dstate, x_buf.data());
+            selective_scan_row<T>(
+                p,
+                bi,
+                di,
+                ci * chunk_len,
+                l_end,
+                x_buf.data(),
+                1,
+                nullptr,
+                true);
+          }
+        }
+      });
+}
+
 template <typename T>
 std::tuple<at::Tensor, at::Tensor> selective_scan_kernel_inner(
     const at::Tensor& u,
@@ -37,51 +346,14 @@ std::tuple<at::Tensor, at::Tensor> selective_scan_kernel_inner(
   auto len = u2.size(1);
   auto dstate = A2.size(0);
   auto x = at::zeros({batch, dstate, dim}, at::kFloat);
-  auto out = at::zeros({batch, len, dim}, u.options());
-  auto B_dim = B.dim();
-  auto C_dim = C.dim();
+  auto out = at::empty({batch, len, dim}, u.options());
   auto delta_ptr = delta2.data_ptr<float>();
-  auto u_ptr = u2.data_ptr<T>();
-  auto A_ptr = A2.data_ptr<float>();
-  auto x_ptr = x.data_ptr<float>();
-  auto out_ptr = out.data_ptr<T>();
   bool has_dt_bias = delta_bias.has_value();
   auto delta_bias_ptr =
       has_dt_bias ? delta_bias.value().data_ptr<float>() : nullptr;
-  bool has_D = D.has_value();
-  auto D_ptr = has_D ? D.value().data_ptr<float>() : nullptr;
-  bool has_z = z.has_value();
-  auto z_ptr = has_z ? z.value().data_ptr<T>() : nullptr;
-  auto z_strideB = has_z ? z.value().stride(0) : 0;
-  auto z_strideD = has_z ? z.value().stride(1) : 0;
-  auto z_strideL = has_z ? z.value().stride(2) : 0;
   auto delta_strideB = delta2.stride(0);
   auto delta_strideD = delta2.stride(2);
   auto delta_strideL = delta2.stride(1);
-  auto u_strideB = u2.stride(0);
-  auto u_strideD = u2.stride(2);
-  auto u_strideL = u2.stride(1);
-  auto A_strideD = A2.stride(1);
-  auto A_strideS = A2.stride(0);
-  auto x_strideB = x.stride(0);
-  auto x_strideD = x.stride(2);
-  auto x_strideS = x.stride(1);
-  auto out_strideB = out.stride(0);
-  auto out_strideD = out.stride(2);
-  auto out_strideL = out.stride(1);
-  auto B_ptr = B.data_ptr<T>();
-  auto C_ptr = C.data_ptr<T>();
-  auto B_stride0 = B.stride(0);
-  auto B_stride1 = B.stride(1);
-  auto B_stride2 = B_dim >= 3 ? B.stride(2) : 0;
-  auto B_stride3 = B_dim == 4 ? B.stride(3) : 0;
-  auto C_stride0 = C.stride(0);
-  auto C_stride1 = C.stride(1);
-  auto C_stride2 = C_dim >= 3 ? C.stride(2) : 0;
-  auto C_stride3 = C_dim == 4 ? C.stride(3) : 0;
-  auto BC_group = B_dim == 4 ? B.size(1) : 1;
-  auto one_vec = Vec(1);
-  auto one_vec_fp32 = fVec(1);
   auto threshold = 80.0f;
   auto threshold_vec = fVec(threshold);
 
@@ -130,64 +402,17 @@ std::tuple<at::Tensor, at::Tensor> selective_scan_kernel_inner(
       }
     }
   }
-#pragma omp parallel for collapse(2)
-  for (auto bi = 0; bi < batch; bi++) {
-    for (auto di = 0; di < dim; di++) {
-      for (auto li = 0; li < len; li++) {
-        float delta_val = delta_ptr
-            [bi * delta_strideB + di * delta_strideD + li * delta_strideL];
-        float u_val = u_ptr[bi * u_strideB + di * u_strideD + li * u_strideL];
-        auto out_idx = bi * out_strideB + di * out_strideD + li * out_strideL;
-        float dt_u_mul = delta_val * u_val;
-        float out_val = out_ptr[out_idx];
-        for (auto dsi = 0; dsi < dstate; dsi++) {
-          auto x_idx = bi * x_strideB + di * x_strideD + dsi * x_strideS;
-          float x_val = x_ptr[x_idx];
-          float deltaA_A_mul =
-              delta_val * A_ptr[A_strideD * di + dsi * A_strideS];
-          float deltaA =
-              deltaA_A_mul > threshold ? deltaA_A_mul : std::exp(deltaA_A_mul);
-          x_val *= deltaA;
-          if (B_dim == 2) { // dim x dstate
-            float B_val = B_ptr[di * B_stride0 + dsi * B_stride1];
-            x_val += B_val * dt_u_mul;
-          } else if (B_dim == 3) { // batch x dstate x len
-            float B_val =
-                B_ptr[bi * B_stride0 + dsi * B_stride1 + li * B_stride2];
-            x_val += B_val * dt_u_mul;
-          } else { // batch x BC_group x dstate x len
-            float B_val = B_ptr
-                [bi * B_stride0 + int(di / BC_group) * B_stride1 +
-                 dsi * B_stride2 + li * B_stride3];
-            x_val += B_val * dt_u_mul;
-          }
-
-          if (C_dim == 2) {
-            float C_val = C_ptr[di * C_stride0 + dsi * C_stride1];
-            out_val += x_val * C_val;
-          } else if (C_dim == 3) {
-            float C_val =
-                C_ptr[bi * C_stride0 + dsi * C_stride1 + li * C_stride2];
-            out_val += x_val * C_val;
-          } else {
-            float C_val = C_ptr
-                [bi * C_stride0 + int(di / BC_group) * C_stride1 +
-                 dsi * C_stride2 + li * C_stride3];
-            out_val += x_val * C_val;
-          }
-          x_ptr[x_idx] = x_val;
-        }
-        if (has_D) {
-          out_val += u_val * D_ptr[di];
-        }
-        if (has_z) {
-          float z_val = z_ptr[bi * z_strideB + di * z_strideD + li * z_strideL];
-          out_val *= z_val / (1 + expf(-z_val));
-        }
-        out_ptr[out_idx] = out_val;
-      }
-    }
-  }
+  SelectiveScanParams<T> params(
+      u2, delta2, A2, B, C, D, z, out, /*clamp_delta_A*/ false);
+  selective_scan_chunked<T>(
+      params,
+      batch,
+      len,
+      dim,
+      x.data_ptr<float>(),
+      x.stride(0),
+      x.stride(2),
+      x.stride(1));
   return std::make_tuple(
       std::move(out.transpose_(1, 2)), std::move(x.transpose_(1, 2)));
 }
@@ -220,50 +445,14 @@ std::tuple<at::Tensor, at::Tensor> selective_scan_kernel_inner<float>(
   auto len = u2.size(1);
   auto dstate = A2.size(0);
   auto x = at::zeros({batch, dstate, dim}, u.options());
-  auto out = at::zeros({batch, len, dim}, u.options());
-  auto B_dim = B.dim();
-  auto C_dim = C.dim();
+  auto out = at::empty({batch, len, dim}, u.options());
   auto delta_ptr = delta2.data_ptr<float>();
-  auto u_ptr = u2.data_ptr<float>();
-  auto A_ptr = A2.data_ptr<float>();
-  auto x_ptr = x.data_ptr<float>();
-  auto out_ptr = out.data_ptr<float>();
   bool has_dt_bias = delta_bias.has_value();
   auto delta_bias_ptr =
       has_dt_bias ? delta_bias.value().data_ptr<float>() : nullptr;
-  bool has_D = D.has_value();
-  auto D_ptr = has_D ? D.value().data_ptr<float>() : nullptr;
-  bool has_z = z.has_value();
-  auto z_ptr = has_z ? z.value().data_ptr<float>() : nullptr;
-  auto z_strideB = has_z ? z.value().stride(0) : 0;
-  auto z_strideD = has_z ? z.value().stride(1) : 0;
-  auto z_strideL = has_z ? z.value().stride(2) : 0;
   auto delta_strideB = delta2.stride(0);
   auto delta_strideD = delta2.stride(2);
   auto delta_strideL = delta2.stride(1);
-  auto u_strideB = u2.stride(0);
-  auto u_strideD = u2.stride(2);
-  auto u_strideL = u2.stride(1);
-  auto A_strideD = A2.stride(1);
-  auto A_strideS = A2.stride(0);
-  auto x_strideB = x.stride(0);
-  auto x_strideD = x.stride(2);
-  auto x_strideS = x.stride(1);
-  auto out_strideB = out.stride(0);
-  auto out_strideD = out.stride(2);
-  auto out_strideL = out.stride(1);
-  auto B_ptr = B.data_ptr<float>();
-  auto C_ptr = C.data_ptr<float>();
-  auto B_stride0 = B.stride(0);
-  auto B_stride1 = B.stride(1);
-  auto B_stride2 = B_dim >= 3 ? B.stride(2) : 0;
-  auto B_stride3 = B_dim == 4 ? B.stride(3) : 0;
-  auto C_stride0 = C.stride(0);
-  auto C_stride1 = C.stride(1);
-  auto C_stride2 = C_dim >= 3 ? C.stride(2) : 0;
-  auto C_stride3 = C_dim == 4 ? C.stride(3) : 0;
-  auto BC_group = B_dim == 4 ? B.size(1) : 1;
-
   auto threshold = 80.0f;
   auto threshold_vec = at::vec::Vectorized<float>(threshold);
 #pragma omp parallel for collapse(2)
@@ -302,63 +491,17 @@ std::tuple<at::Tensor, at::Tensor> selective_scan_kernel_inner<float>(
       }
     }
   }
-#pragma omp parallel for collapse(2)
-  for (auto bi = 0; bi < batch; bi++) {
-    for (auto di = 0; di < dim; di++) {
-      for (auto li = 0; li < len; li++) {
-        auto delta_val = delta_ptr
-            [bi * delta_strideB + di * delta_strideD + li * delta_strideL];
-        auto u_val = u_ptr[bi * u_strideB + di * u_strideD + li * u_strideL];
-        auto out_idx = bi * out_strideB + di * out_strideD + li * out_strideL;
-        auto dt_u_mul = delta_val * u_val;
-        auto out_val = out_ptr[out_idx];
-        for (auto dsi = 0; dsi < dstate; dsi++) {
-          auto x_idx = bi * x_strideB + di * x_strideD + dsi * x_strideS;
-          float deltaA_A_mul =
-              delta_val * A_ptr[A_strideD * di + dsi * A_strideS];
-          deltaA_A_mul = deltaA_A_mul > threshold ? threshold : deltaA_A_mul;
-          float deltaA = std::exp(deltaA_A_mul);
-          float x_val = x_ptr[x_idx];
-          x_val *= deltaA;
-          if (B_dim == 2) { // dim x dstate
-            auto B_val = B_ptr[di * B_stride0 + dsi * B_stride1];
-            x_val += B_val * dt_u_mul;
-          } else if (B_dim == 3) { // batch x dstate x len
-            auto B_val =
-                B_ptr[bi * B_stride0 + dsi * B_stride1 + li * B_stride2];
-            x_val += B_val * dt_u_mul;
-          } else { // batch x BC_group x dstate x len
-            auto B_val = B_ptr
-                [bi * B_stride0 + int(di / BC_group) * B_stride1 +
-                 dsi * B_stride2 + li * B_stride3];
-            x_val += B_val * dt_u_mul;
-          }
-          if (C_dim == 2) {
-            auto C_val = C_ptr[di * C_stride0 + dsi * C_stride1];
-            out_val += x_val * C_val;
-          } else if (C_dim == 3) {
-            auto C_val =
-                C_ptr[bi * C_stride0 + dsi * C_stride1 + li * C_stride2];
-            out_val += x_val * C_val;
-          } else {
-            auto C_val = C_ptr
-                [bi * C_stride0 + int(di / BC_group) * C_stride1 +
-                 dsi * C_stride2 + li * C_stride3];
-            out_val += x_val * C_val;
-          }
-          x_ptr[x_idx] = x_val;
-        }
-        if (has_D) {
-          out_val += u_val * D_ptr[di];
-        }
-        if (has_z) {
-          auto z_val = z_ptr[bi * z_strideB + di * z_strideD + li * z_strideL];
-          out_val *= z_val / (1 + expf(-z_val));
-        }
-        out_ptr[out_idx] = out_val;
-      }
-    }
-  }
+  SelectiveScanParams<float> params(
+      u2, delta2, A2, B, C, D, z, out, /*clamp_delta_A*/ true);
+  selective_scan_chunked<float>(
+      params,
+      batch,
+      len,
+      dim,
+      x.data_ptr<float>(),
+      x.stride(0),
+      x.stride(2),
+      x.stride(1));
   return std::make_tuple(
       std::move(out.transpose_(1, 2)), std::move(x.transpose_(1, 2)));
 }
@@ -782,6 +925,179 @@ at::Tensor selective_state_update_kernel_impl_inner<float>(
   return out;
 }
 
+/*
+ *One Mamba2 decode step: causal_conv1d_update + SiLU over the xBC channels
+ *followed by selective_state_update, without writing the conv output back.
+ *The B and C channels are convolved first since every head of a group reads
+ *them, then each (batch, head) task convolves its own x channels and updates
+ *the ssm state rows in place. The state is kept as (..., head_dim, dstate)
+ *so the update of every row is a contiguous read-modify-write over dstate.
+ */
+template <typename T>
+at::Tensor causal_conv1d_selective_state_update_kernel_inner(
+    const at::Tensor& hidden_states,
+    const at::Tensor& conv_states,
+    const at::Tensor& conv_weights,
+    const c10::optional<at::Tensor>& conv_bias,
+    const at::Tensor& ssm_state,
+    const at::Tensor& dt,
+    const at::Tensor& A,
+    const c10::optional<at::Tensor>& D,
+    const c10::optional<at::Tensor>& z,
+    const c10::optional<at::Tensor>& dt_bias,
+    bool dt_softplus,
+    int64_t ngroups) {
+  using fVec = at::vec::Vectorized<float>;
+  int64_t fvec_size = fVec::size();
+  auto batch = ssm_state.size(0);
+  auto nheads = ssm_state.size(1);
+  auto head_dim = ssm_state.size(2);
+  int64_t dstate = ssm_state.size(3);
+  auto conv_dim = conv_weights.size(0);
+  auto width = conv_weights.size(1);
+  auto state_len = conv_states.size(2);
+  auto x_dim = nheads * head_dim;
+  auto bc_dim = ngroups * dstate;
+  TORCH_CHECK(
+      conv_dim == x_dim + 2 * bc_dim,
+      "causal_conv1d_selective_state_update: conv_dim must be nheads * "
+      "head_dim + 2 * ngroups * dstate");
+  TORCH_CHECK(
+      nheads % ngroups == 0,
+      "causal_conv1d_selective_state_update: nheads must be divisible by "
+      "ngroups");
+  TORCH_CHECK(state_len >= width - 1);
+  TORCH_CHECK(hidden_states.size(0) == batch);
+  TORCH_CHECK(hidden_states.size(1) == conv_dim);
+  TORCH_CHECK(conv_states.size(0) == batch && conv_states.size(1) == conv_dim);
+  TORCH_CHECK(conv_states.stride(2) == 1 && conv_weights.stride(1) == 1);
+  TORCH_CHECK(ssm_state.stride(3) == 1);
+  TORCH_CHECK(A.stride(-1) == 1 || A.stride(-1) == 0);
+  auto heads_per_group = nheads / ngroups;
+  auto hidden_states_ptr = hidden_states.data_ptr<T>();
+  auto conv_states_ptr = conv_states.data_ptr<T>();
+  auto conv_weights_ptr = conv_weights.data_ptr<T>();
+  auto conv_bias_ptr =
+      conv_bias.has_value() ? conv_bias.value().data_ptr<T>() : nullptr;
+  auto state_ptr = ssm_state.data_ptr<T>();
+  auto dt_ptr = dt.data_ptr<T>();
+  auto A_ptr = A.data_ptr<float>();
+  auto D_ptr = D.has_value() ? D.value().data_ptr<float>() : nullptr;
+  auto z_ptr = z.has_value() ? z.value().data_ptr<T>() : nullptr;
+  auto dt_bias_ptr =
+      dt_bias.has_value() ? dt_bias.value().data_ptr<float>() : nullptr;
+  auto hidden_states_strideB = hidden_states.stride(0);
+  auto hidden_states_strideC = hidden_states.stride(1);
+  auto conv_states_strideB = conv_states.stride(0);
+  auto conv_states_strideC = conv_states.stride(1);
+  auto conv_weights_strideC = conv_weights.stride(0);
+  auto state_strideB = ssm_state.stride(0);
+  auto state_strideH = ssm_state.stride(1);
+  auto state_strideD = ssm_state.stride(2);
+  auto dt_strideB = dt.stride(0);
+  auto dt_strideH = dt.stride(1);
+  auto dt_strideD = dt.stride(2);
+  auto A_strideH = A.stride(0);
+  auto A_strideD = A.stride(1);
+  bool A_broadcast = A.stride(2) == 0;
+  auto D_strideH = D.has_value() ? D.value().stride(0) : 0;
+  auto D_strideD = D.has_value() ? D.value().stride(1) : 0;
+  auto z_strideB = z.has_value() ? z.value().stride(0) : 0;
+  auto z_strideH = z.has_value() ? z.value().stride(1) : 0;
+  auto z_strideD = z.has_value() ? z.value().stride(2) : 0;
+  auto dt_bias_strideH = dt_bias.has_value() ? dt_bias.value().stride(0) : 0;
+  auto dt_bias_strideD = dt_bias.has_value() ? dt_bias.value().stride(1) : 0;
+  auto out = at::empty({batch, nheads, head_dim}, hidden_states.options());
+  auto out_ptr = out.data_ptr<T>();
+  auto threshold = 80.0f;
+
+  // conv1d of one channel for the new token, then shifts the token into the
+  // conv state
+  auto conv_step = [&](int64_t bi, int64_t ci) {
+    auto states = conv_states_ptr + bi * conv_states_strideB +
+        ci * conv_states_strideC;
+    auto weights = conv_weights_ptr + ci * conv_weights_strideC;
+    float x_val = hidden_states_ptr
+        [bi * hidden_states_strideB + ci * hidden_states_strideC];
+    float acc = conv_bias_ptr != nullptr ? float(conv_bias_ptr[ci]) : 0.f;
+    for (auto k = 0; k < width - 1; k++) {
+      acc += float(weights[k]) * float(states[state_len - width + 1 + k]);
+    }
+    acc += float(weights[width - 1]) * x_val;
+    std::copy(states + 1, states + state_len, states);
+    states[state_len - 1] = x_val;
+    return acc / (1 + expf(-acc));
+  };
+
+  // B and C of every group, shared by the heads of the group
+  auto BC = at::empty({batch, 2 * bc_dim}, at::kFloat);
+  auto BC_ptr = BC.data_ptr<float>();
+  at::parallel_for(
+      0, batch * 2 * bc_dim, 64, [&](int64_t begin, int64_t end) {
+        for (auto i = begin; i < end; i++) {
+          auto bi = i / (2 * bc_dim);
+          BC_ptr[i] = conv_step(bi, x_dim + i % (2 * bc_dim));
+        }
+      });
+
+  at::parallel_for(0, batch * nheads, 1, [&](int64_t begin, int64_t end) {
+    std::vector<float> state_buf(dstate);
+    auto state_f = state_buf.data();
+    for (auto i = begin; i < end; i++) {
+      auto bi = i / nheads;
+      auto hi = i % nheads;
+      auto gi = hi / heads_per_group;
+      auto B_row = BC_ptr + bi * 2 * bc_dim + gi * dstate;
+      auto C_row = BC_ptr + bi * 2 * bc_dim + bc_dim + gi * dstate;
+      for (auto di = 0; di < head_dim; di++) {
+        float x_val = conv_step(bi, hi * head_dim + di);
+        float dt_val =
+            dt_ptr[bi * dt_strideB + hi * dt_strideH + di * dt_strideD];
+        if (dt_bias_ptr != nullptr) {
+          dt_val += dt_bias_ptr[hi * dt_bias_strideH + di * dt_bias_strideD];
+        }
+        if (dt_softplus) {
+          dt_val = dt_val > threshold ? dt_val : std::log1p(std::exp(dt_val));
+        }
+        auto state_row = state_ptr + bi * state_strideB + hi * state_strideH +
+            di * state_strideD;
+        auto A_row = A_ptr + hi * A_strideH + di * A_strideD;
+        at::vec::convert(state_row, state_f, dstate);
+        fVec dt_fvec(dt_val);
+        fVec dt_x_fvec(dt_val * x_val);
+        fVec out_fvec(0);
+        float out_val = 0;
+        int64_t si = 0;
+        for (; si < dstate - (dstate % fvec_size); si += fvec_size) {
+          fVec A_fvec = A_broadcast ? fVec(A_row[0]) : fVec::loadu(A_row + si);
+          fVec s_fvec = (dt_fvec * A_fvec).exp() * fVec::loadu(state_f + si) +
+              fVec::loadu(B_row + si) * dt_x_fvec;
+          out_fvec += s_fvec * fVec::loadu(C_row + si);
+          s_fvec.store(state_f + si);
+        }
+        for (; si < dstate; si++) {
+          float A_val = A_broadcast ? A_row[0] : A_row[si];
+          state_f[si] = std::exp(dt_val * A_val) * state_f[si] +
+              B_row[si] * dt_val * x_val;
+          out_val += state_f[si] * C_row[si];
+        }
+        at::vec::convert(state_f, state_row, dstate);
+        out_val += at::vec::vec_reduce_all<float>(
+            [](fVec& a, fVec& b) { return a + b; }, out_fvec);
+        if (D_ptr != nullptr) {
+          out_val += x_val * D_ptr[hi * D_strideH + di * D_strideD];
+        }
+        if (z_ptr != nullptr) {
+          float z_val = z_ptr[bi * z_strideB + hi * z_strideH + di * z_strideD];
+          out_val *= z_val / (1 + expf(-z_val));
+        }
+        out_ptr[i * head_dim + di] = out_val;
+      }
+    }
+  });
+  return out;
+}
+
 std::tuple<at::Tensor, at::Tensor> selective_scan_kernel_impl(
     const at::Tensor& u,
     const at::Tensor& delta,
@@ -835,11 +1151,77 @@ at::Tensor selective_state_update_kernel_impl(
   }
 }
 
+at::Tensor causal_conv1d_selective_state_update_kernel_impl(
+    const at::Tensor& hidden_states,
+    const at::Tensor& conv_states,
+    const at::Tensor& conv_weights,
+    const c10::optional<at::Tensor>& conv_bias,
+    const at::Tensor& ssm_state,
+    const at::Tensor& dt,
+    const at::Tensor& A,
+    const c10::optional<at::Tensor>& D,
+    const c10::optional<at::Tensor>& z,
+    const c10::optional<at::Tensor>& dt_bias,
+    bool dt_softplus,
+    int64_t ngroups) {
+  if (hidden_states.scalar_type() == at::ScalarType::Float) {
+    return causal_conv1d_selective_state_update_kernel_inner<float>(
+        hidden_states,
+        conv_states,
+        conv_weights,
+        conv_bias,
+        ssm_state,
+        dt,
+        A,
+        D,
+        z,
+        dt_bias,
+        dt_softplus,
+        ngroups);
+  } else if (hidden_states.scalar_type() == at::ScalarType::BFloat16) {
+    return causal_conv1d_selective_state_update_kernel_inner<at::BFloat16>(
+        hidden_states,
+        conv_states,
+        conv_weights,
+        conv_bias,
+        ssm_state,
+        dt,
+        A,
+        D,
+        z,
+        dt_bias,
+        dt_softplus,
+        ngroups);
+  } else if (hidden_states.scalar_type() == at::ScalarType::Half) {
+    return causal_conv1d_selective_state_update_kernel_inner<at::Half>(
+        hidden_states,
+        conv_states,
+        conv_weights,
+        conv_bias,
+        ssm_state,
+        dt,
+        A,
+        D,
+        z,
+        dt_bias,
+        dt_softplus,
+        ngroups);
+  } else {
+    TORCH_CHECK(
+        false,
+        "Only support bfloat16, float16 and float for "
+        "causal_conv1d_selective_state_update");
+  }
+}
+
 } // anonymous namespace
 IPEX_REGISTER_DISPATCH(selective_scan_kernel_stub, &selective_scan_kernel_impl);
 IPEX_REGISTER_DISPATCH(
     selective_state_update_kernel_stub,
     &selective_state_update_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    causal_conv1d_selective_state_update_kernel_stub,
+    &causal_conv1d_selective_state_update_kernel_impl);
 
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
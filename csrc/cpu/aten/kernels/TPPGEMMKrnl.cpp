@@ -99,6 +99,61 @@ at::Tensor tpp_linear_nobias_kernel_impl(
   return t_out;
 }
 
+// Greedy / beam decoding only need the top k tokens of the LM head, they
+// are selected while the logits are computed so that the [BS, vocab_size]
+// logits are never written. The blocked weight may be padded past
+// out_features, the padded rows are not candidates.
+std::tuple<at::Tensor, at::Tensor> tpp_linear_topk_kernel_impl(
+    const at::Tensor& t_in,
+    const at::Tensor& t_wt,
+    int64_t k,
+    int64_t out_features) {
+  auto t_in_ = t_in.dim() == 2 ? t_in.unsqueeze(0) : t_in;
+  auto sizes = t_in_.sizes().vec();
+  auto wt_sizes = t_wt.sizes();
+  auto vocab_size = wt_sizes[0] * wt_sizes[3];
+  TORCH_CHECK(
+      out_features >= 1 && out_features <= vocab_size,
+      "tpp_linear_topk: out_features should be in [1, ",
+      vocab_size,
+      "], got ",
+      out_features);
+  TORCH_CHECK(
+      k >= 1 && k <= out_features,
+      "tpp_linear_topk: k should be in [1, ",
+      out_features,
+      "], got ",
+      k);
+  sizes[2] = k;
+  auto t_values = t_in_.new_empty(sizes);
+  auto t_indices = t_in_.new_empty(sizes, at::kLong);
+
+  auto dt = t_wt.dtype();
+  if (dt == at::kFloat) {
+    torch_ipex::tpp::tpp_linear_topk<float>(
+        t_in_, t_wt, k, out_features, t_values, t_indices, VNNI_OFF);
+  } else if (dt == at::kBFloat16) {
+    torch_ipex::tpp::tpp_linear_topk<at::BFloat16>(
+        t_in_, t_wt, k, out_features, t_values, t_indices, VNNI_ON);
+  } else if (dt == at::kHalf) {
+    TORCH_CHECK(
+        torch_ipex::utils::isa_has_amx_fp16_support(),
+        "TPP does not support fp16 on platforms without amx_fp16 support");
+    torch_ipex::tpp::tpp_linear_topk<at::Half>(
+        t_in_, t_wt, k, out_features, t_values, t_indices, VNNI_ON);
+  } else {
+    AT_ASSERT(
+        0,
+        "TPP does not support current weight dtype %s:%d\n",
+        __FILE__,
+        __LINE__);
+  }
+  if (t_in.dim() == 2) {
+    return std::make_tuple(t_values.squeeze(0), t_indices.squeeze(0));
+  }
+  return std::make_tuple(t_values, t_indices);
+}
+
 at::Tensor tpp_linear_gelu_kernel_impl(
     const at::Tensor& t_in,
     const at::Tensor& t_wt,
@@ -506,6 +561,9 @@ IPEX_REGISTER_DISPATCH(tpp_linear_add_kernel_stub, &tpp_linear_add_kernel_impl);
 IPEX_REGISTER_DISPATCH(
     tpp_linear_add_add_kernel_stub,
     &tpp_linear_add_add_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    tpp_linear_topk_kernel_stub,
+    &tpp_linear_topk_kernel_impl);
 IPEX_REGISTER_DISPATCH(
     tpp_gelu_tanh_bf16_kernel_stub,
     &tpp_gelu_tanh_bf16_kernel_impl);
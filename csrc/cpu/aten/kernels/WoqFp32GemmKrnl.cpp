@@ -61,7 +61,6 @@ at::Tensor woq_gemm_fp32(
   auto biases = bias_list.empty()
       ? TensorList({at::Tensor(), at::Tensor(), at::Tensor()})
       : bias_list;
-  const bool is_4bit_flag = is_4bit(qw_type);
   const bool asym_quant_w = is_asymmetric_quant_w(quant_w_mode);
   if (qw_type == WOQ_DTYPE_NF4) {
     TORCH_CHECK(
@@ -71,10 +70,8 @@ at::Tensor woq_gemm_fp32(
     auto w_sizes = qw.sizes();
     auto K = x.size(-1);
     auto M = x.numel() / K;
-    auto N = w_sizes[0] * w_sizes[3];
-    if (is_4bit_flag) {
-      N *= 2;
-    }
+    // sub-byte weights pack 8 / bits values along N into each byte
+    auto N = w_sizes[0] * w_sizes[3] * 8 / get_weight_bits(qw_type);
     auto out_sizes = x.sizes().vec();
     out_sizes.back() = N;
     auto y = at::empty(out_sizes, x.options());
@@ -64,7 +64,6 @@ at::Tensor woq_gemm_int8(
   auto biases = bias_list.empty()
       ? TensorList({at::Tensor(), at::Tensor(), at::Tensor()})
       : bias_list;
-  const bool is_4bit_flag = is_4bit(qw_type);
   const bool asym_quant_w = is_asymmetric_quant_w(quant_w_mode);
   if (qw_type == WOQ_DTYPE_NF4 || qw_type == WOQ_DTYPE_INT8) {
     TORCH_CHECK(
@@ -76,8 +75,8 @@ at::Tensor woq_gemm_int8(
     auto K = x.size(-1);
     auto M = x.numel() / K;
     auto N = w_sizes[0] * w_sizes[3];
-    if (is_4bit_flag && !compensation.has_value()) {
-      N *= 2;
+    if (!compensation.has_value()) {
+      N = N * 8 / get_weight_bits(qw_type);
     }
     auto out_sizes = x.sizes().vec();
     out_sizes.back() = N;
@@ -165,7 +164,8 @@ at::Tensor woq_gemm_int8(
       others_list,
       quant_w_mode,
       quant_block_k,
-      c10::nullopt);
+      c10::nullopt,
+      /*act_int8=*/true);
 }
 
 #endif // defined(CPU_CAPABILITY_AVX512_FP16) && defined(COMPILER_PREREQ_MET)
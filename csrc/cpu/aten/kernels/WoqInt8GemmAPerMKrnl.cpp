@@ -64,7 +64,6 @@ at::Tensor woq_gemm_int8(
   auto biases = bias_list.empty()
       ? TensorList({at::Tensor(), at::Tensor(), at::Tensor()})
       : bias_list;
-  const bool is_4bit_flag = is_4bit(qw_type);
   const bool asym_quant_w = is_asymmetric_quant_w(quant_w_mode);
   if (qw_type == WOQ_DTYPE_NF4 || qw_type == WOQ_DTYPE_INT8) {
     TORCH_CHECK(
@@ -76,8 +75,8 @@ at::Tensor woq_gemm_int8(
     auto K = x.size(-1);
     auto M = x.numel() / K;
     auto N = w_sizes[0] * w_sizes[3];
-    if (is_4bit_flag && !compensation.has_value()) {
-      N *= 2;
+    if (!compensation.has_value()) {
+      N = N * 8 / get_weight_bits(qw_type);
     }
     auto out_sizes = x.sizes().vec();
     out_sizes.back() = N;
@@ -138,6 +137,118 @@ at::Tensor woq_gemm_int8(
   }
 }
 
+/**
+ * @brief Same as woq_gemm_int8 but the activation comes in already
+ * per-M quantized, e.g., by rmsnorm_dynamic_quant, so that the dynamic
+ * quantization pass over the activation is skipped.
+ *
+ * @param x_q activation in int8 (symmetric) or uint8 (asymmetric) format,
+ * 2D plain format [M,K]
+ * @param scale_a fp32 scales of the activation, [M]
+ * @param zp_a int32 zero points of the activation, [M]. Undefined for
+ * symmetric quantization.
+ * @param out_dtype output dtype, i.e., dtype of the activation before it was
+ * quantized
+ * Other parameters are the same as those of woq_gemm_int8.
+ * @return at::Tensor output in `out_dtype`, 2D plain format [M,N]
+ */
+at::Tensor woq_gemm_int8_quantized_a(
+    const at::Tensor& x_q,
+    const at::Tensor& scale_a,
+    const at::Tensor& zp_a,
+    at::ScalarType out_dtype,
+    const at::Tensor& qw,
+    const TensorList& scales_list,
+    const TensorList& zp_list,
+    const TensorList& bias_list,
+    const int qw_type,
+    int64_t fusion_type,
+    const TensorList& others_list,
+    int64_t quant_a_mode,
+    int64_t quant_w_mode = 0,
+    int64_t quant_block_k = 0,
+    const c10::optional<at::Tensor>& compensation = c10::nullopt) {
+  const int64_t k_splits = 0;
+  quant_block_k = std::max(0L, quant_block_k);
+  // int8_idx is only valid with zp_list when lowp_mode == LOWP_MODE_INT8
+  constexpr size_t fp32_idx = 0, int8_idx = 3;
+  auto biases = bias_list.empty()
+      ? TensorList({at::Tensor(), at::Tensor(), at::Tensor()})
+      : bias_list;
+  const bool asym_quant_w = is_asymmetric_quant_w(quant_w_mode);
+  if (qw_type == WOQ_DTYPE_NF4 || qw_type == WOQ_DTYPE_INT8) {
+    TORCH_CHECK(
+        !asym_quant_w,
+        "WOQ: symmetric quantization is required for NF4 or INT8 with lowp-mode INT8");
+  }
+  if (qw.dim() == 4) {
+    auto w_sizes = qw.sizes();
+    auto N = w_sizes[0] * w_sizes[3];
+    if (!compensation.has_value()) {
+      N = N * 8 / get_weight_bits(qw_type);
+    }
+    auto out_sizes = x_q.sizes().vec();
+    out_sizes.back() = N;
+    auto y = at::empty(out_sizes, x_q.options().dtype(out_dtype));
+    const auto& x_quantized = x_q;
+    product_dispatcher<
+        std::tuple<at::ScalarType, long>,
+        std::tuple<
+            enumerate_dispatcher<
+                at::ScalarType,
+                at::kFloat,
+                at::kBFloat16,
+                at::kHalf>,
+            range_dispatcher<long, 0, 3>>>::
+        call(
+            std::make_tuple(out_dtype, quant_w_mode),
+            [&](auto tuple) {
+              auto act_dtype = std::get<0>(tuple);
+              auto quant_w_mode_ = std::get<1>(tuple);
+              using act_type =
+                  typename c10::impl::ScalarTypeToCPPType<act_dtype>::type;
+              auto block_k = w_sizes[2];
+              if (quant_block_k <= 0)
+                quant_block_k = block_k;
+              bool is_sym_quant = !is_asymmetric_quant_a(quant_a_mode);
+              float* scale_a_ptr = scale_a.data_ptr<float>();
+              int32_t* zp_a_ptr =
+                  is_sym_quant ? nullptr : zp_a.data_ptr<int32_t>();
+              if (quant_a_mode == QUANT_A_PER_M) {
+                CALL_WOQ_KERNEL_IMPL_INT8(uint8_t, QUANT_A_PER_M);
+              } else if (quant_a_mode == QUANT_A_PER_M_SYM) {
+                CALL_WOQ_KERNEL_IMPL_INT8(int8_t, QUANT_A_PER_M_SYM);
+              } else {
+                TORCH_CHECK(
+                    false,
+                    "Unexpected quant_a_mode for lowp-mode INT8 per M quant: ",
+                    quant_a_mode);
+              }
+            },
+            [](auto tuple) { failing_fallback(); });
+    return y;
+  } else {
+    return woq_gemm_ref_impl(
+        dequantize_woq_activation(
+            x_q,
+            scale_a,
+            zp_a,
+            quant_block_k > 0 ? quant_block_k : x_q.size(-1),
+            out_dtype),
+        qw,
+        scales_list,
+        zp_list,
+        bias_list,
+        qw_type,
+        out_dtype,
+        fusion_type,
+        others_list,
+        quant_w_mode,
+        quant_block_k,
+        c10::nullopt);
+  }
+}
+
 #else // defined(CPU_CAPABILITY_AVX512_FP16) && defined(COMPILER_PREREQ_MET)
 
 at::Tensor woq_gemm_int8(
@@ -165,6 +276,41 @@ at::Tensor woq_gemm_int8(
       others_list,
       quant_w_mode,
       quant_block_k,
+      c10::nullopt,
+      /*act_int8=*/true);
+}
+
+at::Tensor woq_gemm_int8_quantized_a(
+    const at::Tensor& x_q,
+    const at::Tensor& scale_a,
+    const at::Tensor& zp_a,
+    at::ScalarType out_dtype,
+    const at::Tensor& qw,
+    const TensorList& scales_list,
+    const TensorList& zp_list,
+    const TensorList& bias_list,
+    const int qw_type,
+    int64_t fusion_type,
+    const TensorList& others_list,
+    int64_t quant_a_mode,
+    int64_t quant_w_mode = 0,
+    int64_t quant_block_k = 0,
+    const c10::optional<at::Tensor>& compensation = c10::nullopt) {
+  auto block_k = quant_block_k > 0 ? quant_block_k
+      : qw.dim() == 4               ? qw.size(2)
+                                    : x_q.size(-1);
+  return woq_gemm_ref_impl(
+      dequantize_woq_activation(x_q, scale_a, zp_a, block_k, out_dtype),
+      qw,
+      scales_list,
+      zp_list,
+      bias_list,
+      qw_type,
+      out_dtype,
+      fusion_type,
+      others_list,
+      quant_w_mode,
+      quant_block_k,
       c10::nullopt);
 }
 
@@ -173,6 +319,9 @@ at::Tensor woq_gemm_int8(
 } // namespace
 
 IPEX_REGISTER_DISPATCH(woq_int8_gemm_pre_m_block_kernel_stub, &woq_gemm_int8);
+IPEX_REGISTER_DISPATCH(
+    woq_int8_gemm_pre_m_block_quantized_a_kernel_stub,
+    &woq_gemm_int8_quantized_a);
 
 } // namespace cpu
 } // namespace torch_ipex
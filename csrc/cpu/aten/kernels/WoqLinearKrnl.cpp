@@ -26,6 +26,8 @@ IPEX_DEFINE_DISPATCH(woq_int8_gemm_pre_tensor_kernel_stub);
 IPEX_DEFINE_DISPATCH(woq_int8_gemm_pre_k_block_kernel_stub);
 IPEX_DEFINE_DISPATCH(woq_int8_gemm_pre_m_block_kernel_stub);
 IPEX_DEFINE_DISPATCH(woq_int8_gemm_pre_m_k_block_kernel_stub);
+IPEX_DEFINE_DISPATCH(woq_int8_gemm_pre_m_block_quantized_a_kernel_stub);
+IPEX_DEFINE_DISPATCH(woq_int8_gemm_pre_m_k_block_quantized_a_kernel_stub);
 
 /**
  * @brief Weight only quantization GEMM kernel. Here we dispatch to different
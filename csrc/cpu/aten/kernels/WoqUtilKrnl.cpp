@@ -22,6 +22,159 @@ namespace {
 // Aligned with WoqTppKrnl.cpp
 #if defined(CPU_CAPABILITY_AVX512_FP16) && defined(COMPILER_PREREQ_MET)
 
+// Read the k-th value of a plain INT2 ([N, K/4], 4 values per byte) or INT3
+// ([N, K], 1 value per byte) weight row
+inline uint8_t get_plain_lowbit(const uint8_t* row, int bits, long k) {
+  return bits == 2 ? (row[k / 4] >> (k % 4 * 2)) & 0x3 : row[k] & 0x7;
+}
+
+inline void set_plain_lowbit(uint8_t* row, int bits, long k, uint8_t v) {
+  if (bits == 2) {
+    row[k / 4] |= v << (k % 4 * 2);
+  } else {
+    row[k] = v;
+  }
+}
+
+// Byte and bit position of column `i` and row `kb` inside a packed INT2/INT3
+// group, for the 2-bit plane and the 3rd-bit plane respectively.
+struct LowbitPos {
+  long low_byte;
+  int low_shift;
+  long high_byte;
+  int high_shift;
+};
+
+/*
+ * INT2/INT3 weights are packed per group of N_GROUP_SIZE columns. The lower 2
+ * bits of the group come first as a 2-bit plane, followed by a 1-bit plane of
+ * the 3rd bit for INT3:
+ * - By default, a group of one row holds G/4 bytes of 2-bit plane where byte b
+ *   has column b + j * G/4 at bits 2j, followed by G/8 bytes for INT3 where
+ *   bit n is the 3rd bit of column n. See `load_dequant_zp_only_lowbit`.
+ * - With LOWP_MODE_INT8, a group of 16 columns x 4 rows holds 16 bytes of
+ *   2-bit plane where byte n has the 4 rows of column n at bits 2r, followed by
+ *   8 bytes for INT3 where bit 4n+r is the 3rd bit. See
+ *   `load_lowbit_as_uint8`.
+ */
+inline LowbitPos get_lowbit_pos(
+    int qw_type,
+    int64_t lowp_mode,
+    long block_n,
+    long n_group_size,
+    long kb,
+    long nb,
+    long i) {
+  if (lowp_mode != LOWP_MODE_INT8) {
+    long group = get_packed_offset(qw_type, kb * block_n + nb);
+    long plane = n_group_size / 4;
+    return {
+        group + i % plane,
+        (int)(i / plane * 2),
+        group + plane + i / 8,
+        (int)(i % 8)};
+  }
+  long group = get_packed_offset(qw_type, (kb / 4 * block_n + nb) * 4);
+  int r = kb % 4;
+  return {group + i, r * 2, group + 16 + i / 2, (int)(i % 2 * 4 + r)};
+}
+
+at::Tensor qlinear_woq_pack_lowbit(
+    const at::Tensor& qw,
+    int qw_type,
+    size_t block_n,
+    size_t block_k,
+    int64_t lowp_mode) {
+  TORCH_CHECK(qw.is_contiguous(), "qw must be contiguous");
+  const int bits = get_weight_bits(qw_type);
+  auto N = qw.size(0);
+  auto K = bits == 2 ? qw.size(1) * 4 : qw.size(1);
+  auto ld_src = qw.size(1);
+  TLA_ASSERT(N % block_n == 0, "N must be multiple of block_n");
+  TLA_ASSERT(K % block_k == 0, "K must be multiple of block_k");
+  TLA_ASSERT(
+      block_n % 16 == 0, "block_n must be multiple of 16 for lowbit weight");
+  if (lowp_mode == LOWP_MODE_INT8) {
+    TLA_ASSERT(
+        block_k % 4 == 0,
+        "block_k must be multiple of 4 for int8 for LOWP_MODE_INT8");
+  }
+  const int N_GROUP_SIZE =
+      lowp_mode != LOWP_MODE_INT8 ? get_n_group_size(block_n) : 16;
+  const int Nc = N / block_n;
+  const int Kc = K / block_k;
+  const long row_bytes = get_packed_offset(qw_type, block_n);
+  // Bits are OR-ed into the destination, so start from zeros
+  auto result =
+      at::zeros({Nc, Kc, block_k, row_bytes}, qw.options().dtype(at::kByte));
+  uint8_t* src_data = (uint8_t*)qw.data_ptr();
+  uint8_t* dst_data = (uint8_t*)result.data_ptr();
+  auto pdst = GetVLAPtr<uint8_t>(dst_data, {Kc, block_k * row_bytes});
+  auto pack_loop = ThreadedLoop<3>(
+      {{Nc}, {Kc}, {0, block_n, N_GROUP_SIZE, false}}, "ABc");
+  pack_loop([&](int* idx) {
+    int nc = idx[0];
+    int kc = idx[1];
+    int nb = idx[2];
+    uint8_t* dst = pdst[nc][kc];
+    for (int i = 0; i < N_GROUP_SIZE; i++) {
+      uint8_t* src_row = src_data + (nc * block_n + nb + i) * ld_src;
+      for (int kb = 0; kb < block_k; kb++) {
+        auto v = get_plain_lowbit(src_row, bits, kc * block_k + kb);
+        auto pos = get_lowbit_pos(
+            qw_type, lowp_mode, block_n, N_GROUP_SIZE, kb, nb, i);
+        dst[pos.low_byte] |= (v & 0x3) << pos.low_shift;
+        if (bits == 3) {
+          dst[pos.high_byte] |= (v >> 2) << pos.high_shift;
+        }
+      }
+    }
+  });
+  return result;
+}
+
+at::Tensor qlinear_woq_unpack_lowbit(
+    const at::Tensor& qw_packed,
+    int qw_type,
+    int64_t lowp_mode) {
+  const int bits = get_weight_bits(qw_type);
+  auto w_sizes = qw_packed.sizes();
+  auto Nc = w_sizes[0];
+  auto Nb = w_sizes[3] * 8 / bits;
+  auto Kc = w_sizes[1];
+  auto Kb = w_sizes[2];
+  auto N = Nc * Nb;
+  auto K = Kc * Kb;
+  const int N_GROUP_SIZE =
+      lowp_mode != LOWP_MODE_INT8 ? get_n_group_size(Nb) : 16;
+  auto ld_dst = bits == 2 ? K / 4 : K;
+  auto result = at::zeros({N, ld_dst}, qw_packed.options());
+  uint8_t* dst_data = (uint8_t*)result.data_ptr();
+  auto psrc = GetVLAPtr<uint8_t>(
+      (uint8_t*)qw_packed.data_ptr(), {Kc, Kb * w_sizes[3]});
+  auto unpack_loop =
+      ThreadedLoop<3>({{Nc}, {Kc}, {0, Nb, N_GROUP_SIZE, false}}, "ABc");
+  unpack_loop([&](int* idx) {
+    int nc = idx[0];
+    int kc = idx[1];
+    int nb = idx[2];
+    uint8_t* src = psrc[nc][kc];
+    for (int i = 0; i < N_GROUP_SIZE; i++) {
+      uint8_t* dst_row = dst_data + (nc * Nb + nb + i) * ld_dst;
+      for (int kb = 0; kb < Kb; kb++) {
+        auto pos =
+            get_lowbit_pos(qw_type, lowp_mode, Nb, N_GROUP_SIZE, kb, nb, i);
+        uint8_t v = (src[pos.low_byte] >> pos.low_shift) & 0x3;
+        if (bits == 3) {
+          v |= ((src[pos.high_byte] >> pos.high_shift) & 0x1) << 2;
+        }
+        set_plain_lowbit(dst_row, bits, kc * Kb + kb, v);
+      }
+    }
+  });
+  return result;
+}
+
 /**
  * @brief pack the weight in quantized format.
  * @param qw quantized weight with shape [N, K]
@@ -36,6 +189,12 @@ at::Tensor qlinear_woq_pack(
     size_t block_k,
     int64_t lowp_mode,
     int64_t weight_format) {
+  if (is_lowbit(qw_type)) {
+    TORCH_CHECK(
+        weight_format == PLAIN_WEIGHT_FORMAT,
+        "WOQ: only plain weight format is supported for INT2/INT3 weight");
+    return qlinear_woq_pack_lowbit(qw, qw_type, block_n, block_k, lowp_mode);
+  }
   bool is_4bit_flag = is_4bit(qw_type);
   auto sizes = qw.sizes();
   auto strides = qw.strides();
@@ -252,6 +411,9 @@ at::Tensor qlinear_woq_unpack(
     const at::Tensor& qw_packed,
     int qw_type,
     int64_t lowp_mode) {
+  if (is_lowbit(qw_type) && qw_packed.dim() == 4) {
+    return qlinear_woq_unpack_lowbit(qw_packed, qw_type, lowp_mode);
+  }
   bool is_4bit_flag = is_4bit(qw_type);
   if (qw_packed.dim() == 4) {
     auto w_sizes = qw_packed.sizes();
@@ -103,3 +103,159 @@ inline void _mkl_gemm(
       c,
       ldc);
 }
+
+// MKL packed B matrix (N x K, transposed as for a linear weight) for
+// C = A x B^T with an M x K row-major A. The packed buffer is opaque and
+// only valid for the M it was packed for.
+template <typename T>
+inline size_t _mkl_gemm_pack_b_size(const int& m, const int& n, const int& k);
+
+template <>
+inline size_t _mkl_gemm_pack_b_size<float>(
+    const int& m,
+    const int& n,
+    const int& k) {
+  return cblas_sgemm_pack_get_size(CblasBMatrix, m, n, k);
+}
+
+template <>
+inline size_t _mkl_gemm_pack_b_size<double>(
+    const int& m,
+    const int& n,
+    const int& k) {
+  return cblas_dgemm_pack_get_size(CblasBMatrix, m, n, k);
+}
+
+template <>
+inline size_t _mkl_gemm_pack_b_size<at::BFloat16>(
+    const int& m,
+    const int& n,
+    const int& k) {
+  return cblas_gemm_bf16bf16f32_pack_get_size(CblasBMatrix, m, n, k);
+}
+
+inline void _mkl_gemm_pack_b(
+    const int& m,
+    const int& n,
+    const int& k,
+    const float* b,
+    void* packed_b) {
+  cblas_sgemm_pack(
+      CblasRowMajor,
+      CblasBMatrix,
+      CblasTrans,
+      m,
+      n,
+      k,
+      1.0f,
+      b,
+      k,
+      (float*)packed_b);
+}
+
+inline void _mkl_gemm_pack_b(
+    const int& m,
+    const int& n,
+    const int& k,
+    const double* b,
+    void* packed_b) {
+  cblas_dgemm_pack(
+      CblasRowMajor,
+      CblasBMatrix,
+      CblasTrans,
+      m,
+      n,
+      k,
+      1.0,
+      b,
+      k,
+      (double*)packed_b);
+}
+
+inline void _mkl_gemm_pack_b(
+    const int& m,
+    const int& n,
+    const int& k,
+    const at::BFloat16* b,
+    void* packed_b) {
+  cblas_gemm_bf16bf16f32_pack(
+      CblasRowMajor,
+      CblasBMatrix,
+      CblasTrans,
+      m,
+      n,
+      k,
+      (const MKL_BF16*)(b),
+      k,
+      (MKL_BF16*)(packed_b));
+}
+
+inline void _mkl_gemm_compute_packed_b(
+    const int& m,
+    const int& n,
+    const int& k,
+    const float* a,
+    const void* packed_b,
+    float* c) {
+  cblas_sgemm_compute(
+      CblasRowMajor,
+      CblasNoTrans,
+      CblasPacked,
+      m,
+      n,
+      k,
+      a,
+      k,
+      (const float*)packed_b,
+      k,
+      0.0f,
+      c,
+      n);
+}
+
+inline void _mkl_gemm_compute_packed_b(
+    const int& m,
+    const int& n,
+    const int& k,
+    const double* a,
+    const void* packed_b,
+    double* c) {
+  cblas_dgemm_compute(
+      CblasRowMajor,
+      CblasNoTrans,
+      CblasPacked,
+      m,
+      n,
+      k,
+      a,
+      k,
+      (const double*)packed_b,
+      k,
+      0.0,
+      c,
+      n);
+}
+
+inline void _mkl_gemm_compute_packed_b(
+    const int& m,
+    const int& n,
+    const int& k,
+    const at::BFloat16* a,
+    const void* packed_b,
+    float* c) {
+  cblas_gemm_bf16bf16f32_compute(
+      CblasRowMajor,
+      CblasNoTrans,
+      CblasPacked,
+      m,
+      n,
+      k,
+      1.0f,
+      (const MKL_BF16*)(a),
+      k,
+      (const MKL_BF16*)(packed_b),
+      k,
+      0.0f,
+      c,
+      n);
+}
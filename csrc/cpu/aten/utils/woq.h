@@ -313,6 +313,93 @@ struct load_dequant_zp_only_4bit<16, sym_quant> {
 #endif
 };
 
+// 2-bit and 3-bit weights are packed per N_GROUP_SIZE (G) columns of a k row.
+// The first G / 4 bytes hold the lower 2 bits: byte b holds column
+// b + j * G / 4 at bits [2j, 2j + 2). INT3 appends G / 8 bytes holding bit 2
+// of column n at bit n. The lut is repeated every 2^bits entries (see
+// VecOps::set_lowbit_lut) so only bit 2 of INT3 needs explicit masking.
+template <long N_GROUP_SIZE, int bits, bool sym_quant>
+struct load_dequant_zp_only_lowbit {
+  static_assert(bits == 2 || bits == 3, "only 2-bit and 3-bit are supported");
+
+#if defined(CPU_CAPABILITY_AVX512)
+  // Returns the 2-bit values of columns [16 * idx, 16 * idx + 16) in the
+  // lowest 2 bits of each byte, other bits are garbage.
+  template <long idx>
+  static inline __m128i shift_2bit_plane(uint8_t* p) {
+    if constexpr (N_GROUP_SIZE == 64) {
+      return _mm_srli_epi64(_mm_loadu_si128((__m128i*)p), idx * 2);
+    } else if constexpr (N_GROUP_SIZE == 32) {
+      uint64_t packed = reinterpret_cast<uint64_t*>(p)[0];
+      return _mm_set_epi64x(packed >> (idx * 4 + 2), packed >> (idx * 4));
+    } else {
+      uint32_t packed = reinterpret_cast<uint32_t*>(p)[0];
+      return _mm_set_epi32(packed >> 6, packed >> 4, packed >> 2, packed);
+    }
+  }
+
+  static inline std::array<__m512, N_GROUP_SIZE / 16> call(
+      uint8_t* p,
+      __m512 lut,
+      std::array<__m512, N_GROUP_SIZE / 16> vzps) {
+    constexpr long COLS = N_GROUP_SIZE / 16;
+    std::array<__m512, COLS> vbs;
+    compile_time_for<COLS>::op([&](auto idx) {
+      auto int32 = _mm512_cvtepu8_epi32(shift_2bit_plane<idx>(p));
+      if constexpr (bits == 3) {
+        __mmask16 bit2 =
+            reinterpret_cast<uint16_t*>(p + N_GROUP_SIZE / 4)[idx];
+        int32 = _mm512_and_si512(int32, _mm512_set1_epi32(3));
+        int32 = _mm512_mask_add_epi32(int32, bit2, int32, _mm512_set1_epi32(4));
+      }
+      vbs[idx] = _mm512_permutexvar_ps(int32, lut);
+      if constexpr (!sym_quant) {
+        vbs[idx] = _mm512_sub_ps(vbs[idx], vzps[idx]);
+      }
+    });
+    return vbs;
+  }
+#endif
+
+#if defined(CPU_CAPABILITY_AVX512_FP16)
+  static inline std::array<__m512h, N_GROUP_SIZE / 32> call(
+      uint8_t* p,
+      __m512h lut,
+      std::array<__m512h, N_GROUP_SIZE / 32> vzps) {
+    constexpr long COLS = N_GROUP_SIZE / 32;
+    std::array<__m512h, COLS> vbs;
+    if constexpr (COLS == 0) {
+      TLA_ASSERT(false, "not implemented");
+    }
+    compile_time_for<COLS>::op([&](auto idx) {
+      __m256i plane;
+      if constexpr (N_GROUP_SIZE == 64) {
+        auto packed = _mm_loadu_si128((__m128i*)p);
+        plane = _mm256_set_m128i(
+            _mm_srli_epi64(packed, idx * 4 + 2),
+            _mm_srli_epi64(packed, idx * 4));
+      } else {
+        uint64_t packed = reinterpret_cast<uint64_t*>(p)[0];
+        plane = _mm256_set_epi64x(
+            packed >> 6, packed >> 4, packed >> 2, packed);
+      }
+      auto int16 = _mm512_cvtepu8_epi16(plane);
+      if constexpr (bits == 3) {
+        __mmask32 bit2 =
+            reinterpret_cast<uint32_t*>(p + N_GROUP_SIZE / 4)[idx];
+        int16 = _mm512_and_si512(int16, _mm512_set1_epi16(3));
+        int16 = _mm512_mask_add_epi16(int16, bit2, int16, _mm512_set1_epi16(4));
+      }
+      vbs[idx] = _mm512_permutexvar_ph(int16, lut);
+      if constexpr (!sym_quant) {
+        vbs[idx] = _mm512_sub_ph(vbs[idx], vzps[idx]);
+      }
+    });
+    return vbs;
+  }
+#endif
+};
+
 template <long N_GROUP_SIZE, bool sym_quant>
 struct load_dequant_zp_only_int8 {
   template <typename VAT>
@@ -669,6 +756,26 @@ inline std::array<__m256i, 2> load_nf4_as_int8(uint8_t* qB) {
   return {low, high};
 }
 
+// load 2-bit or 3-bit values of 16 columns x 4 rows as 64 uint8 in
+// [16 columns][4 rows] vnni order. The 16 bytes of the 2-bit plane hold
+// column n in byte n, row r at bits [2r, 2r + 2). INT3 appends 8 bytes holding
+// bit 2 of (n, r) at bit 4n + r.
+template <int bits>
+inline __m512i load_lowbit_as_uint8(uint8_t* qB) {
+  __m512i packed = _mm512_cvtepu8_epi32(_mm_loadu_si128((__m128i*)qB));
+  // move the 2 bits of row r to the lowest bits of byte r of each int32
+  __m512i v = _mm512_or_si512(
+      _mm512_or_si512(packed, _mm512_slli_epi32(packed, 6)),
+      _mm512_or_si512(
+          _mm512_slli_epi32(packed, 12), _mm512_slli_epi32(packed, 18)));
+  v = _mm512_and_si512(v, _mm512_set1_epi8(0x3));
+  if constexpr (bits == 3) {
+    __mmask64 bit2 = reinterpret_cast<uint64_t*>(qB + 16)[0];
+    v = _mm512_mask_add_epi8(v, bit2, v, _mm512_set1_epi8(0x4));
+  }
+  return v;
+}
+
 #else
 inline std::array<__m256i, 2> load_zps_4vnni(int8_t* zps) {
   TLA_ASSERT(false, "not implemented");
@@ -690,6 +797,12 @@ inline std::array<__m256i, 2> load_nf4_as_int8(uint8_t* qB) {
   return std::array<__m256i, 2>();
 }
 
+template <int bits>
+inline __m512i load_lowbit_as_uint8(uint8_t* qB) {
+  TLA_ASSERT(false, "not implemented");
+  return __m512i();
+}
+
 #endif
 
 template <long N, bool sym_quant, typename T>
@@ -708,6 +821,23 @@ struct load_dequant_4bit {
   }
 };
 
+template <long N, int bits, bool sym_quant, typename T>
+struct load_dequant_lowbit {
+  using VT = typename VecType<T>::type;
+  using V = VecOps<VT>;
+  using VA = VecArray<N, T>;
+  using VAT = typename VA::type;
+  constexpr static long COLS = VA::num_vec;
+
+  static inline VAT call(uint8_t* p, VAT vscales, VT lut, VAT vzps) {
+    auto vbs =
+        load_dequant_zp_only_lowbit<N, bits, sym_quant>::call(p, lut, vzps);
+    compile_time_for<COLS>::op(
+        [&](auto idx) { vbs[idx] = V::mul(vbs[idx], vscales[idx]); });
+    return vbs;
+  }
+};
+
 template <long N, bool sym_quant, typename T>
 struct load_dequant_int8 {
   using VT = typename VecType<T>::type;
@@ -826,6 +956,7 @@ struct GemmMicroKernel<
 
     VT lut;
     constexpr bool is_4bit_flag = is_4bit(qw_type);
+    constexpr bool is_lowbit_flag = is_lowbit(qw_type);
     if constexpr (is_4bit_flag) {
       if constexpr (qw_type == WOQ_DTYPE_NF4) {
         lut = V::set_nf4_lut();
@@ -834,6 +965,8 @@ struct GemmMicroKernel<
       } else {
         lut = V::set_0_to_15();
       }
+    } else if constexpr (is_lowbit_flag) {
+      lut = V::set_lowbit_lut(get_weight_bits(qw_type), sym_quant_w);
     }
 
     // Load scales and zps
@@ -848,7 +981,8 @@ struct GemmMicroKernel<
     // NB: For fp16 in int8 woq, we do not delay the scale to the post-op but
     // leave it to the dequant otherwise the weight value might be too large to
     // overflow fp16 range.
-    constexpr bool scale_as_post_op = !std::is_same<T, half>() || is_4bit_flag;
+    constexpr bool scale_as_post_op =
+        !std::is_same<T, half>() || is_4bit_flag || is_lowbit_flag;
 
     compile_time_for<M * COLS>::op([&](auto i) { vc[i] = V::setzero(); });
 
@@ -873,6 +1007,15 @@ struct GemmMicroKernel<
                     ADDRESS(B, k, col * V::VLEN / 2, ldb / 2),
                     lut,
                     vzps[cbidx]);
+          } else if constexpr (is_lowbit_flag) {
+            vb[cbidx] = load_dequant_zp_only_lowbit<
+                N_GROUP_SIZE,
+                get_weight_bits(qw_type),
+                sym_quant_w>::
+                call(
+                    B + get_packed_offset(qw_type, k * ldb + col * V::VLEN),
+                    lut,
+                    vzps[cbidx]);
           } else if constexpr (qw_type == WOQ_DTYPE_FP8) {
             vb[cbidx] =
                 load_dequant_cvt_only_fp8<N_GROUP_SIZE>::template call<VArrayT>(
@@ -898,15 +1041,11 @@ struct GemmMicroKernel<
           }
         }
         if constexpr (PREFETCH_K_DIST > 0) {
-          if constexpr (is_4bit_flag) {
-            _mm_prefetch(
-                ADDRESS(B, k + PREFETCH_K_DIST, col * V::VLEN / 2, ldb / 2),
-                _MM_HINT_T0);
-          } else {
-            _mm_prefetch(
-                ADDRESS(B, k + PREFETCH_K_DIST, col * V::VLEN, ldb),
-                _MM_HINT_T0);
-          }
+          _mm_prefetch(
+              B +
+                  get_packed_offset(
+                      qw_type, (k + PREFETCH_K_DIST) * ldb + col * V::VLEN),
+              _MM_HINT_T0);
         }
       }
 
@@ -1032,7 +1171,17 @@ struct GemmMicroKernel<
       }
 
       if constexpr (row == 0) {
-        if constexpr (!sym_quant_w) {
+        if constexpr (is_lowbit(qw_type)) {
+          constexpr int bits = get_weight_bits(qw_type);
+          vb[col] = load_lowbit_as_uint8<bits>(
+              B + get_packed_offset(qw_type, (k / 4 * ldb + col * 16) * 4));
+          if constexpr (sym_quant_w) {
+            vb[col] =
+                _mm512_sub_epi8(vb[col], _mm512_set1_epi8(1 << (bits - 1)));
+          } else {
+            vb[col] = _mm512_sub_epi8(vb[col], vzps[col]);
+          }
+        } else if constexpr (!sym_quant_w) {
           vb[col] = combine_m256i(load_uint4_as_int8(pqB[k / 4][col * 16]));
           vb[col] = _mm512_sub_epi8(vb[col], vzps[col]);
         } else if constexpr (qw_type == WOQ_DTYPE_INT4) {
@@ -1045,7 +1194,10 @@ struct GemmMicroKernel<
               _mm512_dpbusd_epi32(vcompensate[col], ones, vb[col]);
         }
         if constexpr (PREFETCH_K_DIST > 0) {
-          _mm_prefetch(pqB[(k + PREFETCH_K_DIST) / 4][col * 16], _MM_HINT_T0);
+          long prefetch_k = (k + PREFETCH_K_DIST) / 4 * ldb;
+          _mm_prefetch(
+              B + get_packed_offset(qw_type, (prefetch_k + col * 16) * 4),
+              _MM_HINT_T0);
         }
       }
       if constexpr (is_asymmetric_quant_a(quant_a_mode)) {
@@ -1147,7 +1299,6 @@ struct dequant_n_grouped {
       const Lambda3& store) {
     using VA = VecArray<N_GROUP_SIZE, Tin>;
     using VAT = typename VA::type;
-    constexpr bool is_4bit_flag = is_4bit(qw_type);
     for (int n = 0; n < N; n += N_GROUP_SIZE) {
       // load scales and zps
       auto vscales = load_qparam(scales + n);
@@ -1158,14 +1309,13 @@ struct dequant_n_grouped {
       for (int k = 0; k < K; k++) {
         // load and dequant qB to vb
         auto vbs = load_qint_as_fp(
-            is_4bit_flag ? &qB[k * ldb / 2 + n / 2] : &qB[k * ldb + n],
+            &qB[get_packed_offset(qw_type, k * ldb + n)],
             vscales,
             vzps);
         // prefetch qB data
         if constexpr (PREFETCH_K_DIST > 0) {
-          auto prefetch_addr = is_4bit_flag
-              ? &qB[(k + PREFETCH_K_DIST) * ldb / 2 + n / 2]
-              : &qB[(k + PREFETCH_K_DIST) * ldb + n];
+          auto prefetch_addr =
+              &qB[get_packed_offset(qw_type, (k + PREFETCH_K_DIST) * ldb + n)];
           _mm_prefetch(prefetch_addr, _MM_HINT_T0);
         }
         // store vb to B
@@ -1189,7 +1339,6 @@ struct dequant_n_grouped {
       const Lambda3& store) {
     using VA = VecArray<N_GROUP_SIZE, Tin>;
     using VAT = typename VA::type;
-    constexpr bool is_4bit_flag = is_4bit(qw_type);
     for (int n = 0; n < N; n += N_GROUP_SIZE) {
       for (int k = 0; k < K; k++) {
         // load scales and zps
@@ -1201,14 +1350,13 @@ struct dequant_n_grouped {
         }
         // load and dequant qB to vb
         auto vbs = load_qint_as_fp(
-            is_4bit_flag ? &qB[k * ldb / 2 + n / 2] : &qB[k * ldb + n],
+            &qB[get_packed_offset(qw_type, k * ldb + n)],
             vscales,
             vzps);
         // prefetch qB data
         if constexpr (PREFETCH_K_DIST > 0) {
-          auto prefetch_addr = is_4bit_flag
-              ? &qB[(k + PREFETCH_K_DIST) * ldb / 2 + n / 2]
-              : &qB[(k + PREFETCH_K_DIST) * ldb + n];
+          auto prefetch_addr =
+              &qB[get_packed_offset(qw_type, (k + PREFETCH_K_DIST) * ldb + n)];
           _mm_prefetch(prefetch_addr, _MM_HINT_T0);
         }
         // store vb to B
@@ -1276,7 +1424,6 @@ struct dequant_n_grouped<bfloat16, ldb, N_GROUP_SIZE, qw_type, sym_quant_w> {
     using VA = VecArray<N_GROUP_SIZE, float>;
     using VAT = typename VA::type;
     constexpr long COLS = VA::num_vec;
-    constexpr bool is_4bit_flag = is_4bit(qw_type);
 
     for (int n = 0; n < N; n += N_GROUP_SIZE) {
       // load scales and zps
@@ -1289,19 +1436,17 @@ struct dequant_n_grouped<bfloat16, ldb, N_GROUP_SIZE, qw_type, sym_quant_w> {
       for (int k = 0; k < K; k += 2) {
         // load and dequant qB to vb
         auto vbs_k0 = load_qint_as_fp(
-            is_4bit_flag ? &qB[k * ldb / 2 + n / 2] : &qB[k * ldb + n],
+            &qB[get_packed_offset(qw_type, k * ldb + n)],
             vscales,
             vzps);
         auto vbs_k1 = load_qint_as_fp(
-            is_4bit_flag ? &qB[(k + 1) * ldb / 2 + n / 2]
-                         : &qB[(k + 1) * ldb + n],
+            &qB[get_packed_offset(qw_type, (k + 1) * ldb + n)],
             vscales,
             vzps);
         // prefetch qB data
         if constexpr (PREFETCH_K_DIST > 0) {
-          auto prefetch_addr = is_4bit_flag
-              ? &qB[(k + PREFETCH_K_DIST) * ldb / 2 + n / 2]
-              : &qB[(k + PREFETCH_K_DIST) * ldb + n];
+          auto prefetch_addr =
+              &qB[get_packed_offset(qw_type, (k + PREFETCH_K_DIST) * ldb + n)];
           _mm_prefetch(prefetch_addr, _MM_HINT_T0);
         }
         typename VA::type vbs[2];
@@ -1340,7 +1485,6 @@ struct dequant_n_grouped<bfloat16, ldb, N_GROUP_SIZE, qw_type, sym_quant_w> {
     using VA = VecArray<N_GROUP_SIZE, float>;
     using VAT = typename VA::type;
     constexpr long COLS = VA::num_vec;
-    constexpr bool is_4bit_flag = is_4bit(qw_type);
 
     for (int n = 0; n < N; n += N_GROUP_SIZE) {
       // convert to vnni: [K/2, N, 2]
@@ -1354,7 +1498,7 @@ struct dequant_n_grouped<bfloat16, ldb, N_GROUP_SIZE, qw_type, sym_quant_w> {
         }
         // load and dequant qB to vb
         auto vbs_k0 = load_qint_as_fp(
-            is_4bit_flag ? &qB[k * ldb / 2 + n / 2] : &qB[k * ldb + n],
+            &qB[get_packed_offset(qw_type, k * ldb + n)],
             vscales,
             vzps);
         g = g_idx[k_start + k + 1];
@@ -1363,15 +1507,13 @@ struct dequant_n_grouped<bfloat16, ldb, N_GROUP_SIZE, qw_type, sym_quant_w> {
           vzps = load_qparam(zps + g * N + n);
         }
         auto vbs_k1 = load_qint_as_fp(
-            is_4bit_flag ? &qB[(k + 1) * ldb / 2 + n / 2]
-                         : &qB[(k + 1) * ldb + n],
+            &qB[get_packed_offset(qw_type, (k + 1) * ldb + n)],
             vscales,
             vzps);
         // prefetch qB data
         if constexpr (PREFETCH_K_DIST > 0) {
-          auto prefetch_addr = is_4bit_flag
-              ? &qB[(k + PREFETCH_K_DIST) * ldb / 2 + n / 2]
-              : &qB[(k + PREFETCH_K_DIST) * ldb + n];
+          auto prefetch_addr =
+              &qB[get_packed_offset(qw_type, (k + PREFETCH_K_DIST) * ldb + n)];
           _mm_prefetch(prefetch_addr, _MM_HINT_T0);
         }
         typename VA::type vbs[2];
@@ -1449,6 +1591,8 @@ struct Dequantize<float, ldb, N_GROUP_SIZE, qw_type, sym_quant_w, use_g_idx> {
       } else {
         lut = V::set_0_to_15();
       }
+    } else if constexpr (is_lowbit(qw_type)) {
+      lut = V::set_lowbit_lut(get_weight_bits(qw_type), sym_quant_w);
     }
 
     auto load_qparam = [&](float* p) { return VA::load1d(p); };
@@ -1456,6 +1600,12 @@ struct Dequantize<float, ldb, N_GROUP_SIZE, qw_type, sym_quant_w, use_g_idx> {
       if constexpr (is_4bit_flag) {
         return load_dequant_4bit<N_GROUP_SIZE, sym_quant_w, T>::call(
             p, vscales, lut, vzps);
+      } else if constexpr (is_lowbit(qw_type)) {
+        return load_dequant_lowbit<
+            N_GROUP_SIZE,
+            get_weight_bits(qw_type),
+            sym_quant_w,
+            T>::call(p, vscales, lut, vzps);
       } else if constexpr (qw_type == WOQ_DTYPE_FP8) {
         return load_dequant_fp8<N_GROUP_SIZE, T>::call(p, vscales);
       } else {
@@ -1535,6 +1685,8 @@ struct Dequantize<
       } else {
         lut = V::set_0_to_15();
       }
+    } else if constexpr (is_lowbit(qw_type)) {
+      lut = V::set_lowbit_lut(get_weight_bits(qw_type), sym_quant_w);
     }
 
     auto load_qparam = [&](bfloat16* p) { return VA::load1d(p); };
@@ -1542,6 +1694,12 @@ struct Dequantize<
       if constexpr (is_4bit_flag) {
         return load_dequant_4bit<N_GROUP_SIZE, sym_quant_w, float>::call(
             p, vscales, lut, vzps);
+      } else if constexpr (is_lowbit(qw_type)) {
+        return load_dequant_lowbit<
+            N_GROUP_SIZE,
+            get_weight_bits(qw_type),
+            sym_quant_w,
+            float>::call(p, vscales, lut, vzps);
       } else if constexpr (qw_type == WOQ_DTYPE_FP8) {
         return load_dequant_fp8<N_GROUP_SIZE, float>::call(p, vscales);
       } else {
@@ -1618,6 +1776,8 @@ struct Dequantize<half, ldb, N_GROUP_SIZE, qw_type, sym_quant_w, use_g_idx> {
       } else {
         lut = V::set_0_to_15();
       }
+    } else if constexpr (is_lowbit(qw_type)) {
+      lut = V::set_lowbit_lut(get_weight_bits(qw_type), sym_quant_w);
     }
 
     auto load_qparam = [&](half* p) { return VA::load1d(p); };
@@ -1625,6 +1785,12 @@ struct Dequantize<half, ldb, N_GROUP_SIZE, qw_type, sym_quant_w, use_g_idx> {
       if constexpr (is_4bit_flag) {
         return load_dequant_4bit<N_GROUP_SIZE, sym_quant_w, T>::call(
             p, vscales, lut, vzps);
+      } else if constexpr (is_lowbit(qw_type)) {
+        return load_dequant_lowbit<
+            N_GROUP_SIZE,
+            get_weight_bits(qw_type),
+            sym_quant_w,
+            T>::call(p, vscales, lut, vzps);
       } else if constexpr (qw_type == WOQ_DTYPE_FP8) {
         return load_dequant_fp8<N_GROUP_SIZE, T>::call(p, vscales);
       } else {
@@ -1678,6 +1844,10 @@ struct Dequantize<
       int8_t* B,
       int32_t* compensation) {
 #if defined(CPU_CAPABILITY_AVX512_VNNI)
+    if constexpr (is_lowbit(qw_type)) {
+      call_lowbit<quant_a_mode>(qB, K, N, zps, B, compensation);
+      return;
+    }
     auto pqB = GetVLAPtr<uint8_t>(qB, {ldb, 2}); // [K/4,N,4] packed in 4-bit
     auto pB = GetVLAPtr<int8_t>(B, {ldb, 4}); // [K/4,N,4]
     __m256i ones = _mm256_set1_epi8(1);
@@ -1729,6 +1899,47 @@ struct Dequantize<
     }
 #else
     TLA_ASSERT(false, "not implemented");
+#endif
+  }
+
+ private:
+  // INT2/INT3 weights: every 16 columns x 4 rows of K are stored as a 2-bit
+  // plane (plus a 1-bit plane for INT3), see `load_lowbit_as_uint8`.
+  template <int quant_a_mode>
+  static inline void call_lowbit(
+      uint8_t* qB,
+      long K,
+      long N,
+      int8_t* zps,
+      int8_t* B,
+      int32_t* compensation) {
+#if defined(CPU_CAPABILITY_AVX512_VNNI)
+    constexpr int bits = get_weight_bits(qw_type);
+    auto pB = GetVLAPtr<int8_t>(B, {ldb, 4}); // [K/4,N,4]
+    __m512i ones = _mm512_set1_epi8(1);
+    for (int n = 0; n < N; n += 16) {
+      __m512i vzps;
+      if constexpr (sym_quant_w) {
+        vzps = _mm512_set1_epi8(1 << (bits - 1));
+      } else {
+        vzps = combine_m256i(load_zps_4vnni(&zps[n]));
+      }
+      __m512i vcompensate = _mm512_setzero_si512();
+      for (int k = 0; k < K / 4; k++) {
+        __m512i vb = load_lowbit_as_uint8<bits>(
+            qB + get_packed_offset(qw_type, (k * ldb + n) * 4));
+        vb = _mm512_sub_epi8(vb, vzps);
+        if constexpr (is_asymmetric_quant_a(quant_a_mode)) {
+          vcompensate = _mm512_dpbusd_epi32(vcompensate, ones, vb);
+        }
+        _mm512_storeu_si512(pB[k][n], vb);
+      }
+      if constexpr (is_asymmetric_quant_a(quant_a_mode)) {
+        _mm512_storeu_si512(&compensation[n], vcompensate);
+      }
+    }
+#else
+    TLA_ASSERT(false, "not implemented");
 #endif
   }
 };
@@ -1930,7 +2141,7 @@ class DequantGemmTPP<
                 kc_start / quant_block_multiple;
         Dequantize<Tin, ldb, N_GROUP_SIZE, qw_type, sym_quant_w, use_g_idx>::
             call(
-                qB + K * N * cnt,
+                qB + get_packed_offset(qw_type, K * N * cnt),
                 K,
                 N,
                 scales + N * quant_offset,
@@ -2145,7 +2356,7 @@ class DequantGemmTPP<
           template call<quant_a_mode>(qB, K, N, zps, B[0][0], compensation);
       (*pgemm)((int8_t*)qA[0], B[0][0], qC[0], 1, no_tile_cfg);
       if constexpr (PREFETCH_K_DIST > 0) {
-        _mm_prefetch(qB + N * K / 2, _MM_HINT_T0);
+        _mm_prefetch(qB + get_packed_offset(qw_type, N * K), _MM_HINT_T0);
         _mm_prefetch(A + K, _MM_HINT_T0);
       }
       // post-op and convert back to C
@@ -2770,7 +2981,8 @@ void qlinear_woq_affine_impl(
     int32_t* zps_a_ptr = nullptr,
     const c10::optional<at::Tensor>& compensation = c10::nullopt,
     const c10::optional<at::Tensor>& g_idx = c10::nullopt) {
-  const bool is_4bit_flag = is_4bit(qw_type);
+  // INT4/INT2/INT3 weights pack several values into one byte
+  const bool is_sub_byte = get_weight_bits(qw_type) < 8;
   constexpr bool asym_quant_w = is_asymmetric_quant_w(quant_w_mode);
   bool no_dequant_weight = compensation.has_value();
   if (no_dequant_weight) {
@@ -2783,7 +2995,9 @@ void qlinear_woq_affine_impl(
       std::is_same<TComp, uint8_t>();
   auto w_sizes = qw_packed.sizes();
   auto Nc = w_sizes[0];
-  auto Nb = (is_4bit_flag && !no_dequant_weight) ? w_sizes[3] * 2 : w_sizes[3];
+  auto Nb = (is_sub_byte && !no_dequant_weight)
+      ? w_sizes[3] * 8 / get_weight_bits(qw_type)
+      : w_sizes[3];
   auto Kc = w_sizes[1];
   auto Kb = w_sizes[2];
   auto N = Nc * Nb;
@@ -2799,7 +3013,7 @@ void qlinear_woq_affine_impl(
   // For first token with large M, go to the dequant upfront path
   // Now it only supports INT8 weight
   if constexpr (!std::is_same<TComp, uint8_t>()) {
-    if (M >= DEQUANT_UPFRONT_THRESHOLD && !is_4bit_flag) {
+    if (M >= DEQUANT_UPFRONT_THRESHOLD && !is_sub_byte) {
       qlinear_woq_affine_dequant_upfront_impl<
           T,
           TComp,
@@ -2864,16 +3078,17 @@ void qlinear_woq_affine_impl(
   if (M < PARALLEL_M_THRESHOLD) {
     Kcb = 1;
   } else if (
-      is_4bit_flag || !std::is_same<T, TComp>() ||
+      is_sub_byte || !std::is_same<T, TComp>() ||
       std::is_same<TComp, uint8_t>()) {
     Kcb = 1;
   } else if (M >= PARALLEL_M_THRESHOLD) {
     Kcb = IPEX_KCB_BLOCK_SIZE;
   }
   auto px = GetVLAPtr<T>(x, {Kc, Kb});
+  auto Nb_packed =
+      (is_sub_byte && !no_dequant_weight) ? get_packed_offset(qw_type, Nb) : Nb;
   auto pw = GetVLAPtr<uint8_t>(
-      (uint8_t*)qw_packed.data_ptr(),
-      {Kc, Kb * ((is_4bit_flag && !no_dequant_weight) ? Nb / 2 : Nb)});
+      (uint8_t*)qw_packed.data_ptr(), {Kc, Kb * Nb_packed});
   auto py = GetVLAPtr<Tout>(y, {Nc, Nb}); /*[M, Nc, Nb]*/
   int scales_kc = quant_w_mode == QUANT_W_PER_CHANNEL ||
           quant_w_mode == QUANT_W_PER_CHANNEL_SYM
@@ -3045,7 +3260,9 @@ void qlinear_woq_affine_impl(
               WOQ_DTYPE_INT8,
               WOQ_DTYPE_INT4,
               WOQ_DTYPE_NF4,
-              WOQ_DTYPE_FP8>,
+              WOQ_DTYPE_FP8,
+              WOQ_DTYPE_INT2,
+              WOQ_DTYPE_INT3>,
           enumerate_dispatcher<bool, false, true>,
           enumerate_dispatcher<bool, false, true>>>::
       call(
@@ -3508,6 +3725,257 @@ void qlinear_woq_affine_impl(
           [](auto tuple) { failing_fallback(); });
 }
 
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX2_VNNI)
+// Small-M WoQ GEMM for machines without AVX512, where the packed kernels above
+// are not built. The reference path dequantizes the whole weight on every
+// call, which dominates decode, so here each weight row is unpacked in
+// registers and reused by all rows of x instead.
+static inline float _woq_hsum_avx2(__m256 a) {
+  auto sum =
+      _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+  return _mm_cvtss_f32(sum);
+}
+
+// 32 INT4 values from 16 bytes, k = 2j in the low and k = 2j + 1 in the high
+// nibble of byte j, to 32 uint8 values in k order
+static inline __m256i _woq_unpack_int4_avx2(const uint8_t* p) {
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  auto bytes = _mm_loadu_si128((const __m128i*)p);
+  auto lo = _mm_and_si128(bytes, mask);
+  auto hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+  return _mm256_set_m128i(
+      _mm_unpackhi_epi8(lo, hi), _mm_unpacklo_epi8(lo, hi));
+}
+
+template <bool is_int4>
+static inline void _woq_load_w32_avx2(const uint8_t* w, int64_t k, __m256* v) {
+  if constexpr (is_int4) {
+    auto u8 = _woq_unpack_int4_avx2(w + k / 2);
+    auto u8_lo = _mm256_castsi256_si128(u8);
+    auto u8_hi = _mm256_extracti128_si256(u8, 1);
+    v[0] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8_lo));
+    v[1] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(u8_lo, 8)));
+    v[2] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8_hi));
+    v[3] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(u8_hi, 8)));
+  } else {
+    for (int j = 0; j < 4; j++) {
+      auto s8 = _mm_loadl_epi64((const __m128i*)(w + k + j * 8));
+      v[j] = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(s8));
+    }
+  }
+}
+
+// y[i] = sum_k x[i][k] * (w[k] - zp) * scale for MB rows of x and one weight
+// row. The sums run on the raw quantized values per block of K, the zero
+// point term is subtracted once per block through the block sums of x. With
+// act_int8, x holds symmetric INT8 activations with one scale per block and
+// the INT4 weights are multiplied as u8 x s8 (with AVX-VNNI when available).
+template <int MB, bool is_int4, bool act_int8>
+static void woq_gemv_avx2_rows(
+    const float* x,
+    const int8_t* xq,
+    const float* x_blk_scale,
+    const float* x_blk_sum,
+    int64_t ldx,
+    const uint8_t* w,
+    const float* w_scale,
+    const float* w_zp,
+    float w_zp_sym,
+    bool per_group,
+    int64_t n_blocks,
+    int64_t kb,
+    float* y,
+    int64_t ldy) {
+  __m256 acc[MB];
+  float zp_acc[MB];
+  for (int i = 0; i < MB; i++) {
+    acc[i] = _mm256_setzero_ps();
+    zp_acc[i] = 0.0f;
+  }
+  for (int64_t b = 0; b < n_blocks; b++) {
+    const auto gw = per_group ? b : 0;
+    const float s = w_scale[gw];
+    const float z = w_zp ? w_zp[gw] : w_zp_sym;
+    if constexpr (act_int8) {
+      __m256i bacc[MB];
+      for (int i = 0; i < MB; i++) {
+        bacc[i] = _mm256_setzero_si256();
+      }
+#if !defined(CPU_CAPABILITY_AVX2_VNNI)
+      const __m256i ones = _mm256_set1_epi16(1);
+#endif
+      for (int64_t k = b * kb; k < (b + 1) * kb; k += 32) {
+        auto wv = _woq_unpack_int4_avx2(w + k / 2);
+        for (int i = 0; i < MB; i++) {
+          auto xv = _mm256_loadu_si256((const __m256i*)(xq + i * ldx + k));
+#if defined(CPU_CAPABILITY_AVX2_VNNI)
+          bacc[i] = _mm256_dpbusd_avx_epi32(bacc[i], wv, xv);
+#else
+          // 2 * 15 * 127 fits in int16, maddubs does not saturate here
+          bacc[i] = _mm256_add_epi32(
+              bacc[i], _mm256_madd_epi16(_mm256_maddubs_epi16(wv, xv), ones));
+#endif
+        }
+      }
+      for (int i = 0; i < MB; i++) {
+        const float sa = s * x_blk_scale[i * n_blocks + b];
+        acc[i] = _mm256_fmadd_ps(
+            _mm256_cvtepi32_ps(bacc[i]), _mm256_set1_ps(sa), acc[i]);
+        zp_acc[i] += sa * z * x_blk_sum[i * n_blocks + b];
+      }
+    } else {
+      __m256 bacc[MB];
+      for (int i = 0; i < MB; i++) {
+        bacc[i] = _mm256_setzero_ps();
+      }
+      for (int64_t k = b * kb; k < (b + 1) * kb; k += 32) {
+        __m256 wv[4];
+        _woq_load_w32_avx2<is_int4>(w, k, wv);
+        for (int i = 0; i < MB; i++) {
+          for (int j = 0; j < 4; j++) {
+            auto xv = _mm256_loadu_ps(x + i * ldx + k + j * 8);
+            bacc[i] = _mm256_fmadd_ps(wv[j], xv, bacc[i]);
+          }
+        }
+      }
+      for (int i = 0; i < MB; i++) {
+        acc[i] = _mm256_fmadd_ps(bacc[i], _mm256_set1_ps(s), acc[i]);
+        zp_acc[i] += s * z * x_blk_sum[i * n_blocks + b];
+      }
+    }
+  }
+  for (int i = 0; i < MB; i++) {
+    y[i * ldy] = _woq_hsum_avx2(acc[i]) - zp_acc[i];
+  }
+}
+
+// Returns an fp32 [M, N] output, or an undefined tensor when the weight
+// layout is not covered and the caller should take the reference path.
+// Covers plain INT4 and INT8 weights with fp32 scales and zero points, per
+// channel or with groups that are multiples of 32, and K a multiple of 32.
+static at::Tensor woq_gemm_small_m_avx2(
+    const at::Tensor& x,
+    const at::Tensor& qw,
+    const at::Tensor& scale,
+    const at::Tensor& zp,
+    const int qw_type,
+    int64_t quant_block_k,
+    bool act_int8) {
+  auto K = x.size(-1);
+  auto M = x.numel() / K;
+  auto N = qw.size(0);
+  const bool is_int4 = qw_type == WOQ_DTYPE_INT4;
+  const bool per_group = quant_block_k > 0 && quant_block_k < K;
+  const int64_t G = per_group ? K / quant_block_k : 1;
+  if ((!is_int4 && qw_type != WOQ_DTYPE_INT8) || K % 32 != 0 ||
+      (per_group && (quant_block_k % 32 != 0 || K % quant_block_k != 0)) ||
+      !qw.is_contiguous() || qw.size(1) != (is_int4 ? K / 2 : K) ||
+      (!is_int4 && qw.scalar_type() != at::kChar) ||
+      scale.scalar_type() != at::kFloat || scale.numel() != N * G ||
+      (zp.defined() &&
+       (zp.scalar_type() != at::kFloat || zp.numel() != N * G))) {
+    return at::Tensor();
+  }
+  act_int8 = act_int8 && is_int4;
+  // per channel weights still split K into blocks, they bound the INT8
+  // activation scales and the int32 partial sums
+  const int64_t kb = per_group ? quant_block_k : (K % 128 == 0 ? 128 : 32);
+  const int64_t n_blocks = K / kb;
+  auto x_fp = x.reshape({M, K}).to(at::kFloat).contiguous();
+  auto x_ptr = x_fp.data_ptr<float>();
+  auto x_blk_sum = at::empty({M, n_blocks}, at::kFloat);
+  auto x_blk_sum_ptr = x_blk_sum.data_ptr<float>();
+  at::Tensor x_q, x_blk_scale;
+  int8_t* x_q_ptr = nullptr;
+  float* x_blk_scale_ptr = nullptr;
+  if (act_int8) {
+    x_q = at::empty({M, K}, at::kChar);
+    x_blk_scale = at::empty({M, n_blocks}, at::kFloat);
+    x_q_ptr = x_q.data_ptr<int8_t>();
+    x_blk_scale_ptr = x_blk_scale.data_ptr<float>();
+  }
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t b = 0; b < n_blocks; b++) {
+      const float* xb = x_ptr + m * K + b * kb;
+      float sum = 0.0f;
+      if (act_int8) {
+        float amax = 0.0f;
+        for (int64_t k = 0; k < kb; k++) {
+          amax = std::max(amax, std::abs(xb[k]));
+        }
+        const float sa = amax > 0.0f ? amax / 127.0f : 1.0f;
+        int8_t* xqb = x_q_ptr + m * K + b * kb;
+        for (int64_t k = 0; k < kb; k++) {
+          xqb[k] = static_cast<int8_t>(std::nearbyint(xb[k] / sa));
+          sum += xqb[k];
+        }
+        x_blk_scale_ptr[m * n_blocks + b] = sa;
+      } else {
+        for (int64_t k = 0; k < kb; k++) {
+          sum += xb[k];
+        }
+      }
+      x_blk_sum_ptr[m * n_blocks + b] = sum;
+    }
+  }
+  auto y = at::empty({M, N}, at::kFloat);
+  auto y_ptr = y.data_ptr<float>();
+  auto w_ptr = (const uint8_t*)qw.data_ptr();
+  const int64_t ldw = qw.size(1);
+  auto scale_c = scale.contiguous();
+  auto zp_c = zp.defined() ? zp.contiguous() : zp;
+  auto s_ptr = scale_c.data_ptr<float>();
+  auto z_ptr = zp_c.defined() ? zp_c.data_ptr<float>() : nullptr;
+  const float zp_sym = is_int4 ? 8.0f : 0.0f;
+  constexpr int MAX_MB = 4;
+  at::parallel_for(0, N, 16, [&](int64_t n_start, int64_t n_end) {
+    for (int64_t n = n_start; n < n_end; n++) {
+      for (int64_t m = 0; m < M; m += MAX_MB) {
+        auto mb = std::min<int64_t>(MAX_MB, M - m);
+#define WOQ_GEMV_AVX2_ROWS(MB, IS_INT4, ACT_INT8)                           \
+  woq_gemv_avx2_rows<MB, IS_INT4, ACT_INT8>(                                \
+      x_ptr + m * K,                                                        \
+      x_q_ptr ? x_q_ptr + m * K : nullptr,                                  \
+      x_blk_scale_ptr ? x_blk_scale_ptr + m * n_blocks : nullptr,           \
+      x_blk_sum_ptr + m * n_blocks,                                         \
+      K,                                                                    \
+      w_ptr + n * ldw,                                                      \
+      s_ptr + n * G,                                                        \
+      z_ptr ? z_ptr + n * G : nullptr,                                      \
+      zp_sym,                                                               \
+      per_group,                                                            \
+      n_blocks,                                                             \
+      kb,                                                                   \
+      y_ptr + m * N + n,                                                    \
+      N)
+#define WOQ_GEMV_AVX2_DISPATCH(MB)             \
+  if (act_int8) {                              \
+    WOQ_GEMV_AVX2_ROWS(MB, true, true);        \
+  } else if (is_int4) {                        \
+    WOQ_GEMV_AVX2_ROWS(MB, true, false);       \
+  } else {                                     \
+    WOQ_GEMV_AVX2_ROWS(MB, false, false);      \
+  }
+        if (mb == 4) {
+          WOQ_GEMV_AVX2_DISPATCH(4)
+        } else if (mb == 3) {
+          WOQ_GEMV_AVX2_DISPATCH(3)
+        } else if (mb == 2) {
+          WOQ_GEMV_AVX2_DISPATCH(2)
+        } else {
+          WOQ_GEMV_AVX2_DISPATCH(1)
+        }
+#undef WOQ_GEMV_AVX2_DISPATCH
+#undef WOQ_GEMV_AVX2_ROWS
+      }
+    }
+  });
+  return y;
+}
+#endif
+
 static at::Tensor woq_gemm_ref_impl(
     const at::Tensor& x,
     const at::Tensor& qw,
@@ -3520,7 +3988,8 @@ static at::Tensor woq_gemm_ref_impl(
     const TensorList& others_list,
     int64_t quant_w_mode = 0,
     int64_t quant_block_k = 0,
-    const c10::optional<at::Tensor>& g_idx = c10::nullopt) {
+    const c10::optional<at::Tensor>& g_idx = c10::nullopt,
+    bool act_int8 = false) {
   constexpr size_t fp32_idx = 0, fp16_idx = 1, bf16_idx = 2, int8_idx = 3;
   auto biases = bias_list.empty()
       ? TensorList({at::Tensor(), at::Tensor(), at::Tensor()})
@@ -3562,12 +4031,23 @@ static at::Tensor woq_gemm_ref_impl(
       zp = zp_list[fp32_idx].unsqueeze(-1);
     }
   }
-  auto w = torch_ipex::cpu::dequantize_woq_weight(
-               qw, {N, K}, scale, zp, qw_type, quant_block_k)
-               .to(compute_dtype);
-  auto x_reshape = x.reshape({M, K});
-  auto x_fp = x_reshape.to(compute_dtype);
-  auto y = at::linear(x_fp, w);
+  at::Tensor y;
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX2_VNNI)
+  if (M < SMALL_BATCH_THRESHOLD && !g_idx.has_value()) {
+    y = woq_gemm_small_m_avx2(
+        x, qw, scale, zp, qw_type, quant_block_k, act_int8);
+  }
+#endif
+  if (y.defined()) {
+    y = y.to(compute_dtype);
+  } else {
+    auto w = torch_ipex::cpu::dequantize_woq_weight(
+                 qw, {N, K}, scale, zp, qw_type, quant_block_k)
+                 .to(compute_dtype);
+    auto x_reshape = x.reshape({M, K});
+    auto x_fp = x_reshape.to(compute_dtype);
+    y = at::linear(x_fp, w);
+  }
   if (biases[0].defined()) {
     auto b_index = compute_dtype == at::kFloat ? fp32_idx
         : compute_dtype == at::kHalf           ? fp16_idx
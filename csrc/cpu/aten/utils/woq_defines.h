@@ -7,6 +7,8 @@
 #define WOQ_DTYPE_INT4 2
 #define WOQ_DTYPE_NF4 3
 #define WOQ_DTYPE_FP8 4
+#define WOQ_DTYPE_INT2 5
+#define WOQ_DTYPE_INT3 6
 
 #define UNQUANT_A -1
 #define QUANT_A_PER_TENSOR 0
@@ -51,6 +53,10 @@
 #define GPTQ_WEIGHT_FORMAT 1
 #define AWQ_WEIGHT_FORMAT 2
 
+// INT2/INT3 weight format before packing (plain format only)
+// int2: [N, K / 4] in uint8, value k at bits [2 * (k % 4), 2 * (k % 4) + 2)
+// int3: [N, K] in uint8, one value per byte
+
 constexpr bool is_asymmetric_quant_a(const int quant_a_mode) {
   return quant_a_mode <= QUANT_A_PER_M_K_BLOCK;
 }
@@ -62,3 +68,21 @@ constexpr bool is_asymmetric_quant_w(const int quant_w_mode) {
 constexpr bool is_4bit(const int qw_type) {
   return qw_type == WOQ_DTYPE_INT4 || qw_type == WOQ_DTYPE_NF4;
 }
+
+constexpr bool is_lowbit(const int qw_type) {
+  return qw_type == WOQ_DTYPE_INT2 || qw_type == WOQ_DTYPE_INT3;
+}
+
+// Number of bits a weight element takes in the packed weight
+constexpr int get_weight_bits(const int qw_type) {
+  return is_4bit(qw_type)         ? 4
+      : qw_type == WOQ_DTYPE_INT3 ? 3
+      : qw_type == WOQ_DTYPE_INT2 ? 2
+                                  : 8;
+}
+
+// Byte offset of the n-th weight element in a packed weight block.
+// n must be a multiple of 8 so that it never points into the middle of a byte.
+constexpr long get_packed_offset(const int qw_type, long n) {
+  return n * get_weight_bits(qw_type) / 8;
+}
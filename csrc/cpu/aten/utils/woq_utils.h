@@ -95,9 +95,21 @@ static at::Tensor dequantize_woq_weight(
     w_int8 = at::empty({N, qw.size(1) * 2}, qw.options().dtype(at::kByte));
     w_int8.index({Slice(), Slice(None, None, 2)}).copy_(qw.bitwise_and(0xf));
     w_int8.index({Slice(), Slice(1, None, 2)}).copy_(qw.bitwise_right_shift(4));
-  } else { // INT8
+  } else if (qw_type == WOQ_DTYPE_INT2) {
+    // unpack to uint8, 4 values per byte
+    w_int8 = at::empty({N, qw.size(1) * 4}, qw.options().dtype(at::kByte));
+    for (int i = 0; i < 4; ++i) {
+      w_int8.index({Slice(), Slice(i, None, 4)})
+          .copy_(qw.bitwise_right_shift(2 * i).bitwise_and(0x3));
+    }
+  } else { // INT8 or INT3 (1 value per byte)
     w_int8 = qw;
   }
+  // shift unsigned INT4/INT2/INT3 values to be centered at zero for sym quant
+  const int sym_offset = qw_type == WOQ_DTYPE_INT4 ? 8
+      : qw_type == WOQ_DTYPE_INT2                  ? 2
+      : qw_type == WOQ_DTYPE_INT3                  ? 4
+                                                   : 0;
   at::Tensor dqw;
   if (scale.sizes().vec() == weight_shape) {
     if (zp.defined()) {
@@ -107,8 +119,8 @@ static at::Tensor dequantize_woq_weight(
     }
     auto w_fp = qw_type == WOQ_DTYPE_NF4 ? map_nf4_tensor_to_float(w_int8)
                                          : w_int8.to(at::kFloat);
-    if (qw_type == WOQ_DTYPE_INT4 && sym_quant) {
-      w_fp = w_fp - 8;
+    if (sym_offset > 0 && sym_quant) {
+      w_fp = w_fp - sym_offset;
     }
     if (w_fp.sizes().vec() != weight_shape) {
       w_fp = w_fp.narrow(1, 0, K).contiguous();
@@ -117,9 +129,9 @@ static at::Tensor dequantize_woq_weight(
   } else if (group_size <= 0) {
     if (qw_type == WOQ_DTYPE_NF4) {
       dqw = map_nf4_tensor_to_float(w_int8) * scale;
-    } else if (qw_type == WOQ_DTYPE_INT4 && sym_quant) {
-      // shift from [0, 15] to [-8, 7]
-      dqw = (w_int8.to(at::kFloat) - 8) * scale;
+    } else if (sym_offset > 0 && sym_quant) {
+      // e.g., shift from [0, 15] to [-8, 7] for INT4
+      dqw = (w_int8.to(at::kFloat) - sym_offset) * scale;
     } else {
       dqw = sym_quant ? w_int8.to(at::kFloat) * scale
                       : (w_int8.to(at::kFloat) - zp) * scale;
@@ -129,9 +141,9 @@ static at::Tensor dequantize_woq_weight(
     auto rem = K % group_size;
     auto w_fp = qw_type == WOQ_DTYPE_NF4 ? map_nf4_tensor_to_float(w_int8)
                                          : w_int8.to(at::kFloat);
-    if (qw_type == WOQ_DTYPE_INT4 && sym_quant) {
-      // shift from [0, 15] to [-8, 7]
-      w_fp -= 8;
+    if (sym_offset > 0 && sym_quant) {
+      // e.g., shift from [0, 15] to [-8, 7] for INT4
+      w_fp -= sym_offset;
     }
     if (rem > 0) {
       dqw = at::empty({N, K}, qw.options().dtype(at::kFloat));
@@ -154,14 +166,42 @@ static at::Tensor dequantize_woq_weight(
     }
     dqw = dqw.view({N, -1});
   }
-  if (K != qw.size(1) * 2) {
+  if (K != w_int8.size(1)) {
     TORCH_CHECK(
-        K < qw.size(1) * 2, 'WOQ Linear kernel: Unexpected weight shape');
+        K < w_int8.size(1), "WOQ Linear kernel: Unexpected weight shape");
     dqw = dqw.narrow(1, 0, K).contiguous();
   }
   return dqw;
 }
 
+// Dequantize per-M or per-M-K-block quantized activation, e.g. the output of
+// rmsnorm_dynamic_quant, back to `out_dtype` for the reference path.
+// scale_a is [M] or [M, Kc] and zp_a is undefined for symmetric quantization.
+static at::Tensor dequantize_woq_activation(
+    const at::Tensor& x_q,
+    const at::Tensor& scale_a,
+    const at::Tensor& zp_a,
+    int64_t quant_block_k,
+    at::ScalarType out_dtype) {
+  auto K = x_q.size(-1);
+  auto M = x_q.numel() / K;
+  bool per_m = scale_a.dim() == 1;
+  auto block_k = per_m ? K : quant_block_k;
+  auto Kc = (K + block_k - 1) / block_k;
+  auto x = at::pad(
+               x_q.reshape({M, K}).to(at::kFloat),
+               {0, Kc * block_k - K},
+               "constant",
+               0)
+               .view({M, Kc, block_k});
+  auto scale = scale_a.view({M, Kc, 1});
+  auto dqx = zp_a.defined() ? (x - zp_a.view({M, Kc, 1})) * scale : x * scale;
+  return dqx.view({M, Kc * block_k})
+      .narrow(1, 0, K)
+      .to(out_dtype)
+      .reshape(x_q.sizes());
+}
+
 // Define this macro to make code more concise
 #define CALL_WOQ_KERNEL_IMPL_INT8(T, quant_a_mode) \
   qlinear_woq_affine_impl<                         \
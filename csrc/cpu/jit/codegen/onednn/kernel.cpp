@@ -25,6 +25,11 @@ thread_local std::
     unordered_map<std::vector<int64_t>, LlgaKernel::list_iterator_t>
         LlgaKernel::cache_items_map_;
 thread_local int LlgaKernel::capacity_ = 7500;
+std::unordered_map<std::vector<int64_t>, LlgaKernel::compiled_entry_ptr>
+    LlgaKernel::compiled_partitions_;
+std::list<std::vector<int64_t>> LlgaKernel::compiled_partitions_order_;
+int LlgaKernel::compiled_partitions_capacity_ = 7500;
+ReadWriteMutex LlgaKernel::compiled_partitions_mutex_;
 
 LlgaKernel::LlgaKernel(const Node* fusionNode)
     : fusionNode_(fusionNode),
@@ -451,6 +456,29 @@ std::pair<compiled_partition, ArgSpecs> LlgaKernel::compile(
   return std::make_pair(compilation, outputSpecs);
 }
 
+LlgaKernel::compiled_entry_ptr LlgaKernel::lookupCompiledPartition(
+    const std::vector<int64_t>& key) {
+  UniqueReadLock<ReadWriteMutex> lock(compiled_partitions_mutex_);
+  auto iter = compiled_partitions_.find(key);
+  if (iter == compiled_partitions_.end())
+    return nullptr;
+  return iter->second;
+}
+
+void LlgaKernel::storeCompiledPartition(
+    const std::vector<int64_t>& key,
+    compiled_entry_ptr entry) {
+  UniqueWriteLock<ReadWriteMutex> lock(compiled_partitions_mutex_);
+  // another thread may have compiled the same partition meanwhile
+  if (!compiled_partitions_.emplace(key, std::move(entry)).second)
+    return;
+  compiled_partitions_order_.push_back(key);
+  if (compiled_partitions_.size() > compiled_partitions_capacity_) {
+    compiled_partitions_.erase(compiled_partitions_order_.front());
+    compiled_partitions_order_.pop_front();
+  }
+}
+
 LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
     Stack& stack,
     TensorArgs& outputs) {
@@ -478,13 +506,23 @@ LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
   }
   auto iter = cache_items_map_.find(key);
   if (iter == cache_items_map_.end()) {
-    GRAPH_DEBUG("Compiling partition");
     cp_entry compiledPartitionEntry;
-    auto input_shape = inputs[0].sizes().vec();
     auto inputSpecs = initializeInputSpecs(inputs);
-    auto compilationOutput = compile(partition_, inputs, inputSpecs);
-    compiledPartitionEntry.outputSpecs_ = std::move(compilationOutput.second);
-    compiledPartitionEntry.cp_ = std::move(compilationOutput.first);
+    if (auto compiled = lookupCompiledPartition(key)) {
+      GRAPH_DEBUG("Reusing partition compiled by another thread");
+      compiledPartitionEntry.cp_ = compiled->cp_;
+      compiledPartitionEntry.outputSpecs_ = compiled->outputSpecs_;
+    } else {
+      GRAPH_DEBUG("Compiling partition");
+      auto compilationOutput = compile(partition_, inputs, inputSpecs);
+      compiledPartitionEntry.outputSpecs_ = compilationOutput.second;
+      compiledPartitionEntry.cp_ = compilationOutput.first;
+      storeCompiledPartition(
+          key,
+          std::make_shared<const compiled_entry>(compiled_entry{
+              std::move(compilationOutput.first),
+              std::move(compilationOutput.second)}));
+    }
     prepareAndCacheRunArgs(
         compiledPartitionEntry.inputLLGATensors_,
         compiledPartitionEntry.outputLLGATensors_,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <list>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include "codegen/LlgaTensorImpl.h"
@@ -176,6 +178,26 @@ class LlgaKernel {
   static thread_local std::unordered_map<std::vector<int64_t>, list_iterator_t>
       cache_items_map_;
   static thread_local int capacity_;
+
+  // The thread-local LRU above holds run arguments that are rebound on every
+  // call, so it can't be shared. The compiled partitions themselves are kept
+  // in a process-wide cache as well, so that a thread missing its LRU reuses
+  // the partition another thread compiled instead of compiling it again.
+  struct compiled_entry {
+    dnnl::graph::compiled_partition cp_;
+    ArgSpecs outputSpecs_;
+  };
+  using compiled_entry_ptr = std::shared_ptr<const compiled_entry>;
+  static compiled_entry_ptr lookupCompiledPartition(
+      const std::vector<int64_t>& key);
+  static void storeCompiledPartition(
+      const std::vector<int64_t>& key,
+      compiled_entry_ptr entry);
+  static std::unordered_map<std::vector<int64_t>, compiled_entry_ptr>
+      compiled_partitions_;
+  static std::list<std::vector<int64_t>> compiled_partitions_order_;
+  static int compiled_partitions_capacity_;
+  static ReadWriteMutex compiled_partitions_mutex_;
   std::vector<std::vector<int64_t>> tracedInputShapes_;
   std::vector<std::vector<int64_t>> tracedInputStrides_;
   std::string debugName_;
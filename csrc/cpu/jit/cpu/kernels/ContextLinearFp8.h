@@ -0,0 +1,80 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+
+#include <ideep.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+
+// Compiled oneDNN matmul for one input shape. If the primitive could not
+// consume the prepacked weight layout directly, weight_desc_ is the layout
+// it expects and the weight is reordered on the fly.
+struct Fp8LinearPrimitive {
+  dnnl::matmul::primitive_desc primitive_desc_;
+  dnnl::matmul primitive_;
+  ideep::tensor::desc scratchpad_desc_;
+  bool reorder_weight_ = false;
+  ideep::tensor::desc weight_desc_;
+};
+
+// (M, input dtype, output dtype)
+using Fp8LinearPrimitiveKey =
+    std::tuple<int64_t, at::ScalarType, at::ScalarType>;
+
+struct ContextLinearFp8 final {
+  // [K, N] view of the public [N, K] fp8 weight
+  ideep::tensor::desc original_desc_;
+  ideep::tensor weight_packed_;
+  // at_weight_ owns the memory of weight_packed_
+  at::Tensor at_weight_;
+  at::ScalarType weight_dtype_;
+  std::vector<int64_t> weight_shape_;
+  c10::optional<at::Tensor> at_bias_;
+  // [1, N] view of at_bias_
+  ideep::tensor bias_;
+  // scales are read once at prepack time, never from a tensor at run time
+  float input_scale_;
+  float weight_scale_;
+  ideep::tensor input_scale_t_;
+  ideep::tensor weight_scale_t_;
+  std::map<Fp8LinearPrimitiveKey, Fp8LinearPrimitive> primitive_cache_;
+  std::unique_ptr<std::mutex> primitive_cache_mutex_;
+
+  ContextLinearFp8() = delete;
+
+  ContextLinearFp8(
+      ideep::tensor::desc&& original_desc,
+      ideep::tensor&& weight_packed,
+      at::Tensor&& at_weight,
+      at::ScalarType weight_dtype,
+      std::vector<int64_t>&& weight_shape,
+      c10::optional<at::Tensor>&& bias,
+      float input_scale,
+      float weight_scale)
+      : original_desc_(std::move(original_desc)),
+        weight_packed_(std::move(weight_packed)),
+        at_weight_(std::move(at_weight)),
+        weight_dtype_(weight_dtype),
+        weight_shape_(std::move(weight_shape)),
+        at_bias_(std::move(bias)),
+        input_scale_(input_scale),
+        weight_scale_(weight_scale),
+        input_scale_t_(ideep::scale_t(1, input_scale)),
+        weight_scale_t_(ideep::scale_t(1, weight_scale)),
+        primitive_cache_mutex_(std::make_unique<std::mutex>()) {}
+
+  ContextLinearFp8(ContextLinearFp8&&) = default;
+  ContextLinearFp8& operator=(ContextLinearFp8&&) = default;
+
+  ~ContextLinearFp8() {}
+};
+
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
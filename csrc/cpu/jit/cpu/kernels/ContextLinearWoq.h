@@ -5,6 +5,8 @@
 #define WOQ_DTYPE_INT8 1
 #define WOQ_DTYPE_INT4 2
 #define WOQ_DTYPE_NF4 3
+#define WOQ_DTYPE_INT2 5
+#define WOQ_DTYPE_INT3 6
 
 namespace torch_ipex {
 namespace cpu {
@@ -36,7 +38,7 @@ struct ContextLinearWoq final {
 
   ContextLinearWoq(
       at::Tensor&& at_weight,
-      int64_t weight_dtype, // int8=1, int4=2, nf4=3
+      int64_t weight_dtype, // int8=1, int4=2, nf4=3, int2=5, int3=6
       std::vector<int64_t>&& weight_shape,
       at::Tensor&& scales_float,
       c10::optional<at::Tensor>&& zero_point_float,
@@ -71,6 +73,10 @@ struct ContextLinearWoq final {
         int64_t block_n = at_weight_.size(-1);
         if (is_4bit_) {
           block_n *= 2;
+        } else if (weight_dtype == WOQ_DTYPE_INT2) {
+          block_n *= 4;
+        } else if (weight_dtype == WOQ_DTYPE_INT3) {
+          block_n = block_n * 8 / 3;
         }
         TORCH_CHECK(scales_float.size(0) % block_n == 0);
         std::vector<int64_t> reshape_dim = {
@@ -132,6 +138,41 @@ struct ContextLinearWoq final {
     }
   }
 
+  // Restore a context from already packed data, e.g. memory mapped from a
+  // packed weight file. Nothing is packed, converted or copied.
+  ContextLinearWoq(
+      at::Tensor&& at_weight,
+      int64_t weight_dtype,
+      std::vector<int64_t>&& weight_shape,
+      std::vector<at::Tensor>&& scales_list,
+      std::vector<at::Tensor>&& zero_points_list,
+      std::vector<at::Tensor>&& bias_list,
+      c10::optional<at::Tensor>&& bias,
+      c10::optional<at::Tensor>&& g_idx,
+      c10::optional<at::Tensor>&& compensation,
+      int64_t group_size,
+      int64_t lowp_mode,
+      int64_t act_quant_mode,
+      bool cache_weight_for_large_batch,
+      bool handle_g_idx_in_kernel)
+      : at_weight_(std::move(at_weight)),
+        weight_dtype_(weight_dtype),
+        weight_shape_(std::move(weight_shape)),
+        at_bias_(std::move(bias)),
+        g_idx_(std::move(g_idx)),
+        bias_list_(std::move(bias_list)),
+        scales_list_(std::move(scales_list)),
+        zero_points_list_(std::move(zero_points_list)),
+        group_size_(group_size),
+        lowp_mode_(lowp_mode),
+        act_quant_mode_(act_quant_mode),
+        cache_weight_for_large_batch_(cache_weight_for_large_batch),
+        cached_compensation_(std::move(compensation)),
+        handle_g_idx_in_kernel_(handle_g_idx_in_kernel) {
+    is_4bit_ =
+        (weight_dtype == WOQ_DTYPE_INT4 || weight_dtype == WOQ_DTYPE_NF4);
+  }
+
   ContextLinearWoq(ContextLinearWoq&&) = default;
   ContextLinearWoq& operator=(ContextLinearWoq&&) = default;
 
@@ -0,0 +1,301 @@
+#include "LinearFp8Packed.h"
+#include <ideep.hpp>
+#include "ideep/IDeepConversions.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+namespace fp8_linear {
+
+namespace {
+
+// Primitives are compiled per M. Small M (decode, beams) get their own
+// primitive; larger M are rounded up to one of 8 buckets per power of two,
+// so that variable-length prefill reuses a handful of primitives at the cost
+// of at most 1/8 of padded rows.
+constexpr int64_t kExactMaxM = 16;
+constexpr int64_t kBucketsPerPow2 = 8;
+// bound for the cache, only reached with very many dtypes or huge M
+constexpr size_t kMaxCachedPrimitives = 256;
+
+int64_t bucket_m(int64_t M) {
+  if (M <= kExactMaxM) {
+    return M;
+  }
+  int64_t pow2 = 1;
+  while (pow2 * 2 <= M) {
+    pow2 *= 2;
+  }
+  int64_t step = std::max(pow2 / kBucketsPerPow2, int64_t(1));
+  return (M + step - 1) / step * step;
+}
+
+// dnnl::error is propagated to let the callers fall back on unsupported
+// layouts, see get_primitive.
+dnnl::matmul::primitive_desc create_primitive_desc(
+    const ideep::tensor::desc& src_desc,
+    const ideep::tensor::desc& weights_desc,
+    const ideep::tensor::desc& bias_desc,
+    const ideep::tensor::desc& dst_desc,
+    bool with_bias) {
+  auto op_attr = ideep::attr_t();
+  // always take the scales as runtime arguments so that a primitive stays
+  // valid when the scales of the context are reloaded
+  op_attr.set_scales_mask(DNNL_ARG_SRC, 0);
+  op_attr.set_scales_mask(DNNL_ARG_WEIGHTS, 0);
+  op_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+  auto engine = ideep::engine::cpu_engine();
+  return with_bias
+      ? dnnl::matmul::primitive_desc(
+            engine, src_desc, weights_desc, bias_desc, dst_desc, op_attr)
+      : dnnl::matmul::primitive_desc(
+            engine, src_desc, weights_desc, dst_desc, op_attr);
+}
+
+ideep::tensor::desc bias_desc_of(const ContextLinearFp8& context) {
+  if (!context.at_bias_.has_value()) {
+    return ideep::tensor::desc();
+  }
+  return ideep::tensor::desc(
+      context.bias_.get_dims(),
+      get_mkldnn_dtype(context.at_bias_.value().scalar_type()),
+      ideep::format_tag::any);
+}
+
+// Returned by value: the entry is a set of ref-counted oneDNN handles and the
+// cache may be cleared by another thread once the lock is released. The
+// scales are read under the same lock, as load_from_ctx may replace them.
+// M is the bucketed M.
+Fp8LinearPrimitive get_primitive(
+    ContextLinearFp8& context,
+    int64_t M,
+    at::ScalarType src_dtype,
+    at::ScalarType dst_dtype,
+    ideep::tensor& input_scale,
+    ideep::tensor& weight_scale) {
+  auto key = std::make_tuple(M, src_dtype, dst_dtype);
+  std::lock_guard<std::mutex> lock(*context.primitive_cache_mutex_);
+  input_scale = context.input_scale_t_;
+  weight_scale = context.weight_scale_t_;
+  auto it = context.primitive_cache_.find(key);
+  if (it != context.primitive_cache_.end()) {
+    return it->second;
+  }
+  if (context.primitive_cache_.size() >= kMaxCachedPrimitives) {
+    context.primitive_cache_.clear();
+  }
+
+  int64_t K = context.weight_shape_[1], N = context.weight_shape_[0];
+  auto src_desc = ideep::tensor::desc(
+      {M, K}, get_mkldnn_dtype(src_dtype), ideep::format_tag::ab);
+  auto dst_desc = ideep::tensor::desc(
+      {M, N}, get_mkldnn_dtype(dst_dtype), ideep::format_tag::ab);
+  bool with_bias = context.at_bias_.has_value();
+  auto bias_desc = bias_desc_of(context);
+
+  Fp8LinearPrimitive entry;
+  try {
+    // consume the prepacked weight as is
+    entry.primitive_desc_ = create_primitive_desc(
+        src_desc,
+        context.weight_packed_.get_desc(),
+        bias_desc,
+        dst_desc,
+        with_bias);
+  } catch (dnnl::error& e) {
+    if (e.status != dnnl_unimplemented)
+      throw;
+    // the packed layout is not supported for this M, let oneDNN pick the
+    // layout and reorder the weight at run time
+    entry.primitive_desc_ = create_primitive_desc(
+        src_desc,
+        ideep::tensor::desc(
+            {K, N},
+            get_mkldnn_dtype(context.weight_dtype_),
+            ideep::format_tag::any),
+        bias_desc,
+        dst_desc,
+        with_bias);
+  }
+  entry.primitive_ = dnnl::matmul(entry.primitive_desc_);
+  entry.scratchpad_desc_ = entry.primitive_desc_.scratchpad_desc();
+  entry.weight_desc_ = entry.primitive_desc_.weights_desc();
+  entry.reorder_weight_ =
+      entry.weight_desc_ != context.weight_packed_.get_desc();
+  return context.primitive_cache_.emplace(key, std::move(entry)).first->second;
+}
+
+} // namespace
+
+c10::intrusive_ptr<Fp8LinearOpContext> createFp8LinearPrePackOpContext(
+    at::Tensor&& weight,
+    c10::optional<at::Tensor>&& bias,
+    double input_scale,
+    double weight_scale,
+    c10::optional<int64_t> batch_size) {
+  RECORD_FUNCTION(
+      "ipex_prepack::createFp8LinearPrePackOpContext",
+      c10::ArrayRef<c10::IValue>({}));
+
+  return IpexFp8LinearOpContext::create_context(
+      std::move(weight),
+      std::move(bias),
+      input_scale,
+      weight_scale,
+      batch_size);
+}
+
+ContextLinearFp8 create(
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    double input_scale,
+    double weight_scale,
+    const c10::optional<int64_t> batch_size) {
+  TORCH_CHECK(weight.dim() == 2, "FP8 linear: weight should be 2D");
+  TORCH_CHECK(
+      weight.scalar_type() == at::ScalarType::Float8_e4m3fn ||
+          weight.scalar_type() == at::ScalarType::Float8_e5m2,
+      "FP8 linear: weight should be float8_e4m3fn or float8_e5m2");
+  auto out_features = weight.size(0);
+  auto in_features = weight.size(1);
+  auto weight_dtype = get_mkldnn_dtype(weight.scalar_type());
+  // [N, K] weight seen as [K, N] without a copy
+  auto weight_ = weight.contiguous();
+  auto w = itensor_view_from_dense(weight_.t());
+  ideep::tensor::desc ori_desc(w.get_desc());
+
+  // Ask oneDNN for the weight layout it prefers for the expected batch size
+  // (decode by default) and pack into it once.
+  int64_t M = batch_size.has_value() ? batch_size.value() : 1;
+  auto src_desc = ideep::tensor::desc(
+      {M, in_features}, weight_dtype, ideep::format_tag::ab);
+  auto dst_desc = ideep::tensor::desc(
+      {M, out_features}, ideep::data_type::f32, ideep::format_tag::ab);
+  auto weights_desc = ideep::tensor::desc(
+      {in_features, out_features}, weight_dtype, ideep::format_tag::any);
+  dnnl::matmul::primitive_desc primitive_desc;
+  // TODO: Remove this try/catch when oneDNN provides API to notify
+  // framework whether current platform can run FP8 primitives.
+  try {
+    primitive_desc = create_primitive_desc(
+        src_desc, weights_desc, ideep::tensor::desc(), dst_desc, false);
+  } catch (dnnl::error& e) {
+    if (e.status == dnnl_unimplemented)
+      throw std::runtime_error("Running FP8 on not supported platform.");
+    // on any other error just re-throw
+    throw;
+  }
+  ideep::tensor::desc packed_desc = primitive_desc.weights_desc();
+
+  auto at_weight = at::empty(
+      {static_cast<int64_t>(packed_desc.get_size())},
+      weight.options().dtype(at::kByte));
+  ideep::tensor packed_weight;
+  packed_weight.init(packed_desc, at_weight.data_ptr());
+  packed_weight.feed_from(w);
+
+  c10::optional<at::Tensor> at_bias = c10::nullopt;
+  if (bias.has_value() && bias.value().defined()) {
+    TORCH_CHECK(
+        bias.value().numel() == out_features,
+        "FP8 linear: bias should have out_features elements");
+    at_bias = bias.value().contiguous().view({out_features});
+  }
+
+  auto context = ContextLinearFp8{
+      std::move(ori_desc),
+      std::move(packed_weight),
+      std::move(at_weight),
+      weight.scalar_type(),
+      {out_features, in_features},
+      std::move(at_bias),
+      static_cast<float>(input_scale),
+      static_cast<float>(weight_scale)};
+  if (context.at_bias_.has_value()) {
+    context.bias_ = itensor_view_from_dense(
+        context.at_bias_.value().view({1, out_features}));
+  }
+  return context;
+}
+
+at::Tensor run(
+    ContextLinearFp8& context,
+    const at::Tensor& input,
+    c10::optional<at::ScalarType> out_dtype) {
+  RECORD_FUNCTION(
+      "ipex_prepack::fp8_linear_run", c10::ArrayRef<c10::IValue>({}));
+
+  int64_t K = context.weight_shape_[1], N = context.weight_shape_[0];
+  TORCH_CHECK(
+      input.size(-1) == K,
+      "Check the shapes of mat1 and mat2, they cannot be multiplied!");
+  auto input_ = input.contiguous();
+  int64_t M = input_.numel() / K;
+  auto dst_dtype = out_dtype.value_or(at::kFloat);
+  auto out_sizes = input_.sizes().vec();
+  out_sizes.back() = N;
+  if (M == 0) {
+    return at::empty(out_sizes, input_.options().dtype(dst_dtype));
+  }
+
+  // run the primitive of the bucket on rows padded with zeros, the padded
+  // rows of the output are dropped
+  int64_t M_bucket = bucket_m(M);
+  auto src_2d = input_.view({M, K});
+  if (M_bucket != M) {
+    // copied as bytes, fp8 inputs have no copy or fill kernels
+    auto padded = at::empty({M_bucket, K}, input_.options());
+    auto padded_bytes = padded.view(at::kByte);
+    padded_bytes.narrow(0, 0, M).copy_(src_2d.view(at::kByte));
+    padded_bytes.narrow(0, M, M_bucket - M).zero_();
+    src_2d = padded;
+  }
+  auto output =
+      at::empty({M_bucket, N}, input_.options().dtype(dst_dtype));
+
+  ideep::tensor input_scale, weight_scale;
+  auto prim = get_primitive(
+      context,
+      M_bucket,
+      input_.scalar_type(),
+      dst_dtype,
+      input_scale,
+      weight_scale);
+  auto src = itensor_view_from_dense(src_2d);
+  auto dst = itensor_view_from_dense(output);
+  ideep::tensor weight = context.weight_packed_;
+  if (prim.reorder_weight_) {
+    weight = context.weight_packed_.reorder_if_differ_in(prim.weight_desc_);
+  }
+  ideep::tensor scratchpad(prim.scratchpad_desc_);
+
+  ideep::exec_args args;
+  args.insert({DNNL_ARG_SRC, src});
+  args.insert({DNNL_ARG_WEIGHTS, weight});
+  args.insert({DNNL_ARG_DST, dst});
+  args.insert({DNNL_ARG_SCRATCHPAD, scratchpad});
+  if (context.at_bias_.has_value()) {
+    args.insert({DNNL_ARG_BIAS, context.bias_});
+  }
+  args.insert({DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, input_scale});
+  args.insert({DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS, weight_scale});
+  prim.primitive_.execute(ideep::stream::default_stream(), args);
+  // the first M rows of a row-major matrix are contiguous
+  return output.narrow(0, 0, M).view(out_sizes);
+}
+
+at::Tensor unpack(ContextLinearFp8& context, const at::Tensor& tensor) {
+  ideep::tensor blocked_tensor;
+  blocked_tensor.init(context.weight_packed_.get_desc(), tensor.data_ptr());
+  auto result = at::empty(
+      context.weight_shape_, tensor.options().dtype(context.weight_dtype_));
+  ideep::tensor pub_tensor;
+  pub_tensor.init(context.original_desc_, result.data_ptr());
+  pub_tensor.feed_from(blocked_tensor);
+  return result;
+}
+
+} // namespace fp8_linear
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
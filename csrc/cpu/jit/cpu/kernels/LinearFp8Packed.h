@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include "ContextLinearFp8.h"
+#include "OpContext.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+namespace fp8_linear {
+
+c10::intrusive_ptr<Fp8LinearOpContext> createFp8LinearPrePackOpContext(
+    at::Tensor&& weight,
+    c10::optional<at::Tensor>&& bias,
+    double input_scale,
+    double weight_scale,
+    c10::optional<int64_t> batch_size);
+
+ContextLinearFp8 create(
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    double input_scale,
+    double weight_scale,
+    const c10::optional<int64_t> batch_size);
+
+at::Tensor run(
+    ContextLinearFp8& context,
+    const at::Tensor& input,
+    c10::optional<at::ScalarType> out_dtype);
+
+// Reorder the packed weight back to the public [out_features, in_features]
+at::Tensor unpack(ContextLinearFp8& context, const at::Tensor& tensor);
+
+} // namespace fp8_linear
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
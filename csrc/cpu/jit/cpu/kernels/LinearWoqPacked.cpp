@@ -205,6 +205,8 @@ static const std::map<c10::string_view, int64_t> WOQ_DTYPE_MAP = {
     {"int8", WOQ_DTYPE_INT8},
     {"int4", WOQ_DTYPE_INT4},
     {"nf4", WOQ_DTYPE_NF4},
+    {"int2", WOQ_DTYPE_INT2},
+    {"int3", WOQ_DTYPE_INT3},
 };
 
 // output:
@@ -266,6 +268,8 @@ at::Tensor unpackWoqLinearWeight(
   int64_t K = weight_shape[1];
   if (w_dtype == WOQ_DTYPE_INT4 || w_dtype == WOQ_DTYPE_NF4) {
     K = (K + 1) / 2;
+  } else if (w_dtype == WOQ_DTYPE_INT2) {
+    K = (K + 3) / 4;
   }
   if (unpacked_weight.size(0) != N || unpacked_weight.size(1) != K) {
     // narrow unpacked weight to original shape
@@ -305,6 +309,9 @@ ContextLinearWoq create(
   // GPTQ with act-order
   bool handle_g_idx_in_kernel = lowp_mode != LOWP_MODE_INT8 && group_size > 0 &&
       group_size * scales.size(1) != K;
+  TORCH_CHECK(
+      !is_lowbit(weight_dtype) || !g_idx.has_value() || handle_g_idx_in_kernel,
+      "WOQ: g_idx is only supported by the kernel for INT2/INT3 weight");
   if (is_4bit && group_size > 0 && g_idx.has_value() &&
       !handle_g_idx_in_kernel) {
     TORCH_CHECK(
@@ -332,15 +339,11 @@ ContextLinearWoq create(
   std::unique_ptr<ContextLinearWoq> context_ptr;
   auto packed_shape = packed_weight.sizes();
   // If OC is not a multiple of BLOCK_N, it may be padded.
-  bool oc_is_padded = (packed_shape.size() == 4 && is_4bit &&
-                       packed_shape[0] * packed_shape[3] * 2 != N) ||
-      (packed_shape.size() == 4 && !is_4bit &&
-       packed_shape[0] * packed_shape[3] != N) ||
-      (packed_shape.size() == 2 && packed_shape[0] != N);
+  // Sub-byte weights pack 8 / bits values along OC in each byte
   int64_t padded_N = packed_shape.size() == 4
-      ? (is_4bit ? packed_shape[0] * packed_shape[3] * 2
-                 : packed_shape[0] * packed_shape[3])
+      ? packed_shape[0] * packed_shape[3] * 8 / get_weight_bits(weight_dtype)
       : packed_shape[0];
+  bool oc_is_padded = padded_N != N;
   if (oc_is_padded) {
     std::vector<int64_t> pad_vec = scales.dim() == 1
         ? std::vector<int64_t>({0, padded_N - N})
@@ -482,7 +485,8 @@ static void _dequant_weight_and_cache_in_context(ContextLinearWoq& context) {
       return;
     // You don't have to cache extra INT8 weight for lowp-mode INT8
     // Because you compute with INT8 weight directly
-    if (context.weight_dtype_ == WOQ_DTYPE_INT8)
+    // INT2/INT3 weights are dequantized to INT8 on the fly, not cached
+    if (!context.is_4bit_)
       return;
     auto w_sizes = context.at_weight_.sizes();
     auto Nc = w_sizes[0];
@@ -741,6 +745,99 @@ at::Tensor run_binary(
   return res;
 }
 
+// Called by IpexWoqLinearOpContext::run_quantized_input
+// Input is already quantized per M or per M x K block with the same block
+// size as the dynamic quantization in the int8 kernel would use
+at::Tensor run_quantized_input(
+    ContextLinearWoq& context,
+    const at::Tensor& input,
+    const at::Tensor& scale,
+    const at::Tensor& zero_point,
+    at::ScalarType out_dtype) {
+  TORCH_CHECK(
+      context.lowp_mode_ == 3,
+      "WOQ linear: quantized input requires lowp_mode INT8 (3), got ",
+      context.lowp_mode_);
+  TORCH_CHECK(
+      !context.g_idx_.has_value(),
+      "WOQ linear: quantized input is not supported with g_idx");
+  const auto act_quant_mode = context.act_quant_mode_;
+  const bool per_m = act_quant_mode == QUANT_A_PER_M ||
+      act_quant_mode == QUANT_A_PER_M_SYM;
+  const bool per_m_k_block = act_quant_mode == QUANT_A_PER_M_K_BLOCK ||
+      act_quant_mode == QUANT_A_PER_M_K_BLOCK_SYM;
+  TORCH_CHECK(
+      per_m || per_m_k_block,
+      "WOQ linear: quantized input requires per-M or per-M-K-block "
+      "activation quantization, got act_quant_mode = ",
+      act_quant_mode);
+  const bool is_sym_quant = !is_asymmetric_quant_a(act_quant_mode);
+  TORCH_CHECK(
+      input.scalar_type() == (is_sym_quant ? at::kChar : at::kByte),
+      "WOQ linear: expect quantized input in ",
+      is_sym_quant ? "int8" : "uint8",
+      " but got ",
+      input.scalar_type());
+  TORCH_CHECK(
+      is_sym_quant || zero_point.defined(),
+      "WOQ linear: zero points of input are required for asymmetric "
+      "activation quantization");
+  auto w_k = context.weight_shape_[1];
+  TORCH_CHECK(
+      input.size(input.dim() - 1) == w_k,
+      "WOQ linear: input and weight shapes do not match, got k = ",
+      input.size(input.dim() - 1),
+      " and ",
+      w_k,
+      " respectively.");
+  auto M = input.numel() > 0 ? input.numel() / w_k : 0;
+  bool fast_path_lowp_mode_3 = M >= SMALL_BATCH_THRESHOLD &&
+      context.cached_weight_.has_value() &&
+      context.cached_weight_.value().defined() &&
+      context.cached_compensation_.has_value() &&
+      context.cached_compensation_.value().defined();
+  bool use_cached_compensation = fast_path_lowp_mode_3 ||
+      context.weight_dtype_ == WOQ_DTYPE_INT8;
+  auto& weight = fast_path_lowp_mode_3 ? context.cached_weight_.value()
+                                       : context.at_weight_;
+  // Same block size as the int8 kernel uses for dynamic quantization
+  int64_t block_k = context.group_size_ > 0 ? context.group_size_
+      : weight.dim() == 4                   ? weight.size(2)
+                                            : w_k;
+  int64_t num_blocks = per_m ? 1 : (w_k + block_k - 1) / block_k;
+  TORCH_CHECK(
+      scale.numel() == M * num_blocks &&
+          (!zero_point.defined() || zero_point.numel() == M * num_blocks),
+      "WOQ linear: expect ",
+      M * num_blocks,
+      " scales and zero points of input, got ",
+      scale.numel());
+  auto scale_sizes = per_m ? std::vector<int64_t>({M})
+                           : std::vector<int64_t>({M, num_blocks});
+  auto scale_ = scale.to(at::kFloat).contiguous().view(scale_sizes);
+  auto zero_point_ = zero_point.defined()
+      ? zero_point.to(at::kInt).contiguous().view(scale_.sizes())
+      : zero_point;
+  auto res = woq_linear_quantized_input_kernel(
+      input.contiguous(),
+      scale_,
+      zero_point_,
+      out_dtype,
+      weight,
+      context.weight_dtype_,
+      context.scales_list_,
+      context.zero_points_list_,
+      context.bias_list_,
+      context.group_size_,
+      act_quant_mode,
+      use_cached_compensation ? context.cached_compensation_ : c10::nullopt);
+  if (res.size(-1) != context.weight_shape_[0]) {
+    int64_t N = context.weight_shape_[0];
+    return at::narrow(res, /*dim*/ -1, /*start*/ 0, /*end*/ N);
+  }
+  return res;
+}
+
 at::Tensor pack(ContextLinearWoq& context, const at::Tensor& tensor) {
   return tensor;
 }
@@ -765,6 +862,8 @@ at::Tensor unpack(ContextLinearWoq& context, const at::Tensor& tensor) {
   auto shape = context.weight_shape_;
   if (context.is_4bit_) {
     shape.back() = (shape.back() + 1) / 2;
+  } else if (context.weight_dtype_ == WOQ_DTYPE_INT2) {
+    shape.back() = (shape.back() + 3) / 4;
   }
   // weight may be padded. Copy data according to original shape
   at::Tensor qweight =
@@ -94,6 +94,13 @@ at::Tensor run_binary(
     const c10::string_view& post_op,
     const std::vector<at::Tensor>& others);
 
+at::Tensor run_quantized_input(
+    ContextLinearWoq& context,
+    const at::Tensor& input,
+    const at::Tensor& scale,
+    const at::Tensor& zero_point,
+    at::ScalarType out_dtype);
+
 at::Tensor pack(ContextLinearWoq& context, const at::Tensor& tensor);
 
 at::Tensor unpack(ContextLinearWoq& context, const at::Tensor& tensor);
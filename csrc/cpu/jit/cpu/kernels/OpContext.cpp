@@ -2,9 +2,11 @@
 #include <torch/all.h>
 #include "ConvPacked.h"
 #include "ConvTransposePacked.h"
+#include "LinearFp8Packed.h"
 #include "LinearMKLPacked.h"
 #include "LinearPacked.h"
 #include "LinearWoqPacked.h"
+#include "utils/shared_weight.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -206,6 +208,14 @@ void IpexLinearOpContext::load_from_ctx(
   load_from_ctx_template(this, other);
 }
 
+void IpexLinearOpContext::share_weight(const std::string& key) {
+  auto shared_weight =
+      utils::share_tensor_across_processes(key, op_context_.at_weight_);
+  // weight_packed_ and at_weight_ keep sharing the same memory
+  op_context_.weight_packed_.set_data_handle(shared_weight.data_ptr());
+  op_context_.at_weight_ = shared_weight;
+}
+
 c10::intrusive_ptr<ConvTransposeOpContext> IpexConvTransposeOpContext::
     create_context(
         at::Tensor&& weight,
@@ -295,6 +305,17 @@ void IpexLinearMKLOpContext::load_from_ctx(
   load_from_ctx_template(this, other);
 }
 
+void IpexLinearMKLOpContext::share_weight(const std::string& key) {
+  op_context_.at_weight_ =
+      utils::share_tensor_across_processes(key, op_context_.at_weight_);
+  auto shared_ori_weight = utils::share_tensor_across_processes(
+      key + ".ori_weight", op_context_.ori_weight_);
+  // ori_weight_ aliases the weight parameter of the module, swap its storage
+  // in place so that the module drops its private copy as well
+  at::NoGradGuard no_grad;
+  op_context_.ori_weight_.set_(shared_ori_weight);
+}
+
 at::Tensor IpexConvTransposeOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
@@ -420,6 +441,15 @@ at::Tensor IpexWoqLinearOpContext::run_binary(
       op_context_, input, post_op, others);
 }
 
+at::Tensor IpexWoqLinearOpContext::run_quantized_input(
+    const at::Tensor& input,
+    const at::Tensor& scale,
+    const at::Tensor& zero_point,
+    at::ScalarType out_dtype) {
+  return torch_ipex::cpu::detail::woq_linear::run_quantized_input(
+      op_context_, input, scale, zero_point, out_dtype);
+}
+
 at::Tensor IpexWoqLinearOpContext::to_public(const at::Tensor& tensor) {
   return torch_ipex::cpu::detail::woq_linear::unpack(op_context_, tensor);
 }
@@ -505,6 +535,83 @@ void IpexWoqLinearOpContext::load_from_ctx(
     c10::intrusive_ptr<WoqLinearOpContext> other) {
   load_from_ctx_template(this, other);
 }
+
+void IpexWoqLinearOpContext::share_weight(const std::string& key) {
+  op_context_.at_weight_ =
+      utils::share_tensor_across_processes(key, op_context_.at_weight_);
+  if (op_context_.cached_weight_.has_value() &&
+      op_context_.cached_weight_.value().defined()) {
+    auto shared_cached_weight = utils::share_tensor_across_processes(
+        key + ".cached_weight", op_context_.cached_weight_.value());
+    op_context_.cached_weight_ =
+        c10::make_optional<at::Tensor>(std::move(shared_cached_weight));
+  }
+}
 #endif
+
+c10::intrusive_ptr<Fp8LinearOpContext> IpexFp8LinearOpContext::create_context(
+    at::Tensor&& weight,
+    c10::optional<at::Tensor>&& bias,
+    double input_scale,
+    double weight_scale,
+    c10::optional<int64_t> batch_size) {
+  auto op_context = torch_ipex::cpu::detail::fp8_linear::create(
+      weight, bias, input_scale, weight_scale, batch_size);
+  return c10::make_intrusive<IpexFp8LinearOpContext>(
+      batch_size, std::move(op_context));
+}
+
+at::Tensor IpexFp8LinearOpContext::get_data_handle() {
+  at::Tensor ptr = at::empty(1, at::kLong);
+  ptr[0] = reinterpret_cast<int64_t>(this);
+  return ptr;
+}
+
+at::Tensor IpexFp8LinearOpContext::run(
+    const at::Tensor& input,
+    c10::optional<at::ScalarType> out_dtype) {
+  return torch_ipex::cpu::detail::fp8_linear::run(
+      op_context_, input, out_dtype);
+}
+
+at::Tensor IpexFp8LinearOpContext::to_public(const at::Tensor& tensor) {
+  return torch_ipex::cpu::detail::fp8_linear::unpack(op_context_, tensor);
+}
+
+at::Tensor IpexFp8LinearOpContext::get_at_packed_weight() {
+  return op_context_.at_weight_;
+}
+
+c10::optional<at::Tensor> IpexFp8LinearOpContext::get_at_bias() {
+  return op_context_.at_bias_;
+}
+
+std::vector<int64_t> IpexFp8LinearOpContext::get_weight_shape() {
+  return op_context_.weight_shape_;
+}
+
+detail::ContextLinearFp8& IpexFp8LinearOpContext::get_context() {
+  return op_context_;
+}
+
+void IpexFp8LinearOpContext::load_from_ctx(
+    c10::intrusive_ptr<Fp8LinearOpContext> other) {
+  auto& other_ctx_ = other->get_context();
+  TORCH_CHECK(
+      other_ctx_.weight_packed_.get_desc() ==
+          op_context_.weight_packed_.get_desc(),
+      "Fp8LinearOpContext::load_from_ctx: packed weight layout mismatch");
+  load_from_ctx_template(this, other);
+  // the cached primitives take the scales as runtime arguments, so they stay
+  // valid after the scales change; run() reads them under the same lock
+  std::lock_guard<std::mutex> lock(*op_context_.primitive_cache_mutex_);
+  op_context_.input_scale_ = other_ctx_.input_scale_;
+  op_context_.weight_scale_ = other_ctx_.weight_scale_;
+  op_context_.input_scale_t_ =
+      ideep::tensor(ideep::scale_t(1, op_context_.input_scale_));
+  op_context_.weight_scale_t_ =
+      ideep::tensor(ideep::scale_t(1, op_context_.weight_scale_));
+}
+
 } // namespace cpu
 } // namespace torch_ipex
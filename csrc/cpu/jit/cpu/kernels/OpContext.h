@@ -9,6 +9,7 @@
 #include "ContextConvolution.h"
 #include "ContextLinear.h"
 #include "ContextLinearMKL.h"
+#include "ContextLinearFp8.h"
 #include "ContextLinearWoq.h"
 #include "assert.h"
 
@@ -219,6 +220,11 @@ class LinearOpContext : public torch::jit::CustomClassHolder {
   //         new_ctx = create_ctx(state_dict[weight])
   //         self.ctx.load_from_ctx(new_ctx)
   virtual void load_from_ctx(c10::intrusive_ptr<LinearOpContext> other) = 0;
+
+  // Move the packed weight into named POSIX shared memory so that processes
+  // packing the same weight under the same key share a single read-only
+  // copy. The weight can no longer be updated in place afterwards.
+  virtual void share_weight(const std::string& key) = 0;
 };
 
 class IpexLinearOpContext final : public LinearOpContext {
@@ -270,6 +276,8 @@ class IpexLinearOpContext final : public LinearOpContext {
 
   virtual void load_from_ctx(
       c10::intrusive_ptr<LinearOpContext> other) override;
+
+  virtual void share_weight(const std::string& key) override;
 };
 
 using SerializationTypeMKLPrePack =
@@ -317,6 +325,10 @@ class MKLOpContext : public torch::jit::CustomClassHolder {
   //         new_ctx = create_ctx(state_dict[weight])
   //         self.ctx.load_from_ctx(new_ctx)
   virtual void load_from_ctx(c10::intrusive_ptr<MKLOpContext> other) = 0;
+
+  // See LinearOpContext::share_weight. Both the MKL packed weight and the
+  // original weight are shared.
+  virtual void share_weight(const std::string& key) = 0;
 };
 
 class IpexLinearMKLOpContext final : public MKLOpContext {
@@ -357,6 +369,8 @@ class IpexLinearMKLOpContext final : public MKLOpContext {
       c10::optional<int64_t> batch_size);
 
   virtual void load_from_ctx(c10::intrusive_ptr<MKLOpContext> other) override;
+
+  virtual void share_weight(const std::string& key) override;
 };
 
 // Weight-only quantization
@@ -402,6 +416,17 @@ class WoqLinearOpContext : public torch::jit::CustomClassHolder {
         this->get_context().cache_weight_for_large_batch_);
   }
 
+  // weight dtype, group size, lowp mode, act quant mode and
+  // cache_weight_for_large_batch, without unpacking the weight
+  std::tuple<int64_t, int64_t, int64_t, int64_t, bool> get_config() {
+    return std::make_tuple(
+        this->get_context().weight_dtype_,
+        this->get_context().group_size_,
+        this->get_context().lowp_mode_,
+        this->get_context().act_quant_mode_,
+        this->get_context().cache_weight_for_large_batch_);
+  }
+
   virtual at::Tensor get_data_handle() = 0;
 
   virtual at::Tensor run(const at::Tensor& input) = 0;
@@ -417,6 +442,13 @@ class WoqLinearOpContext : public torch::jit::CustomClassHolder {
       const c10::string_view& post_op,
       const std::vector<at::Tensor>& others) = 0;
 
+  // input is int8/uint8 activation quantized per M or per M x K block
+  virtual at::Tensor run_quantized_input(
+      const at::Tensor& input,
+      const at::Tensor& scale,
+      const at::Tensor& zero_point,
+      at::ScalarType out_dtype) = 0;
+
   virtual at::Tensor to_public(const at::Tensor& tensor) = 0;
 
   virtual at::Tensor get_at_packed_weight() = 0;
@@ -447,6 +479,10 @@ class WoqLinearOpContext : public torch::jit::CustomClassHolder {
   //         new_ctx = create_ctx(state_dict[weight])
   //         self.ctx.load_from_ctx(new_ctx)
   virtual void load_from_ctx(c10::intrusive_ptr<WoqLinearOpContext> other) = 0;
+
+  // See LinearOpContext::share_weight. The weight cached for large batches
+  // is shared as well.
+  virtual void share_weight(const std::string& key) = 0;
 };
 
 class IpexWoqLinearOpContext final : public WoqLinearOpContext {
@@ -476,6 +512,12 @@ class IpexWoqLinearOpContext final : public WoqLinearOpContext {
       const c10::string_view& post_op,
       const std::vector<at::Tensor>& others) override;
 
+  virtual at::Tensor run_quantized_input(
+      const at::Tensor& input,
+      const at::Tensor& scale,
+      const at::Tensor& zero_point,
+      at::ScalarType out_dtype) override;
+
   virtual at::Tensor to_public(const at::Tensor& tensor) override;
 
   virtual at::Tensor get_at_packed_weight() override;
@@ -515,6 +557,97 @@ class IpexWoqLinearOpContext final : public WoqLinearOpContext {
 
   virtual void load_from_ctx(
       c10::intrusive_ptr<WoqLinearOpContext> other) override;
+
+  virtual void share_weight(const std::string& key) override;
+};
+
+// FP8 linear
+using SerializationTypeFp8LinearPrePack = std::tuple<
+    at::Tensor, // weight in fp8, [out_features, in_features]
+    c10::optional<at::Tensor>, // bias
+    double, // input scale
+    double, // weight scale
+    c10::optional<int64_t>>; // batch size
+
+class Fp8LinearOpContext : public torch::jit::CustomClassHolder {
+ protected:
+  c10::optional<int64_t> batch_size_;
+
+ public:
+  SerializationTypeFp8LinearPrePack unpack() {
+    auto orig_weight_ = this->to_public(this->get_at_packed_weight());
+    auto orig_bias_ = this->get_at_bias();
+    return std::make_tuple(
+        orig_weight_,
+        orig_bias_,
+        static_cast<double>(this->get_context().input_scale_),
+        static_cast<double>(this->get_context().weight_scale_),
+        batch_size_);
+  }
+
+  virtual at::Tensor get_data_handle() = 0;
+
+  virtual at::Tensor run(
+      const at::Tensor& input,
+      c10::optional<at::ScalarType> out_dtype) = 0;
+
+  virtual at::Tensor to_public(const at::Tensor& tensor) = 0;
+
+  virtual at::Tensor get_at_packed_weight() = 0;
+
+  virtual c10::optional<at::Tensor> get_at_bias() = 0;
+
+  virtual std::vector<int64_t> get_weight_shape() = 0;
+
+  virtual detail::ContextLinearFp8& get_context() = 0;
+
+  // The load_state_dict behavior for nn.Modules are inplace copy weight from
+  // state_dict So the load_state_dict for optimizer can only handle the states
+  // and keep parameter groups un-changed Thus we need this method to apply
+  // inplace copy on weight/bias for IPEX modules with op context The process
+  // is:
+  //         new_ctx = create_ctx(state_dict[weight])
+  //         self.ctx.load_from_ctx(new_ctx)
+  virtual void load_from_ctx(c10::intrusive_ptr<Fp8LinearOpContext> other) = 0;
+};
+
+class IpexFp8LinearOpContext final : public Fp8LinearOpContext {
+ private:
+  detail::ContextLinearFp8 op_context_;
+
+ public:
+  IpexFp8LinearOpContext(
+      c10::optional<int64_t> batch_size,
+      detail::ContextLinearFp8&& op_context)
+      : op_context_(std::move(op_context)) {
+    batch_size_ = batch_size;
+  }
+
+  virtual at::Tensor get_data_handle() override;
+
+  virtual at::Tensor run(
+      const at::Tensor& input,
+      c10::optional<at::ScalarType> out_dtype) override;
+
+  virtual at::Tensor to_public(const at::Tensor& tensor) override;
+
+  virtual at::Tensor get_at_packed_weight() override;
+
+  virtual c10::optional<at::Tensor> get_at_bias() override;
+
+  virtual std::vector<int64_t> get_weight_shape() override;
+
+  virtual detail::ContextLinearFp8& get_context() override;
+
+  static c10::intrusive_ptr<Fp8LinearOpContext> create_context(
+      at::Tensor&& weight,
+      c10::optional<at::Tensor>&& bias,
+      double input_scale,
+      double weight_scale,
+      c10::optional<int64_t> batch_size);
+
+  virtual void load_from_ctx(
+      c10::intrusive_ptr<Fp8LinearOpContext> other) override;
 };
 
 // deconv op
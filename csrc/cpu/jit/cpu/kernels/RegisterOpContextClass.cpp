@@ -3,21 +3,26 @@
 
 #include "ConvPacked.h"
 #include "ConvTransposePacked.h"
+#include "LinearFp8Packed.h"
 #include "LinearMKLPacked.h"
 #include "LinearPacked.h"
 #include "LinearWoqPacked.h"
 #include "OpContext.h"
+#include "WoqPackedWeightFile.h"
 
 namespace torch_ipex {
 namespace cpu {
 using detail::conv_transpose::createConvTransposePrePackOpContext;
 using detail::convolution::createConvolutionPrePackOpContext;
+using detail::fp8_linear::createFp8LinearPrePackOpContext;
 using detail::linear::createLinearPrePackOpContext;
 using detail::mkl_sgemm::createLinearMKLPrePackOpContext;
 #ifdef USE_LIBXSMM
 using detail::woq_linear::createWoqLinearPrePackOpContext;
 using detail::woq_linear::createWoqLinearPrePackOpContextInt4;
+using detail::woq_linear::loadWoqLinearPackedWeight;
 using detail::woq_linear::packWoqLinearWeight;
+using detail::woq_linear::saveWoqLinearPackedWeights;
 using detail::woq_linear::unpackWoqLinearWeight;
 #endif
 
@@ -72,7 +77,8 @@ TORCH_LIBRARY(ipex_prepack, m) {
       .def("to_public", &torch_ipex::cpu::LinearOpContext::to_public)
       .def(
           "get_data_handle", &torch_ipex::cpu::LinearOpContext::get_data_handle)
-      .def("load_from_ctx", &torch_ipex::cpu::LinearOpContext::load_from_ctx);
+      .def("load_from_ctx", &torch_ipex::cpu::LinearOpContext::load_from_ctx)
+      .def("share_weight", &torch_ipex::cpu::LinearOpContext::share_weight);
   m.class_<MKLOpContext>("MKLOpContext")
       .def_pickle(
           [](const c10::intrusive_ptr<MKLOpContext>& op_context)
@@ -91,7 +97,8 @@ TORCH_LIBRARY(ipex_prepack, m) {
       .def("pack", &torch_ipex::cpu::MKLOpContext::pack)
       .def("to_public", &torch_ipex::cpu::MKLOpContext::to_public)
       .def("get_data_handle", &torch_ipex::cpu::MKLOpContext::get_data_handle)
-      .def("load_from_ctx", &torch_ipex::cpu::MKLOpContext::load_from_ctx);
+      .def("load_from_ctx", &torch_ipex::cpu::MKLOpContext::load_from_ctx)
+      .def("share_weight", &torch_ipex::cpu::MKLOpContext::share_weight);
   m.class_<ConvTransposeOpContext>("ConvTransposeOpContext")
       .def_pickle(
           [](const c10::intrusive_ptr<ConvTransposeOpContext>& op_context)
@@ -123,6 +130,34 @@ TORCH_LIBRARY(ipex_prepack, m) {
       .def(
           "load_from_ctx",
           &torch_ipex::cpu::ConvTransposeOpContext::load_from_ctx);
+  m.class_<Fp8LinearOpContext>("Fp8LinearOpContext")
+      .def_pickle(
+          [](const c10::intrusive_ptr<Fp8LinearOpContext>& op_context)
+              -> SerializationTypeFp8LinearPrePack { // __getstate__
+            return op_context->unpack();
+          },
+          [](SerializationTypeFp8LinearPrePack state)
+              -> c10::intrusive_ptr<Fp8LinearOpContext> { // __setstate__
+            return createFp8LinearPrePackOpContext(
+                std::move(std::get<0>(state)), // weight
+                std::move(std::get<1>(state)), // bias
+                std::move(std::get<2>(state)), // input scale
+                std::move(std::get<3>(state)), // weight scale
+                std::move(std::get<4>(state))); // batch size
+          })
+      .def(
+          "get_weight",
+          &torch_ipex::cpu::Fp8LinearOpContext::get_at_packed_weight)
+      .def("get_bias", &torch_ipex::cpu::Fp8LinearOpContext::get_at_bias)
+      .def(
+          "get_weight_shape",
+          &torch_ipex::cpu::Fp8LinearOpContext::get_weight_shape)
+      .def("to_public", &torch_ipex::cpu::Fp8LinearOpContext::to_public)
+      .def(
+          "get_data_handle",
+          &torch_ipex::cpu::Fp8LinearOpContext::get_data_handle)
+      .def(
+          "load_from_ctx", &torch_ipex::cpu::Fp8LinearOpContext::load_from_ctx);
 #ifdef USE_LIBXSMM
   m.class_<WoqLinearOpContext>("WoqLinearOpContext")
       .def_pickle(
@@ -158,6 +193,7 @@ TORCH_LIBRARY(ipex_prepack, m) {
           "get_weight_shape",
           &torch_ipex::cpu::WoqLinearOpContext::get_weight_shape)
       .def("get_g_idx", &torch_ipex::cpu::WoqLinearOpContext::get_g_idx)
+      .def("get_config", &torch_ipex::cpu::WoqLinearOpContext::get_config)
       .def(
           "get_cached_weight",
           &torch_ipex::cpu::WoqLinearOpContext::get_cached_weight)
@@ -170,7 +206,9 @@ TORCH_LIBRARY(ipex_prepack, m) {
           "get_data_handle",
           &torch_ipex::cpu::WoqLinearOpContext::get_data_handle)
       .def(
-          "load_from_ctx", &torch_ipex::cpu::WoqLinearOpContext::load_from_ctx);
+          "load_from_ctx", &torch_ipex::cpu::WoqLinearOpContext::load_from_ctx)
+      .def(
+          "share_weight", &torch_ipex::cpu::WoqLinearOpContext::share_weight);
 #endif
   m.def(
       "convolution_prepack(Tensor W, Tensor? B, int[] stride, "
@@ -188,6 +226,11 @@ TORCH_LIBRARY(ipex_prepack, m) {
       "int[] padding, int[] output_padding, int groups, int[] dilation, "
       "bool input_is_channels_last, int[] input_sizes) "
       "-> __torch__.torch.classes.ipex_prepack.ConvTransposeOpContext");
+  // input_scale/weight_scale are the scale_inv values of the fp8 tensors
+  m.def(
+      "fp8_linear_prepack(Tensor W, Tensor? B, float input_scale, "
+      "float weight_scale, int? batch_size) "
+      "-> __torch__.torch.classes.ipex_prepack.Fp8LinearOpContext");
 #ifdef USE_LIBXSMM
   m.def(
       "weight_only_qlinear_prepack(Tensor W, int W_dtype, int[] W_shape, Tensor scales, Tensor? zero_points, Tensor? B, Tensor? g_idx, int? batch_size, int group_size, int lowp_mode, int act_quant_mode, bool cache_weight_for_large_batch = False) "
@@ -201,6 +244,17 @@ TORCH_LIBRARY(ipex_prepack, m) {
   m.def(
       "woq_linear_unpack_weight(Tensor W, str W_dtype, int[] W_shape, int lowp_mode) "
       "-> Tensor");
+  // No tensor arguments to dispatch on, so register them as catch-all
+  m.def(
+      "woq_linear_save_packed(str path, str[] names, Tensor[] op_contexts) -> ()",
+      TORCH_FN(saveWoqLinearPackedWeights));
+  m.def(
+      "woq_linear_packed_names(str path) -> str[]",
+      TORCH_FN(listWoqLinearPackedWeights));
+  m.def(
+      "woq_linear_load_packed(str path, str name) "
+      "-> __torch__.torch.classes.ipex_prepack.WoqLinearOpContext",
+      TORCH_FN(loadWoqLinearPackedWeight));
 #endif
 }
 
@@ -210,6 +264,7 @@ TORCH_LIBRARY_IMPL(ipex_prepack, CPU, m) {
   m.impl("mkl_sgemm_prepack", TORCH_FN(createLinearMKLPrePackOpContext));
   m.impl(
       "conv_transpose_prepack", TORCH_FN(createConvTransposePrePackOpContext));
+  m.impl("fp8_linear_prepack", TORCH_FN(createFp8LinearPrePackOpContext));
 }
 #ifdef USE_LIBXSMM
 TORCH_LIBRARY_IMPL(ipex_prepack, CPU, m) {
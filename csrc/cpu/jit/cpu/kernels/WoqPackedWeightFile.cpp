@@ -0,0 +1,399 @@
+#ifdef USE_LIBXSMM
+#include "WoqPackedWeightFile.h"
+#include <ATen/ATen.h>
+#include <ATen/record_function.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "aten/utils/isa_help.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+namespace woq_linear {
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'P', 'E', 'X', 'W', 'O', 'Q', 'P'};
+constexpr size_t kIsaLen = 32;
+// page aligned so that the packed weights can be mapped zero-copy
+constexpr uint64_t kPayloadAlignment = 4096;
+
+// Tensor slots of a record
+enum WoqPackedSlot : int32_t {
+  kWeight = 0,
+  kScales = 1, // fp32, fp16, bf16
+  kZeroPoints = 4, // fp32, fp16, bf16, int8
+  kBiasList = 8, // fp32, fp16, bf16
+  kBias = 11,
+  kGIdx = 12,
+  kCompensation = 13,
+  kNumSlots = 14,
+};
+
+inline uint64_t align_up(uint64_t v, uint64_t alignment) {
+  return (v + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+inline void put(std::vector<char>& buf, const T& v) {
+  const char* p = reinterpret_cast<const char*>(&v);
+  buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+struct Cursor {
+  const char* base;
+  size_t size;
+  size_t pos;
+
+  template <typename T>
+  T get() {
+    TORCH_CHECK(
+        pos + sizeof(T) <= size, "WOQ packed weight file: truncated metadata");
+    T v;
+    std::memcpy(&v, base + pos, sizeof(T));
+    pos += sizeof(T);
+    return v;
+  }
+
+  std::string get_string(size_t len) {
+    TORCH_CHECK(pos + len <= size, "WOQ packed weight file: truncated name");
+    std::string s(base + pos, len);
+    pos += len;
+    return s;
+  }
+};
+
+// A read-only view of a packed weight file, mapped once and shared by the
+// contexts of all its layers.
+struct WoqPackedFile {
+  std::string path;
+  void* base = nullptr;
+  size_t size = 0;
+  uint64_t data_offset = 0;
+  // layer name -> metadata offset of its record
+  std::unordered_map<std::string, size_t> records;
+  // layer names in the order they were written
+  std::vector<std::string> names;
+
+  ~WoqPackedFile() {
+    if (base != nullptr) {
+      munmap(base, size);
+    }
+  }
+};
+
+std::mutex& packed_file_registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<std::string, std::weak_ptr<WoqPackedFile>>&
+packed_file_registry() {
+  static std::unordered_map<std::string, std::weak_ptr<WoqPackedFile>>
+      registry;
+  return registry;
+}
+
+std::shared_ptr<WoqPackedFile> map_packed_file(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  TORCH_CHECK(fd >= 0, "WOQ packed weight file: cannot open ", path);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    TORCH_CHECK(false, "WOQ packed weight file: cannot stat ", path);
+  }
+  auto file = std::make_shared<WoqPackedFile>();
+  file->path = path;
+  file->size = st.st_size;
+  // Private writable mapping: pages stay shared with the page cache until a
+  // context writes to them (e.g. load_from_ctx), which then copies on write.
+  void* base = mmap(
+      nullptr, file->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  TORCH_CHECK(base != MAP_FAILED, "WOQ packed weight file: mmap failed");
+  file->base = base;
+
+  Cursor cursor{static_cast<const char*>(base), file->size, 0};
+  TORCH_CHECK(
+      std::memcmp(cursor.get_string(sizeof(kMagic)).data(), kMagic, 8) == 0,
+      "WOQ packed weight file: bad magic in ",
+      path);
+  auto version = cursor.get<uint32_t>();
+  TORCH_CHECK(
+      version == kWoqPackedFileVersion,
+      "WOQ packed weight file: unsupported version ",
+      version);
+  auto num_records = cursor.get<uint32_t>();
+  auto isa = cursor.get_string(kIsaLen);
+  isa = isa.substr(0, isa.find('\0'));
+  auto current_isa = get_current_isa_level();
+  TORCH_CHECK(
+      isa == current_isa,
+      "WOQ packed weight file: weights were packed for ISA ",
+      isa,
+      " but the current ISA is ",
+      current_isa,
+      ", please pack the weights again");
+  file->data_offset = cursor.get<uint64_t>();
+  TORCH_CHECK(
+      file->data_offset <= file->size,
+      "WOQ packed weight file: bad data offset");
+
+  // index the records, skipping over their tensor descriptors
+  for (uint32_t r = 0; r < num_records; r++) {
+    auto name = cursor.get_string(cursor.get<uint32_t>());
+    file->records[name] = cursor.pos;
+    file->names.push_back(name);
+    cursor.pos += 4 * sizeof(int64_t) + 2 * sizeof(uint8_t) +
+        2 * sizeof(int64_t);
+    auto num_tensors = cursor.get<uint32_t>();
+    for (uint32_t t = 0; t < num_tensors; t++) {
+      cursor.get<int32_t>();
+      cursor.get<int32_t>();
+      auto ndim = cursor.get<int32_t>();
+      cursor.pos += ndim * sizeof(int64_t) + 2 * sizeof(uint64_t);
+    }
+  }
+  return file;
+}
+
+std::shared_ptr<WoqPackedFile> get_packed_file(const std::string& path) {
+  std::lock_guard<std::mutex> lock(packed_file_registry_mutex());
+  auto& registry = packed_file_registry();
+  auto it = registry.find(path);
+  if (it != registry.end()) {
+    if (auto file = it->second.lock()) {
+      return file;
+    }
+  }
+  auto file = map_packed_file(path);
+  registry[path] = file;
+  return file;
+}
+
+std::vector<std::pair<int32_t, at::Tensor>> collect_tensors(
+    ContextLinearWoq& context) {
+  std::vector<std::pair<int32_t, at::Tensor>> tensors;
+  auto add = [&](int32_t slot, const at::Tensor& t) {
+    if (t.defined()) {
+      tensors.emplace_back(slot, t.contiguous());
+    }
+  };
+  add(kWeight, context.at_weight_);
+  for (size_t i = 0; i < context.scales_list_.size(); i++) {
+    add(kScales + i, context.scales_list_[i]);
+  }
+  for (size_t i = 0; i < context.zero_points_list_.size(); i++) {
+    add(kZeroPoints + i, context.zero_points_list_[i]);
+  }
+  for (size_t i = 0; i < context.bias_list_.size(); i++) {
+    add(kBiasList + i, context.bias_list_[i]);
+  }
+  if (context.at_bias_.has_value()) {
+    add(kBias, context.at_bias_.value());
+  }
+  if (context.g_idx_.has_value()) {
+    add(kGIdx, context.g_idx_.value());
+  }
+  if (context.cached_compensation_.has_value()) {
+    add(kCompensation, context.cached_compensation_.value());
+  }
+  return tensors;
+}
+
+} // namespace
+
+void saveWoqLinearPackedWeights(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<at::Tensor>& op_contexts) {
+  RECORD_FUNCTION(
+      "ipex_prepack::saveWoqLinearPackedWeights",
+      c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      names.size() == op_contexts.size(),
+      "WOQ packed weight file: names and op_contexts should have the same ",
+      "size");
+
+  std::vector<char> metadata;
+  std::vector<at::Tensor> payloads;
+  uint64_t data_size = 0;
+  for (size_t r = 0; r < names.size(); r++) {
+    auto& context = reinterpret_cast<IpexWoqLinearOpContext*>(
+                        op_contexts[r].data_ptr<int64_t>()[0])
+                        ->get_context();
+    put<uint32_t>(metadata, names[r].size());
+    metadata.insert(metadata.end(), names[r].begin(), names[r].end());
+    put<int64_t>(metadata, context.weight_dtype_);
+    put<int64_t>(metadata, context.group_size_);
+    put<int64_t>(metadata, context.lowp_mode_);
+    put<int64_t>(metadata, context.act_quant_mode_);
+    put<uint8_t>(metadata, context.cache_weight_for_large_batch_);
+    put<uint8_t>(metadata, context.handle_g_idx_in_kernel_);
+    put<int64_t>(metadata, context.weight_shape_[0]);
+    put<int64_t>(metadata, context.weight_shape_[1]);
+    auto tensors = collect_tensors(context);
+    put<uint32_t>(metadata, tensors.size());
+    for (auto& slot_tensor : tensors) {
+      auto& t = slot_tensor.second;
+      put<int32_t>(metadata, slot_tensor.first);
+      put<int32_t>(metadata, static_cast<int32_t>(t.scalar_type()));
+      put<int32_t>(metadata, t.dim());
+      for (auto s : t.sizes()) {
+        put<int64_t>(metadata, s);
+      }
+      uint64_t nbytes = t.nbytes();
+      put<uint64_t>(metadata, data_size);
+      put<uint64_t>(metadata, nbytes);
+      data_size = align_up(data_size + nbytes, kPayloadAlignment);
+      payloads.push_back(t);
+    }
+  }
+
+  const uint64_t header_size = sizeof(kMagic) + 2 * sizeof(uint32_t) +
+      kIsaLen + sizeof(uint64_t);
+  const uint64_t data_offset =
+      align_up(header_size + metadata.size(), kPayloadAlignment);
+  char isa[kIsaLen] = {0};
+  auto current_isa = get_current_isa_level();
+  std::strncpy(isa, current_isa.c_str(), kIsaLen - 1);
+
+  // write to a temporary file first so that a reader never maps a partially
+  // written file
+  auto tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    TORCH_CHECK(out.good(), "WOQ packed weight file: cannot create ", tmp_path);
+    std::vector<char> header;
+    header.insert(header.end(), kMagic, kMagic + sizeof(kMagic));
+    put<uint32_t>(header, kWoqPackedFileVersion);
+    put<uint32_t>(header, names.size());
+    header.insert(header.end(), isa, isa + kIsaLen);
+    put<uint64_t>(header, data_offset);
+    out.write(header.data(), header.size());
+    out.write(metadata.data(), metadata.size());
+    std::vector<char> zeros(kPayloadAlignment, 0);
+    out.write(zeros.data(), data_offset - header_size - metadata.size());
+    for (auto& t : payloads) {
+      uint64_t nbytes = t.nbytes();
+      out.write(static_cast<const char*>(t.const_data_ptr()), nbytes);
+      out.write(zeros.data(), align_up(nbytes, kPayloadAlignment) - nbytes);
+    }
+    TORCH_CHECK(out.good(), "WOQ packed weight file: failed to write ", path);
+  }
+  TORCH_CHECK(
+      std::rename(tmp_path.c_str(), path.c_str()) == 0,
+      "WOQ packed weight file: cannot rename ",
+      tmp_path,
+      " to ",
+      path);
+  {
+    // drop a stale mapping of an older file at the same path
+    std::lock_guard<std::mutex> lock(packed_file_registry_mutex());
+    packed_file_registry().erase(path);
+  }
+}
+
+std::vector<std::string> listWoqLinearPackedWeights(const std::string& path) {
+  return get_packed_file(path)->names;
+}
+
+c10::intrusive_ptr<WoqLinearOpContext> loadWoqLinearPackedWeight(
+    const std::string& path,
+    const std::string& name) {
+  RECORD_FUNCTION(
+      "ipex_prepack::loadWoqLinearPackedWeight",
+      c10::ArrayRef<c10::IValue>({}));
+  auto file = get_packed_file(path);
+  auto it = file->records.find(name);
+  TORCH_CHECK(
+      it != file->records.end(),
+      "WOQ packed weight file: no layer named ",
+      name,
+      " in ",
+      path);
+
+  Cursor cursor{static_cast<const char*>(file->base), file->size, it->second};
+  auto weight_dtype = cursor.get<int64_t>();
+  auto group_size = cursor.get<int64_t>();
+  auto lowp_mode = cursor.get<int64_t>();
+  auto act_quant_mode = cursor.get<int64_t>();
+  bool cache_weight_for_large_batch = cursor.get<uint8_t>();
+  bool handle_g_idx_in_kernel = cursor.get<uint8_t>();
+  std::vector<int64_t> weight_shape(2);
+  weight_shape[0] = cursor.get<int64_t>();
+  weight_shape[1] = cursor.get<int64_t>();
+
+  std::vector<at::Tensor> slots(kNumSlots);
+  auto num_tensors = cursor.get<uint32_t>();
+  for (uint32_t t = 0; t < num_tensors; t++) {
+    auto slot = cursor.get<int32_t>();
+    auto scalar_type = static_cast<at::ScalarType>(cursor.get<int32_t>());
+    auto ndim = cursor.get<int32_t>();
+    std::vector<int64_t> sizes(ndim);
+    for (auto& s : sizes) {
+      s = cursor.get<int64_t>();
+    }
+    auto offset = cursor.get<uint64_t>();
+    auto nbytes = cursor.get<uint64_t>();
+    TORCH_CHECK(
+        slot >= 0 && slot < kNumSlots &&
+            file->data_offset + offset + nbytes <= file->size,
+        "WOQ packed weight file: corrupted record ",
+        name);
+    void* data = static_cast<char*>(file->base) + file->data_offset + offset;
+    // every tensor holds a reference to the mapping
+    slots[slot] = at::from_blob(
+        data,
+        sizes,
+        [file](void*) {},
+        at::TensorOptions().dtype(scalar_type));
+  }
+  TORCH_CHECK(
+      slots[kWeight].defined() && slots[kScales].defined(),
+      "WOQ packed weight file: record ",
+      name,
+      " has no weight or scales");
+
+  auto optional_of = [&](int32_t slot) {
+    return slots[slot].defined() ? c10::make_optional(slots[slot])
+                                 : c10::nullopt;
+  };
+  std::vector<at::Tensor> scales_list(
+      slots.begin() + kScales, slots.begin() + kZeroPoints);
+  std::vector<at::Tensor> zero_points_list(
+      slots.begin() + kZeroPoints, slots.begin() + kBiasList);
+  std::vector<at::Tensor> bias_list(
+      slots.begin() + kBiasList, slots.begin() + kBias);
+  ContextLinearWoq context(
+      std::move(slots[kWeight]),
+      weight_dtype,
+      std::move(weight_shape),
+      std::move(scales_list),
+      std::move(zero_points_list),
+      std::move(bias_list),
+      optional_of(kBias),
+      optional_of(kGIdx),
+      optional_of(kCompensation),
+      group_size,
+      lowp_mode,
+      act_quant_mode,
+      cache_weight_for_large_batch,
+      handle_g_idx_in_kernel);
+  return c10::make_intrusive<IpexWoqLinearOpContext>(
+      c10::nullopt, std::move(context));
+}
+
+} // namespace woq_linear
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
+#endif
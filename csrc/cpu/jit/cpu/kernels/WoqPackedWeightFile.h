@@ -0,0 +1,55 @@
+#pragma once
+#ifdef USE_LIBXSMM
+#include <ATen/Tensor.h>
+#include "ContextLinearWoq.h"
+#include "OpContext.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+namespace woq_linear {
+
+// clang-format off
+// On-disk format of prepacked WOQ linear weights, so that a model can skip
+// woq_linear_pack_weight at startup and map its packed weights zero-copy.
+//
+//   header  | magic "IPEXWOQP" | u32 version | u32 num_records |
+//           | char isa[32] | u64 data_offset |
+//   records | num_records x record |
+//   data    | tensor payloads at data_offset, each kPayloadAlignment aligned |
+//
+//   record  | u32 name_len | name | i64 weight_dtype | i64 group_size |
+//           | i64 lowp_mode | i64 act_quant_mode | u8 cache_weight |
+//           | u8 handle_g_idx_in_kernel | i64 weight_shape[2] |
+//           | u32 num_tensors | num_tensors x tensor |
+//   tensor  | i32 slot | i32 scalar_type | i32 ndim | i64 sizes[ndim] |
+//           | u64 offset (from data_offset) | u64 nbytes |
+//
+// The packed layout (block_n, block_k) is carried by the packed weight
+// sizes. Packing depends on the ISA, so a file is only loaded on a machine
+// with the same ISA level it was written on.
+// clang-format on
+constexpr uint32_t kWoqPackedFileVersion = 1;
+
+// Write the contexts given by their data handles to one file under the given
+// layer names.
+void saveWoqLinearPackedWeights(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<at::Tensor>& op_contexts);
+
+// Names of the layers stored in the file, in the order they were written.
+std::vector<std::string> listWoqLinearPackedWeights(const std::string& path);
+
+// Create the context of one layer on top of the memory mapped file. The
+// mapping is shared by all the layers of a file and released with the last
+// tensor that references it.
+c10::intrusive_ptr<WoqLinearOpContext> loadWoqLinearPackedWeight(
+    const std::string& path,
+    const std::string& name);
+
+} // namespace woq_linear
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
+#endif
@@ -3,13 +3,178 @@
 #include <stdlib.h>
 #include <string>
 #ifndef _WIN32
+#include <c10/util/Exception.h>
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libxsmm.h>
+#include <stdint.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #else
 #include <stdexcept>
 #endif
 namespace torch_ipex {
 namespace tpp {
+#ifndef _WIN32
+// JIT-compiled loop nests are kept in an on-disk cache so that a new process
+// does not pay the g++ invocation again for a scheme it has seen before.
+// Loop nests are only JIT-compiled with TPP_JIT_LOOPS=1, schemes without a
+// precompiled nest are interpreted otherwise. Entries are keyed by a hash of
+// the build compiler, the target ISA, the compiler flags and the generated
+// source.
+// The cache lives in $TPP_JIT_CACHE_DIR (set it empty to disable caching),
+// falling back to $XDG_CACHE_HOME/ipex_tpp_jit or $HOME/.cache/ipex_tpp_jit.
+// Since its entries are dlopen'ed, the directory and the entries must be
+// owned by the current user and not be writable by group or others.
+static bool jit_cache_trusted(const struct stat& st) {
+  return st.st_uid == getuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+static std::string jit_cache_dir() {
+  static std::string dir = []() -> std::string {
+    std::string d;
+    if (auto env = getenv("TPP_JIT_CACHE_DIR")) {
+      d = env;
+    } else if (auto xdg = getenv("XDG_CACHE_HOME")) {
+      d = std::string(xdg) + "/ipex_tpp_jit";
+    } else if (auto home = getenv("HOME")) {
+      d = std::string(home) + "/.cache/ipex_tpp_jit";
+    }
+    if (d.empty())
+      return d;
+    // mkdir -p
+    for (size_t pos = 0; pos != std::string::npos;) {
+      pos = d.find('/', pos + 1);
+      auto sub = d.substr(0, pos);
+      struct stat st;
+      if (stat(sub.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+        continue;
+      if (mkdir(sub.c_str(), 0700) != 0 && errno != EEXIST) {
+        TORCH_WARN(
+            "TPP JIT cache: unable to create '", sub, "', caching disabled");
+        return std::string();
+      }
+    }
+    struct stat st;
+    if (stat(d.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) ||
+        !jit_cache_trusted(st)) {
+      TORCH_WARN(
+          "TPP JIT cache: '",
+          d,
+          "' is not owned by the current user or is writable by others, "
+          "caching disabled");
+      return std::string();
+    }
+    return d;
+  }();
+  return dir;
+}
+
+// Identifies the compiler this library was built with, so that a cache entry
+// stays valid across processes and machines sharing the same build.
+#ifndef TPP_JIT_TARGET
+#define TPP_JIT_TARGET "unknown"
+#endif
+static std::string jit_compiler_id() {
+  return std::string(__VERSION__) + " " + TPP_JIT_TARGET;
+}
+
+static std::string jit_cache_key(
+    const std::string& src,
+    const std::string& flags) {
+  // 64-bit FNV-1a over flags and source
+  uint64_t h = 0xcbf29ce484222325ULL;
+  auto mix = [&h](const std::string& s) {
+    for (unsigned char c : s) {
+      h ^= c;
+      h *= 0x100000001b3ULL;
+    }
+    h ^= 0xff;
+    h *= 0x100000001b3ULL;
+  };
+  mix(jit_compiler_id());
+  mix(libxsmm_get_target_arch());
+  mix(flags);
+  mix(src);
+  char key[17];
+  snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+  return key;
+}
+
+static bool jit_compile(
+    const std::string filename,
+    const std::string flags,
+    const char* libname) {
+  auto cmd = std::string("g++ -shared -fPIC -x c++ ") + flags;
+  cmd = cmd + " -o " + libname + " " + filename;
+  printf("JIT COMPILE: %s\n", cmd.c_str());
+  return system(cmd.c_str()) == 0;
+}
+
+static void* jit_load(const char* libname) {
+  auto handle = dlopen(libname, RTLD_LAZY | RTLD_NODELETE);
+  if (!handle) {
+    fputs(dlerror(), stderr);
+    return NULL;
+  }
+  return handle;
+}
+
+static void* jit_lookup(void* handle, const std::string func_name) {
+  if (handle == NULL)
+    return NULL;
+  void* func = dlsym(handle, func_name.c_str());
+  if (func == NULL) {
+    printf("Unable to find '%s' symbol in JIT COMPILE\n", func_name.c_str());
+  }
+  dlclose(handle);
+  return func;
+}
+
+// dlopen a cache entry through the descriptor its ownership was checked on,
+// so the file can not be swapped in between.
+static void* jit_cache_open(const std::string& libname) {
+  int fd = open(libname.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+  void* handle = NULL;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && jit_cache_trusted(st)) {
+    char fdname[50];
+    snprintf(fdname, sizeof(fdname), "/proc/self/fd/%d", fd);
+    handle = dlopen(fdname, RTLD_LAZY | RTLD_NODELETE);
+  } else {
+    TORCH_WARN("TPP JIT cache: ignoring untrusted entry '", libname, "'");
+  }
+  close(fd);
+  return handle;
+}
+
+// Compiles into a private temporary next to the cache entry and renames it
+// into place, so concurrent processes never dlopen a partially written file.
+// A read-only cache directory (e.g. one pre-populated for the user) still
+// serves hits; misses then fall back to the uncached path.
+static void* jit_compile_to_cache(
+    const std::string filename,
+    const std::string flags,
+    const std::string libname) {
+  auto tmpname = libname + ".XXXXXX";
+  int fd = mkstemp(&tmpname[0]);
+  if (fd < 0)
+    return NULL;
+  close(fd);
+  void* handle = NULL;
+  if (jit_compile(filename, flags, tmpname.c_str()) &&
+      chmod(tmpname.c_str(), S_IRWXU) == 0 &&
+      rename(tmpname.c_str(), libname.c_str()) == 0) {
+    handle = jit_cache_open(libname);
+  }
+  unlink(tmpname.c_str());
+  return handle;
+}
+#endif
+
 void* jit_compile_and_load(
     const std::string filename,
     const std::string flags) {
@@ -19,18 +184,9 @@ void* jit_compile_and_load(
   unlink(libname);
   char fdname[50];
   snprintf(fdname, sizeof(fdname), "/proc/self/fd/%d", fd);
-  auto cmd = std::string("g++ -shared -fPIC -x c++ ") + flags;
-  cmd = cmd + " -o " + fdname + " " + filename;
-  printf("JIT COMPILE: %s\n", cmd.c_str());
-  int ret = system(cmd.c_str());
-  if (ret != 0)
+  if (!jit_compile(filename, flags, fdname))
     return NULL;
-  auto handle = dlopen(fdname, RTLD_LAZY | RTLD_NODELETE);
-  if (!handle) {
-    fputs(dlerror(), stderr);
-    return NULL;
-  }
-  return handle;
+  return jit_load(fdname);
 #else
   throw std::runtime_error("not implemented.");
   return NULL;
@@ -42,15 +198,7 @@ void* jit_from_file(
     const std::string flags,
     const std::string func_name) {
 #ifndef _WIN32
-  void* handle = jit_compile_and_load(filename, flags);
-  if (handle == NULL)
-    return NULL;
-  void* func = dlsym(handle, func_name.c_str());
-  if (func == NULL) {
-    printf("Unable to find '%s' symbol in JIT COMPILE\n", func_name.c_str());
-  }
-  dlclose(handle);
-  return func;
+  return jit_lookup(jit_compile_and_load(filename, flags), func_name);
 #else
   throw std::runtime_error("not implemented.");
   return NULL;
@@ -62,12 +210,31 @@ void* jit_from_str(
     const std::string flags,
     const std::string func_name) {
 #ifndef _WIN32
+  std::string libname;
+  auto cache_dir = jit_cache_dir();
+  if (!cache_dir.empty()) {
+    libname = cache_dir + "/ppx_" + jit_cache_key(src, flags) + ".so";
+    if (access(libname.c_str(), F_OK) == 0) {
+      void* handle = jit_cache_open(libname);
+      if (handle != NULL)
+        return jit_lookup(handle, func_name);
+      // untrusted, stale or truncated entry, rebuild it below
+      unlink(libname.c_str());
+    }
+  }
   char filename[] = "/tmp/ppx_XXXXXX";
   int fd = mkstemp(filename);
   unlink(filename);
   char fdname[50];
   snprintf(fdname, sizeof(fdname), "/proc/self/fd/%d", fd);
   write(fd, src.c_str(), src.length());
+  if (!libname.empty()) {
+    void* handle = jit_compile_to_cache(fdname, flags, libname);
+    if (handle != NULL) {
+      close(fd);
+      return jit_lookup(handle, func_name);
+    }
+  }
   return jit_from_file(fdname, flags, func_name);
 #else
   throw std::runtime_error("not implemented.");
@@ -9,7 +9,9 @@
 #ifndef NO_PARLOOPER
 #include "tpp/threaded_loops.h"
 #endif
+#include <algorithm>
 #include <cstdint>
+#include <utility>
 #include "../../utils/isa_utils.h"
 #include "tpp/tensor_helper.h"
 #include "tpp/xsmm_functors.h"
@@ -50,6 +52,9 @@ REGISTER_LOCAL_SCOPE(
 REGISTER_LOCAL_SCOPE(
     tpp_linear_relu_krnl,
     "tpp_linear_relu_krnl"); // linear bias + relu
+REGISTER_LOCAL_SCOPE(
+    tpp_linear_topk_krnl,
+    "tpp_linear_topk_krnl"); // linear W/O bias + topk
 
 REGISTER_LOCAL_SCOPE(fftkn, "fftkn");
 
@@ -252,6 +257,127 @@ inline void tpp_linear_no_bias(
   }
 }
 
+// LM head for greedy / beam decoding: the top k of t_in x t_wt^T per row,
+// without writing the [BS, K] logits. Each thread takes a contiguous range
+// of Nk blocks, computes one [BSb, Hk] block of logits at a time into a
+// float scratch and keeps the best k of every row in a heap, the heaps of
+// all threads are merged at the end. Values and indices are sorted by
+// decreasing value, ties by increasing index. Only the first out_features
+// logits are candidates, the rest are padding of the blocked weight.
+template <typename T>
+inline void tpp_linear_topk(
+    const at::Tensor& t_in,
+    const at::Tensor& t_wt,
+    long k,
+    long out_features,
+    at::Tensor& t_values,
+    at::Tensor& t_indices,
+    int b_vnni) {
+  using Cand = std::pair<float, long>;
+  auto in_sizes = t_in.sizes();
+  auto BS = in_sizes[0] * in_sizes[1];
+  auto wt_sizes = t_wt.sizes();
+  auto C = in_sizes[2];
+  auto Nc = wt_sizes[1];
+  auto Hc = C / Nc;
+  auto Nk = wt_sizes[0];
+  auto Hk = wt_sizes[3];
+  auto t_wt_V = torch_ipex::tpp::wt_tensor_for_fwd(Nk, Hk, Nc, Hc, t_wt);
+
+  auto in = GetVLAPtr<T>(t_in, {Nc, Hc});
+  auto wt_V = GetVLAPtr<T>(t_wt_V, {Nc, Hc * Hk});
+  auto values = GetVLAPtr<T>(t_values, {k});
+  auto indices = GetVLAPtr<int64_t>(t_indices, {k});
+
+  auto BSb = 64L;
+  auto rem = BS % BSb;
+  auto nBSb = (BS + BSb - 1) / BSb;
+  auto brgemm_tpp = SCOPEITGEMM((BrgemmTPP<T, float>(
+      BSb, Hk, Hc, Hc, Hk * Hc, C, Hk, Hk, 0.0, 0, Nc, b_vnni)));
+  auto brgemm_tpp_rem = SCOPEITGEMM((BrgemmTPP<T, float>(
+      rem, Hk, Hc, Hc, Hk * Hc, C, Hk, Hk, 0.0, 0, Nc, b_vnni)));
+
+  // a is better than b: larger value, or same value and smaller index; the
+  // front of a heap ordered by it is the worst candidate kept
+  auto better = [](const Cand& a, const Cand& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  auto num_threads = omp_get_max_threads();
+  // the best k of every thread and row, kept across calls since the LM head
+  // runs once per decoding step
+  static thread_local std::vector<Cand> partial_buf;
+  partial_buf.assign(num_threads * BS * k, Cand(0.f, -1));
+  auto partial = partial_buf.data();
+
+  {
+    RECORD_SCOPE(tpp_linear_topk_krnl, {t_in, t_wt_V});
+#pragma omp parallel
+    {
+      auto tid = omp_get_thread_num();
+      std::vector<float> scratch(BSb * Hk);
+      std::vector<std::vector<Cand>> heaps(BS);
+      for (auto& heap : heaps) {
+        heap.reserve(k);
+      }
+      brgemm_tpp.config();
+      // nk outer, so that a thread streams its part of the weight once
+#pragma omp for schedule(static)
+      for (long n = 0; n < Nk * nBSb; n++) {
+        long nk = n / nBSb, s1 = n % nBSb * BSb;
+        bool is_rem = (s1 + BSb > BS);
+        if (!is_rem) {
+          brgemm_tpp(in[s1][0], wt_V[nk][0], scratch.data(), Nc, true);
+        } else {
+          brgemm_tpp_rem(in[s1][0], wt_V[nk][0], scratch.data(), Nc, false);
+          brgemm_tpp.config();
+        }
+        auto rows = is_rem ? rem : BSb;
+        auto cols = std::min(Hk, out_features - nk * Hk);
+        for (long r = 0; r < rows; r++) {
+          auto& heap = heaps[s1 + r];
+          auto logits = scratch.data() + r * Hk;
+          for (long j = 0; j < cols; j++) {
+            Cand c(logits[j], nk * Hk + j);
+            if ((long)heap.size() < k) {
+              heap.push_back(c);
+              std::push_heap(heap.begin(), heap.end(), better);
+            } else if (better(c, heap.front())) {
+              std::pop_heap(heap.begin(), heap.end(), better);
+              heap.back() = c;
+              std::push_heap(heap.begin(), heap.end(), better);
+            }
+          }
+        }
+      }
+      brgemm_tpp.release();
+      for (long b = 0; b < BS; b++) {
+        std::copy(
+            heaps[b].begin(),
+            heaps[b].end(),
+            partial + (tid * BS + b) * k);
+      }
+#pragma omp barrier
+#pragma omp for
+      for (long b = 0; b < BS; b++) {
+        std::vector<Cand> cands;
+        cands.reserve(num_threads * k);
+        for (int t = 0; t < num_threads; t++) {
+          auto first = partial + (t * BS + b) * k;
+          for (long i = 0; i < k && first[i].second >= 0; i++) {
+            cands.push_back(first[i]);
+          }
+        }
+        std::partial_sort(
+            cands.begin(), cands.begin() + k, cands.end(), better);
+        for (long i = 0; i < k; i++) {
+          values[b][i] = static_cast<T>(cands[i].first);
+          indices[b][i] = cands[i].second;
+        }
+      }
+    }
+  }
+}
+
 template <typename T, typename Tout = T>
 inline void tpp_linear_mul(
     const at::Tensor t_in,
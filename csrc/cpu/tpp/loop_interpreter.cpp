@@ -0,0 +1,329 @@
+#include <c10/util/Exception.h>
+#include <ctype.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <functional>
+#include <string>
+#include "threaded_loops.h"
+
+namespace torch_ipex {
+namespace tpp {
+
+LoopNestInterpreter::LoopNestInterpreter(const std::string& scheme)
+    : nLoops(0),
+      nLogicalLoops(0),
+      ompforBefore(-1),
+      nCollapsed(0),
+      rowTeams(0),
+      colTeams(0) {
+  int lastPhys[MAX_LOGICAL_LOOPS];
+  int nBlocking[MAX_LOGICAL_LOOPS] = {0};
+  for (int i = 0; i < MAX_LOGICAL_LOOPS; i++)
+    lastPhys[i] = -1;
+
+  size_t i = 0;
+  while (i < scheme.length()) {
+    char c = scheme[i];
+    if (isalpha(c)) {
+      int ll = tolower(c) - 'a';
+      TORCH_CHECK(
+          nLoops < MAX_LOOPS && ll < MAX_LOGICAL_LOOPS,
+          "LoopNestInterpreter: '",
+          scheme,
+          "': too many loops at position ",
+          i);
+      Level& lv = levels[nLoops];
+      lv.logical = ll;
+      lv.prev = lastPhys[ll];
+      lv.blocking = nBlocking[ll]++;
+      TORCH_CHECK(
+          lv.blocking < MAX_BLOCKING_LEVELS,
+          "LoopNestInterpreter: '",
+          scheme,
+          "': too many blocking levels for loop '",
+          c,
+          "'");
+      lv.last = false;
+      lv.parallel = isupper(c);
+      lv.barrier = false;
+      lv.team = 0;
+      lastPhys[ll] = nLoops++;
+      if (nLogicalLoops <= ll)
+        nLogicalLoops = ll + 1;
+      i++;
+    } else if (c == '|' && nLoops > 0) {
+      levels[nLoops - 1].barrier = true;
+      i++;
+    } else if (c == '[' && nLoops > 0) {
+      // [start,end,step(bs0,bs1,..)], any field may be left empty
+      auto close = scheme.find(']', i);
+      TORCH_CHECK(
+          close != std::string::npos,
+          "LoopNestInterpreter: '",
+          scheme,
+          "': unterminated '[' at position ",
+          i);
+      auto spec = scheme.substr(i + 1, close - i - 1);
+      Bounds& b = consts[levels[nLoops - 1].logical];
+      auto paren = spec.find('(');
+      if (paren != std::string::npos) {
+        auto bs = spec.substr(paren + 1, spec.find(')', paren) - paren - 1);
+        size_t pos = 0;
+        while (pos < bs.length() && b.n_block_sizes < MAX_BLOCKING_LEVELS) {
+          auto comma = bs.find(',', pos);
+          if (comma == std::string::npos)
+            comma = bs.length();
+          b.block_size[b.n_block_sizes++] = atol(bs.c_str() + pos);
+          pos = comma + 1;
+        }
+        spec = spec.substr(0, paren);
+      }
+      size_t pos = 0;
+      for (int field = 0; field < 3 && pos <= spec.length(); field++) {
+        auto comma = spec.find(',', pos);
+        if (comma == std::string::npos)
+          comma = spec.length();
+        if (comma > pos) {
+          long val = atol(spec.c_str() + pos);
+          if (field == 0) {
+            b.has_start = true;
+            b.start = val;
+          } else if (field == 1) {
+            b.has_end = true;
+            b.end = val;
+          } else {
+            b.has_step = true;
+            b.step = val;
+          }
+        }
+        pos = comma + 1;
+      }
+      i = close + 1;
+    } else if (c == '{' && nLoops > 0) {
+      // {R:n} / {C:n} splits the previous loop across n row / col teams
+      auto close = scheme.find('}', i);
+      TORCH_CHECK(
+          close != std::string::npos && close > i + 2,
+          "LoopNestInterpreter: '",
+          scheme,
+          "': malformed team spec at position ",
+          i);
+      int teams = atoi(scheme.c_str() + i + 3);
+      if (rowTeams == 0) {
+        rowTeams = 1;
+        colTeams = 1;
+      }
+      if (scheme[i + 1] == 'R' || scheme[i + 1] == 'r') {
+        levels[nLoops - 1].team = 1;
+        rowTeams = teams;
+      } else {
+        levels[nLoops - 1].team = 2;
+        colTeams = teams;
+      }
+      i = close + 1;
+    } else {
+      TORCH_WARN(
+          "LoopNestInterpreter: '",
+          scheme,
+          "': Ignoring unknown scheme character: '",
+          c,
+          "' at position ",
+          i);
+      i++;
+    }
+  }
+
+  for (int ll = 0; ll < nLogicalLoops; ll++) {
+    TORCH_CHECK(
+        lastPhys[ll] >= 0,
+        "LoopNestInterpreter: '",
+        scheme,
+        "': logical loop '",
+        (char)('a' + ll),
+        "' is not used");
+    levels[lastPhys[ll]].last = true;
+  }
+  for (int l = 0; l < nLoops; l++) {
+    bool shared = levels[l].parallel && levels[l].team == 0;
+    if (ompforBefore == -1 && shared)
+      ompforBefore = l;
+    if (ompforBefore != -1 && ompforBefore + nCollapsed == l && shared)
+      nCollapsed++;
+  }
+  // A barrier on one of the collapsed loops lands after the whole
+  // worksharing loop, deeper ones would not be reached by every thread.
+  int lastShared = ompforBefore + nCollapsed - 1;
+  for (int l = ompforBefore; ompforBefore != -1 && l < nLoops; l++) {
+    if (l != lastShared && levels[l].barrier) {
+      if (l < lastShared) {
+        levels[lastShared].barrier = true;
+      } else {
+        TORCH_WARN(
+            "LoopNestInterpreter: '",
+            scheme,
+            "': Ignoring barrier inside parallel loop");
+      }
+      levels[l].barrier = false;
+    }
+  }
+}
+
+void LoopNestInterpreter::bounds(
+    int l,
+    const LoopSpecs* loopSpecs,
+    const long* vals,
+    long& start,
+    long& end,
+    long& step) const {
+  const Level& lv = levels[l];
+  const Bounds& c = consts[lv.logical];
+  const LoopSpecs& spec = loopSpecs[lv.logical];
+  const long* block_size =
+      c.n_block_sizes > 0 ? c.block_size : spec.block_size;
+  if (lv.prev < 0) {
+    start = c.has_start ? c.start : spec.start;
+    end = c.has_end ? c.end : spec.end;
+  } else {
+    start = vals[lv.prev];
+    end = start + block_size[lv.blocking - 1];
+  }
+  if (lv.last)
+    step = c.has_step ? c.step : spec.step;
+  else
+    step = block_size[lv.blocking];
+}
+
+void LoopNestInterpreter::walk(
+    int l,
+    const LoopSpecs* loopSpecs,
+    const std::function<void(int*)>& body_func,
+    long* vals,
+    int* ind,
+    int row_id,
+    int col_id) const {
+  if (l == nLoops) {
+    body_func(ind);
+    return;
+  }
+  long start, end, step;
+  if (l == ompforBefore) {
+    // Flatten the collapsed loops into one iteration space. Trip counts
+    // do not depend on the outer indices (inner blocks span a fixed
+    // block_size), so they can be taken before the first iteration.
+    int last = l + nCollapsed;
+    long counts[MAX_LOOPS], digits[MAX_LOOPS], starts[MAX_LOOPS],
+        steps[MAX_LOOPS];
+    long total = 1;
+    for (int j = l; j < last; j++) {
+      bounds(j, loopSpecs, vals, start, end, step);
+      counts[j] = end > start ? (end - start + step - 1) / step : 0;
+      starts[j] = start;
+      steps[j] = step;
+      total *= counts[j];
+    }
+    long next = -1;
+#pragma omp for nowait
+    for (long n = 0; n < total; n++) {
+      // Iterations of a thread are mostly consecutive, step the indices
+      // like an odometer and only decompose n when jumping.
+      int from = l;
+      if (n == next) {
+        from = last - 1;
+        while (++digits[from] == counts[from]) {
+          digits[from] = 0;
+          from--;
+        }
+      } else {
+        long rem = n;
+        for (int j = last - 1; j >= l; j--) {
+          digits[j] = rem % counts[j];
+          rem /= counts[j];
+        }
+      }
+      next = n + 1;
+      for (int j = from; j < last; j++) {
+        // blocks of a loop collapsed with its outer block start at it
+        int prev = levels[j].prev;
+        start = prev >= l ? vals[prev] : starts[j];
+        vals[j] = start + digits[j] * steps[j];
+        ind[levels[j].logical] = vals[j];
+      }
+      if (last == nLoops)
+        body_func(ind);
+      else
+        walk(last, loopSpecs, body_func, vals, ind, row_id, col_id);
+    }
+    if (levels[last - 1].barrier) {
+#pragma omp barrier
+    }
+    return;
+  }
+
+  bounds(l, loopSpecs, vals, start, end, step);
+  if (levels[l].team != 0) {
+    bool row = levels[l].team == 1;
+    long id = row ? row_id : col_id;
+    long teams = row ? rowTeams : colTeams;
+    long tasks = (end - start + step - 1) / step;
+    long chunk = (tasks + teams - 1) / teams;
+    long my_start = id * chunk < tasks ? start + id * chunk * step : end;
+    end = (id + 1) * chunk < tasks ? start + (id + 1) * chunk * step : end;
+    start = my_start;
+  }
+  auto ll = levels[l].logical;
+  if (l + 1 == nLoops) {
+    for (long v = start; v < end; v += step) {
+      ind[ll] = v;
+      body_func(ind);
+    }
+  } else {
+    for (long v = start; v < end; v += step) {
+      vals[l] = v;
+      ind[ll] = v;
+      walk(l + 1, loopSpecs, body_func, vals, ind, row_id, col_id);
+    }
+  }
+  if (levels[l].barrier) {
+#pragma omp barrier
+  }
+}
+
+void LoopNestInterpreter::run(
+    LoopSpecs* loopSpecs,
+    std::function<void(int*)> body_func,
+    std::function<void()> init_func,
+    std::function<void()> fini_func) const {
+  if (ompforBefore == -1 && rowTeams == 0) {
+    long vals[MAX_LOOPS] = {0};
+    int ind[MAX_LOGICAL_LOOPS] = {0};
+    if (init_func)
+      init_func();
+    walk(0, loopSpecs, body_func, vals, ind, 0, 0);
+    if (fini_func)
+      fini_func();
+    return;
+  }
+#pragma omp parallel
+  {
+    long vals[MAX_LOOPS] = {0};
+    int ind[MAX_LOGICAL_LOOPS] = {0};
+    int tid = omp_get_thread_num();
+    int row_id = 0, col_id = 0;
+    bool active = true;
+    if (rowTeams > 0) {
+      row_id = tid / colTeams;
+      col_id = tid % colTeams;
+      active = tid < rowTeams * colTeams;
+    }
+    if (active) {
+      if (init_func)
+        init_func();
+      walk(0, loopSpecs, body_func, vals, ind, row_id, col_id);
+      if (fini_func)
+        fini_func();
+    }
+  }
+}
+
+} // namespace tpp
+} // namespace torch_ipex
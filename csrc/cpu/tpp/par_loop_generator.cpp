@@ -618,8 +618,8 @@ std::string loop_generator(const char* __loop_nest_desc_extended) {
   int jit_loop_spec = 0;
   int use_2d_par = 0;
   size_t src_len = strlen(__loop_nest_desc_extended);
-  char _loop_nest_desc_extended[src_len];
-  char loop_nest_desc_extended[src_len];
+  char _loop_nest_desc_extended[src_len + 1];
+  char loop_nest_desc_extended[src_len + 1];
 
   /* Extract explicit 2D parallelization info */
   for (i = 0; i < src_len; i++) {
@@ -629,6 +629,8 @@ std::string loop_generator(const char* __loop_nest_desc_extended) {
     }
   }
   l_code.use_2d_par = use_2d_par;
+  // team settings are only written for the loops that have them
+  std::fill_n(loop_params, 256, loop_param_t{});
   if (use_2d_par > 0) {
     l_code.n_col_teams = 1;
     l_code.n_row_teams = 1;
@@ -2,11 +2,13 @@
 #define _THREADED_LOOPS_H_
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <array>
 #include <cassert>
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -115,6 +117,66 @@ typedef void (*par_loop_kernel)(
 
 extern std::unordered_map<std::string, par_loop_kernel> pre_defined_loops;
 
+// Runs a looping scheme straight from its description instead of compiling
+// the nest that loop_generator() emits for it. The scheme is parsed once
+// into a table of physical loops (logical loop, blocking level, parallel and
+// barrier markers, team splits and constant bounds), which run() walks
+// inside a single omp parallel region, collapsing the leading run of
+// parallel loops into one worksharing loop like the generated code does.
+class LoopNestInterpreter {
+ public:
+  LoopNestInterpreter(const std::string& scheme);
+
+  void run(
+      LoopSpecs* loopSpecs,
+      std::function<void(int*)> body_func,
+      std::function<void()> init_func,
+      std::function<void()> fini_func) const;
+
+ private:
+  struct Level {
+    int logical; // logical loop index, 'a' -> 0
+    int prev; // physical level of the enclosing block of this loop, or -1
+    int blocking; // blocking level of this occurrence
+    bool last; // innermost occurrence of its logical loop
+    bool parallel;
+    bool barrier; // omp barrier after this loop completes
+    int team; // 0: none, 1: split across row teams, 2: across col teams
+  };
+  // Constant bounds given as "[start,end,step(bs0,bs1,..)]" in the scheme
+  struct Bounds {
+    bool has_start = false, has_end = false, has_step = false;
+    long start = 0, end = 0, step = 1;
+    int n_block_sizes = 0;
+    long block_size[MAX_BLOCKING_LEVELS] = {0};
+  };
+
+  void bounds(
+      int l,
+      const LoopSpecs* loopSpecs,
+      const long* vals,
+      long& start,
+      long& end,
+      long& step) const;
+  void walk(
+      int l,
+      const LoopSpecs* loopSpecs,
+      const std::function<void(int*)>& body_func,
+      long* vals,
+      int* ind,
+      int row_id,
+      int col_id) const;
+
+  int nLoops;
+  int nLogicalLoops;
+  int ompforBefore;
+  int nCollapsed;
+  int rowTeams;
+  int colTeams;
+  Level levels[MAX_LOOPS];
+  Bounds consts[MAX_LOGICAL_LOOPS];
+};
+
 #if 0
 void par_nested_loops(LoopSpecs *loopSpecs, std::function<void(int*)> body_func, std::function<void()> init_func, std::function<void()> fini_func)
 {
@@ -197,7 +259,7 @@ class LoopingScheme {
     auto search = pre_defined_loops.find(scheme);
     if (search != pre_defined_loops.end()) {
       test_kernel = search->second;
-    } else {
+    } else if (getenv("TPP_JIT_LOOPS") && atoi(getenv("TPP_JIT_LOOPS"))) {
       std::string gen_code = loop_generator(scheme.c_str());
       std::ofstream ofs("debug.cpp", std::ofstream::out);
       ofs << code_str + gen_code;
@@ -208,6 +270,11 @@ class LoopingScheme {
       test_kernel = (par_loop_kernel)jit_from_str(
           code_str + gen_code, " -fopenmp ", "par_nested_loops");
     }
+    // Schemes without a precompiled nest are interpreted unless
+    // TPP_JIT_LOOPS=1 asks for g++ codegen, which sandboxed deployments
+    // (no system(), no writable exec memory) can not do.
+    if (test_kernel == NULL)
+      interpreter = std::make_unique<LoopNestInterpreter>(scheme);
   }
 
   void call(
@@ -215,7 +282,10 @@ class LoopingScheme {
       std::function<void(int*)> body_func,
       std::function<void()> init_func,
       std::function<void()> fini_func) {
-    test_kernel(loopSpecs, body_func, init_func, fini_func);
+    if (test_kernel)
+      test_kernel(loopSpecs, body_func, init_func, fini_func);
+    else
+      interpreter->run(loopSpecs, body_func, init_func, fini_func);
   }
 
   const std::string getKernelCode() {
@@ -231,6 +301,7 @@ class LoopingScheme {
   bool isParallel[MAX_LOOPS];
   int p2lMap[MAX_LOOPS];
   par_loop_kernel test_kernel;
+  std::unique_ptr<LoopNestInterpreter> interpreter;
 };
 
 inline LoopingScheme* getLoopingScheme(std::string scheme) {
@@ -31,6 +31,9 @@ struct VecOps {
   static VT set_nf4_lut() {
     TLA_ASSERT(false, "should not reach here");
   }
+  static VT set_lowbit_lut(int bits, bool sym) {
+    TLA_ASSERT(false, "should not reach here");
+  }
   static VT mul() {
     TLA_ASSERT(false, "should not reach here");
   }
@@ -121,6 +124,17 @@ struct VecOps<__m512> {
         -0.6961928009986877,
         -1.0f);
   }
+  // lookup table of 2-bit or 3-bit values, [0, 2^bits) or [-2^(bits-1),
+  // 2^(bits-1)) if sym. Repeated every 2^bits entries so that the index bits
+  // above `bits` do not need to be masked off.
+  static inline __m512 set_lowbit_lut(int bits, bool sym) {
+    auto v = _mm512_cvttps_epi32(set_0_to_15());
+    v = _mm512_and_si512(v, _mm512_set1_epi32((1 << bits) - 1));
+    if (sym) {
+      v = _mm512_sub_epi32(v, _mm512_set1_epi32(1 << (bits - 1)));
+    }
+    return _mm512_cvtepi32_ps(v);
+  }
 };
 
 template <>
@@ -261,6 +275,14 @@ struct VecOps<__m512h> {
         static_cast<_Float16>(-0.6961928009986877f),
         static_cast<_Float16>(-1.0f));
   }
+  static inline __m512h set_lowbit_lut(int bits, bool sym) {
+    auto v = _mm512_cvttph_epi16(set_0_to_15());
+    v = _mm512_and_si512(v, _mm512_set1_epi16((1 << bits) - 1));
+    if (sym) {
+      v = _mm512_sub_epi16(v, _mm512_set1_epi16(1 << (bits - 1)));
+    }
+    return _mm512_cvtepi16_ph(v);
+  }
 };
 
 template <>
@@ -0,0 +1,266 @@
+#include "shared_weight.h"
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace torch_ipex {
+namespace utils {
+
+namespace {
+
+constexpr uint64_t kSegmentMagic = 0x5448474945575049; // "IPWEIGHT"
+constexpr int32_t kSegmentCreating = 0;
+constexpr int32_t kSegmentReady = 1;
+constexpr int kAttachTimeoutSeconds = 600;
+constexpr int64_t kMaxDims = 8;
+
+struct SegmentHeader {
+  std::atomic<int32_t> state;
+  std::atomic<int32_t> refcount;
+  uint64_t magic;
+  uint64_t nbytes;
+  int32_t scalar_type;
+  int64_t ndim;
+  int64_t sizes[kMaxDims];
+  int64_t strides[kMaxDims];
+};
+static_assert(
+    std::atomic<int32_t>::is_always_lock_free,
+    "shared weight segments need lock free atomics");
+
+// The header has its own page so that the data can be mapped read-only.
+size_t header_size() {
+  static const size_t size = sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+void fill_header(SegmentHeader* header, const at::Tensor& tensor) {
+  header->magic = kSegmentMagic;
+  header->nbytes = tensor.nbytes();
+  header->scalar_type = static_cast<int32_t>(tensor.scalar_type());
+  header->ndim = tensor.dim();
+  for (int64_t d = 0; d < tensor.dim(); d++) {
+    header->sizes[d] = tensor.size(d);
+    header->strides[d] = tensor.stride(d);
+  }
+}
+
+bool header_matches(const SegmentHeader* header, const at::Tensor& tensor) {
+  if (header->magic != kSegmentMagic || header->nbytes != tensor.nbytes() ||
+      header->scalar_type != static_cast<int32_t>(tensor.scalar_type()) ||
+      header->ndim != tensor.dim()) {
+    return false;
+  }
+  for (int64_t d = 0; d < tensor.dim(); d++) {
+    if (header->sizes[d] != tensor.size(d) ||
+        header->strides[d] != tensor.stride(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct SharedSegment {
+  std::string name;
+  SegmentHeader* header = nullptr;
+  void* data = nullptr;
+  size_t nbytes = 0;
+
+  ~SharedSegment() {
+    if (data != nullptr) {
+      munmap(data, nbytes);
+    }
+    if (header != nullptr) {
+      bool last = header->refcount.fetch_sub(1) == 1;
+      munmap(header, header_size());
+      if (last) {
+        shm_unlink(name.c_str());
+      }
+    }
+  }
+};
+
+std::mutex& segment_registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<std::string, std::weak_ptr<SharedSegment>>&
+segment_registry() {
+  static std::unordered_map<std::string, std::weak_ptr<SharedSegment>>
+      registry;
+  return registry;
+}
+
+// POSIX shm names are a single path component of at most NAME_MAX chars
+std::string segment_name(const std::string& key) {
+  std::string name = "/ipex_weight_";
+  for (char c : key) {
+    name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+  }
+  if (name.size() > 200) {
+    name = name.substr(0, 180) + "_" +
+        std::to_string(std::hash<std::string>{}(key));
+  }
+  return name;
+}
+
+void* map_or_fail(size_t size, int prot, int fd, off_t offset) {
+  void* ptr = mmap(nullptr, size, prot, MAP_SHARED, fd, offset);
+  TORCH_CHECK(
+      ptr != MAP_FAILED,
+      "share_tensor_across_processes: mmap failed, ",
+      std::strerror(errno));
+  return ptr;
+}
+
+std::shared_ptr<SharedSegment> create_or_attach(
+    const std::string& name,
+    const at::Tensor& tensor) {
+  auto segment = std::make_shared<SharedSegment>();
+  segment->name = name;
+  segment->nbytes = tensor.nbytes();
+  const size_t total = header_size() + std::max<size_t>(segment->nbytes, 1);
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  bool owner = fd >= 0;
+  if (owner) {
+    if (ftruncate(fd, total) != 0) {
+      close(fd);
+      shm_unlink(name.c_str());
+      TORCH_CHECK(
+          false,
+          "share_tensor_across_processes: cannot allocate ",
+          total,
+          " bytes of shared memory");
+    }
+    segment->header = static_cast<SegmentHeader*>(
+        map_or_fail(header_size(), PROT_READ | PROT_WRITE, fd, 0));
+    // a fresh segment is zero filled, i.e. state is kSegmentCreating
+    segment->header->refcount.store(1);
+    fill_header(segment->header, tensor);
+    if (segment->nbytes > 0) {
+      void* data = map_or_fail(
+          segment->nbytes, PROT_READ | PROT_WRITE, fd, header_size());
+      std::memcpy(data, tensor.contiguous().data_ptr(), segment->nbytes);
+      mprotect(data, segment->nbytes, PROT_READ);
+      segment->data = data;
+    }
+    close(fd);
+    segment->header->state.store(kSegmentReady, std::memory_order_release);
+    return segment;
+  }
+
+  TORCH_CHECK(
+      errno == EEXIST,
+      "share_tensor_across_processes: shm_open failed, ",
+      std::strerror(errno));
+  fd = shm_open(name.c_str(), O_RDWR, 0600);
+  TORCH_CHECK(
+      fd >= 0,
+      "share_tensor_across_processes: cannot attach to ",
+      name,
+      ", ",
+      std::strerror(errno));
+  // the owner may not have sized the segment yet
+  auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::seconds(kAttachTimeoutSeconds);
+  struct stat st;
+  while (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < total &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (static_cast<size_t>(st.st_size) < total) {
+    close(fd);
+    TORCH_CHECK(
+        false,
+        "share_tensor_across_processes: segment ",
+        name,
+        " does not match the tensor to share");
+  }
+  segment->header = static_cast<SegmentHeader*>(
+      map_or_fail(header_size(), PROT_READ | PROT_WRITE, fd, 0));
+  segment->header->refcount.fetch_add(1);
+  while (segment->header->state.load(std::memory_order_acquire) !=
+             kSegmentReady &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bool ready =
+      segment->header->state.load(std::memory_order_acquire) == kSegmentReady;
+  bool match = ready && header_matches(segment->header, tensor);
+  if (!ready || !match) {
+    close(fd);
+    // the destructor drops the reference taken above
+    TORCH_CHECK(
+        ready,
+        "share_tensor_across_processes: timed out waiting for the owner of ",
+        name);
+    TORCH_CHECK(
+        false,
+        "share_tensor_across_processes: segment ",
+        name,
+        " does not match the tensor to share");
+  }
+  if (segment->nbytes > 0) {
+    segment->data = map_or_fail(segment->nbytes, PROT_READ, fd, header_size());
+  }
+  close(fd);
+  return segment;
+}
+
+} // namespace
+
+at::Tensor share_tensor_across_processes(
+    const std::string& key,
+    const at::Tensor& tensor) {
+  TORCH_CHECK(
+      tensor.device().is_cpu(),
+      "share_tensor_across_processes: only CPU tensors can be shared");
+  TORCH_CHECK(
+      tensor.dim() <= kMaxDims,
+      "share_tensor_across_processes: tensors of more than ",
+      kMaxDims,
+      " dims are not supported");
+  auto name = segment_name(key);
+  std::shared_ptr<SharedSegment> segment;
+  {
+    std::lock_guard<std::mutex> lock(segment_registry_mutex());
+    auto& registry = segment_registry();
+    auto it = registry.find(name);
+    if (it != registry.end()) {
+      segment = it->second.lock();
+    }
+    if (segment == nullptr) {
+      segment = create_or_attach(name, tensor);
+      registry[name] = segment;
+    }
+  }
+  TORCH_CHECK(
+      header_matches(segment->header, tensor),
+      "share_tensor_across_processes: key ",
+      key,
+      " is already used by a tensor of a different shape, strides or dtype");
+  auto contiguous_strides = tensor.contiguous().strides().vec();
+  return at::from_blob(
+      segment->data,
+      tensor.sizes(),
+      contiguous_strides,
+      [segment](void*) {},
+      tensor.options().requires_grad(false));
+}
+
+} // namespace utils
+} // namespace torch_ipex
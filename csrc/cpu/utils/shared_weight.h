@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <string>
+
+namespace torch_ipex {
+namespace utils {
+
+/*
+Share a read-only tensor across the processes of a host through named POSIX
+shared memory, e.g. the packed weights of the model instances launched one per
+CPUPool.
+
+The first process calling it with a given key creates the segment and copies
+`tensor` into it (pack once), the others attach to the segment and wait until
+it is filled. Attaching fails unless `tensor` has the dtype, sizes and strides
+the segment was created with. The returned tensor has the sizes and strides of `tensor` and
+is mapped read-only, so any in-place update of it faults. The segment is
+reference counted across processes and unlinked when the last tensor
+referencing it, in any process, is released. A process that dies without
+releasing its reference leaks the segment until /dev/shm is cleaned up.
+*/
+at::Tensor share_tensor_across_processes(
+    const std::string& key,
+    const at::Tensor& tensor);
+
+} // namespace utils
+} // namespace torch_ipex
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <ATen/ATen.h>
+#include <ATen/cpu/vec/vec.h>
+#include <torch/types.h>
+#include "utils.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+template <typename QT, typename KT, typename CT>
+void _reduce_head(
+    const QT* q_ptr_start,
+    const KT* k_ptr_start,
+    float* attn_w_pos,
+    int64_t head_size,
+    bool store_key,
+    CT* k_cache_start) {
+  auto hsi = 0;
+  auto vec_size = 8; // 256/32
+  // two accumulators hide the FMA latency on the short decode dot products
+  auto qk_sum_vec0 = _mm256_setzero_ps();
+  auto qk_sum_vec1 = _mm256_setzero_ps();
+  for (hsi = 0; hsi <= head_size - 2 * vec_size; hsi += 2 * vec_size) {
+    auto q_vec0 = _loadu(q_ptr_start + hsi);
+    auto k_vec0 = _loadu(k_ptr_start + hsi);
+    auto q_vec1 = _loadu(q_ptr_start + hsi + vec_size);
+    auto k_vec1 = _loadu(k_ptr_start + hsi + vec_size);
+    if (store_key) {
+      _storeu(k_cache_start + hsi, k_vec0);
+      _storeu(k_cache_start + hsi + vec_size, k_vec1);
+    }
+    qk_sum_vec0 = _mm256_fmadd_ps(q_vec0, k_vec0, qk_sum_vec0);
+    qk_sum_vec1 = _mm256_fmadd_ps(q_vec1, k_vec1, qk_sum_vec1);
+  }
+  for (; hsi <= head_size - vec_size; hsi += vec_size) {
+    auto q_vec = _loadu(q_ptr_start + hsi);
+    auto k_vec = _loadu(k_ptr_start + hsi);
+    if (store_key) {
+      _storeu(k_cache_start + hsi, k_vec);
+    }
+    qk_sum_vec0 = _mm256_fmadd_ps(q_vec, k_vec, qk_sum_vec0);
+  }
+  attn_w_pos[0] += _reduce_add_ps(_mm256_add_ps(qk_sum_vec0, qk_sum_vec1));
+  for (; hsi < head_size; hsi++) {
+    if (store_key) {
+      k_cache_start[hsi] =
+          (float)k_ptr_start[hsi]; // cat the key into the key_cache.
+    }
+    attn_w_pos[0] += q_ptr_start[hsi] * (float)k_ptr_start[hsi];
+  }
+}
+
+template <typename VT, typename OT, typename CT>
+inline void _mul_and_accumulate(
+    const float& attn_w,
+    const VT* v_ptr_start,
+    OT* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    CT* v_cache_start,
+    int accumulated) {
+  auto vec_size = 8; // 256/32
+  auto hsi = 0;
+  auto attn_w_vec = _mm256_set1_ps(attn_w);
+  for (hsi = 0; hsi <= head_size - vec_size; hsi += vec_size) {
+    auto v_vec = _loadu(v_ptr_start + hsi);
+    if (accumulated) {
+      auto attn_out_vec = _loadu(attn_out_start + hsi);
+      auto attn_out_vec_new = _mm256_fmadd_ps(attn_w_vec, v_vec, attn_out_vec);
+      _storeu(attn_out_start + hsi, attn_out_vec_new);
+    } else {
+      auto attn_out_vec_new = _mm256_mul_ps(attn_w_vec, v_vec);
+      _storeu(attn_out_start + hsi, attn_out_vec_new);
+    }
+    if (store_value) {
+      _storeu(v_cache_start + hsi, v_vec);
+    }
+  }
+  for (; hsi < head_size; hsi++) {
+    if (accumulated) {
+      attn_out_start[hsi] += attn_w * (float)v_ptr_start[hsi];
+    } else {
+      attn_out_start[hsi] = attn_w * (float)v_ptr_start[hsi];
+    }
+    if (store_value) {
+      v_cache_start[hsi] = (float)v_ptr_start[hsi];
+    }
+  }
+}
+
+template <typename VT, typename OT, typename CT>
+inline typename std::enable_if_t<at::vec::is_reduced_floating_point_v<VT>, void>
+_mul_and_accumulate(
+    const VT& attn_w,
+    const VT* v_ptr_start,
+    OT* attn_out_start,
+    int64_t head_size,
+    bool store_value,
+    CT* v_cache_start,
+    int accumulated) {
+  _mul_and_accumulate<VT, OT, CT>(
+      (float)attn_w,
+      v_ptr_start,
+      attn_out_start,
+      head_size,
+      store_value,
+      v_cache_start,
+      accumulated);
+}
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1 @@
+#include "add_softmax.h"
@@ -0,0 +1,35 @@
+#pragma once
+
+// below is for unaligned data load
+inline __m256 _loadu(const float* data_base) {
+  return _mm256_loadu_ps(data_base);
+}
+
+inline __m256 _loadu(const at::BFloat16* data_base) {
+  return cvt_bf16_to_fp32(_mm_loadu_si128((__m128i*)data_base));
+}
+
+inline __m256 _loadu(const at::Half* data_base) {
+  return _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)data_base));
+}
+
+// below is for unaligned data store
+inline void _storeu(float* data_base, __m256 a) {
+  _mm256_storeu_ps(data_base, a);
+}
+
+inline void _storeu(at::BFloat16* data_base, __m256 a) {
+  _mm_storeu_si128((__m128i*)data_base, cvt_fp32_to_bf16(a));
+}
+
+inline void _storeu(at::Half* data_base, __m256 a) {
+  auto vec_fp16_out = _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT);
+  _mm_storeu_si128((__m128i*)data_base, vec_fp16_out);
+}
+
+inline float _reduce_add_ps(__m256 a) {
+  auto sum = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+  return _mm_cvtss_f32(sum);
+}
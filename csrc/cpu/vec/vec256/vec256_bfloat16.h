@@ -6,6 +6,37 @@
 
 using namespace at::vec;
 
+#include <immintrin.h>
+// Conversion from BF16 to FP32
+inline __m256 cvt_bf16_to_fp32(const __m128i src) {
+  auto y = _mm256_cvtepu16_epi32(src);
+  return _mm256_castsi256_ps(_mm256_slli_epi32(y, 16));
+}
+
+// Conversion from FP32 to BF16
+inline __m128i cvt_fp32_to_bf16(const __m256 src) {
+  __m256i value = _mm256_castps_si256(src);
+  __m256i nan = _mm256_set1_epi32(0xffff);
+  __m256i mask_value =
+      _mm256_castps_si256(_mm256_cmp_ps(src, src, _CMP_ORD_Q));
+  __m256i ones = _mm256_set1_epi32(0x1);
+  __m256i vec_bias = _mm256_set1_epi32(0x7fff);
+  // uint32_t lsb = (input >> 16) & 1;
+  auto t_value = _mm256_and_si256(_mm256_srli_epi32(value, 16), ones);
+  // uint32_t rounding_bias = 0x7fff + lsb;
+  t_value = _mm256_add_epi32(t_value, vec_bias);
+  // input += rounding_bias;
+  t_value = _mm256_add_epi32(t_value, value);
+  // input = input >> 16;
+  t_value = _mm256_srli_epi32(t_value, 16);
+  // Check NaN before converting back to bf16
+  t_value = _mm256_blendv_epi8(nan, t_value, mask_value);
+  // packus works within 128-bit lanes, gather the low halves of both lanes
+  t_value = _mm256_packus_epi32(t_value, t_value);
+  t_value = _mm256_permute4x64_epi64(t_value, 0xd8);
+  return _mm256_castsi256_si128(t_value);
+}
+
 /*
   Following the namespace convention of PyTorch, we put ISA-specific kernels
   under at::vec::[CPU_CAPABILITY] with [CPU_CAPABILITY] as the inline namespace.
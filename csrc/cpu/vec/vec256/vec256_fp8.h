@@ -0,0 +1,52 @@
+#pragma once
+#include <immintrin.h>
+#include <cstdlib>
+#include "utils/SysUtil.h"
+#include "vec256_bfloat16.h"
+
+namespace torch_ipex {
+namespace cpu {
+namespace kernel {
+
+// E5M2 is the high byte of an FP16, so the widening is exact.
+static IPEX_FORCE_INLINE __m256i _mm256_cvte5m2_fp16(__m128i a) {
+  return _mm256_slli_epi16(_mm256_cvtepi8_epi16(a), 8);
+}
+
+static IPEX_FORCE_INLINE void cvt_e5m2_bf16_intrinsic(
+    const at::Float8_e5m2* __restrict__ in,
+    at::BFloat16* out,
+    size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m256i a = _mm256_cvte5m2_fp16(_mm_loadu_si128((__m128i*)&in[i]));
+    __m256 lo = _mm256_cvtph_ps(_mm256_castsi256_si128(a));
+    __m256 hi = _mm256_cvtph_ps(_mm256_extracti128_si256(a, 1));
+    _mm_storeu_si128((__m128i*)(out + i), cvt_fp32_to_bf16(lo));
+    _mm_storeu_si128((__m128i*)(out + i + 8), cvt_fp32_to_bf16(hi));
+  }
+  for (; i < len; i++) {
+    out[i] = static_cast<at::BFloat16>(in[i]);
+  }
+}
+
+static IPEX_FORCE_INLINE void cvt_e5m2_fp32_intrinsic(
+    const at::Float8_e5m2* __restrict__ in,
+    float* out,
+    size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m256i a = _mm256_cvte5m2_fp16(_mm_loadu_si128((__m128i*)&in[i]));
+    __m256 lo = _mm256_cvtph_ps(_mm256_castsi256_si128(a));
+    __m256 hi = _mm256_cvtph_ps(_mm256_extracti128_si256(a, 1));
+    _mm256_storeu_ps(out + i, lo);
+    _mm256_storeu_ps(out + i + 8, hi);
+  }
+  for (; i < len; i++) {
+    out[i] = static_cast<float>(in[i]);
+  }
+}
+
+} // namespace kernel
+} // namespace cpu
+} // namespace torch_ipex
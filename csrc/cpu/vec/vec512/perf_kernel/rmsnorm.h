@@ -158,6 +158,103 @@ void _add_back_and_compute_rmsnorm(
     _mask_storeu(out_ptr + i, vec_res, mask);
   }
 }
+
+// Quantize `size` elements with a scale (and zero point) computed from their
+// own range: int8 symmetric if TQ is int8_t, uint8 asymmetric if TQ is
+// uint8_t. The range always includes zero, like the qparams computed by
+// `compute_int8_qparams_per_block` for the WOQ int8 GEMM.
+template <typename T, typename TQ>
+void _dynamic_quantize_block(
+    const T* a_ptr,
+    const int& size,
+    TQ* out_ptr,
+    float* scale_ptr,
+    int32_t* zp_ptr) {
+  constexpr bool is_sym_quant = std::is_same<TQ, int8_t>::value;
+  auto vec_min = _mm512_setzero_ps();
+  auto vec_max = _mm512_setzero_ps();
+  int i;
+  for (i = 0; i <= size - 16; i += 16) {
+    auto vec_a = _loadu(a_ptr + i);
+    vec_min = _mm512_min_ps(vec_min, vec_a);
+    vec_max = _mm512_max_ps(vec_max, vec_a);
+  }
+  if (i < size) {
+    __mmask16 mask = (1 << (size - i)) - 1;
+    // masked out lanes are zero, which is in the range anyway
+    auto vec_a = _maskz_loadu(a_ptr + i, mask);
+    vec_min = _mm512_min_ps(vec_min, vec_a);
+    vec_max = _mm512_max_ps(vec_max, vec_a);
+  }
+  float min_val = _mm512_reduce_min_ps(vec_min);
+  float max_val = _mm512_reduce_max_ps(vec_max);
+  float scale = is_sym_quant
+      ? std::max(std::fabs(max_val), std::fabs(min_val)) / 127.0f
+      : (max_val - min_val) / 255.0f;
+  // an all-zero block quantizes to the zero point with any scale
+  if (scale == 0.0f) {
+    scale = 1.0f;
+  }
+  int32_t zp = is_sym_quant ? 0 : (int32_t)(-std::nearbyint(min_val / scale));
+  *scale_ptr = scale;
+  if (zp_ptr) {
+    *zp_ptr = zp;
+  }
+  auto vec_scale = _mm512_set1_ps(scale);
+  auto vec_zp = _mm512_set1_ps((float)zp);
+  auto vec_qmin = _mm512_set1_ps(is_sym_quant ? -128.0f : 0.0f);
+  auto vec_qmax = _mm512_set1_ps(is_sym_quant ? 127.0f : 255.0f);
+  auto quantize = [&](__m512 vec_a) {
+    auto vec_q = _mm512_roundscale_ps(
+        _mm512_div_ps(vec_a, vec_scale),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    vec_q = _mm512_add_ps(vec_q, vec_zp);
+    vec_q = _mm512_min_ps(_mm512_max_ps(vec_q, vec_qmin), vec_qmax);
+    return _mm512_cvtps_epi32(vec_q);
+  };
+  auto store = [&](TQ* ptr, __m512i vec_q, __mmask16 mask) {
+    if constexpr (is_sym_quant) {
+      _mm512_mask_cvtsepi32_storeu_epi8(ptr, mask, vec_q);
+    } else {
+      _mm512_mask_cvtusepi32_storeu_epi8(ptr, mask, vec_q);
+    }
+  };
+  for (i = 0; i <= size - 16; i += 16) {
+    store(out_ptr + i, quantize(_loadu(a_ptr + i)), 0xffff);
+  }
+  if (i < size) {
+    __mmask16 mask = (1 << (size - i)) - 1;
+    store(out_ptr + i, quantize(_maskz_loadu(a_ptr + i, mask)), mask);
+  }
+}
+
+// RMSNorm followed by dynamic quantization of the normalized row in blocks
+// of `block_k` elements (block_k == size for per-row quantization).
+// The normalized row is staged in `buf_ptr` (`size` elements of T), so it is
+// rounded to T exactly like the output of `_compute_rmsnorm`, while it stays
+// in cache instead of making another trip through memory.
+template <typename T, typename T1, typename TQ>
+void _compute_rmsnorm_and_quantize(
+    const T* a_ptr,
+    const int& size,
+    float eps,
+    const T1* gamma_ptr,
+    const int& block_k,
+    T* buf_ptr,
+    TQ* out_ptr,
+    float* scale_ptr,
+    int32_t* zp_ptr) {
+  _compute_rmsnorm<T, T1>(a_ptr, size, eps, gamma_ptr, buf_ptr);
+  for (int k = 0, b = 0; k < size; k += block_k, b++) {
+    int len = std::min(block_k, size - k);
+    _dynamic_quantize_block<T, TQ>(
+        buf_ptr + k,
+        len,
+        out_ptr + k,
+        scale_ptr + b,
+        zp_ptr ? zp_ptr + b : nullptr);
+  }
+}
 } // namespace kernel
 } // namespace cpu
 } // namespace torch_ipex
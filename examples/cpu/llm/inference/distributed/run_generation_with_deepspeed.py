@@ -223,10 +223,13 @@ parser.add_argument(
     choices=[
         "auto",
         "fp8_e5m2",
+        "fp8_e4m3",
+        "int8",
     ],
     default="auto",
     help='Data type for kv cache storage. If "auto", will use model '
-    "data type. fp8 type now supports e5m2.",
+    "data type. fp8 type now supports e5m2. fp8_e4m3 and int8 keep a "
+    "per-token scale and are supported by the DeepSeek latent cache.",
 )
 parser.add_argument(
     "--low-precision-checkpoint",
@@ -419,6 +422,10 @@ if args.kv_cache_dtype == "auto":
     kv_cache_dtype = None
 elif args.kv_cache_dtype == "fp8_e5m2":
     kv_cache_dtype = torch.float8_e5m2
+elif args.kv_cache_dtype == "fp8_e4m3":
+    kv_cache_dtype = torch.float8_e4m3fn
+elif args.kv_cache_dtype == "int8":
+    kv_cache_dtype = torch.int8
 config.kv_cache_dtype = kv_cache_dtype
 
 config.use_cache = True  # For inference, it should always be True
@@ -316,10 +316,13 @@ def main(args_in: Optional[List[str]] = None) -> None:
         choices=[
             "auto",
             "fp8_e5m2",
+            "fp8_e4m3",
+            "int8",
         ],
         default="auto",
         help='Data type for kv cache storage. If "auto", will use model '
-        "data type. fp8 type now supports e5m2.",
+        "data type. fp8 type now supports e5m2. fp8_e4m3 and int8 keep a "
+        "per-token scale and are supported by the DeepSeek latent cache.",
     )
     parser.add_argument(
         "--verbose",
@@ -462,6 +462,23 @@ def meta_ROIAlign_forward(
     ).to(memory_format=torch._prims_common.suggest_memory_format(input))
 
 
+@register_meta("ROIAlign_linear_forward")
+def meta_ROIAlign_linear_forward(
+    input,
+    rois,
+    spatial_scale,
+    pooled_height,
+    pooled_width,
+    sampling_ratio,
+    aligned,
+    weight,
+    bias,
+    fuse_relu,
+    packed_weight=None,
+):
+    return input.new_empty((rois.shape[0], weight.shape[0]))
+
+
 @register_meta("ROIAlign_backward")
 def meta_ROIAlign_backward(
     grad,
@@ -650,6 +667,19 @@ def meta_tpp_linear_mul(
     return input.new_empty((*input.shape[:-1], out_features))
 
 
+@register_meta("tpp_linear_topk")
+def meta_tpp_linear_topk(
+    input,
+    weight,
+    k,
+    out_features,
+):
+    return (
+        input.new_empty((*input.shape[:-1], k)),
+        input.new_empty((*input.shape[:-1], k), dtype=torch.long),
+    )
+
+
 @register_meta("tpp_fused_gate_up_proj")
 def meta_tpp_fused_gate_up_proj(
     t_in,
@@ -753,6 +783,25 @@ def meta_rotary_position_embedding(
         )
 
 
+@register_meta("rotary_position_embedding_cache")
+def meta_rotary_position_embedding_cache(
+    t_in,
+    t_emb_pos,
+    t_pos,
+    N,
+    H,
+    offset,
+    rotary_ndims,
+    key_cache,
+    value_cache,
+    slot_mapping,
+    kv_cache_dtype,
+    k_scale,
+    v_scale,
+):
+    return t_in.new_empty((*t_in.shape[:-1], N, H))
+
+
 @register_meta("rmsnorm")
 def meta_rmsnorm(
     input,
@@ -762,6 +811,28 @@ def meta_rmsnorm(
     return input.new_empty(input.shape)
 
 
+@register_meta("rmsnorm_dynamic_quant")
+def meta_rmsnorm_dynamic_quant(
+    input,
+    weight,
+    eps,
+    quant_a_mode,
+    quant_block_k,
+):
+    # quant_a_mode: 2/6 per M, 3/7 per M x K block, sym if >= 4
+    is_sym = quant_a_mode >= 4
+    K = input.shape[-1]
+    M = input.numel() // K if K > 0 else 0
+    if quant_a_mode in [2, 6]:
+        scale_shape = [M]
+    else:
+        scale_shape = [M, (K + quant_block_k - 1) // quant_block_k]
+    out = input.new_empty(input.shape, dtype=torch.int8 if is_sym else torch.uint8)
+    scale = input.new_empty(scale_shape, dtype=torch.float)
+    zp = None if is_sym else input.new_empty(scale_shape, dtype=torch.int32)
+    return (out, scale, zp)
+
+
 @register_meta("punica_bgmv_shrink")
 def meta_bgmv_shrink(
     out,
@@ -797,6 +868,21 @@ def meta_bgmv_expand_slice(
     return out.new_empty(out.shape)
 
 
+@register_meta("punica_bgmv_shrink_expand_slice")
+def meta_bgmv_shrink_expand_slice(
+    out,
+    input,
+    lora_a_weights,
+    lora_b_weights,
+    indicies,
+    scale,
+    slice_offset,
+    slice_size,
+    add_inputs,
+):
+    return out.new_empty(out.shape)
+
+
 @register_meta("punica_sgmv_shrink")
 def meta_sgmv_shrink(
     out,
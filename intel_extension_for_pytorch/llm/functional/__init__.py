@@ -13,5 +13,6 @@ from .fusions import (
     bgmv_expand,
     sgmv_expand,
     bgmv_expand_slice,
+    bgmv_shrink_expand_slice,
     sgmv_expand_slice,
 )
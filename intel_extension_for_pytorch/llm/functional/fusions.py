@@ -417,6 +417,50 @@ def bgmv_expand_slice(
     )
 
 
+def bgmv_shrink_expand_slice(
+    input: torch.Tensor,
+    lora_a_weights: torch.Tensor,
+    lora_b_weights: torch.Tensor,
+    output: torch.Tensor,
+    token_lora_mapping: torch.Tensor,
+    scaling: float,
+    slice_offset: int,
+    slice_size: int,
+    add_inputs: bool,
+):
+    r"""
+    Applies bgmv_shrink followed by bgmv_expand_slice in one call, without
+    materializing the [batchsize, max_rank] intermediate.
+    Args:
+        input (torch.Tensor): The input tensor with shape of
+            [batchsize, input_size1] which input_size1 >= hidden_size.
+        lora_a_weights (torch.Tensor): LoRA A weights tensor with shape of
+            [num_lora, max_rank, hidden_size].
+        lora_b_weights (torch.Tensor): LoRA B weights tensor with shape of
+            [num_lora, slice_size, max_rank].
+        output (torch.Tensor): The output tensor with shape of [batchsize, output_size1]
+            which output_size1 >= slice_offset + slice_size
+        token_lora_mapping (torch.Tensor): The tensor mapping each input token to
+            the lora-id related to that token with shape of [batchsize].
+        scaling (float): Scaling factor applied to the shrink result.
+        slice_offset (int): Slice offset start for output.
+        slice_size (int): Slice length for output.
+        add_inputs (bool): Whether to add to the output tensor.
+    """
+    f = _get_function_from_device(input.device.type, bgmv_shrink_expand_slice)
+    return f(
+        input,
+        lora_a_weights,
+        lora_b_weights,
+        output,
+        token_lora_mapping,
+        scaling,
+        slice_offset,
+        slice_size,
+        add_inputs,
+    )
+
+
 def sgmv_shrink(
     inputs: torch.Tensor,
     lora_a_weights: torch.Tensor,
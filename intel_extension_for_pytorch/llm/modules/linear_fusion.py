@@ -323,6 +323,56 @@ class LinearMul(IPEXLinearFusion):
         return self.linear_fusion(x, y)
 
 
+class LinearTopk(IPEXLinearFusion):
+    r"""
+    Applies a linear transformation to the `input` data, and then returns
+    the `k` largest elements of the result along the last dimension, e.g.
+    the next token candidates of greedy or beam search from the LM head:
+
+    .. highlight:: python
+    .. code-block:: python
+
+        values, indices = torch.topk(linear(input), k, dim=-1)
+
+    With TPP weights and no bias, the top `k` are selected while the output
+    is computed and the full output is never materialized. Other linear
+    modules, e.g. weight only quantized ones, fall back to the expression
+    above.
+
+    This module is opt-in: `ipex.llm.optimize` and the generation loops
+    (greedy and beam search) keep computing the full logits with the LM
+    head, since logits processors and the beam search scores need the
+    whole vocabulary. Use it in customized models whose decoding only needs
+    the top `k` candidates of the LM head, e.g. plain greedy search.
+
+    Args:
+        linear (torch.nn.Linear module) : the original torch.nn.Linear
+            module to be fused with topk.
+
+    Shape:
+        Input shape is the same as torch.nn.Linear, `values` and `indices`
+        have the shape of the output with the last dimension being `k`.
+
+    Examples:
+        >>> # module init:
+        >>> linear_module = torch.nn.Linear(4096, 32000, bias=False)
+        >>> ipex_fusion = ipex.llm.modules.LinearTopk(linear_module)
+        >>> # module forward:
+        >>> input = torch.randn(4, 4096)
+        >>> values, indices = ipex_fusion(input, 4)
+
+    """
+
+    def __init__(self, linear):
+        super().__init__(linear)
+
+    def forward(self, x, k):
+        if self.device_type != x.device.type:
+            self.init_on_device(x, IPEXCustomOpType.LINEAR_TOPK)
+
+        return self.linear_fusion(x, k)
+
+
 class LinearAdd(IPEXLinearFusion):
     r"""
     Applies a linear transformation to the `input` data,
@@ -813,6 +813,22 @@ class IndirectAccessKVCacheAttention(nn.Module):
 
     The parameters of `apply_function()` are the same as the `forward()` call.
 
+    [Speculative decoding] Up to 16 draft tokens can be verified in one `forward()` call
+    with seq_len > 1, every query token attends to the past tokens and to the draft tokens
+    up to itself. The rejected draft tokens are dropped with `.rollback_cache`, which only
+    shortens the seq_info of layer_past so their cache entries get overwritten by the next
+    step, nothing is copied.
+
+    .. highlight:: python
+    .. code-block:: python
+
+        past_key_values = tuple(
+            ipex.llm.modules.IndirectAccessKVCacheAttention.rollback_cache(
+                layer_past, num_rejected_tokens
+            )
+            for layer_past in past_key_values
+        )
+
     """
 
     runtime_ops: IPEXRuntimeCustomOps = IPEXRuntimeCustomOps()
@@ -821,6 +837,22 @@ class IndirectAccessKVCacheAttention(nn.Module):
         super().__init__()
         self.text_max_length = text_max_length
 
+    @classmethod
+    def rollback_cache(
+        cls,
+        layer_past: Tuple[torch.Tensor],
+        num_tokens: int,
+    ):
+        # layer_past: tuple(seq_info, key_cache, value_cache, beam-idx)
+        # num_tokens: number of the latest tokens to be dropped from the cache
+        # Return: layer_past without the latest num_tokens tokens
+        seq_len = layer_past[0].size(-2)
+        assert 0 <= num_tokens <= seq_len, "can not drop more tokens than cached"
+        seq_len = seq_len - num_tokens
+        # only the shape of seq_info is used, expand to avoid allocating it
+        seq_info = layer_past[0].new_empty(1, 1, 1, 1).expand(1, seq_len, seq_len, 1)
+        return (seq_info,) + tuple(layer_past[1:])
+
     @classmethod
     def apply_function(
         cls,
@@ -984,6 +1016,45 @@ class MambaMixer:
         dt_bias (torch.Tensor): delta time bias tensor, shape: [dim] or [nheads, dim].
         dt_softplus (bool): whether to apply softplus to delta time.
 
+    [class method]: causal_conv1d_selective_state_update
+
+    .. highlight:: python
+    .. code-block:: python
+
+        ipex.llm.modules.MambaMixer.causal_conv1d_selective_state_update(
+            xBC,
+            conv_state,
+            conv_weight,
+            conv_bias,
+            state,
+            dt,
+            A,
+            ngroups,
+            D=None,
+            z=None,
+            dt_bias=None,
+            dt_softplus=False
+        )
+
+    Mamba2 decode step: causal_conv1d_update with SiLU over the x, B and C channels
+    followed by selective_state_update, in one kernel. Head h uses the B/C group
+    h // (nheads // ngroups).
+
+    Args:
+        xBC (torch.Tensor): x, B and C of the new token before the convolution,
+            shape: [batch, nheads * dim + 2 * ngroups * dstate].
+        conv_state (torch.Tensor): convolution state tensor, shape: [batch, conv_dim, state_len], updated in place.
+        conv_weight (torch.Tensor): weight tensor of conv1d, shape: [conv_dim, width].
+        conv_bias (torch.Tensor): bias tensor of conv1d, shape: [conv_dim].
+        state (torch.Tensor): state tensor, shape: [batch, nheads, dim, dstate], updated in place.
+        dt (torch.Tensor): delta time tensor, shape: [batch, nheads, dim].
+        A (torch.Tensor): A tensor, shape: [nheads, dim, dstate].
+        ngroups (int): number of B/C groups.
+        D (torch.Tensor): D tensor, shape: [nheads, dim].
+        z (torch.Tensor): z tensor, shape: [batch, nheads, dim].
+        dt_bias (torch.Tensor): delta time bias tensor, shape: [nheads, dim].
+        dt_softplus (bool): whether to apply softplus to delta time.
+
     [class method]: selective_scan_fn
 
     .. highlight:: python
@@ -1057,6 +1128,39 @@ class MambaMixer:
             x.device.type, IPEXCustomOpType.MAMBA_MIXER, False
         ).selective_state_update(state, x, dt, A, B, C, D, z, dt_bias, dt_softplus)
 
+    @classmethod
+    def causal_conv1d_selective_state_update(
+        cls,
+        xBC,
+        conv_state,
+        conv_weight,
+        conv_bias,
+        state,
+        dt,
+        A,
+        ngroups,
+        D=None,
+        z=None,
+        dt_bias=None,
+        dt_softplus=False,
+    ):
+        return cls.runtime_ops.get_module_from_device(
+            xBC.device.type, IPEXCustomOpType.MAMBA_MIXER, False
+        ).causal_conv1d_selective_state_update(
+            xBC,
+            conv_state,
+            conv_weight,
+            conv_bias,
+            state,
+            dt,
+            A,
+            ngroups,
+            D,
+            z,
+            dt_bias,
+            dt_softplus,
+        )
+
     @classmethod
     def selective_scan_fn(
         cls,
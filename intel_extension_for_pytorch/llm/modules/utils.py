@@ -6,6 +6,7 @@ from intel_extension_for_pytorch.transformers.models.cpu.fusions.linear_fusion i
     _IPEXlinearReluCPU,
     _IPEXlinearGeluCPU,
     _IPEXlinearMulCPU,
+    _IPEXlinearTopkCPU,
     _IPEXlinearSiluCPU,
     _IPEXlinearSiluMulCPU,
     _IPEXlinearSiluAndMulCPU,
@@ -41,6 +42,7 @@ class IPEXCustomOpType(Enum):
     INDIRECTACCESS_KVCACHE_ATTENTION: int = 14
     LINEAR_MOE: int = 15
     MAMBA_MIXER: int = 16
+    LINEAR_TOPK: int = 17
 
 
 CPU_fusion_modules = {
@@ -59,6 +61,7 @@ CPU_fusion_modules = {
     IPEXCustomOpType.LINEAR_ADD: _IPEXlinearAddCPU,
     IPEXCustomOpType.LINEAR_ADD_ADD: _IPEXlinearAddAddCPU,
     IPEXCustomOpType.LINEAR_MUL: _IPEXlinearMulCPU,
+    IPEXCustomOpType.LINEAR_TOPK: _IPEXlinearTopkCPU,
     IPEXCustomOpType.LINEAR_MOE: _IPEXGatedMLPMOECPU,
     IPEXCustomOpType.MAMBA_MIXER: _IPEXMambaMixerCPU,
 }
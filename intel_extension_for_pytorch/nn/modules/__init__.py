@@ -10,4 +10,6 @@ from .weight_only_quantization import (
     WeightOnlyQuantizedLinear,
     IpexWoqLinearAllreduce,
     WoqWeightFormat,
+    save_woq_packed_weights,
+    load_woq_packed_weights,
 )
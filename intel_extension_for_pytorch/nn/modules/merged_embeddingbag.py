@@ -58,6 +58,24 @@ def merged_embeddingbag_with_cat(
     )
 
 
+def merged_embeddingbag_with_cat_interaction_linear(
+    weights,
+    indices,
+    offsets,
+    dense_feature,
+    mlp_weight,
+    mlp_bias,
+    fuse_relu,
+):
+    if torch.is_grad_enabled():
+        raise NotImplementedError(
+            "do not support training for merged_embeddingbag_with_cat_interaction_linear"
+        )
+    return torch.ops.torch_ipex.merged_embeddingbag_cat_interaction_linear_forward(
+        weights, indices, offsets, dense_feature, mlp_weight, mlp_bias, fuse_relu
+    )
+
+
 def merged_embeddingbag_sgd(
     weights, indices, offsets, pooling_mode, include_last_offset, sgd_args
 ):
@@ -635,6 +653,31 @@ class MergedEmbeddingBagWithCat(MergedEmbeddingBag):
         embedding_specs: List[EmbeddingSpec],
     ):
         super(MergedEmbeddingBagWithCat, self).__init__(embedding_specs)
+        self._mlp_cache = None
+
+    def _get_mlp_params(self, mlp_weight, mlp_bias, dtype):
+        # the top MLP weight is usually kept in another dtype than the
+        # tables, convert it once instead of on every call; in-place updates
+        # bump the version of the weight and invalidate the cache
+        version = (
+            mlp_weight._version,
+            mlp_bias._version if mlp_bias is not None else None,
+        )
+        cache = self._mlp_cache
+        if (
+            cache is None
+            or cache[0] is not mlp_weight
+            or cache[1] is not mlp_bias
+            or cache[2] != version
+            or cache[3] != dtype
+        ):
+            weight = mlp_weight.detach().to(dtype).contiguous()
+            bias = None
+            if mlp_bias is not None:
+                bias = mlp_bias.detach().to(dtype).contiguous()
+            cache = (mlp_weight, mlp_bias, version, dtype, weight, bias)
+            self._mlp_cache = cache
+        return cache[4], cache[5]
 
     def forward(self, indices, offsets, dense_feature):
         r"""
@@ -652,15 +695,86 @@ class MergedEmbeddingBagWithCat(MergedEmbeddingBag):
             dense_feature,
         )
 
+    def forward_interaction_linear(
+        self,
+        indices,
+        offsets,
+        dense_feature,
+        mlp_weight,
+        mlp_bias=None,
+        fuse_relu=False,
+    ):
+        r"""
+        Inference only. Fuse the "dot" interaction (see
+        `ipex.nn.functional.interaction`) and the first layer of the top MLP
+        after the embedding lookup + cat. Native usage is:
+
+            >>> cat_out = merged_emb(indices, offsets, dense_feature)
+            >>> feats = cat_out.view(batch_size, -1, emb_dim).unbind(1)
+            >>> out = ipex.nn.functional.interaction(*feats)
+            >>> out = torch.relu(torch.nn.functional.linear(out, mlp_weight, mlp_bias))
+
+        The optimized path never writes the cat output and the interaction
+        output to memory:
+
+            >>> out = merged_emb.forward_interaction_linear(
+            >>>     indices, offsets, dense_feature, mlp_weight, mlp_bias, fuse_relu=True)
+
+        Args:
+            indices (Tensor): a list of indices for all tables
+            offsets (Tensor): a list of offsets for all tables
+            dense_feature (Tensor): dense feature to be cat
+            mlp_weight (Tensor): weight of the first top MLP layer with shape
+                `(out_features, emb_dim + (num_tables + 1) * num_tables / 2)`
+            mlp_bias (Tensor, optional): bias of the first top MLP layer
+            fuse_relu (bool): whether to apply relu on the output
+        Returns:
+            output shape of `(batch_size, out_features)`.
+        """
+        mlp_weight, mlp_bias = self._get_mlp_params(
+            mlp_weight, mlp_bias, dense_feature.dtype
+        )
+        return merged_embeddingbag_with_cat_interaction_linear(
+            self.weights,
+            indices,
+            offsets,
+            dense_feature,
+            mlp_weight,
+            mlp_bias,
+            fuse_relu,
+        )
+
 
 import torch.distributed as dist
 
 
-def sparse_all2all(
+class CommBufferPool:
+    r"""
+    Keep the receive buffers of sparse all to all alive across iterations.
+    The received sizes change every iteration, a buffer is only re-allocated
+    when it is too small and a view of the first n rows is handed out.
+    """
+
+    def __init__(self):
+        self._buffers = {}
+
+    def get(self, key, n, shape, dtype):
+        buf = self._buffers.get(key)
+        if buf is None or buf.dtype != dtype or buf.shape[1:] != shape:
+            buf = None
+        if buf is None or buf.shape[0] < n:
+            buf = torch.empty((n,) + tuple(shape), dtype=dtype)
+            self._buffers[key] = buf
+        return buf[:n]
+
+
+def sparse_all2all_async(
     world_size: int,
     send_idx: List[torch.Tensor],
     send_buf: List[torch.Tensor],
     send_ofs: List[torch.Tensor],
+    buffer_pool: Optional[CommBufferPool] = None,
+    buffer_key=None,
 ):
     # the first thing to know is the recv tensor sizes
     # this requires an all to all
@@ -669,25 +783,60 @@ def sparse_all2all(
         is_buffers[i][0] = send_idx[i].shape[0]
     os_buffers = [torch.empty(1, dtype=torch.int64) for _ in range(world_size)]
     dist.all_to_all(os_buffers, is_buffers)
-    dist.barrier()
 
-    # init received buffers sizes
+    # init received buffers sizes, all of them will be fully written by all to all
     index_type = send_idx[0].dtype
     val_type = send_buf[0].dtype
     emb_dim = send_buf[0].shape[1]
     ofs_size = send_ofs[0].shape[0]
-    recv_idx = [torch.zeros(os_buffers[i], dtype=index_type) for i in range(world_size)]
+    if buffer_pool is None:
+        buffer_pool = CommBufferPool()
+    recv_idx = [
+        buffer_pool.get((buffer_key, "idx", i), int(os_buffers[i]), (), index_type)
+        for i in range(world_size)
+    ]
     recv_buf = [
-        torch.zeros((os_buffers[i], emb_dim), dtype=val_type) for i in range(world_size)
+        buffer_pool.get(
+            (buffer_key, "val", i), int(os_buffers[i]), (emb_dim,), val_type
+        )
+        for i in range(world_size)
+    ]
+    recv_ofs = [
+        buffer_pool.get((buffer_key, "ofs", i), ofs_size, (), torch.int64)
+        for i in range(world_size)
     ]
-    recv_ofs = [torch.zeros((ofs_size,), dtype=torch.int64) for i in range(world_size)]
-    dist.all_to_all(recv_idx, send_idx)
-    dist.all_to_all(recv_buf, send_buf)
-    dist.all_to_all(recv_ofs, send_ofs)
+    works = [
+        dist.all_to_all(recv_idx, send_idx, async_op=True),
+        dist.all_to_all(recv_buf, send_buf, async_op=True),
+        dist.all_to_all(recv_ofs, send_ofs, async_op=True),
+    ]
+    return recv_idx, recv_buf, recv_ofs, works
+
+
+def sparse_all2all(
+    world_size: int,
+    send_idx: List[torch.Tensor],
+    send_buf: List[torch.Tensor],
+    send_ofs: List[torch.Tensor],
+):
+    recv_idx, recv_buf, recv_ofs, works = sparse_all2all_async(
+        world_size, send_idx, send_buf, send_ofs
+    )
+    for work in works:
+        work.wait()
     dist.barrier()
     return recv_idx, recv_buf, recv_ofs
 
 
+def split_table_groups(num_tables: int, num_groups: int):
+    num_groups = max(1, min(num_groups, num_tables))
+    group_size = (num_tables + num_groups - 1) // num_groups
+    return [
+        (begin, min(begin + group_size, num_tables))
+        for begin in range(0, num_tables, group_size)
+    ]
+
+
 class DistMergeEmbeddingBagFunc(Function):
     @staticmethod
     def forward(
@@ -700,6 +849,8 @@ class DistMergeEmbeddingBagFunc(Function):
         world_size: int,
         include_last_offsets: bool,
         adagrad_args: AdaGradArgs,
+        num_comm_groups: int = 1,
+        buffer_pool: Optional[CommBufferPool] = None,
     ):
         global_bs = offsets[0].size(0)
         if include_last_offsets:
@@ -715,20 +866,34 @@ class DistMergeEmbeddingBagFunc(Function):
         ctx.world_size = world_size
         num_emb = len(indices)
         emb_dim = weight.shape[1]
-        (
-            send_idx,
-            send_buf,
-            send_ofs,
-        ) = torch.ops.torch_ipex.mergedemb_distribute_forward_local(
-            weight, row_offset, indices, offsets, rank, world_size, include_last_offsets
-        )
-        recv_idx, recv_buf, recv_ofs = sparse_all2all(
-            world_size, send_idx, send_buf, send_ofs
-        )
+        # pipeline over table groups: the local lookup for group i + 1 runs
+        # while the all to all for group i is in flight
+        pending = []
+        for begin, end in split_table_groups(num_emb, num_comm_groups):
+            (
+                send_idx,
+                send_buf,
+                send_ofs,
+            ) = torch.ops.torch_ipex.mergedemb_distribute_forward_local(
+                weight,
+                row_offset[begin:end],
+                indices[begin:end],
+                offsets[begin:end],
+                rank,
+                world_size,
+                include_last_offsets,
+            )
+            recv = sparse_all2all_async(
+                world_size, send_idx, send_buf, send_ofs, buffer_pool, begin
+            )
+            pending.append((begin, end, recv))
         output = torch.empty((local_bs, num_emb, emb_dim), dtype=weight.dtype)
-        torch.ops.torch_ipex.mergedemb_distribute_forward_merge(
-            output, recv_idx, recv_buf, recv_ofs, num_emb
-        )
+        for begin, end, (recv_idx, recv_buf, recv_ofs, works) in pending:
+            for work in works:
+                work.wait()
+            torch.ops.torch_ipex.mergedemb_distribute_forward_merge(
+                output, recv_idx, recv_buf, recv_ofs, end - begin, begin
+            )
         return output
 
     @staticmethod
@@ -758,7 +923,7 @@ class DistMergeEmbeddingBagFunc(Function):
         torch.ops.torch_ipex.mergedemb_distribute_backward_merge_adagrad_update(
             recv_idx, recv_buf, recv_ofs, weight, trail[0], hessian[0], lr, eps
         )
-        return None, None, None, None, None, None, None, None
+        return None, None, None, None, None, None, None, None, None, None
 
 
 class DistMergeEmbeddingBagWithAdaGrad(MergedEmbeddingBagWithAdaGrad):
@@ -775,6 +940,11 @@ class DistMergeEmbeddingBagWithAdaGrad(MergedEmbeddingBagWithAdaGrad):
         >>> dist.init_process_group("ccl", world_size=world_size, rank=rank)
         >>> distributed_emb = DistMergeEmbeddingBagWithAdaGrad.from_embeddingbag_list(EmbLists)
         >>> out = distributed_emb(indices, offsets)
+
+    Set `num_comm_groups` > 1 to split the tables into groups and overlap the
+    local lookup of one group with the all to all of the previous group:
+
+        >>> distributed_emb.num_comm_groups = 4
     """
 
     def __init__(
@@ -782,8 +952,11 @@ class DistMergeEmbeddingBagWithAdaGrad(MergedEmbeddingBagWithAdaGrad):
         embedding_specs: List[EmbeddingSpec],
         lr: float = 0.01,
         eps: float = 1e-10,
+        num_comm_groups: int = 1,
     ):
         super(MergedEmbeddingBagWithAdaGrad, self).__init__(embedding_specs)
+        self.num_comm_groups = num_comm_groups
+        self._comm_buffer_pool = CommBufferPool()
         assert (
             self.pooling_mode == PoolingMode.SUM
         ), "only support SUM for DistMergeEmbeddingBagWithAdaGrad"
@@ -826,11 +999,14 @@ class DistMergeEmbeddingBagWithAdaGrad(MergedEmbeddingBagWithAdaGrad):
             self._size,
             self.include_last_offset,
             self.adagrad_args,
+            self.num_comm_groups,
+            self._comm_buffer_pool,
         )
         return out
 
     def extra_repr(self) -> str:
         s = ""
-        s += f"world_size: {self._size}, rank_id: {self._rank}\n"
+        s += f"world_size: {self._size}, rank_id: {self._rank}, "
+        s += f"num_comm_groups: {self.num_comm_groups}\n"
         s += super(DistMergeEmbeddingBagWithAdaGrad, self).extra_repr()
         return s
@@ -532,6 +532,78 @@ class WeightOnlyQuantizedLinear(nn.Module):
         )
         return qlinear
 
+    @classmethod
+    def from_packed(cls, path, name):
+        r"""Create a weight-only quantized module from a packed weight file
+        written by ``save_woq_packed_weights``. The packed weight is memory
+        mapped instead of being quantized and packed again.
+
+        Args:
+            path (str): path of the packed weight file
+            name (str): name of the layer in the file
+        """
+        op_context = torch.ops.ipex_prepack.woq_linear_load_packed(path, name)
+        out_features, in_features = op_context.get_weight_shape()
+        dtype, group_size, lowp_mode, act_quant_mode, cache_weight = (
+            op_context.get_config()
+        )
+        bias = op_context.get_bias()
+        qlinear = cls(in_features, out_features, bias is not None, dtype=dtype)
+        qlinear._op_context = op_context
+        qlinear.weight = op_context.get_weight()
+        qlinear._lowp_mode = lowp_mode
+        qlinear._act_quant_mode = act_quant_mode
+        qlinear._group_size = group_size
+        qlinear._cache_weight_for_large_batch = cache_weight
+        qlinear._weight_qscheme = (
+            WoqWeightQScheme.ASYMMETRIC
+            if op_context.get_zero_points() is not None
+            else WoqWeightQScheme.SYMMETRIC
+        )
+        return qlinear
+
+
+def save_woq_packed_weights(model, path):
+    r"""Save the packed weights of all weight-only quantized linear modules in
+    ``model`` to one file, keyed by their module names. Load them back with
+    ``load_woq_packed_weights`` to skip weight packing at startup.
+    """
+    names, handles = [], []
+    for name, m in model.named_modules():
+        if isinstance(m, WeightOnlyQuantizedLinear) and m._op_context is not None:
+            names.append(name)
+            handles.append(m._op_context.get_data_handle())
+    torch.ops.ipex_prepack.woq_linear_save_packed(path, names, handles)
+
+
+def load_woq_packed_weights(model, path):
+    r"""Build the weight-only quantized linear modules of ``model`` from the
+    packed weights memory mapped from ``path``. ``model`` may be the float
+    model, the prepared one or an already converted one, as long as it has
+    the same structure as the one that was saved. The layers stored in the
+    file replace the modules of the same names.
+    """
+    for name in torch.ops.ipex_prepack.woq_linear_packed_names(path):
+        parent_name, _, attr = name.rpartition(".")
+        parent = model.get_submodule(parent_name)
+        m = getattr(parent, attr)
+        if isinstance(m, WeightOnlyQuantizedLinear) and m._op_context is not None:
+            # keep converted modules, e.g. the allreduce ones, and only swap
+            # their packed weights
+            m._op_context = torch.ops.ipex_prepack.woq_linear_load_packed(path, name)
+            m.weight = m._op_context.get_weight()
+            continue
+        assert isinstance(
+            m, nn.Linear
+        ), f"load_woq_packed_weights: {name} is {type(m).__name__}, not a Linear"
+        qlinear = WeightOnlyQuantizedLinear.from_packed(path, name)
+        assert (qlinear.in_features, qlinear.out_features) == (
+            m.in_features,
+            m.out_features,
+        ), f"load_woq_packed_weights: shape mismatch of {name}"
+        setattr(parent, attr, qlinear)
+    return model
+
 
 class IpexWoqLinearAllreduce(WeightOnlyQuantizedLinear):
     def __init__(
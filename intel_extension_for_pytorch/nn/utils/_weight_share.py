@@ -0,0 +1,40 @@
+import torch
+
+
+def share_prepacked_weights(model, prefix):
+    r"""
+    Move the prepacked weights of the linear layers in ``model`` into named
+    POSIX shared memory, so that several processes running the same model on
+    one host, e.g. one instance per ``CPUPool``, keep a single read-only copy
+    of the weights instead of one copy each.
+
+    The first process calling it with a given ``prefix`` packs the weights
+    into shared memory, the others attach to them. The shared memory is
+    released when the last process using it releases its model. Only the
+    prepacked linear layers (oneDNN, MKL and weight-only quantized) are
+    shared, and the shared weights can not be updated in place afterwards,
+    so it is meant for inference.
+
+    Args:
+        model (torch.nn.Module): a model optimized by ``ipex.optimize`` or
+            ``ipex.llm.optimize``.
+        prefix (str): a key identifying the model, shared by all the
+            processes that should share the weights.
+    """
+    from ._weight_prepack import _IPEXLinear
+    from ..modules.weight_only_quantization import WeightOnlyQuantizedLinear
+
+    for name, m in model.named_modules():
+        key = "{}.{}".format(prefix, name)
+        if isinstance(m, _IPEXLinear) and getattr(m, "ctx", None) is not None:
+            m.ctx.share_weight(key)
+            if m.use_dnnl:
+                # drop the reference to the private copy of the packed weight
+                with torch.no_grad():
+                    m.weight.data = m.ctx.get_weight()
+        elif (
+            isinstance(m, WeightOnlyQuantizedLinear) and m._op_context is not None
+        ):
+            m._op_context.share_weight(key)
+            m.weight = m._op_context.get_weight()
+    return model
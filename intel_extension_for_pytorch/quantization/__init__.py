@@ -13,6 +13,7 @@ from ._qconfig import (
     WoqWeightQScheme,
 )
 from ._autotune import autotune
+from ._warmup import save_warmup_inputs, warmup
 from ._quantize_utils import (
     quantize_per_channel,
     dequantize_per_channel,
@@ -149,6 +149,8 @@ class WoqWeightDtype(IntEnum):
     INT4 = 2
     NF4 = 3
     FP8 = 4
+    INT2 = 5
+    INT3 = 6
 
 
 WOQ_DTYPE_TO_STR = {
@@ -156,6 +158,8 @@ WOQ_DTYPE_TO_STR = {
     WoqWeightDtype.INT4: "int4",
     WoqWeightDtype.NF4: "nf4",
     WoqWeightDtype.FP8: "fp8",
+    WoqWeightDtype.INT2: "int2",
+    WoqWeightDtype.INT3: "int3",
 }
 
 
@@ -857,6 +857,49 @@ def is_4bit(dtype):
     return dtype in (WoqWeightDtype.INT4, WoqWeightDtype.NF4)
 
 
+def is_lowbit(dtype):
+    return dtype in (WoqWeightDtype.INT2, WoqWeightDtype.INT3)
+
+
+def is_sub_byte_int(dtype):
+    return dtype == WoqWeightDtype.INT4 or is_lowbit(dtype)
+
+
+def get_weight_bits(dtype):
+    if dtype == WoqWeightDtype.INT2:
+        return 2
+    if dtype == WoqWeightDtype.INT3:
+        return 3
+    return 4 if is_4bit(dtype) else 8
+
+
+def pack_lowbit(qt, dtype):
+    r"""
+    Pack INT2/INT3 values in uint8 along input channel.
+    INT2 packs 4 values per byte, value k at bits 2 * (k % 4).
+    INT3 keeps 1 value per byte. The kernel repacks it to bit planes.
+    """
+    if dtype == WoqWeightDtype.INT2:
+        if qt.size(-1) % 4:
+            qt = torch.nn.functional.pad(qt, (0, 4 - qt.size(-1) % 4), value=0)
+        packed = qt[:, ::4].clone()
+        for i in range(1, 4):
+            packed.bitwise_or_(qt[:, i::4].bitwise_left_shift(2 * i))
+        return packed
+    return qt
+
+
+def unpack_lowbit(qt, dtype):
+    if dtype == WoqWeightDtype.INT2:
+        t = torch.empty(
+            qt.shape[0], qt.shape[1] * 4, dtype=torch.uint8, device=qt.device
+        )
+        for i in range(4):
+            t[:, i::4] = qt.bitwise_right_shift(2 * i).bitwise_and(0x3)
+        return t
+    return qt
+
+
 def is_sym_quant(dtype):
     return dtype in (WoqWeightDtype.NF4,)
 
@@ -883,7 +926,13 @@ def quantize_per_channel(
         - Zero points
     """
     assert t.ndim == 2
-    assert dtype in (WoqWeightDtype.INT8, WoqWeightDtype.INT4, WoqWeightDtype.NF4)
+    assert dtype in (
+        WoqWeightDtype.INT8,
+        WoqWeightDtype.INT4,
+        WoqWeightDtype.NF4,
+        WoqWeightDtype.INT2,
+        WoqWeightDtype.INT3,
+    )
     assert not (
         dtype == WoqWeightDtype.NF4 and not sym_quant
     ), "NF4 must be symmetric quant"
@@ -905,12 +954,13 @@ def quantize_per_channel(
                 scales = torch.max(scales, eps)
                 zps = -torch.round(mins / scales)
                 zps -= 128
-        elif dtype == WoqWeightDtype.INT4:
+        elif is_sub_byte_int(dtype):
+            qmax = 2 ** get_weight_bits(dtype) - 1
             if sym_quant:
-                scales = torch.maximum(torch.abs(maxs), torch.abs(mins)) / 7
+                scales = torch.maximum(torch.abs(maxs), torch.abs(mins)) / (qmax // 2)
                 scales = torch.max(scales, eps)
             else:
-                scales = (maxs - mins) / 15
+                scales = (maxs - mins) / qmax
                 scales = torch.max(scales, eps)
                 zps = -torch.round(mins / scales)
         else:  # NF4
@@ -928,12 +978,13 @@ def quantize_per_channel(
             min=qmin,
             max=qmax,
         ).to(torch.int8)
-    elif dtype == WoqWeightDtype.INT4:
+    elif is_sub_byte_int(dtype):
         qmin = 0
-        qmax = 15
-        # for sym_quant, shift to 0-15 for storage
+        qmax = 2 ** get_weight_bits(dtype) - 1
+        # for sym_quant, shift to [0, qmax] for storage, e.g., 0-15 for INT4
         qt = torch.clamp(
-            torch.round(t * inv_scales) + (zps.unsqueeze(1) if not sym_quant else 8),
+            torch.round(t * inv_scales)
+            + (zps.unsqueeze(1) if not sym_quant else (qmax + 1) // 2),
             min=qmin,
             max=qmax,
         ).to(torch.uint8)
@@ -943,6 +994,8 @@ def quantize_per_channel(
         if qt.size(-1) % 2:
             qt = torch.nn.functional.pad(qt, (0, 1), value=0)
         qt = qt[:, 1::2].bitwise_left_shift(4).bitwise_or_(qt[:, ::2].bitwise_and(0xF))
+    elif is_lowbit(dtype):
+        qt = pack_lowbit(qt, dtype)
     return qt.contiguous(), scales, zps
 
 
@@ -972,14 +1025,20 @@ def dequantize_per_channel(
         The dequantized tensor
     """
     assert qt.ndim == 2
-    assert dtype in (WoqWeightDtype.INT8, WoqWeightDtype.INT4, WoqWeightDtype.NF4)
+    assert dtype in (
+        WoqWeightDtype.INT8,
+        WoqWeightDtype.INT4,
+        WoqWeightDtype.NF4,
+        WoqWeightDtype.INT2,
+        WoqWeightDtype.INT3,
+    )
     scales = scales.squeeze()
     sym_quant = zps is None
     if sym_quant:
         zps = torch.zeros_like(scales)
-        if dtype == WoqWeightDtype.INT4:
-            # shift from [0, 15] to [-8, 7]
-            zps += 8
+        if is_sub_byte_int(dtype):
+            # e.g., shift from [0, 15] to [-8, 7] for INT4
+            zps += 2 ** (get_weight_bits(dtype) - 1)
     else:
         zps = zps.squeeze()
     if dtype == WoqWeightDtype.INT8:
@@ -994,6 +1053,12 @@ def dequantize_per_channel(
         if weight_shape is not None:
             t = t[: weight_shape[0], : weight_shape[1]].contiguous()
         return t
+    elif is_lowbit(dtype):
+        t = unpack_lowbit(qt, dtype)
+        t = (t.to(torch.float) - zps.unsqueeze(-1)) * scales.unsqueeze(-1)
+        if weight_shape is not None:
+            t = t[: weight_shape[0], : weight_shape[1]].contiguous()
+        return t
     else:  # NF4
         t = torch.empty(
             qt.shape[0], qt.shape[1] * 2, dtype=torch.uint8, device=qt.device
@@ -1041,7 +1106,13 @@ def quantize_per_block(
         input.dim() == 2
     ), f"{__name__}: Expect input has 2 dimensions but got {input.dim()}"
     assert group_size > 0, f"{__name__}: Expect group_size > 0 but got {group_size}"
-    assert dtype in (WoqWeightDtype.INT8, WoqWeightDtype.INT4, WoqWeightDtype.NF4)
+    assert dtype in (
+        WoqWeightDtype.INT8,
+        WoqWeightDtype.INT4,
+        WoqWeightDtype.NF4,
+        WoqWeightDtype.INT2,
+        WoqWeightDtype.INT3,
+    )
     assert not (
         dtype == WoqWeightDtype.NF4 and not sym_quant
     ), "NF4 must be symmetric quant"
@@ -1067,12 +1138,13 @@ def quantize_per_block(
                 scales = torch.max(scales, eps)
                 zps = -torch.round(mins / scales)
                 zps -= 128
-        elif dtype == WoqWeightDtype.INT4:
+        elif is_sub_byte_int(dtype):
+            qmax = 2 ** get_weight_bits(dtype) - 1
             if sym_quant:
-                scales = torch.maximum(torch.abs(maxs), torch.abs(mins)) / 7
+                scales = torch.maximum(torch.abs(maxs), torch.abs(mins)) / (qmax // 2)
                 scales = torch.max(scales, eps)
             else:
-                scales = (maxs - mins) / 15
+                scales = (maxs - mins) / qmax
                 scales = torch.max(scales, eps)
                 zps = -torch.round(mins / scales)
         else:  # NF4
@@ -1094,14 +1166,15 @@ def quantize_per_block(
                     scales_rem = torch.max(scales_rem, eps)
                     zps_rem = -torch.round(mins_rem / scales_rem)
                     zps_rem -= 128
-            elif dtype == WoqWeightDtype.INT4:
+            elif is_sub_byte_int(dtype):
+                qmax = 2 ** get_weight_bits(dtype) - 1
                 if sym_quant:
-                    scales_rem = (
-                        torch.maximum(torch.abs(maxs_rem), torch.abs(mins_rem)) / 7
-                    )
+                    scales_rem = torch.maximum(
+                        torch.abs(maxs_rem), torch.abs(mins_rem)
+                    ) / (qmax // 2)
                     scales_rem = torch.max(scales_rem, eps)
                 else:
-                    scales_rem = (maxs_rem - mins_rem) / 15
+                    scales_rem = (maxs_rem - mins_rem) / qmax
                     scales_rem = torch.max(scales_rem, eps)
                     zps_rem = -torch.round(mins_rem / scales_rem)
             else:  # NF4
@@ -1132,13 +1205,13 @@ def quantize_per_block(
             min=qmin,
             max=qmax,
         )
-    elif dtype == WoqWeightDtype.INT4:
+    elif is_sub_byte_int(dtype):
         qmin = 0
-        qmax = 15
-        # for sym_quant, shift to 0-15 for storage
+        qmax = 2 ** get_weight_bits(dtype) - 1
+        # for sym_quant, shift to [0, qmax] for storage, e.g., 0-15 for INT4
         qt = torch.clamp(
             torch.round(t_com * inv_scales_com)
-            + (zps_com.unsqueeze(-1) if zps_com is not None else 8),
+            + (zps_com.unsqueeze(-1) if zps_com is not None else (qmax + 1) // 2),
             min=qmin,
             max=qmax,
         )
@@ -1161,11 +1234,11 @@ def quantize_per_block(
                 min=qmin,
                 max=qmax,
             )
-        elif dtype == WoqWeightDtype.INT4:
-            # for sym_quant, shift to 0-15 for storage
+        elif is_sub_byte_int(dtype):
+            # for sym_quant, shift to [0, qmax] for storage
             qt_rem = torch.clamp(
                 torch.round(t_rem * inv_scales_rem)
-                + (zps_rem.unsqueeze(-1) if zps_rem is not None else 8),
+                + (zps_rem.unsqueeze(-1) if zps_rem is not None else (qmax + 1) // 2),
                 min=qmin,
                 max=qmax,
             )
@@ -1176,12 +1249,15 @@ def quantize_per_block(
     # INT8 weight: always store in int8
     # INT4 weight: store in int8 if sym_quant, otherwise in uint8
     # NF4 weight: always store in uint8
-    qt = qt.to(torch.uint8 if is_4bit(dtype) else torch.int8)
+    # INT2/INT3 weight: always store in uint8
+    qt = qt.to(torch.uint8 if is_4bit(dtype) or is_lowbit(dtype) else torch.int8)
     qt = qt.view(N, K)
     if is_4bit(dtype):
         if qt.size(-1) % 2:
             qt = torch.nn.functional.pad(qt, (0, 1), value=0)
         qt = qt[:, 1::2].bitwise_left_shift(4).bitwise_or_(qt[:, ::2])
+    elif is_lowbit(dtype):
+        qt = pack_lowbit(qt, dtype)
     return qt.contiguous(), scales, zps
 
 
@@ -1213,14 +1289,16 @@ def dequantize_per_block(
         The dequantized tensor
     """
     N = qt.size(0)
+    if is_lowbit(dtype):
+        qt = unpack_lowbit(qt, dtype)
     K = qt.size(1) * 2 if is_4bit(dtype) else qt.size(1)
     if scales.dim() > 2:
         scales = scales.squeeze()
     if zps is None:
         zps = torch.zeros_like(scales)
-        if dtype == WoqWeightDtype.INT4:
-            # shift from [0, 15] to [-8, 7]
-            zps += 8
+        if is_sub_byte_int(dtype):
+            # e.g., shift from [0, 15] to [-8, 7] for INT4
+            zps += 2 ** (get_weight_bits(dtype) - 1)
     if zps.dim() > 2:
         zps = zps.squeeze()
     if is_4bit(dtype):
@@ -0,0 +1,78 @@
+import json
+
+import torch
+
+
+def _to_signature(inputs):
+    if isinstance(inputs, torch.Tensor):
+        dtype = str(inputs.dtype).replace("torch.", "")
+        return {"shape": list(inputs.shape), "dtype": dtype}
+    if isinstance(inputs, dict):
+        return {"kwargs": {k: _to_signature(v) for k, v in inputs.items()}}
+    if isinstance(inputs, (tuple, list)):
+        return {"args": [_to_signature(v) for v in inputs]}
+    raise TypeError(
+        "warmup inputs should be Tensors, or tuples, lists or dicts of Tensors,"
+        f" got {type(inputs)}"
+    )
+
+
+def _from_signature(signature):
+    if "kwargs" in signature:
+        return {k: _from_signature(v) for k, v in signature["kwargs"].items()}
+    if "args" in signature:
+        return tuple(_from_signature(v) for v in signature["args"])
+    # zeros are valid for any input, including indices into embeddings
+    return torch.zeros(signature["shape"], dtype=getattr(torch, signature["dtype"]))
+
+
+def save_warmup_inputs(example_inputs_list, f):
+    r"""
+    Record the input signatures (shapes and dtypes) a TorchScript model is
+    expected to serve, so that it can be warmed up with :func:`warmup` right
+    after loading, e.g. next to ``traced_model.save("quantized_model.pt")``.
+
+    oneDNN graph partitions of INT8 models are compiled on the first run of
+    each input shape. Warming up before serving moves that compilation off
+    the request path of freshly started replicas.
+
+    Args:
+        example_inputs_list (list): one entry per input shape to prepare for.
+            An entry is the positional inputs of the model (a Tensor or a
+            tuple of Tensors) or its keyword inputs (a dict of Tensors).
+        f (str): path of the json file to write.
+    """
+    with open(f, "w") as fp:
+        json.dump([_to_signature(x) for x in example_inputs_list], fp, indent=4)
+
+
+def warmup(model, f, profiling_count=2):
+    r"""
+    Run a TorchScript model once per input signature saved by
+    :func:`save_warmup_inputs`, with zero-filled inputs, so that its graph
+    is optimized and its oneDNN graph partitions are compiled before the
+    first real request. Compiled partitions are shared by all threads of the
+    process.
+
+    Args:
+        model (torch.jit.ScriptModule): the loaded and frozen model.
+        f (str): path of the json file written by :func:`save_warmup_inputs`.
+        profiling_count (int): runs per signature, the profiling executor
+            needs two runs before it fuses the graph.
+
+    Returns:
+        The model, for chaining after ``torch.jit.load``.
+    """
+    with open(f, "r") as fp:
+        signatures = json.load(fp)
+    with torch.no_grad():
+        for signature in signatures:
+            inputs = _from_signature(signature)
+            for _ in range(profiling_count):
+                if isinstance(inputs, dict):
+                    model(**inputs)
+                elif isinstance(inputs, tuple):
+                    model(*inputs)
+                else:
+                    model(inputs)
+    return model
@@ -9,6 +9,7 @@ from intel_extension_for_pytorch.quantization.fp8.util import (
     cast_to_fp8,
 )
 import intel_extension_for_pytorch._isa_help as ipex
+import intel_extension_for_pytorch._C as core
 from .base import Fp8BaseModule, prepare_backward
 from intel_extension_for_pytorch.quantization.fp8.fp8 import (
     get_fp8_dtype,
@@ -210,6 +211,11 @@ class FP8Linear(Fp8BaseModule):
         else:
             self.register_parameter("bias", None)
 
+        # fp8 weight prepacked for inference, see _prepack_fp8_weight
+        self._fp8_op_context = None
+        self._fp8_op_context_key = None
+        self._fp8_weight_amax = None
+
         self.reset_parameters()
 
     def reset_parameters(self) -> None:
@@ -222,15 +228,108 @@ class FP8Linear(Fp8BaseModule):
             bound = 1 / math.sqrt(fan_in) if fan_in > 0 else 0
             init.uniform_(self.bias, -bound, bound)
 
+    def __getstate__(self):
+        # the op context is not saved, it is packed again on the first
+        # inference forward
+        state = self.__dict__.copy()
+        state["_fp8_op_context"] = None
+        state["_fp8_op_context_key"] = None
+        return state
+
+    def __setstate__(self, state):
+        super().__setstate__(state)
+        for name in ("_fp8_op_context", "_fp8_op_context_key", "_fp8_weight_amax"):
+            self.__dict__.setdefault(name, None)
+
+    def train(self, mode: bool = True):
+        super().train(mode)
+        self._fp8_op_context = None
+        if (
+            not mode
+            and self.fp8_meta_tensors_initialized
+            and core.onednn_has_fp8_support()
+        ):
+            self._prepack_fp8_weight(self.activation_dtype)
+        return self
+
+    def _prepack_fp8_weight(self, activation_dtype):
+        """
+        Cast the weight to fp8 and prepack it with its scales into an
+        Fp8LinearOpContext, unless the cached one was packed from the same
+        weight, scales and dtypes. The scales of the delayed scaling recipe
+        only change when the amax history does, so inference packs once.
+        """
+        scaling = self.fp8_meta["scaling_fwd"]
+        fp8_dtype = get_fp8_dtype(self.fp8_meta["recipe"], fprop_tensor=True)
+        input_scale_inv, weight_scale_inv = scaling.scale_inv[
+            [ipex.FP8FwdTensors.GEMM1_INPUT, ipex.FP8FwdTensors.GEMM1_WEIGHT]
+        ].tolist()
+        key = (
+            self.weight.data_ptr(),
+            self.weight._version,
+            input_scale_inv,
+            weight_scale_inv,
+            fp8_dtype,
+            activation_dtype,
+        )
+        if self._fp8_op_context is not None and self._fp8_op_context_key == key:
+            return self._fp8_op_context
+        weight = cast_if_needed(self.weight.detach(), activation_dtype)
+        weight_fp8 = cast_to_fp8(
+            weight,
+            scaling,
+            ipex.FP8FwdTensors.GEMM1_WEIGHT,
+            fp8_dtype,
+        )
+        bias = None
+        if self.use_bias:
+            bias_dtype = (
+                torch.bfloat16
+                if activation_dtype == torch.float32
+                else activation_dtype
+            )
+            bias = cast_if_needed(self.bias.detach(), bias_dtype)
+        self._fp8_weight_amax = torch.abs(weight).max().float()
+        self._fp8_op_context = torch.ops.ipex_prepack.fp8_linear_prepack(
+            weight_fp8, bias, input_scale_inv, weight_scale_inv, None
+        )
+        self._fp8_op_context_key = key
+        return self._fp8_op_context
+
+    def _prepacked_forward(self, input: torch.Tensor):
+        op_context = self._prepack_fp8_weight(self.activation_dtype)
+        scaling = self.fp8_meta["scaling_fwd"]
+        # the weight is not cast again, record its amax for the scale update
+        amax = scaling.amax_history[0]
+        amax[ipex.FP8FwdTensors.GEMM1_WEIGHT] = self._fp8_weight_amax
+        inputmat = input.reshape(-1, self.in_features)
+        inputmat_fp8 = cast_to_fp8(
+            inputmat,
+            scaling,
+            ipex.FP8FwdTensors.GEMM1_INPUT,
+            get_fp8_dtype(self.fp8_meta["recipe"], fprop_tensor=True),
+        )
+        out = torch.ops.torch_ipex.ipex_fp8_linear(
+            inputmat_fp8, op_context.get_data_handle(), self.activation_dtype
+        )
+        return out.view(*input.shape[:-1], self.out_features)
+
     def forward(self, input: torch.Tensor):
         with self.prepare_forward():
+            self.activation_dtype = input.dtype
+            if (
+                not torch.is_grad_enabled()
+                and not self.training
+                and self.fp8
+                and not self.fp8_calibration
+            ):
+                return self._prepacked_forward(input)
             if torch.is_grad_enabled():
                 fn = _FP8Linear.apply
                 args = []
             else:
                 fn = _FP8Linear.forward
                 args = [None]
-            self.activation_dtype = input.dtype
 
             args += (
                 input,
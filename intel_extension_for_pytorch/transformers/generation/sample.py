@@ -7,7 +7,13 @@ from transformers.generation.stopping_criteria import (
     StoppingCriteriaList,
     validate_stopping_criteria,
 )
-from transformers.generation.logits_process import LogitsProcessorList
+from transformers.generation.logits_process import (
+    LogitsProcessorList,
+    RepetitionPenaltyLogitsProcessor,
+    TemperatureLogitsWarper,
+    TopKLogitsWarper,
+    TopPLogitsWarper,
+)
 from transformers.generation.streamers import BaseStreamer
 import time
 from transformers.generation.utils import (
@@ -37,6 +43,42 @@ def softmax_multinomial(
     return probs.div_(q).argmax(dim=1).view(-1, num_samples)
 
 
+def _fused_sampler_args(processors):
+    r"""
+    Map the logits processors of ``generate(do_sample=True)`` to the arguments
+    of ``torch.ops.torch_ipex.fused_sampler``: (temperature,
+    repetition_penalty, top_k, top_p). Returns None when a processor is not
+    supported by the fused op, or the processors are not in the order HF
+    applies them (penalty, temperature, top-k, top-p), so that the caller
+    falls back to the processor lists.
+    """
+    temperature, penalty, top_k, top_p = 1.0, 1.0, 0, 1.0
+    rank = -1
+    for processor in processors:
+        if isinstance(processor, RepetitionPenaltyLogitsProcessor):
+            new_rank = 0
+            penalty = float(processor.penalty)
+        elif isinstance(processor, TemperatureLogitsWarper):
+            new_rank = 1
+            temperature = float(processor.temperature)
+        elif isinstance(processor, TopKLogitsWarper):
+            new_rank = 2
+            top_k = int(processor.top_k)
+        elif isinstance(processor, TopPLogitsWarper):
+            if processor.min_tokens_to_keep != 1:
+                return None
+            new_rank = 3
+            top_p = float(processor.top_p)
+        else:
+            return None
+        if new_rank <= rank:
+            return None
+        rank = new_rank
+    if temperature <= 0:
+        return None
+    return temperature, penalty, top_k, top_p
+
+
 def _sample(
     self,
     input_ids: torch.LongTensor,
@@ -138,6 +180,13 @@ def _sample(
 
     # init attention / hidden states / scores tuples
     scores = () if (return_dict_in_generate and output_scores) else None
+    # penalty, warpers, softmax and multinomial in one op when the scores are
+    # not returned
+    fused_sampler_args = None
+    if not DISABLE_IPEX_SAMPLE and scores is None:
+        fused_sampler_args = _fused_sampler_args(
+            list(logits_processor) + list(logits_warper)
+        )
     decoder_attentions = () if (return_dict_in_generate and output_attentions) else None
     cross_attentions = () if (return_dict_in_generate and output_attentions) else None
     decoder_hidden_states = (
@@ -195,9 +244,10 @@ def _sample(
         else:
             next_token_logits = outputs[0][:, -1, :]
 
-        # pre-process distribution
-        next_token_scores = logits_processor(input_ids, next_token_logits)
-        next_token_scores = logits_warper(input_ids, next_token_scores)
+        if fused_sampler_args is None:
+            # pre-process distribution
+            next_token_scores = logits_processor(input_ids, next_token_logits)
+            next_token_scores = logits_warper(input_ids, next_token_scores)
 
         # Store scores, attentions and hidden_states when required
         if return_dict_in_generate:
@@ -220,7 +270,11 @@ def _sample(
                 )
 
         # sample
-        if not DISABLE_IPEX_SAMPLE:
+        if fused_sampler_args is not None:
+            next_tokens = torch.ops.torch_ipex.fused_sampler(
+                next_token_logits, input_ids, *fused_sampler_args
+            )
+        elif not DISABLE_IPEX_SAMPLE:
             next_tokens = softmax_multinomial(next_token_scores, num_samples=1).squeeze(
                 1
             )
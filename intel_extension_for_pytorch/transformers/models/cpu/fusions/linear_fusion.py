@@ -135,6 +135,24 @@ class _IPEXlinearMulCPU(_IPEXlinearFusionCPU):
             return self.linear(x) * y
 
 
+class _IPEXlinearTopkCPU(_IPEXlinearFusionCPU):
+    def __init__(self, module, tpp=False, woq=False):
+        super().__init__(module, tpp=tpp, woq=woq)
+        self.linear = module
+
+    def forward(self, x, k):
+        if self.tpp and not self.linear.tpp_fallback and self.linear.bias is None:
+            x = x.to(self.dtype).contiguous()
+            w = torch.ops.torch_ipex.choose_tpp_linear_weight(
+                x, self.linear.weight, self.linear.weight_for_large_batch
+            )
+            return torch.ops.torch_ipex.tpp_linear_topk(
+                x, w.detach(), k, self.linear.out_features
+            )
+        else:  # fallback path
+            return torch.topk(self.linear(x), k, dim=-1)
+
+
 class _IPEXlinearAddCPU(_IPEXlinearFusionCPU):
     def __init__(self, module, tpp=False, woq=False):
         super().__init__(module, tpp=tpp, woq=woq)
@@ -587,6 +605,20 @@ class _IPEXGatedMLPMOECPU(nn.Module):
                 auto_kernel_selection=auto_kernel_selection,
                 inplace=True,
             )
+        # When every expert runs on TPP, all of them go through one fused op
+        # that groups the tokens by expert, instead of one op per expert.
+        self.tpp_weights = None
+        if all(
+            isinstance(m, _IPEXLinear)
+            and getattr(m, "use_tpp", False)
+            and not m.tpp_fallback
+            for linears in self.linear_module_list
+            for m in linears
+        ):
+            self.tpp_weights = [
+                [linears[i].weight.detach() for linears in self.linear_module_list]
+                for i in [0, 2, 1]
+            ]
 
     # This is used by the Deepseek-V2 and Deepseek-V3 model
     # ref from:
@@ -685,6 +717,18 @@ class _IPEXGatedMLPMOECPU(nn.Module):
             )
 
         routing_weights = routing_weights.to(hidden_states.dtype)
+        if self.tpp_weights is not None:
+            gate_weights, up_weights, down_weights = self.tpp_weights
+            return torch.ops.torch_ipex.deepseek_moe_tpp(
+                hidden_states,
+                selected_experts.to(torch.int64),
+                gate_weights,
+                up_weights,
+                down_weights,
+                False,
+                routing_weights,
+                False,
+            ).view(-1, head_dim)
         final_hidden_states = torch.zeros(
             (batch_size, head_dim),
             dtype=hidden_states.dtype,
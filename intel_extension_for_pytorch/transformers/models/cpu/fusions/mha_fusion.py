@@ -714,6 +714,54 @@ class _IPEXMambaMixerCPU:
             state, x, dt, A, B, C, D, z, dt_bias, dt_softplus
         )
 
+    @classmethod
+    def causal_conv1d_selective_state_update(
+        cls,
+        xBC,
+        conv_state,
+        conv_weight,
+        conv_bias,
+        state,
+        dt,
+        A,
+        ngroups,
+        D=None,
+        z=None,
+        dt_bias=None,
+        dt_softplus=False,
+    ):
+        """
+        Argument:
+            xBC: (batch, conv_dim), conv_dim = nheads * dim + 2 * ngroups * dstate
+            conv_state: (batch, conv_dim, state_len), updated in place
+            conv_weight: (conv_dim, width)
+            conv_bias: (conv_dim,) or None
+            state: (batch, nheads, dim, dstate), updated in place
+            dt: (batch, nheads, dim)
+            A: (nheads, dim, dstate)
+            ngroups: int
+            D: (nheads, dim) or None
+            z: (batch, nheads, dim) or None
+            dt_bias: (nheads, dim) or None
+            dt_softplus: bool
+        Return:
+            out: (batch, nheads, dim)
+        """
+        return torch.ops.torch_ipex.causal_conv1d_selective_state_update(
+            xBC,
+            conv_state,
+            conv_weight,
+            conv_bias,
+            state,
+            dt,
+            A,
+            D,
+            z,
+            dt_bias,
+            dt_softplus,
+            ngroups,
+        )
+
     @classmethod
     def selective_scan_fn(
         cls,
@@ -885,6 +933,49 @@ def bgmv_expand_slice_cpu(
     )
 
 
+def bgmv_shrink_expand_slice_cpu(
+    inputs: torch.Tensor,
+    lora_a_weights: torch.Tensor,
+    lora_b_weights: torch.Tensor,
+    output_tensor: torch.Tensor,
+    lora_indices_tensor: torch.Tensor,
+    scaling: float,
+    slice_offset: int,
+    slice_size: int,
+    add_inputs: bool,
+):
+    r"""
+    Fused bgmv_shrink + bgmv_expand_slice, the tokens are grouped by LoRA once
+    and the [batchsize, max_rank] intermediate never leaves the kernel.
+    Args:
+        inputs (torch.Tensor): The input tensor with shape of
+            [batchsize, input_size1] which input_size1 >= hidden_size.
+        lora_a_weights (torch.Tensor): LoRA A weights tensor with shape of
+            [num_lora, max_rank, hidden_size].
+        lora_b_weights (torch.Tensor): LoRA B weights tensor with shape of
+            [num_lora, slice_size, max_rank].
+        output_tensor (torch.Tensor): The output tensor with shape of [batchsize, output_size1]
+            which output_size1 >= slice_offset + slice_size
+        lora_indices_tensor (torch.Tensor): The tensor mapping each input token to
+            the lora-id related to that token with shape of [batchsize].
+        scaling (float): Scaling factor applied to the shrink result.
+        slice_offset (int): Slice offset start for output.
+        slice_size (int): Slice length for output.
+        add_inputs (bool): Whether to add to the output tensor.
+    """
+    return torch.ops.torch_ipex.punica_bgmv_shrink_expand_slice(
+        output_tensor,
+        inputs,
+        lora_a_weights,
+        lora_b_weights,
+        lora_indices_tensor,
+        scaling,
+        slice_offset,
+        slice_size,
+        add_inputs,
+    )
+
+
 def sgmv_shrink_cpu(
     inputs: torch.Tensor,
     lora_a_weights: torch.Tensor,
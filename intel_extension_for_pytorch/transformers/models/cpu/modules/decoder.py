@@ -249,6 +249,14 @@ class _IPEXDecoderLayerCPU(nn.Module):
                     tpp=tpp,
                     woq=woq,
                 )
+            if self.model_backbone == "MixtralForCausalLM":
+                # the experts are TPP-packed only by now, decide once here
+                # whether the forward runs all of them in one fused op
+                self.use_fused_moe_tpp = all(
+                    getattr(m, "use_tpp", False) and not m.tpp_fallback
+                    for expert in self.block_sparse_moe.experts
+                    for m in [expert.w1, expert.w2, expert.w3]
+                )
             if self.model_backbone in [
                 "DeepseekV2ForCausalLM",
                 "DeepseekV3ForCausalLM",
@@ -41,6 +41,15 @@ class _IPEXlinearMulRef(nn.Module):
         return self.linear(x) * y
 
 
+class _IPEXlinearTopkRef(nn.Module):
+    def __init__(self, module):
+        super().__init__()
+        self.linear = module
+
+    def forward(self, x, k):
+        return torch.topk(self.linear(x), k, dim=-1)
+
+
 class _IPEXlinearNewGeluRef(nn.Module):
     def __init__(self, module):
         super().__init__()
@@ -932,67 +932,81 @@ def MixtralDecoderLayer_forward(
     # we cast back to the input dtype
     routing_weights = routing_weights.to(hidden_states.dtype)
 
-    final_hidden_states = torch.zeros(
-        (batch_size * sequence_length, hidden_dim),
-        dtype=hidden_states.dtype,
-        device=hidden_states.device,
-    )
+    experts = self.block_sparse_moe.experts
+    if self.use_fused_moe_tpp:
+        # all experts in one op, the tokens are grouped by expert in the kernel
+        final_hidden_states = torch.ops.torch_ipex.deepseek_moe_tpp(
+            hidden_states,
+            selected_experts,
+            [expert.w1.weight for expert in experts],
+            [expert.w3.weight for expert in experts],
+            [expert.w2.weight for expert in experts],
+            False,
+            routing_weights,
+            self.distributed,
+        )
+    else:
+        final_hidden_states = torch.zeros(
+            (batch_size * sequence_length, hidden_dim),
+            dtype=hidden_states.dtype,
+            device=hidden_states.device,
+        )
 
-    # One hot encode the selected experts to create an expert mask
-    # this will be used to easily index which expert is going to be sollicitated
-    expert_mask = torch.nn.functional.one_hot(
-        selected_experts, num_classes=self.block_sparse_moe.num_experts
-    ).permute(2, 1, 0)
-
-    # Loop over all available experts in the model and perform the computation on each expert
-    for expert_idx in range(self.block_sparse_moe.num_experts):
-        expert_layer = self.block_sparse_moe.experts[expert_idx]
-        idx, top_x = torch.where(expert_mask[expert_idx])
-        if expert_layer.w1.weight.dtype in [torch.qint8, torch.int8, torch.uint8]:
-            final_hidden_states = torch.ops.torch_ipex.mixtral_moe_woq(
-                hidden_states,
-                top_x,
-                idx,
-                expert_layer.w1._op_context.get_data_handle(),
-                expert_layer.w3._op_context.get_data_handle(),
-                expert_layer.w2._op_context.get_data_handle(),
-                routing_weights,
-                final_hidden_states,
-                self.distributed,
-            )
-        elif hasattr(expert_layer.w1, "use_dnnl") and expert_layer.w1.use_dnnl:
-            final_hidden_states = torch.ops.torch_ipex.mixtral_moe(
-                hidden_states,
-                top_x,
-                idx,
-                expert_layer.w1._get_forward_weight(),
-                expert_layer.w1.ctx.get_data_handle(),
-                expert_layer.w3._get_forward_weight(),
-                expert_layer.w3.ctx.get_data_handle(),
-                expert_layer.w2._get_forward_weight(),
-                expert_layer.w2.ctx.get_data_handle(),
-                hasattr(expert_layer.w1, "use_dnnl") and expert_layer.w1.use_dnnl,
-                routing_weights,
-                final_hidden_states,
-                self.distributed,
-            )
-        else:
-            final_hidden_states = torch.ops.torch_ipex.mixtral_moe_tpp(
-                hidden_states,
-                top_x,
-                idx,
-                expert_layer.w1.weight,
-                expert_layer.w3.weight,
-                expert_layer.w2.weight,
-                (
-                    expert_layer.w1.tpp_fallback
-                    if hasattr(expert_layer.w1, "tpp_fallback")
-                    else True
-                ),
-                routing_weights,
-                final_hidden_states,
-                self.distributed,
-            )
+        # One hot encode the selected experts to create an expert mask
+        # this will be used to easily index which expert is going to be sollicitated
+        expert_mask = torch.nn.functional.one_hot(
+            selected_experts, num_classes=self.block_sparse_moe.num_experts
+        ).permute(2, 1, 0)
+
+        # Loop over all available experts in the model and perform the computation on each expert
+        for expert_idx in range(self.block_sparse_moe.num_experts):
+            expert_layer = self.block_sparse_moe.experts[expert_idx]
+            idx, top_x = torch.where(expert_mask[expert_idx])
+            if expert_layer.w1.weight.dtype in [torch.qint8, torch.int8, torch.uint8]:
+                final_hidden_states = torch.ops.torch_ipex.mixtral_moe_woq(
+                    hidden_states,
+                    top_x,
+                    idx,
+                    expert_layer.w1._op_context.get_data_handle(),
+                    expert_layer.w3._op_context.get_data_handle(),
+                    expert_layer.w2._op_context.get_data_handle(),
+                    routing_weights,
+                    final_hidden_states,
+                    self.distributed,
+                )
+            elif hasattr(expert_layer.w1, "use_dnnl") and expert_layer.w1.use_dnnl:
+                final_hidden_states = torch.ops.torch_ipex.mixtral_moe(
+                    hidden_states,
+                    top_x,
+                    idx,
+                    expert_layer.w1._get_forward_weight(),
+                    expert_layer.w1.ctx.get_data_handle(),
+                    expert_layer.w3._get_forward_weight(),
+                    expert_layer.w3.ctx.get_data_handle(),
+                    expert_layer.w2._get_forward_weight(),
+                    expert_layer.w2.ctx.get_data_handle(),
+                    hasattr(expert_layer.w1, "use_dnnl") and expert_layer.w1.use_dnnl,
+                    routing_weights,
+                    final_hidden_states,
+                    self.distributed,
+                )
+            else:
+                final_hidden_states = torch.ops.torch_ipex.mixtral_moe_tpp(
+                    hidden_states,
+                    top_x,
+                    idx,
+                    expert_layer.w1.weight,
+                    expert_layer.w3.weight,
+                    expert_layer.w2.weight,
+                    (
+                        expert_layer.w1.tpp_fallback
+                        if hasattr(expert_layer.w1, "tpp_fallback")
+                        else True
+                    ),
+                    routing_weights,
+                    final_hidden_states,
+                    self.distributed,
+                )
     final_hidden_states = final_hidden_states.reshape(
         batch_size, sequence_length, hidden_dim
     )
@@ -2378,6 +2392,8 @@ class _IPEXDecoderLayerRef(nn.Module):
             if not self.distributed:
                 self.mha_linear_add = _IPEXlinearAddRef(module.self_attn.o_proj)
                 del self.__dict__["_modules"]["self_attn"].o_proj
+            # set by _IPEXDecoderLayerCPU once the experts are TPP-packed
+            self.use_fused_moe_tpp = False
         elif self.model_backbone == "QWenLMHeadModel":
             if not self.distributed:
                 self.mha_linear_add = _IPEXlinearAddRef(module.attn.c_proj)
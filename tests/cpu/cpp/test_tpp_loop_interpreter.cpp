@@ -0,0 +1,148 @@
+#include <omp.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "csrc/cpu/tpp/threaded_loops.h"
+#include "gtest/gtest.h"
+
+using namespace torch_ipex::tpp;
+
+namespace {
+
+constexpr int kLogicalLoops = 3;
+constexpr int kThreads = 6;
+
+using Index = std::array<int, kLogicalLoops>;
+using LoopNest = std::function<
+    void(LoopSpecs*, loop_func, init_func, fini_func)>;
+
+// What every thread of a loop nest did: the indices it visited in order,
+// the global order of each visit and how many times it ran init and fini.
+struct Trace {
+  std::vector<std::vector<Index>> visits;
+  std::vector<std::vector<long>> stamps;
+  std::vector<int> inits;
+  std::vector<int> finis;
+};
+
+Trace trace(const LoopNest& nest, LoopSpecs* specs) {
+  Trace t;
+  t.visits.resize(kThreads);
+  t.stamps.resize(kThreads);
+  t.inits.resize(kThreads);
+  t.finis.resize(kThreads);
+  std::atomic<long> clock(0);
+  omp_set_num_threads(kThreads);
+  nest(
+      specs,
+      [&](int* ind) {
+        int tid = omp_get_thread_num();
+        t.visits[tid].push_back({ind[0], ind[1], ind[2]});
+        t.stamps[tid].push_back(clock++);
+      },
+      [&]() { t.inits[omp_get_thread_num()]++; },
+      [&]() { t.finis[omp_get_thread_num()]++; });
+  return t;
+}
+
+// The loop nest loop_generator() emits for the scheme, compiled with g++
+LoopNest generated_nest(const std::string& scheme) {
+  auto kernel = (par_loop_kernel)jit_from_str(
+      code_str + loop_generator(scheme.c_str()),
+      " -fopenmp ",
+      "par_nested_loops");
+  if (kernel == NULL)
+    return nullptr;
+  return kernel;
+}
+
+LoopNest interpreted_nest(const std::string& scheme) {
+  auto interpreter = std::make_shared<LoopNestInterpreter>(scheme);
+  return [interpreter](
+             LoopSpecs* specs, loop_func body, init_func init, fini_func fini) {
+    interpreter->run(specs, body, init, fini);
+  };
+}
+
+// Every visit with outer index a of the logical loop `ll` happens before
+// any visit of the next outer index, i.e. a barrier separates them.
+void expect_barrier_between(const Trace& t, int ll) {
+  std::map<int, std::pair<long, long>> span;
+  for (int tid = 0; tid < kThreads; tid++) {
+    for (size_t i = 0; i < t.visits[tid].size(); i++) {
+      auto v = t.visits[tid][i][ll];
+      auto s = t.stamps[tid][i];
+      auto it = span.find(v);
+      if (it == span.end()) {
+        span[v] = {s, s};
+      } else {
+        it->second.first = std::min(it->second.first, s);
+        it->second.second = std::max(it->second.second, s);
+      }
+    }
+  }
+  for (auto it = span.begin(); std::next(it) != span.end(); it++) {
+    EXPECT_LT(it->second.second, std::next(it)->second.first)
+        << "visits of index " << it->first << " overlap the next ones";
+  }
+}
+
+struct Case {
+  std::string scheme;
+  int barrier_loop; // logical loop whose iterations a barrier separates
+};
+
+} // namespace
+
+TEST(TestTppLoopInterpreter, MatchesGeneratedLoopNests) {
+  // keep the generated nests out of the on-disk JIT cache
+  setenv("TPP_JIT_CACHE_DIR", "", 1);
+  if (generated_nest("ABC") == nullptr)
+    GTEST_SKIP() << "g++ is not available to compile the generated nests";
+  std::vector<Case> cases = {
+      {"ABC", -1},
+      {"aBC", -1},
+      {"BCa", -1},
+      {"bAc", -1},
+      {"aaBC", -1},
+      {"AaBCb", -1},
+      {"Abca", -1},
+      {"ACb", -1},
+      {"a|BC", -1},
+      {"aB|C", 0},
+      {"aB|c", 0},
+      {"aB|Cb", 0},
+      {"a[0,12,4,()]BC", -1},
+      {"a[4,,,(8)]aBC", -1},
+      {"aB{R:2}C{C:3}", -1},
+      {"A{R:3}bC{C:2}", -1},
+      {"aB{C:6}c", -1},
+  };
+  for (const auto& c : cases) {
+    SCOPED_TRACE(c.scheme);
+    // a: blocked twice, b: blocked once, c: starts at an offset
+    LoopSpecs specs[kLogicalLoops] = {
+        LoopSpecs(0L, 24L, 2L, {8, 4}),
+        LoopSpecs(0L, 10L, 1L, {5}),
+        LoopSpecs(3L, 9L, 1L, {})};
+    auto generated = generated_nest(c.scheme);
+    ASSERT_NE(generated, nullptr);
+    auto ref = trace(generated, specs);
+    auto out = trace(interpreted_nest(c.scheme), specs);
+    for (int tid = 0; tid < kThreads; tid++) {
+      // same iterations on the same threads, in the same order
+      EXPECT_EQ(out.visits[tid], ref.visits[tid]) << "thread " << tid;
+      EXPECT_EQ(out.inits[tid], ref.inits[tid]) << "thread " << tid;
+      EXPECT_EQ(out.finis[tid], ref.finis[tid]) << "thread " << tid;
+    }
+    if (c.barrier_loop >= 0) {
+      expect_barrier_between(ref, c.barrier_loop);
+      expect_barrier_between(out, c.barrier_loop);
+    }
+  }
+}
@@ -1871,6 +1871,32 @@ class CPUOPsTester(TestCase):
                     )
                 )
 
+        # few rows and a long sequence, scanned in chunks
+        batch, dim, dstate, seq_len = 1, 3, 16, 1024
+        example_inputs = (
+            torch.rand(batch, dim, seq_len),
+            torch.rand(batch, dim, seq_len),
+            -torch.rand(dim, dstate),
+            torch.rand(batch, dstate, seq_len),
+            torch.rand(batch, dstate, seq_len),
+            torch.ones(dim),
+            torch.rand(batch, dim, seq_len),
+            torch.rand(dim),
+        )
+        with torch.no_grad():
+            scan_outputs_ref, ssm_state_ref = selective_scan_ref(
+                *self._clone_inputs(example_inputs),
+                delta_softplus=True,
+                return_last_state=True,
+            )
+            scan_outputs_ipex, ssm_state_ipex = torch.ops.torch_ipex.selective_scan_fn(
+                *self._clone_inputs(example_inputs),
+                delta_softplus=True,
+                return_last_state=True,
+            )
+        self.assertEqual(scan_outputs_ref, scan_outputs_ipex, rtol=1e-3, atol=1e-3)
+        self.assertEqual(ssm_state_ref, ssm_state_ipex, rtol=1e-3, atol=1e-3)
+
     def test_selective_state_update(self):
         def selective_state_update_ref(
             state, x, dt, A, B, C, D=None, z=None, dt_bias=None, dt_softplus=False
@@ -1984,6 +2010,80 @@ class CPUOPsTester(TestCase):
                     )
                 )
 
+    def test_causal_conv1d_selective_state_update(self):
+        def fused_ref(
+            xBC,
+            conv_state,
+            conv_weight,
+            conv_bias,
+            state,
+            dt,
+            A,
+            ngroups,
+            D,
+            z,
+            dt_bias,
+        ):
+            batch, nheads, dim, dstate = state.shape
+            width = conv_weight.shape[1]
+            x_all = torch.cat([conv_state, xBC.unsqueeze(-1)], dim=-1).float()
+            conv_state.copy_(x_all[..., 1:])
+            xBC = F.silu(
+                (x_all[..., -width:] * conv_weight.float()).sum(-1) + conv_bias.float()
+            )
+            x, B, C = torch.split(
+                xBC, [nheads * dim, ngroups * dstate, ngroups * dstate], dim=-1
+            )
+            x = x.view(batch, nheads, dim)
+            B = B.view(batch, ngroups, dstate).repeat_interleave(nheads // ngroups, 1)
+            C = C.view(batch, ngroups, dstate).repeat_interleave(nheads // ngroups, 1)
+            dt = F.softplus(dt.float() + dt_bias)
+            dA = torch.exp(dt[..., None] * A)
+            dB_x = dt[..., None] * B[:, :, None] * x[..., None]
+            new_state = state.float() * dA + dB_x
+            state.copy_(new_state)
+            out = torch.einsum("bhdn,bhn->bhd", new_state, C) + x * D
+            return (out * F.silu(z.float())).to(z.dtype)
+
+        batch, nheads, dim, dstate, ngroups, width = 2, 8, 16, 32, 2, 4
+        conv_dim = nheads * dim + 2 * ngroups * dstate
+        dtypes = [torch.float, torch.bfloat16]
+        if core.onednn_has_fp16_support():
+            dtypes.append(torch.float16)
+        for dtype in dtypes:
+            example_inputs = (
+                torch.rand(batch, conv_dim).to(dtype),
+                torch.rand(batch, conv_dim, width - 1).to(dtype),
+                torch.rand(conv_dim, width).to(dtype),
+                torch.rand(conv_dim).to(dtype),
+                torch.rand(batch, nheads, dim, dstate).to(dtype),
+                torch.rand(batch, nheads, dim).to(dtype),
+                -torch.rand(nheads, 1, 1).expand(nheads, dim, dstate),
+                ngroups,
+                torch.ones(nheads, dim),
+                torch.rand(batch, nheads, dim).to(dtype),
+                torch.rand(nheads, dim),
+            )
+            rtol, atol = (1e-4, 1e-4) if dtype == torch.float32 else (2e-2, 5e-2)
+            input_ref = [
+                x.clone() if isinstance(x, torch.Tensor) else x for x in example_inputs
+            ]
+            output_ref = fused_ref(*input_ref)
+            input_ipex = [
+                x.clone() if isinstance(x, torch.Tensor) else x for x in example_inputs
+            ]
+            mamba_mixer = ipex.llm.modules.MambaMixer
+            output_ipex = mamba_mixer.causal_conv1d_selective_state_update(
+                *input_ipex[:8],
+                D=input_ipex[8],
+                z=input_ipex[9],
+                dt_bias=input_ipex[10],
+                dt_softplus=True,
+            )
+            self.assertEqual(output_ref, output_ipex, rtol=rtol, atol=atol)
+            self.assertEqual(input_ref[1], input_ipex[1], rtol=rtol, atol=atol)
+            self.assertEqual(input_ref[4], input_ipex[4], rtol=rtol, atol=atol)
+
     def test_deepseek_moe(self):
         class DeepseekV2MLP(nn.Module):
             def __init__(self, hidden_size=5120, intermediate_size=12288):
@@ -2184,33 +2284,39 @@ class CPUOPsTester(TestCase):
                     )
                 return final_out
 
-        tokens = 1
         hidden_size = 64
         intermediate_size = 1024
         num_experts = 8
         selected_experts = 2
-        x = torch.rand(tokens, hidden_size)
-        topk_weight = torch.rand(tokens, selected_experts)
-        topk_ids = torch.randint(0, num_experts, (tokens, selected_experts))
-        with torch.no_grad():
-            model_ref = MoETest(num_experts, hidden_size, intermediate_size).eval()
-            output_ref = model_ref(x.clone(), topk_ids.clone(), topk_weight.clone())
-            for moe_linear_type in [0, 1, 2, 3, 4]:
-                amp_enabled = False if moe_linear_type == 3 else True
-                dtype = torch.float32 if moe_linear_type == 3 else torch.bfloat16
-                x_clone = x.clone().to(dtype)
-                topk_ids_clone = topk_ids.clone()
-                topk_weight_clone = topk_weight.clone().to(dtype)
-                with torch.cpu.amp.autocast(enabled=amp_enabled):
-                    model_ipex = MoETest(
-                        num_experts,
-                        hidden_size,
-                        intermediate_size,
-                        moe_linear_type,
-                        True,
-                    ).eval()
-                    output_ipex = model_ipex(x_clone, topk_ids_clone, topk_weight_clone)
-                    self.assertEqual(output_ref, output_ipex, prec=0.1)
+        # a single token (decode), experts with uneven token counts and an
+        # expert with more tokens than one 64-row block
+        for tokens in [1, 37, 100]:
+            x = torch.rand(tokens, hidden_size)
+            topk_weight = torch.rand(tokens, selected_experts)
+            topk_ids = torch.randint(0, num_experts, (tokens, selected_experts))
+            if tokens > 64:
+                topk_ids[:, 0] = 0
+            with torch.no_grad():
+                model_ref = MoETest(num_experts, hidden_size, intermediate_size).eval()
+                output_ref = model_ref(x.clone(), topk_ids.clone(), topk_weight.clone())
+                for moe_linear_type in [0, 1, 2, 3, 4]:
+                    amp_enabled = False if moe_linear_type == 3 else True
+                    dtype = torch.float32 if moe_linear_type == 3 else torch.bfloat16
+                    x_clone = x.clone().to(dtype)
+                    topk_ids_clone = topk_ids.clone()
+                    topk_weight_clone = topk_weight.clone().to(dtype)
+                    with torch.cpu.amp.autocast(enabled=amp_enabled):
+                        model_ipex = MoETest(
+                            num_experts,
+                            hidden_size,
+                            intermediate_size,
+                            moe_linear_type,
+                            True,
+                        ).eval()
+                        output_ipex = model_ipex(
+                            x_clone, topk_ids_clone, topk_weight_clone
+                        )
+                        self.assertEqual(output_ref, output_ipex, prec=0.1)
 
     def test_deepseek_moegate(self):
         n_group = 8
@@ -2327,6 +2433,115 @@ class CPUOPsTester(TestCase):
                 self.assertEqual(topk_idx_ref, topk_idx_ipex)
                 self.assertEqual(topk_weight_ref, topk_weight_ipex)
 
+    def test_decode_attention_kv_splits(self):
+        # MLA-like decode: one latent kv head, values are its first columns
+        num_heads, head_size, head_size_v = 16, 80, 64
+        scaling = head_size**-0.5
+        for bs, offset in itertools.product([1, 4], [1, 70, 1000]):
+            query = torch.randn(bs, num_heads, head_size, dtype=torch.bfloat16)
+            kv_cache = torch.randn(offset, bs, 1, head_size, dtype=torch.bfloat16)
+            k = kv_cache[:, :, 0].transpose(0, 1).float()
+            attn = torch.softmax(query.float() @ k.transpose(-1, -2) * scaling, -1)
+            ref = attn @ k[..., :head_size_v]
+            # caller provided splits, and splits planned by the kernel
+            for attn_logits in [
+                torch.empty(bs, num_heads, 3, head_size_v + 1),
+                torch.empty(0),
+            ]:
+                # the first calls of a shape are timed with different splits
+                for _ in range(16):
+                    output = torch.empty(
+                        bs, num_heads, head_size_v, dtype=torch.bfloat16
+                    )
+                    torch.ops.torch_ipex.decode_attention_opt(
+                        query, output, kv_cache, attn_logits, scaling, 0, offset
+                    )
+                    self.assertEqual(output.float(), ref, atol=2e-2, rtol=2e-2)
+
+    def test_decode_attention_quantized_kv_cache(self):
+        # latent cache rows hold the quantized values followed by a float scale
+        num_heads, head_size, head_size_v = 16, 80, 64
+        scaling = head_size**-0.5
+        bs, offset = 2, 300
+        query = torch.randn(bs, num_heads, head_size, dtype=torch.bfloat16)
+        kv = torch.randn(offset, bs, 1, head_size)
+        scale = kv.abs().amax(-1, keepdim=True)
+        for cache_dtype, qmax in [(torch.int8, 127), (torch.float8_e4m3fn, 448)]:
+            kv_q = kv / scale * qmax
+            if cache_dtype == torch.int8:
+                kv_q = kv_q.round()
+            kv_q = kv_q.to(cache_dtype)
+            kv_cache = torch.cat(
+                [kv_q.view(torch.int8), (scale / qmax).view(torch.int8)], -1
+            ).view(cache_dtype)
+            k = (kv_q.float() * scale / qmax)[:, :, 0].transpose(0, 1)
+            k = k.bfloat16().float()
+            attn = torch.softmax(query.float() @ k.transpose(-1, -2) * scaling, -1)
+            ref = attn @ k[..., :head_size_v]
+            output = torch.empty(bs, num_heads, head_size_v, dtype=torch.bfloat16)
+            torch.ops.torch_ipex.decode_attention_opt(
+                query, output, kv_cache, torch.empty(0), scaling, 0, offset
+            )
+            self.assertEqual(output.float(), ref, atol=2e-2, rtol=2e-2)
+
+    def test_fused_sampler(self):
+        def ref_scores(logits, input_ids, temperature, penalty, top_k, top_p):
+            # HF repetition penalty, temperature, top-k and top-p processors
+            scores = logits.float()
+            seen = scores.gather(1, input_ids)
+            seen = torch.where(seen < 0, seen * penalty, seen / penalty)
+            scores = scores.scatter(1, input_ids, seen) / temperature
+            if top_k > 0:
+                kth = scores.topk(top_k).values[:, -1:]
+                scores = scores.masked_fill(scores < kth, -float("inf"))
+            if top_p < 1:
+                sorted_scores, sorted_idx = scores.sort(descending=False)
+                cum = sorted_scores.softmax(-1).cumsum(-1)
+                remove = cum <= 1 - top_p
+                remove[:, -1] = False
+                remove = remove.scatter(1, sorted_idx, remove)
+                scores = scores.masked_fill(remove, -float("inf"))
+            return scores
+
+        def check(logits, input_ids, uniform, temperature, penalty, top_k, top_p):
+            bs, vocab_size = logits.shape
+            next_tokens = torch.ops.torch_ipex.fused_sampler(
+                logits, input_ids, temperature, penalty, top_k, top_p, uniform
+            )
+            if temperature <= 0:
+                ref = ref_scores(logits, input_ids, 1.0, penalty, 0, 1.0)
+                self.assertEqual(next_tokens, ref.argmax(-1))
+                return
+            ref = ref_scores(logits, input_ids, temperature, penalty, top_k, top_p)
+            probs = ref.double().softmax(-1)
+            # the kernel draws from the kept tokens by decreasing probability
+            # with top-k / top-p, and in vocabulary order otherwise
+            if top_k > 0 or top_p < 1:
+                probs, order = probs.sort(-1, descending=True, stable=True)
+            else:
+                order = torch.arange(vocab_size).expand(bs, -1)
+            cdf = probs.cumsum(-1)
+            idx = torch.searchsorted(cdf, uniform.unsqueeze(-1) * cdf[:, -1:])
+            ref_tokens = order.gather(1, idx.clamp(max=vocab_size - 1)).squeeze(1)
+            self.assertEqual(next_tokens, ref_tokens)
+            self.assertTrue(torch.isfinite(ref.gather(1, next_tokens[:, None])).all())
+
+        bs, vocab_size = 4, 32000
+        input_ids = torch.randint(0, vocab_size, (bs, 20))
+        uniform = torch.rand(bs, dtype=torch.double)
+        for dtype, (temperature, penalty, top_k, top_p) in itertools.product(
+            [torch.float, torch.bfloat16],
+            [(0.7, 1.3, 0, 1.0), (0.7, 1.0, 50, 1.0), (1.0, 1.2, 0, 0.8)]
+            + [(0.6, 1.1, 40, 0.9), (0.0, 1.3, 0, 1.0), (1.0, 1.0, 1, 1.0)],
+        ):
+            logits = (torch.randn(bs, vocab_size) * 3).to(dtype)
+            check(logits, input_ids, uniform, temperature, penalty, top_k, top_p)
+        # like HF, top-k keeps every token tied with the k-th largest
+        logits = torch.randn(bs, vocab_size)
+        logits[:, 100:120] = 10
+        for top_k in [1, 5]:
+            check(logits, input_ids, uniform, 1.0, 1.0, top_k, 1.0)
+
 
 if __name__ == "__main__":
     test = unittest.main()
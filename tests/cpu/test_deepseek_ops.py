@@ -1016,6 +1016,79 @@ class DeepSeekTester(TestCase):
                 )
                 self.assertEqual(output_ref, output_ipex, prec=0.05)
 
+    @skipIfNoIns
+    def test_mla_quantized_kv_cache(self):
+        dtype = torch.bfloat16
+        mla = MLA().to(dtype)
+        batch_size, num_beams = 2, 2
+        beam_batch = batch_size * num_beams
+        first_seq_len = 32
+        hidden_size = 5120
+        head_size = mla.kv_lora_rank + mla.qk_rope_head_dim
+        prompt = torch.rand(batch_size, first_seq_len, hidden_size, dtype=dtype)
+        casual_mask = torch.full(
+            (first_seq_len, first_seq_len), -1e6, dtype=dtype
+        ).triu(1)
+        prompt_mask = casual_mask.expand(batch_size, 1, -1, -1).contiguous()
+        next_tokens = [
+            torch.rand(beam_batch, 1, hidden_size, dtype=dtype) for _ in range(2)
+        ]
+        # parent beam of every beam: the prompt only lives in the first beam of
+        # each batch, the next step swaps the beams of each batch
+        reorders = [torch.tensor([0, 0, 2, 2]), torch.tensor([1, 0, 3, 2])]
+
+        def generate(kv_cache_dtype):
+            past_key_value = (
+                torch.zeros(1, 0, 0, 1, dtype=torch.long).contiguous(),
+                torch.zeros([1, 1, 1, 1]).contiguous().to(kv_cache_dtype),
+                torch.zeros(1, beam_batch, dtype=torch.long).contiguous(),
+            )
+            with torch.inference_mode(), torch.no_grad(), torch.autocast(
+                device_type="cpu",
+                enabled=True,
+                dtype=torch.bfloat16,
+            ):
+                output, past_key_value = mla(prompt, prompt_mask, past_key_value, True)
+                outputs = [output]
+                seq_len = first_seq_len
+                for input_t, reorder in zip(next_tokens, reorders):
+                    # what _reorder_cache does for DeepSeek
+                    past_key_value[2][seq_len - 1] = reorder
+                    attention_mask = torch.zeros(
+                        beam_batch, 1, 1, seq_len + 1, dtype=dtype
+                    )
+                    output, past_key_value = mla(
+                        input_t, attention_mask, past_key_value, True
+                    )
+                    outputs.append(output)
+                    seq_len += 1
+            return outputs, past_key_value[1], seq_len
+
+        outputs_ref, cache_ref, seq_len = generate(dtype)
+        for kv_cache_dtype, cache_tol, output_tol in [
+            (torch.int8, 0.01, 0.05),
+            (torch.float8_e4m3fn, 0.07, 0.1),
+        ]:
+            outputs, cache, _ = generate(kv_cache_dtype)
+            self.assertEqual(cache.dtype, kv_cache_dtype)
+            self.assertEqual(cache.size(-1), head_size + 4)
+            # rows are the quantized values followed by their float scale
+            scale = cache[..., head_size:].contiguous().view(torch.float32)
+            dequant = cache[..., :head_size].float() * scale
+            # the prompt is written to the first beam of each batch only
+            for rows, beams in [
+                (slice(0, first_seq_len), slice(None, None, num_beams)),
+                (slice(first_seq_len, seq_len), slice(None)),
+            ]:
+                ref = cache_ref[rows, beams].float()
+                amax = ref.abs().amax(-1, keepdim=True)
+                error = (dequant[rows, beams] - ref).abs() / amax
+                self.assertTrue(error.max() <= cache_tol)
+            # prefill attends over the fresh kv, decode reads the cache
+            self.assertEqual(outputs[0], outputs_ref[0])
+            for output, output_ref in zip(outputs[1:], outputs_ref[1:]):
+                self.assertEqual(output, output_ref, prec=output_tol)
+
 
 if __name__ == "__main__":
     test = unittest.main()
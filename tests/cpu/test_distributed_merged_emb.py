@@ -122,6 +122,12 @@ class DistMergedEmbeddingTester(TestCase):
                         [0] Greatest relative difference: inf at index (8, 21, 106) (up to 0.01 allowed)
                         """
                         self.assertEqual(ref_out, dist_out, atol=0.2, rtol=0.2)
+                        # overlap lookup and all to all over table groups
+                        distributed_emb.num_comm_groups = 4
+                        with torch.no_grad():
+                            pipelined_out = distributed_emb(indices, offsets)
+                        distributed_emb.num_comm_groups = 1
+                        self.assertEqual(out, pipelined_out)
                         un_updated_w = distributed_emb.weights[0].clone()
                         un_updated_hessain = distributed_emb.adagrad_args.hessian[
                             0
@@ -20,6 +20,17 @@ class Embeddingbag(torch.nn.Module):
 
 
 class TestEMB(TestCase):
+    def _test_sparse_grad(self, ref_grad, grad):
+        # IPEX fast path returns a coalesced (deduplicated) sparse grad while
+        # aten returns one row per index, compare them after coalescing
+        ref_grad = ref_grad.coalesce()
+        self.assertEqual(ref_grad.sparse_dim(), grad.sparse_dim())
+        self.assertEqual(ref_grad.dense_dim(), grad.dense_dim())
+        grad = grad.coalesce()
+        self.assertEqual(ref_grad._nnz(), grad._nnz())
+        self.assertEqual(ref_grad._indices(), grad._indices())
+        self.assertEqual(ref_grad._values().float(), grad._values().float())
+
     def _test_emb(
         self,
         mode,
@@ -62,28 +73,7 @@ class TestEMB(TestCase):
 
         self.assertEqual(aten_out, ipex_out)
         if sparse:
-            self.assertEqual(
-                aten_emb.weight.grad.data._nnz(), ipex_emb.weight.grad.data._nnz()
-            )
-            self.assertEqual(
-                aten_emb.weight.grad.data.sparse_dim(),
-                ipex_emb.weight.grad.data.sparse_dim(),
-            )
-            self.assertEqual(
-                aten_emb.weight.grad.data.dense_dim(),
-                ipex_emb.weight.grad.data.dense_dim(),
-            )
-            self.assertEqual(
-                aten_emb.weight.grad.data.is_coalesced(),
-                ipex_emb.weight.grad.data.is_coalesced(),
-            )
-            self.assertEqual(
-                aten_emb.weight.grad.data._indices(),
-                ipex_emb.weight.grad.data._indices(),
-            )
-            self.assertEqual(
-                aten_emb.weight.grad.data._values(), ipex_emb.weight.grad.data._values()
-            )
+            self._test_sparse_grad(aten_emb.weight.grad.data, ipex_emb.weight.grad.data)
 
         if mode == "sum" and padding_idx is None and per_sample_weights is None:
             bf16_out = bf16_emb(input, offsets)
@@ -93,28 +83,9 @@ class TestEMB(TestCase):
                 self.assertEqual(
                     bf16_emb.weight.grad.data._values().dtype, torch.bfloat16
                 )
-                self.assertEqual(
-                    aten_emb.weight.grad.data._nnz(), ipex_emb.weight.grad.data._nnz()
-                )
-                self.assertEqual(
-                    aten_emb.weight.grad.data.sparse_dim(),
-                    ipex_emb.weight.grad.data.sparse_dim(),
-                )
-                self.assertEqual(
-                    aten_emb.weight.grad.data.dense_dim(),
-                    ipex_emb.weight.grad.data.dense_dim(),
-                )
-                self.assertEqual(
-                    aten_emb.weight.grad.data.is_coalesced(),
-                    ipex_emb.weight.grad.data.is_coalesced(),
-                )
-                self.assertEqual(
-                    aten_emb.weight.grad.data._indices(),
-                    ipex_emb.weight.grad.data._indices(),
-                )
-                self.assertEqual(
-                    aten_emb.weight.grad.data._values().bfloat16().float(),
-                    ipex_emb.weight.grad.data._values().float(),
+                self._test_sparse_grad(
+                    aten_emb.weight.grad.data.bfloat16(),
+                    bf16_emb.weight.grad.data,
                 )
 
     def test_emb_fallback_path(self):
@@ -145,6 +116,22 @@ class TestEMB(TestCase):
                 mode="sum", sparse=sparse, include_last_offset=include_last_offset
             )
 
+    def test_emb_sparse_grad_dedup(self):
+        for dtype in [torch.float, torch.bfloat16]:
+            emb = nn.EmbeddingBag(100, 33, mode="sum", sparse=True).to(dtype)
+            ref_emb = copy.deepcopy(emb)
+            input = torch.randint(10, (64,))
+            offsets = torch.arange(0, 64, 4)
+            torch.embedding_bag = aten_emb_fn
+            ref_emb(input, offsets).sum().backward()
+            torch.embedding_bag = ipex_emb_fn
+            emb(input, offsets).sum().backward()
+            grad = emb.weight.grad.data
+            self.assertTrue(grad.is_coalesced())
+            self.assertEqual(grad._nnz(), input.unique().numel())
+            self.assertEqual(grad._values().dtype, dtype)
+            self._test_sparse_grad(ref_emb.weight.grad.data, grad)
+
     def test_emb_jit_scriptable(self):
         emb = nn.EmbeddingBag(10, 3, mode="sum", sparse=True)
         input = torch.LongTensor([1, 2, 4, 5, 4, 3, 2, 9])
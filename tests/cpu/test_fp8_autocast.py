@@ -211,6 +211,21 @@ class TestFP8Cases(TestCase):
             out_fp8_iter5 = fp8_linear_with_calibration(inp2[4])
         self.assertEqual(out_fp8_iter5, out_nn_iter5, atol=0.01, rtol=0.1)
 
+        # inference without autograd runs on the weight packed once by eval()
+        lin = fp8_linear_with_calibration.lin1_gelu.lin1
+        with torch.no_grad(), fp8_autocast(
+            enabled=True,
+            calibrating=False,
+            fp8_recipe=DelayedScaling(fp8_format=Format.E4M3),
+            device="cpu",
+        ):
+            out_prepacked = fp8_linear_with_calibration(inp2[4])
+            op_context = lin._fp8_op_context
+            self.assertIsNotNone(op_context)
+            _ = fp8_linear_with_calibration(inp2[4])
+            self.assertIs(lin._fp8_op_context, op_context)
+        self.assertEqual(out_prepacked, out_nn_iter5, atol=0.01, rtol=0.1)
+
     @unittest.skipIf(
         not core.onednn_has_fp8_support(),
         "IPEX FP8 is not supported on this CPU device",
@@ -229,6 +244,52 @@ class TestFP8Cases(TestCase):
         nn_out = nn_linear(inp)
         self.assertEqual(nn_out, fp8_out, atol=0.01, rtol=0.1)
 
+    @unittest.skipIf(
+        not core.onednn_has_fp8_support(),
+        "IPEX FP8 is not supported on this CPU device",
+    )
+    def test_fp8_linear_prepack(self):
+        in_features, out_features = 64, 48
+        weight = torch.randn(out_features, in_features)
+        bias = torch.randn(out_features).bfloat16()
+        input_scale_inv, weight_scale_inv = 0.5, 0.25
+        weight_fp8 = (weight / weight_scale_inv).to(torch.float8_e4m3fn)
+        scale_inv = torch.tensor([input_scale_inv, weight_scale_inv])
+        ctx = torch.ops.ipex_prepack.fp8_linear_prepack(
+            weight_fp8, bias, input_scale_inv, weight_scale_inv, None
+        )
+        self.assertEqual(ctx.to_public(ctx.get_weight()).float(), weight_fp8.float())
+
+        # decode sizes hit the cached primitives repeatedly, prefill sizes run
+        # on the zero padded rows of their M bucket
+        for m in (1, 4, 1, 33, 4, 100, 257, 250):
+            x = torch.randn(m, in_features)
+            x_fp8 = (x / input_scale_inv).to(torch.float8_e4m3fn)
+            ref = torch.empty(m, out_features)
+            torch.ops.torch_ipex.fp8_linear(
+                x_fp8, scale_inv, 0, 0, weight_fp8, scale_inv, 1, 0, bias, ref
+            )
+            out = torch.ops.torch_ipex.ipex_fp8_linear(
+                x_fp8, ctx.get_data_handle(), None
+            )
+            self.assertEqual(out, ref)
+            out_bf16 = torch.ops.torch_ipex.ipex_fp8_linear(
+                x_fp8.view(1, m, in_features),
+                ctx.get_data_handle(),
+                torch.bfloat16,
+            )
+            self.assertEqual(out_bf16.shape, (1, m, out_features))
+            self.assertEqual(out_bf16.float().view(m, -1), ref, atol=0.1, rtol=0.02)
+
+        # pickle round trip rebuilds the packed weight
+        state = ctx.__getstate__()
+        ctx2 = torch.ops.ipex_prepack.fp8_linear_prepack(*state)
+        x_fp8 = torch.randn(2, in_features).to(torch.float8_e4m3fn)
+        self.assertEqual(
+            torch.ops.torch_ipex.ipex_fp8_linear(x_fp8, ctx.get_data_handle(), None),
+            torch.ops.torch_ipex.ipex_fp8_linear(x_fp8, ctx2.get_data_handle(), None),
+        )
+
 
 if __name__ == "__main__":
     test = unittest.main()
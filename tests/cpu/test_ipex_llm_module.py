@@ -837,6 +837,53 @@ class TestLLMModules(TestCase):
                             self.assertEqual(out, ref_out, atol=atol, rtol=rtol)
                             _disable_tpp()
 
+    def test_linear_topk(self):
+        # LM head of greedy / beam search, 32000 rows are blocked by 100 for TPP
+        x = torch.rand(4, 1, 512)
+        dtypes = [torch.float32]
+        if core.onednn_has_bf16_support():
+            dtypes.append(torch.bfloat16)
+        with torch.no_grad():
+            for dtype, use_tpp, k in itertools.product(
+                dtypes, [True, False], [1, 4, 32]
+            ):
+                model = torch.nn.Sequential(torch.nn.Linear(512, 32000, bias=False))
+                model = model.eval().to(dtype)
+                ref_logits = model(x.to(dtype))
+                ref_values, ref_indices = torch.topk(ref_logits, k, dim=-1)
+                if use_tpp:
+                    _enable_tpp()
+                    model = ipex.optimize(model, dtype=dtype)
+                values, indices = ipex.llm.modules.LinearTopk(model[0])(x.to(dtype), k)
+                _disable_tpp()
+                self.assertEqual(values.shape, ref_values.shape)
+                self.assertEqual(indices.dtype, torch.long)
+                # accumulation order may swap near ties, check the values of
+                # the selected tokens instead of their order
+                self.assertEqual(values, ref_values, atol=1e-2, rtol=1e-2)
+                self.assertEqual(
+                    ref_logits.gather(-1, indices), values, atol=1e-2, rtol=1e-2
+                )
+                if not use_tpp:
+                    self.assertEqual(indices, ref_indices)
+            # a vocab padded up to the TPP blocking: with all-negative logits
+            # the padded rows (logit 0) must not be selected
+            vocab_size = 31950
+            for dtype in dtypes:
+                weight = -torch.rand(vocab_size, 512).to(dtype)
+                ref_values, ref_indices = torch.topk(
+                    torch.nn.functional.linear(x.to(dtype), weight), 8, dim=-1
+                )
+                model = torch.nn.Sequential(torch.nn.Linear(512, 32000, bias=False))
+                model[0].weight.copy_(torch.nn.functional.pad(weight, (0, 0, 0, 50)))
+                _enable_tpp()
+                model = ipex.optimize(model.eval().to(dtype), dtype=dtype)
+                model[0].out_features = vocab_size
+                values, indices = ipex.llm.modules.LinearTopk(model[0])(x.to(dtype), 8)
+                _disable_tpp()
+                self.assertTrue((indices < vocab_size).all())
+                self.assertEqual(values, ref_values, atol=1e-2, rtol=1e-2)
+
     def test_rmsnorm(self):
         x1 = torch.rand(1, 4, 4096)
         x2 = copy.deepcopy(x1)
@@ -1008,6 +1055,35 @@ class TestLLMModules(TestCase):
                         )
                         self.assertEqual(ref_out, ipex_out)
 
+    def test_moe_fusion_tpp(self):
+        if not torch.ops.mkldnn._is_mkldnn_bf16_supported():
+            self.skipTest("TPP experts need bf16 support")
+        with torch.no_grad():
+            # with 2 experts and top-2 routing every expert gets all 80 tokens,
+            # i.e. more than one 64-row block
+            moe_module = MixtralMoE(2, 2, 1024, 4096).eval().to(torch.bfloat16)
+            x = torch.rand(80, 1024).to(torch.bfloat16)
+            ref_out = moe_module(x)
+            ipex_out = moe_module(
+                copy.deepcopy(x), use_ipex_api=True, use_ipex_prepack=True
+            )
+            moe = moe_module.ipex_moe_with_prepack.linear_fusion
+            self.assertIsNotNone(moe.tpp_weights)
+            gate_weights, up_weights, down_weights = moe.tpp_weights
+            for linears, gate, up, down in zip(
+                moe.linear_module_list, gate_weights, up_weights, down_weights
+            ):
+                self.assertEqual(gate.data_ptr(), linears[0].weight.data_ptr())
+                self.assertEqual(up.data_ptr(), linears[2].weight.data_ptr())
+                self.assertEqual(down.data_ptr(), linears[1].weight.data_ptr())
+            self.assertEqual(ref_out, ipex_out)
+            # the per-expert path gives the same result
+            moe.tpp_weights = None
+            per_expert_out = moe_module(
+                copy.deepcopy(x), use_ipex_api=True, use_ipex_prepack=True
+            )
+            self.assertEqual(per_expert_out, ipex_out)
+
     def test_causal_conv1d_update(self):
         def causal_conv1d_update_ref(
             x, conv_state, weight, bias=None, activation=None, cache_seqlens=None
@@ -537,6 +537,59 @@ class OptimizeTransformersTester(TestCase):
                     )
                     self.assertEqual(ipex_res_dict.sequences, ref_res_dict.sequences)
 
+    def test_generate_fused_sampler(self):
+        from transformers.generation.logits_process import (
+            MinLengthLogitsProcessor,
+            RepetitionPenaltyLogitsProcessor,
+            TemperatureLogitsWarper,
+            TopKLogitsWarper,
+            TopPLogitsWarper,
+        )
+        from intel_extension_for_pytorch.transformers.generation.sample import (
+            _fused_sampler_args,
+        )
+
+        penalty = RepetitionPenaltyLogitsProcessor(1.3)
+        temperature = TemperatureLogitsWarper(0.7)
+        top_k = TopKLogitsWarper(5)
+        top_p = TopPLogitsWarper(0.9)
+        self.assertEqual(
+            _fused_sampler_args([penalty, temperature, top_k, top_p]),
+            (0.7, 1.3, 5, 0.9),
+        )
+        # out of HF order, or not supported by the op: fall back
+        self.assertIsNone(_fused_sampler_args([temperature, penalty, top_k]))
+        self.assertIsNone(
+            _fused_sampler_args([MinLengthLogitsProcessor(2, 0), temperature])
+        )
+
+        config = AutoConfig.from_pretrained(
+            f"{curpath}/hf_configs/gptj", return_dict=False
+        )
+        m = transformers.models.gptj.modeling_gptj.GPTJForCausalLM(config).eval()
+        ref_m = copy.deepcopy(m)
+        ipex_m = ipex.llm.optimize(
+            m, dtype=torch.float, deployment_mode=True, inplace=True
+        )
+        input_ids = torch.ones(8).unsqueeze(0).to(torch.long)
+        # top_k=1 keeps the sampled tokens comparable with HF
+        generate_kwargs = dict(
+            do_sample=True,
+            temperature=0.7,
+            top_k=1,
+            top_p=0.9,
+            repetition_penalty=1.3,
+            max_new_tokens=4,
+        )
+        with torch.inference_mode(), torch.no_grad():
+            with torch.profiler.profile() as prof:
+                ipex_res = ipex_m.generate(input_ids, **generate_kwargs)
+            ref_res = ref_m.generate(input_ids, **generate_kwargs)
+        self.assertEqual(ipex_res, ref_res)
+        self.assertTrue(
+            any(e.name == "ipex::fused_sampler" for e in prof.function_events)
+        )
+
     @unittest.skipIf(
         not torch.ops.mkldnn._is_mkldnn_bf16_supported(),
         "mkldnn bf16 is not supported on this device",
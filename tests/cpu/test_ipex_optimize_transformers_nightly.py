@@ -454,6 +454,37 @@ class OptimizeTransformersNightlyTester(TestCase):
             self.model_replacement_check(m, dtype, jit, torchcompile, ret_dict)
         _disable_tpp()
 
+    def test_mixtral_fused_moe_tpp(self):
+        if not core.isa_has_avx512_bf16_support():
+            self.skipTest("TPP experts need bf16 support")
+        config = AutoConfig.from_pretrained(
+            f"{curpath}/hf_configs/mixtral", return_dict=False
+        )
+        model = transformers.models.mixtral.modeling_mixtral.MixtralForCausalLM(
+            config
+        ).eval()
+        ipex_m = ipex.llm.optimize(
+            copy.deepcopy(model), dtype=torch.bfloat16, deployment_mode=False
+        )
+        decoder = ipex_m.model.layers[0]
+        # the experts are TPP-packed, so the decoder runs them in one op
+        self.assertTrue(decoder.use_fused_moe_tpp)
+        input_ids = torch.randint(0, config.vocab_size, (1, 10))
+        input_dict = {
+            "input_ids": input_ids,
+            "attention_mask": torch.ones_like(input_ids),
+            "position_ids": torch.arange(input_ids.shape[-1]).unsqueeze(0),
+            "use_cache": True,
+        }
+        with torch.no_grad(), torch.cpu.amp.autocast(dtype=torch.bfloat16):
+            key_hf = model(**input_dict)
+            key_fused = ipex_m(**input_dict)
+            decoder.use_fused_moe_tpp = False
+            key_per_expert = ipex_m(**input_dict)
+        self.assertEqual(key_hf[0], key_fused[0], prec=0.1)
+        self.assertEqual(key_per_expert[0], key_fused[0], prec=0.1)
+        _disable_tpp()
+
     def test_load_low_precision_checkpoint(self):
         config = AutoConfig.from_pretrained(
             f"{curpath}/hf_configs/gptj", return_dict=False
@@ -5,6 +5,9 @@ import unittest
 from typing import Tuple
 import intel_extension_for_pytorch as ipex
 import itertools
+import os
+import subprocess
+import sys
 
 
 class MaskedMHA(torch.nn.Module):
@@ -846,11 +849,148 @@ class MaskedMHATest(TestCase):
                 )
                 self.assertEqual(outputs[0], ref_outputs[0], prec=1e-2)
 
+    def _test_speculative_verification(self):
+        head_num = 16
+        head_size = 64
+        max_seq_len = 64
+        first_seq_len = 16
+        hidden_size = head_num * head_size
+        for batch_size, beam_size, head_num_kv, draft_len, dtype in itertools.product(
+            [1, 2], [1, 2], [4, 16], [2, 5], [torch.float32, torch.bfloat16]
+        ):
+            mha = MaskedMHA(
+                hidden_size=hidden_size,
+                n_head=head_num,
+                n_head_kv=head_num_kv,
+                head_dim=head_size,
+            )
+            rows = batch_size * beam_size
+            prec = 0.05 if dtype == torch.bfloat16 else None
+
+            def get_causal_mask(bs, q_len, past_len):
+                mask = torch.full((q_len, past_len + q_len), -1e6).triu(past_len + 1)
+                mask = mask.expand(bs, 1, q_len, past_len + q_len).contiguous()
+                return mask.to(dtype)
+
+            input_t = torch.randn(batch_size, first_seq_len, hidden_size, dtype=dtype)
+            key_cache_iakv = torch.randn(
+                max_seq_len, rows, head_num_kv, head_size, dtype=dtype
+            )
+            value_cache_iakv = torch.randn(
+                max_seq_len, rows, head_num_kv, head_size, dtype=dtype
+            )
+            beam_idx = torch.zeros(max_seq_len, rows, dtype=torch.int64)
+            with torch.inference_mode(), torch.no_grad(), torch.autocast(
+                device_type="cpu",
+                enabled=dtype == torch.bfloat16,
+                dtype=torch.bfloat16,
+            ):
+                attention_mask = get_causal_mask(batch_size, first_seq_len, 0)
+                _, _, key_cache, value_cache, _ = mha(
+                    input_t, None, None, max_seq_len, attention_mask, None
+                )
+                _, _, key_cache_iakv, value_cache_iakv, beam_idx = mha(
+                    input_t,
+                    key_cache_iakv,
+                    value_cache_iakv,
+                    max_seq_len,
+                    attention_mask,
+                    beam_idx,
+                    True,
+                    torch.tensor(0),
+                )
+                # every beam starts from the prompt of its batch
+                key_cache = key_cache.repeat_interleave(beam_size, dim=0)
+                value_cache = value_cache.repeat_interleave(beam_size, dim=0)
+                layer_past = (
+                    torch.empty(1, first_seq_len, first_seq_len, 1),
+                    key_cache_iakv,
+                    value_cache_iakv,
+                    beam_idx,
+                )
+                # verify draft_len tokens twice, accepting one token each time
+                for step in range(2):
+                    offset = layer_past[0].size(-2)
+                    draft_t = torch.randn(rows, draft_len, hidden_size, dtype=dtype)
+                    attention_mask = get_causal_mask(rows, draft_len, offset)
+                    naive_output, _, naive_key, naive_value, _ = mha(
+                        draft_t,
+                        key_cache,
+                        value_cache,
+                        max_seq_len,
+                        attention_mask,
+                        None,
+                    )
+                    (
+                        indirect_access_kv_cache_output,
+                        _,
+                        key_cache_iakv,
+                        value_cache_iakv,
+                        beam_idx,
+                    ) = mha(
+                        draft_t,
+                        layer_past[1],
+                        layer_past[2],
+                        max_seq_len,
+                        attention_mask,
+                        layer_past[3],
+                        True,
+                        torch.tensor(offset),
+                    )
+                    self.assertEqual(
+                        naive_output, indirect_access_kv_cache_output, prec=prec
+                    )
+                    # the draft tokens are written to the cache of their beam
+                    self.assertEqual(
+                        naive_key.transpose(0, 1)[offset:],
+                        key_cache_iakv[offset : offset + draft_len],
+                    )
+                    # drop the rejected tokens without touching the cache
+                    layer_past = (
+                        torch.empty(1, offset + draft_len, offset + draft_len, 1),
+                        key_cache_iakv,
+                        value_cache_iakv,
+                        beam_idx,
+                    )
+                    layer_past = (
+                        ipex.llm.modules.IndirectAccessKVCacheAttention.rollback_cache(
+                            layer_past, draft_len - 1
+                        )
+                    )
+                    self.assertEqual(layer_past[0].size(-2), offset + 1)
+                    self.assertEqual(
+                        layer_past[1].data_ptr(), key_cache_iakv.data_ptr()
+                    )
+                    # the beam search picks the beams to continue from
+                    beam_idx_t = torch.arange(rows)
+                    if beam_size > 1:
+                        beam_idx_t = beam_idx_t // beam_size * beam_size
+                        beam_idx_t += torch.tensor([1, step]).repeat(batch_size)
+                    layer_past[3][offset] = beam_idx_t
+                    key_cache = naive_key[:, : offset + 1].index_select(0, beam_idx_t)
+                    value_cache = naive_value[:, : offset + 1].index_select(
+                        0, beam_idx_t
+                    )
+
     def test_mha(self):
         self._test_mha(torchcompile=False)
         self._test_mha_fp16(torchcompile=False)
         self._test_masked_multihead_self_attention()
         self._test_cross_attention()
+        self._test_speculative_verification()
+
+    def test_mha_avx2(self):
+        # Without AVX512 the kernels take the 256-bit paths, check them
+        # against the same references by forcing the AVX2 kernels in a new
+        # process.
+        env = dict(os.environ, ATEN_CPU_CAPABILITY="avx2")
+        result = subprocess.run(
+            [sys.executable, os.path.abspath(__file__), "MaskedMHATest.test_mha"],
+            env=env,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+        )
+        self.assertEqual(result.returncode, 0, result.stdout.decode())
 
 
 if __name__ == "__main__":
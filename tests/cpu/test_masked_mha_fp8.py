@@ -5,6 +5,9 @@ import unittest
 from typing import Tuple
 import intel_extension_for_pytorch as ipex
 import itertools
+import os
+import subprocess
+import sys
 
 
 class MaskedMHA(torch.nn.Module):
@@ -658,6 +661,19 @@ class MaskedMHATest(TestCase):
         self._test_mha(torchcompile=False)
         self._test_masked_multihead_self_attention()
 
+    def test_mha_avx2(self):
+        # Without AVX512 the kernels take the 256-bit e5m2 paths, check them
+        # against the same references by forcing the AVX2 kernels in a new
+        # process.
+        env = dict(os.environ, ATEN_CPU_CAPABILITY="avx2")
+        result = subprocess.run(
+            [sys.executable, os.path.abspath(__file__), "MaskedMHATest.test_mha"],
+            env=env,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+        )
+        self.assertEqual(result.returncode, 0, result.stdout.decode())
+
 
 if __name__ == "__main__":
     test = unittest.main()
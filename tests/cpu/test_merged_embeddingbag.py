@@ -172,6 +172,71 @@ class TestMergedEmbedding(TestCase):
                             dense = torch.randn(B, NUM_DIM, dtype=dtype)
                             self._test_inference(m, ref_m, (indices, offsets, dense))
 
+    def test_inference_cat_interaction_linear(self):
+        NUM_TABLE = 26
+        NUM_DIM = 128
+        OUT_DIM = 64
+        for B in [1, 7, 1029]:
+            indices = [
+                torch.randint(1000, (B * self.multi_hot[i],))
+                for i in range(NUM_TABLE)
+            ]
+            offsets = [
+                torch.arange(0, B * self.multi_hot[i], self.multi_hot[i])
+                for i in range(NUM_TABLE)
+            ]
+            num_feature = NUM_TABLE + 1
+            act_dim = NUM_DIM + num_feature * (num_feature - 1) // 2
+            for dtype in [torch.float32, torch.bfloat16]:
+                if (
+                    dtype == torch.bfloat16
+                    and not torch.ops.mkldnn._is_mkldnn_bf16_supported()
+                ):
+                    continue
+                emb_list = EmbeddingBagList(NUM_TABLE, NUM_DIM, dtype)
+                merged_emb = (
+                    ipex.nn.modules.MergedEmbeddingBagWithCat.from_embeddingbag_list(
+                        emb_list.list
+                    )
+                )
+                dense = torch.randn(B, NUM_DIM, dtype=dtype)
+                mlp = torch.nn.Linear(act_dim, OUT_DIM).to(dtype)
+                for fuse_relu in [True, False]:
+                    with torch.no_grad():
+                        cat_out = merged_emb(indices, offsets, dense)
+                        feats = [
+                            f.contiguous()
+                            for f in cat_out.view(B, num_feature, NUM_DIM).unbind(1)
+                        ]
+                        ref_out = mlp(ipex.nn.functional.interaction(*feats))
+                        if fuse_relu:
+                            ref_out = torch.relu(ref_out)
+                        out = merged_emb.forward_interaction_linear(
+                            indices, offsets, dense, mlp.weight, mlp.bias, fuse_relu
+                        )
+                    if dtype == torch.bfloat16:
+                        self.assertEqual(out, ref_out, atol=0.1, rtol=0.1)
+                    else:
+                        self.assertEqual(out, ref_out, atol=1e-4, rtol=1e-4)
+                # a float MLP weight is converted to the table dtype once, and
+                # again after it is updated in place
+                mlp_fp32 = torch.nn.Linear(act_dim, OUT_DIM)
+                with torch.no_grad():
+                    merged_emb.forward_interaction_linear(
+                        indices, offsets, dense, mlp_fp32.weight, mlp_fp32.bias
+                    )
+                    weight = merged_emb._mlp_cache[4]
+                    self.assertEqual(weight.dtype, dtype)
+                    merged_emb.forward_interaction_linear(
+                        indices, offsets, dense, mlp_fp32.weight, mlp_fp32.bias
+                    )
+                    self.assertTrue(merged_emb._mlp_cache[4] is weight)
+                    mlp_fp32.weight.mul_(2)
+                    merged_emb.forward_interaction_linear(
+                        indices, offsets, dense, mlp_fp32.weight, mlp_fp32.bias
+                    )
+                    self.assertFalse(merged_emb._mlp_cache[4] is weight)
+
     def test_training(self):
         B = 1029
         NUM_TABLE = 26
@@ -237,6 +237,32 @@ class TestNMS(TestCase):
         self.assertEqual(output2_raw_double, output2_raw)
         self.assertTrue(output2_raw_double[0].dtype == torch.float64)
 
+    def test_batch_nms_multi_image_overlap(self):
+        # dense, heavily overlapping boxes so that every (image, label) pair
+        # has more than 64 candidates and spans several suppression words
+        torch.manual_seed(get_rand_seed())
+        batch_size, number_boxes, number_labels = 3, 600, 11
+        criteria, max_output = 0.45, 200
+        xy = torch.rand(batch_size, number_boxes, 2) * 0.5
+        wh = torch.rand(batch_size, number_boxes, 2) * 0.3 + 0.05
+        bboxes = torch.cat((xy, xy + wh), dim=2)
+        probs = torch.rand(batch_size, number_boxes, number_labels).softmax(dim=2)
+
+        output2_raw = batch_score_nms(bboxes, probs, criteria, max_output)
+        idx = 0
+        for i in range(batch_size):
+            loc, label, prob = self.decode_single(
+                bboxes[i], probs[i], criteria, max_output
+            )
+            length = output2_raw[3][i]
+            loc2 = output2_raw[0][idx : idx + length]
+            label2 = output2_raw[1][idx : idx + length]
+            prob2 = output2_raw[2][idx : idx + length]
+            idx += length
+            self.assertTrue(torch.allclose(loc, loc2, rtol=1e-4, atol=1e-4))
+            self.assertEqual(label, label2)
+            self.assertTrue(torch.allclose(prob, prob2, rtol=1e-4, atol=1e-4))
+
     def test_jit_trace_batch_nms(self):
         class Batch_NMS(nn.Module):
             def __init__(self, criteria, max_output):
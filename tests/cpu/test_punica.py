@@ -913,6 +913,72 @@ def check_bgmv_expand_slice(
     )
 
 
+def check_bgmv_shrink_expand_slice(
+    batches: int,
+    num_loras: int,
+    rank: int,
+    hidden_size: int,
+    nslices: int,
+    dtype: torch.dtype,
+    scaling: float,
+    inductor: bool,
+):
+    """
+    Compare the fused bgmv_shrink_expand_slice against bgmv_shrink followed by
+    bgmv_expand_slice, tokens with a negative lora index are left untouched.
+    """
+    ipex_bgmv_shrink_expand_slice = (
+        ipex.llm.functional.fusions.bgmv_shrink_expand_slice
+    )
+    if inductor:
+        torch._dynamo.reset()
+        ipex_bgmv_shrink_expand_slice = torch.compile(
+            ipex_bgmv_shrink_expand_slice, backend="inductor"
+        )
+
+    inputs = torch.rand((batches, hidden_size), dtype=dtype)
+    lora_a = torch.rand((num_loras, rank, hidden_size), dtype=dtype)
+    lora_b_lst = [
+        torch.rand((num_loras, hidden_size, rank), dtype=dtype) / 10
+        for _ in range(nslices)
+    ]
+    token_lora_mapping = torch.randint(0, num_loras, (batches,))
+    token_lora_mapping[0] = -1
+    our_out = torch.rand((batches, hidden_size * nslices), dtype=dtype)
+    ref_out = our_out.clone()
+
+    valid = token_lora_mapping >= 0
+    buffer = torch.zeros((int(valid.sum()), rank), dtype=dtype)
+    bgmv_shrink(inputs[valid], lora_a, buffer, token_lora_mapping[valid], scaling)
+    ref_valid = ref_out[valid]
+    slice_offset = 0
+    for lora_b in lora_b_lst:
+        ipex_bgmv_shrink_expand_slice(
+            inputs,
+            lora_a,
+            lora_b,
+            our_out,
+            token_lora_mapping,
+            scaling,
+            slice_offset,
+            hidden_size,
+            True,
+        )
+        bgmv_expand_slice(
+            buffer,
+            lora_b,
+            ref_valid,
+            token_lora_mapping[valid],
+            slice_offset,
+            hidden_size,
+            True,
+        )
+        slice_offset += hidden_size
+    ref_out[valid] = ref_valid
+
+    assert torch.allclose(ref_out, our_out, atol=ATOL, rtol=RTOL)
+
+
 def check_bgmv_expand(
     batches: int,
     num_loras: int,
@@ -1122,6 +1188,27 @@ class PunicaTest(TestCase):
                 inductor=inductor,
             )
 
+    def test_bgmv_shrink_expand_slice(self):
+        for batch, num_lora, rank, hidden_size, nslices, dtype, inductor in product(
+            [4, 67],
+            test_params["num_loras"],
+            [16, 32],
+            [128, 2049],
+            [1, 3],
+            DTYPES,
+            INDUCTOR,
+        ):
+            check_bgmv_shrink_expand_slice(
+                batches=batch,
+                num_loras=num_lora,
+                rank=rank,
+                hidden_size=hidden_size,
+                nslices=nslices,
+                dtype=dtype,
+                scaling=0.5,
+                inductor=inductor,
+            )
+
     def test_sgmv(self):
         for batches, num_loras, rank, hidden_size, nslices, dtype, inductor in product(
             test_params["batches"],
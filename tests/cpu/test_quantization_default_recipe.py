@@ -25,8 +25,12 @@ from intel_extension_for_pytorch.quantization import (
 from intel_extension_for_pytorch.nn.modules.weight_only_quantization import (
     WeightOnlyQuantizedLinear,
     WoqWeightFormat,
+    save_woq_packed_weights,
+    load_woq_packed_weights,
 )
 import os
+import subprocess
+import sys
 
 curpath = os.path.abspath(os.path.dirname(__file__))
 
@@ -231,6 +235,45 @@ class TestDefaultRecipe(JitLlgaTestCase):
                 prepared_model(torch.rand(4, 4))
             assert check_model_obsever_has_run(prepared_model)
 
+    def test_warmup_inputs_save_load(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.linear = nn.Linear(16, 8)
+
+            def forward(self, x, y):
+                return self.linear(x) + y
+
+        m = M().eval()
+        x = torch.rand(4, 16)
+        y = torch.rand(4, 8)
+        qconfig_mapping = ipex.quantization.default_static_qconfig_mapping
+        prepared_model = ipex.quantization.prepare(m, qconfig_mapping, (x, y))
+        prepared_model(x, y)
+        converted_model = ipex.quantization.convert(prepared_model)
+        with torch.no_grad():
+            traced_model = torch.jit.trace(converted_model, (x, y))
+            traced_model = torch.jit.freeze(traced_model)
+            ref = traced_model(x, y)
+        with tempfile.TemporaryDirectory() as tmp:
+            model_path = os.path.join(tmp, "model.pt")
+            warmup_path = os.path.join(tmp, "model.warmup.json")
+            traced_model.save(model_path)
+            ipex.quantization.save_warmup_inputs(
+                [(x, y), (torch.rand(1, 16), torch.rand(1, 8)), {"x": x, "y": y}],
+                warmup_path,
+            )
+            # the warm-up alone gets the graph fused into LLGA partitions
+            ipex.quantization.warmup(traced_model, warmup_path)
+            graph = torch.jit.last_executed_optimized_graph()
+            self.assertGraphContains(graph, LLGA_FUSION_GROUP)
+            loaded_model = torch.jit.freeze(torch.jit.load(model_path).eval())
+            loaded_model = ipex.quantization.warmup(loaded_model, warmup_path)
+            graph = torch.jit.last_executed_optimized_graph()
+            self.assertGraphContains(graph, LLGA_FUSION_GROUP)
+            with torch.no_grad():
+                self.assertEqual(loaded_model(x, y), ref)
+
     def test_none_example_input_for_quantization(self):
         class M(nn.Module):
             def __init__(self):
@@ -501,6 +544,54 @@ class WeightOnlyQuantizationTester(TestCase):
         for shape, use_bias, w_dtype in cases:
             test(shape, use_bias, w_dtype)
 
+    def test_weight_only_quantization_packed_weight_file(self):
+        class M(nn.Module):
+            def __init__(self, input_channel, output_channel, has_bias):
+                super(M, self).__init__()
+                self.linear = torch.nn.Linear(input_channel, output_channel, has_bias)
+                self.linear2 = torch.nn.Linear(output_channel, input_channel, False)
+
+            def forward(self, x):
+                return self.linear2(self.linear(x))
+
+        def test(feature, has_bias, w_dtype, group_size):
+            m = M(feature[1], feature[2], has_bias).eval()
+            data = torch.rand(feature[0], feature[1])
+            qconfig = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+                weight_dtype=w_dtype, group_size=group_size
+            )
+            prepared_model = prepare(m, qconfig, example_inputs=data, inplace=False)
+            with torch.no_grad():
+                woq_model = convert(prepared_model)
+                output_ref = woq_model(data)
+                with tempfile.TemporaryDirectory() as tmp:
+                    path = os.path.join(tmp, "woq_packed.bin")
+                    save_woq_packed_weights(woq_model, path)
+                    linear = WeightOnlyQuantizedLinear.from_packed(path, "linear")
+                    assert linear.bias == has_bias
+                    assert linear._group_size == group_size
+                    torch.testing.assert_close(linear(data), woq_model.linear(data))
+                    # no convert() needed: build the modules from the file
+                    loaded_model = load_woq_packed_weights(
+                        copy.deepcopy(prepared_model), path
+                    )
+                    assert isinstance(loaded_model.linear, WeightOnlyQuantizedLinear)
+                    torch.testing.assert_close(loaded_model(data), output_ref)
+                    loaded_model = load_woq_packed_weights(copy.deepcopy(m), path)
+                    torch.testing.assert_close(loaded_model(data), output_ref)
+                    with self.assertRaises(RuntimeError):
+                        WeightOnlyQuantizedLinear.from_packed(path, "missing")
+
+        shape_list = [[3, 64, 128], [4, 4096, 4096]]
+        use_bias_list = [True, False]
+        w_dtype_list = [WoqWeightDtype.INT8, WoqWeightDtype.INT4]
+        group_size_list = [-1, 32]
+        cases = itertools.product(
+            shape_list, use_bias_list, w_dtype_list, group_size_list
+        )
+        for shape, use_bias, w_dtype, group_size in cases:
+            test(shape, use_bias, w_dtype, group_size)
+
     def test_weight_only_quantization_int4_weight(self):
         class M(nn.Module):
             def __init__(self, input_channel, output_channel, has_bias):
@@ -609,6 +700,95 @@ class WeightOnlyQuantizationTester(TestCase):
         for shape, use_bias in cases:
             test(shape, use_bias)
 
+    def test_weight_only_quantization_lowbit_weight(self):
+        class M(nn.Module):
+            def __init__(self, input_channel, output_channel, has_bias):
+                super(M, self).__init__()
+                self.linear = torch.nn.Linear(input_channel, output_channel, has_bias)
+
+            def forward(self, x):
+                return self.linear(x)
+
+        def test(feature, w_dtype, group_size, qscheme, has_bias, lowp_mode, act_mode):
+            model = M(feature[1], feature[2], has_bias)
+            m = model.eval()
+            data = torch.rand(feature[0], feature[1])
+            weight = model.linear.weight
+            sym_quant = qscheme == WoqWeightQScheme.SYMMETRIC
+            if group_size == -1:
+                qweight, w_scales, w_zero_points = quantize_per_channel(
+                    weight, w_dtype, sym_quant=sym_quant
+                )
+                weight_fp32 = dequantize_per_channel(
+                    qweight, w_scales, w_zero_points, w_dtype, weight.shape
+                )
+            else:
+                qweight, w_scales, w_zero_points = quantize_per_block(
+                    weight, w_dtype, group_size, sym_quant=sym_quant
+                )
+                weight_fp32 = dequantize_per_block(
+                    qweight,
+                    w_scales,
+                    w_zero_points,
+                    w_dtype,
+                    group_size,
+                    weight.shape,
+                )
+            output1 = torch.matmul(data, weight_fp32.T)
+            if has_bias:
+                output1 += model.linear.bias
+
+            qconfig = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+                weight_dtype=w_dtype,
+                lowp_mode=lowp_mode,
+                act_quant_mode=act_mode,
+                group_size=group_size,
+                weight_qscheme=qscheme,
+            )
+            prepared_model = prepare(m, qconfig, example_inputs=data, inplace=False)
+            with torch.no_grad():
+                woq_model = convert(prepared_model)
+                assert isinstance(woq_model.linear, WeightOnlyQuantizedLinear)
+                op_context = woq_model.linear._op_context
+                # Packed weight is unpacked to the plain format losslessly
+                unpacked_weight = op_context.to_public(op_context.get_weight())
+                torch.testing.assert_close(unpacked_weight, qweight)
+
+                output2 = woq_model(data)
+                if lowp_mode == WoqLowpMode.INT8:
+                    # the activation is quantized to int8 at runtime
+                    torch.testing.assert_close(output1, output2, atol=2e-2, rtol=2e-2)
+                else:
+                    torch.testing.assert_close(output1, output2)
+
+        shape_list = [
+            [3, 256, 128],
+            [4, 4096, 4096],
+            [9, 4096, 4095],
+            [196, 1024, 512],
+        ]
+        w_dtype_list = [WoqWeightDtype.INT2, WoqWeightDtype.INT3]
+        group_size_list = [-1, 128]
+        qscheme_list = [WoqWeightQScheme.ASYMMETRIC, WoqWeightQScheme.SYMMETRIC]
+        use_bias_list = [True, False]
+        # INT8 lowp_mode unpacks the low-bit weight for the VNNI int8 GEMM,
+        # asymmetric activations also need the compensation of the weight
+        compute_list = [
+            (WoqLowpMode.NONE, WoqActQuantMode.PER_BATCH_IC_BLOCK_SYM),
+            (WoqLowpMode.INT8, WoqActQuantMode.PER_BATCH_IC_BLOCK),
+            (WoqLowpMode.INT8, WoqActQuantMode.PER_BATCH_IC_BLOCK_SYM),
+        ]
+        cases = itertools.product(
+            shape_list,
+            w_dtype_list,
+            group_size_list,
+            qscheme_list,
+            use_bias_list,
+            compute_list,
+        )
+        for shape, w_dtype, group_size, qscheme, use_bias, compute in cases:
+            test(shape, w_dtype, group_size, qscheme, use_bias, *compute)
+
     def _test_weight_only_quantization_unary_fused_op_helper(
         self,
         post_op_module,
@@ -1043,6 +1223,62 @@ class WeightOnlyQuantizationTester(TestCase):
         for has_bias, quant_mode, M in cases:
             test(has_bias, quant_mode, M)
 
+    def test_weight_only_quantization_rmsnorm_quantized_input(self):
+        # RMSNorm fused with dynamic quantization of activation, whose output
+        # is consumed by WOQ linear directly, vs. RMSNorm + WOQ linear
+        class Mod(nn.Module):
+            def __init__(self, has_bias):
+                super(Mod, self).__init__()
+                self.linear = torch.nn.Linear(K, N, has_bias)
+
+            def forward(self, x):
+                return self.linear(x)
+
+        def test(has_bias, act_quant_mode, M, dtype):
+            model = Mod(has_bias).eval()
+            data = torch.rand(M, K, dtype=dtype)
+            gamma = torch.rand(K, dtype=dtype)
+            eps = 1e-6
+            qconfig_mapping = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+                weight_dtype=WoqWeightDtype.INT4,
+                lowp_mode=WoqLowpMode.INT8,
+                act_quant_mode=act_quant_mode,
+                group_size=group_size,
+            )
+            prepared_model = prepare(model, qconfig_mapping, inplace=True)
+            with torch.no_grad():
+                woq_model = convert(prepared_model)
+                y_ref = woq_model(torch.ops.torch_ipex.rmsnorm(data, gamma, eps))
+                qx, scale, zp = torch.ops.torch_ipex.rmsnorm_dynamic_quant(
+                    data, gamma, eps, act_quant_mode, group_size
+                )
+                y = torch.ops.torch_ipex.woq_linear_quantized_input(
+                    qx,
+                    scale,
+                    zp,
+                    dtype,
+                    woq_model.linear._op_context.get_data_handle(),
+                )
+                self.assertEqual(y.dtype, dtype)
+                torch.testing.assert_close(y, y_ref, atol=5e-2, rtol=5e-2)
+
+        N, K = 64, 512
+        group_size = 64
+        has_bias_list = [False, True]
+        quant_mode_list = [
+            WoqActQuantMode.PER_BATCH,
+            WoqActQuantMode.PER_BATCH_IC_BLOCK,
+            WoqActQuantMode.PER_BATCH_SYM,
+            WoqActQuantMode.PER_BATCH_IC_BLOCK_SYM,
+        ]
+        batch_size_list = [4, 1024]
+        dtype_list = [torch.float, torch.bfloat16]
+        cases = itertools.product(
+            has_bias_list, quant_mode_list, batch_size_list, dtype_list
+        )
+        for has_bias, quant_mode, M, dtype in cases:
+            test(has_bias, quant_mode, M, dtype)
+
     def test_weight_only_quantization_act_quant_sym_mode(self):
 
         class Mod(nn.Module):
@@ -1206,6 +1442,22 @@ class WeightOnlyQuantizationTester(TestCase):
         for shape, has_bias, act_quant_mode, group_size, w_dtype in cases:
             test(shape, has_bias, act_quant_mode, group_size, w_dtype)
 
+    def test_weight_only_quantization_avx2(self):
+        # Small batches take a 256-bit path without AVX512, check it against
+        # the same references by forcing the AVX2 kernels in a new process.
+        env = dict(os.environ, ATEN_CPU_CAPABILITY="avx2")
+        for test_name in [
+            "test_weight_only_quantization_group_size",
+            "test_weight_only_quantization_sym_quant_weight",
+        ]:
+            result = subprocess.run(
+                [sys.executable, os.path.abspath(__file__), "-k", test_name],
+                env=env,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.STDOUT,
+            )
+            self.assertEqual(result.returncode, 0, result.stdout.decode())
+
     def test_compute_with_g_idx(self):
         class Mod(nn.Module):
             def __init__(self, ic, oc, has_bias):
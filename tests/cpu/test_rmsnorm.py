@@ -156,6 +156,50 @@ class RMSNormTester(TestCase):
                     self.assertEqual(y1_fp16, fused_y1_fp16, prec=1e-2)
                     self.assertEqual(x1_fp16, x2_fp16)
 
+    def test_RMSNorm_dynamic_quant(self):
+        # quant_a_mode: per-M, per-M-K-block, per-M sym, per-M-K-block sym
+        quant_a_mode_list = [2, 3, 6, 7]
+        dtype_list = [torch.float32, torch.bfloat16, torch.half]
+        shape_list = [[3, 128], [2, 5, 100]]
+        cases = itertools.product(quant_a_mode_list, dtype_list, shape_list)
+        for quant_a_mode, dtype, shape in cases:
+            with torch.no_grad():
+                block_k = 32
+                x = torch.randn(shape, dtype=dtype)
+                model = RMSNorm(shape[-1], dtype=dtype).eval()
+                y = model(x, fused_rmsnorm=True).float()
+                qx, scale, zp = torch.ops.torch_ipex.rmsnorm_dynamic_quant(
+                    x, model.weight, model.variance_epsilon, quant_a_mode, block_k
+                )
+                is_sym = quant_a_mode >= 4
+                per_m = quant_a_mode in [2, 6]
+                self.assertEqual(qx.dtype, torch.int8 if is_sym else torch.uint8)
+                self.assertEqual(qx.shape, x.shape)
+                self.assertEqual(zp is None, is_sym)
+                # dequantize and compare with the unfused output
+                K = shape[-1]
+                M = x.numel() // K
+                block = K if per_m else block_k
+                num_blocks = (K + block - 1) // block
+                pad = num_blocks * block - K
+                y = torch.nn.functional.pad(y.reshape(M, K), (0, pad))
+                y = y.view(M, num_blocks, block)
+                q = torch.nn.functional.pad(qx.reshape(M, K).float(), (0, pad))
+                q = q.view(M, num_blocks, block)
+                s = scale.view(M, num_blocks, 1)
+                z = 0 if is_sym else zp.view(M, num_blocks, 1).float()
+                y_min = y.amin(-1, keepdim=True).clamp(max=0)
+                y_max = y.amax(-1, keepdim=True).clamp(min=0)
+                s_ref = (
+                    torch.maximum(y_max.abs(), y_min.abs()) / 127
+                    if is_sym
+                    else (y_max - y_min) / 255
+                )
+                self.assertEqual(s, s_ref)
+                err = ((q - z) * s - y).view(M, -1)[:, :K]
+                tol = (s * 1.01).expand(-1, -1, block).reshape(M, -1)[:, :K]
+                self.assertTrue(err.abs().le(tol).all())
+
 
 if __name__ == "__main__":
     test = unittest.main()
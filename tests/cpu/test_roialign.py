@@ -309,6 +309,53 @@ class RoIAlignTester(TestCase):
                 torch.allclose(gt_x.grad.to(x4.dtype), x4.grad, rtol=1e-5, atol=1e-5)
             )
 
+    def test_roialign_linear_fusion(self):
+        pool_h, pool_w = 7, 7
+        num_rois, out_features = 37, 64
+        x = torch.rand(2, 16, 20, 24)
+        boxes = torch.rand(num_rois, 4) * 12
+        boxes[:, 2:] += boxes[:, :2] + 1
+        batch_idx = torch.randint(0, 2, (num_rois, 1)).float()
+        rois = torch.cat((batch_idx, boxes), dim=1)
+        weight = torch.randn(out_features, 16 * pool_h * pool_w) * 0.05
+        bias = torch.randn(out_features)
+
+        for datatype in (torch.float32, torch.bfloat16):
+            for memory_format in (torch.contiguous_format, torch.channels_last):
+                for fuse_relu, b in ((False, None), (True, bias)):
+                    x1 = x.to(datatype).to(memory_format=memory_format)
+                    w1 = weight.to(datatype)
+                    b1 = b.to(datatype) if b is not None else None
+                    ref = torch.nn.functional.linear(
+                        fn(x1, rois, pool_h, pool_w, sampling_ratio=2).flatten(1),
+                        w1,
+                        b1,
+                    )
+                    if fuse_relu:
+                        ref = ref.relu()
+                    y = torch.ops.torch_ipex.ROIAlign_linear_forward(
+                        x1, rois, 1.0, pool_h, pool_w, 2, False, w1, b1, fuse_relu
+                    )
+                    self.assertEqual(y.dtype, datatype)
+                    tol = 1e-4 if datatype == torch.float32 else 5e-2
+                    self.assertTrue(torch.allclose(ref, y, rtol=tol, atol=tol))
+                    # the weight packed once gives the same output
+                    packed_w1 = torch.ops.torch_ipex.ROIAlign_linear_prepack(w1)
+                    y_packed = torch.ops.torch_ipex.ROIAlign_linear_forward(
+                        x1,
+                        rois,
+                        1.0,
+                        pool_h,
+                        pool_w,
+                        2,
+                        False,
+                        w1,
+                        b1,
+                        fuse_relu,
+                        packed_w1,
+                    )
+                    self.assertEqual(y_packed, y)
+
 
 if __name__ == "__main__":
     test = unittest.main()
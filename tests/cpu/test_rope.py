@@ -342,6 +342,143 @@ class FusedROPETester(TestCase):
                     prec=prec,
                 )
 
+    def test_rope_and_cache(self):
+        num_tokens = 20
+        block_size = 16
+        num_blocks = 4
+        kv_head = self.num_heads // 2
+        F = self.hidden_size + kv_head * 2 * self.head_size
+        model2rope_config = {
+            "gptj": (64, 1),
+            "llama": (self.head_size, self.head_size // 2),
+            "gpt-neox": (24, 12),
+        }
+        cache_dtypes = [
+            (torch.float32, torch.float32, "auto"),
+            (torch.bfloat16, torch.bfloat16, "auto"),
+            (torch.bfloat16, torch.float8_e5m2, "fp8_e5m2"),
+        ]
+        for rope_config, (dtype, cache_dtype, kv_cache_dtype) in product(
+            model2rope_config.values(), cache_dtypes
+        ):
+            rotary_dim, offset = rope_config
+            embed_positions = self.create_sinusoidal_positions(2048, rotary_dim)
+            qkv = torch.rand(num_tokens, F).to(dtype)
+            positions = torch.randint(0, 2048, (num_tokens,))
+            slot_mapping = torch.randperm(num_blocks * block_size)[:num_tokens].to(
+                torch.int32
+            )
+            # a padding token is not written to the cache
+            slot_mapping[-1] = -1
+            query_ref, key_ref, value_ref = (
+                torch.ops.torch_ipex.rotary_position_embedding(
+                    qkv.unsqueeze(1),
+                    embed_positions,
+                    positions.unsqueeze(1),
+                    self.num_heads,
+                    self.head_size,
+                    offset,
+                    rotary_dim,
+                )
+            )
+            cache_shape = (num_blocks, kv_head, block_size, self.head_size)
+            key_cache_ref = torch.zeros(cache_shape, dtype=cache_dtype)
+            value_cache_ref = torch.zeros(cache_shape, dtype=cache_dtype)
+            for t in range(num_tokens - 1):
+                b, p = divmod(slot_mapping[t].item(), block_size)
+                key_cache_ref[b, :, p] = key_ref[t, 0].to(cache_dtype)
+                value_cache_ref[b, :, p] = value_ref[t, 0].to(cache_dtype)
+            key_cache = torch.zeros(cache_shape, dtype=cache_dtype)
+            value_cache = torch.zeros(cache_shape, dtype=cache_dtype)
+            query = torch.ops.torch_ipex.rotary_position_embedding_cache(
+                qkv,
+                embed_positions,
+                positions,
+                self.num_heads,
+                self.head_size,
+                offset,
+                rotary_dim,
+                key_cache,
+                value_cache,
+                slot_mapping,
+                kv_cache_dtype,
+                1.0,
+                1.0,
+            )
+            prec = 1e-5 if dtype == torch.float32 else 5e-3
+            self.assertEqual(query, query_ref.squeeze(1), prec=prec)
+            if cache_dtype == torch.float8_e5m2:
+                # allow one e5m2 rounding step of difference
+                self.assertEqual(
+                    key_cache.float(), key_cache_ref.float(), prec=0.25
+                )
+            else:
+                self.assertEqual(key_cache, key_cache_ref, prec=prec)
+            self.assertEqual(value_cache.float(), value_cache_ref.float())
+
+    def test_woq_linear_rope_and_cache_padded_n(self):
+        # F = 180 is not a multiple of the WOQ N block, so the output of the
+        # WOQ linear is narrowed from a padded N and its rows are strided
+        num_heads, kv_head, head_size = 3, 1, 36
+        F = (num_heads + 2 * kv_head) * head_size
+        num_tokens, block_size, num_blocks = 20, 16, 4
+        model = torch.nn.Sequential(torch.nn.Linear(64, F)).eval()
+        x = torch.rand(num_tokens, 64)
+        qconfig = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+            weight_dtype=ipex.quantization.WoqWeightDtype.INT8
+        )
+        prepared = ipex.quantization.prepare(model, qconfig, example_inputs=x)
+        woq_model = ipex.quantization.convert(prepared)
+        op_context = woq_model[0]._op_context.get_data_handle()
+        for rotary_dim, offset in [(head_size, head_size // 2), (24, 12)]:
+            embed_positions = self.create_sinusoidal_positions(2048, rotary_dim)
+            positions = torch.randint(0, 2048, (num_tokens,))
+            slot_mapping = torch.randperm(num_blocks * block_size)[:num_tokens].to(
+                torch.int32
+            )
+            cache_shape = (num_blocks, kv_head, block_size, head_size)
+            key_cache_ref = torch.zeros(cache_shape)
+            value_cache_ref = torch.zeros(cache_shape)
+            key_cache = torch.zeros(cache_shape)
+            value_cache = torch.zeros(cache_shape)
+            with torch.no_grad():
+                qkv = woq_model(x)
+                self.assertFalse(qkv.is_contiguous())
+                query_ref = torch.ops.torch_ipex.rotary_position_embedding_cache(
+                    qkv.contiguous(),
+                    embed_positions,
+                    positions,
+                    num_heads,
+                    head_size,
+                    offset,
+                    rotary_dim,
+                    key_cache_ref,
+                    value_cache_ref,
+                    slot_mapping,
+                    "auto",
+                    1.0,
+                    1.0,
+                )
+                query = torch.ops.torch_ipex.woq_linear_rotary_position_embedding_cache(
+                    x,
+                    op_context,
+                    embed_positions,
+                    positions,
+                    num_heads,
+                    head_size,
+                    offset,
+                    rotary_dim,
+                    key_cache,
+                    value_cache,
+                    slot_mapping,
+                    "auto",
+                    1.0,
+                    1.0,
+                )
+            self.assertEqual(query, query_ref, prec=1e-5)
+            self.assertEqual(key_cache, key_cache_ref, prec=1e-5)
+            self.assertEqual(value_cache, value_cache_ref, prec=1e-5)
+
 
 if __name__ == "__main__":
     test = unittest.main()
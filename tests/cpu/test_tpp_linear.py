@@ -6,6 +6,10 @@ import intel_extension_for_pytorch._C as core
 from torch.testing._internal.common_utils import TestCase
 import copy
 import os
+import shutil
+import subprocess
+import sys
+import tempfile
 from intel_extension_for_pytorch.cpu._auto_kernel_selection import (
     _enable_tpp,
     _disable_tpp,
@@ -511,6 +515,56 @@ class TestTPPlinear(TestCase):
                 self.assertEqual(out, ref_out, atol=atol, rtol=rtol)
                 _disable_tpp()
 
+    @unittest.skipIf(shutil.which("g++") is None, "g++ is not available")
+    def test_tpp_jit_loop_cache(self):
+        # BCa has no precompiled loop nest and FT_OPT_SIZE=1 makes the linear
+        # use GEMM_LOOP_SCHEME, so TPP_JIT_LOOPS=1 compiles it with g++
+        code = "\n".join(
+            [
+                "import torch",
+                "import intel_extension_for_pytorch as ipex",
+                "from intel_extension_for_pytorch.cpu._auto_kernel_selection "
+                "import _enable_tpp",
+                "model = torch.nn.Linear(256, 256).eval()",
+                "x = torch.rand(1, 4, 256)",
+                "ref = model(x)",
+                "_enable_tpp()",
+                "model = ipex.optimize(model)",
+                "with torch.no_grad():",
+                "    torch.testing.assert_close(model(x), ref)",
+            ]
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            cache_dir = os.path.join(tmp, "tpp_jit")
+            env = dict(
+                os.environ,
+                GEMM_LOOP_SCHEME="BCa",
+                FT_OPT_SIZE="1",
+                TPP_JIT_LOOPS="1",
+                TPP_JIT_CACHE_DIR=cache_dir,
+            )
+
+            def run():
+                r = subprocess.run(
+                    [sys.executable, "-c", code],
+                    env=env,
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.STDOUT,
+                    universal_newlines=True,
+                )
+                self.assertEqual(r.returncode, 0, r.stdout)
+                return r.stdout
+
+            # miss: the nest is compiled into a private cache directory
+            self.assertIn("JIT COMPILE", run())
+            self.assertEqual(os.stat(cache_dir).st_mode & 0o777, 0o700)
+            entries = os.listdir(cache_dir)
+            self.assertEqual(len(entries), 1)
+            self.assertTrue(entries[0].endswith(".so"))
+            # hit: a new process loads the entry without invoking g++
+            self.assertNotIn("JIT COMPILE", run())
+            self.assertEqual(os.listdir(cache_dir), entries)
+
 
 if __name__ == "__main__":
     test = unittest.main()
@@ -1,7 +1,10 @@
 import unittest
 import itertools
 import copy
+import gc
+import multiprocessing
 import os
+import re
 import time
 import sys
 from intel_extension_for_pytorch.utils.channels_last_1d import (
@@ -56,6 +59,24 @@ def get_rand_seed():
     return int(time.time() * 1000000000)
 
 
+def shared_weight_segment(key):
+    return "/dev/shm/ipex_weight_" + re.sub("[^0-9a-zA-Z]", "_", key)
+
+
+def share_prepacked_weights_worker(model, prefix, x, result):
+    # the segment already exists, so sharing attaches to it
+    attached = os.path.exists(shared_weight_segment(prefix + ".0"))
+    ipex_model = ipex.optimize(model, level="O1")
+    ipex.nn.utils.share_prepacked_weights(ipex_model, prefix)
+    with torch.no_grad():
+        y = ipex_model(x)
+    del ipex_model
+    gc.collect()
+    # releasing the last local reference must not unlink the segment
+    alive = os.path.exists(shared_weight_segment(prefix + ".0"))
+    result.put((attached, alive, y.tolist()))
+
+
 class TestPrepackCases(TestCase):
     def test_channels_last_1d_forward(self):
         class Conv1d(torch.nn.Module):
@@ -1000,6 +1021,68 @@ class TestPrepackCases(TestCase):
                 y2 = ipex_model(x2)
             self.assertEqual(y1, y2.float(), rtol=1e-2, atol=1e-3)
 
+    def test_linear_share_prepacked_weights(self):
+        class L(torch.nn.Module):
+            def __init__(self):
+                super(L, self).__init__()
+                self.linear = torch.nn.Linear(64, 32)
+                self.linear2 = torch.nn.Linear(32, 16, bias=False)
+
+            def forward(self, x):
+                return self.linear2(self.linear(x))
+
+        x = torch.randn(8, 64)
+        model = L().eval()
+        y_ref = model(x)
+        prefix = "test_linear_share_{}".format(os.getpid())
+        instances = []
+        for _ in range(2):
+            ipex_model = ipex.optimize(copy.deepcopy(model), level="O1")
+            ipex.nn.utils.share_prepacked_weights(ipex_model, prefix)
+            instances.append(ipex_model)
+        for name in ["linear", "linear2"]:
+            self.assertEqual(
+                getattr(instances[0], name).ctx.get_weight().data_ptr(),
+                getattr(instances[1], name).ctx.get_weight().data_ptr(),
+            )
+        for ipex_model in instances:
+            self.assertEqual(ipex_model(x), y_ref, rtol=1e-5, atol=1e-5)
+        # a weight of another size can not reuse a key
+        other = ipex.optimize(torch.nn.Sequential(torch.nn.Linear(64, 8)).eval())
+        with self.assertRaises(RuntimeError):
+            other[0].ctx.share_weight(prefix + ".linear")
+
+    def test_linear_share_prepacked_weights_across_processes(self):
+        model = torch.nn.Sequential(
+            torch.nn.Linear(64, 32), torch.nn.Linear(32, 16, bias=False)
+        ).eval()
+        x = torch.randn(8, 64)
+        with torch.no_grad():
+            y_ref = model(x)
+        prefix = "test_linear_share_mp_{}".format(os.getpid())
+        segments = [shared_weight_segment(prefix + "." + n) for n in ["0", "1"]]
+        ipex_model = ipex.optimize(copy.deepcopy(model), level="O1")
+        ipex.nn.utils.share_prepacked_weights(ipex_model, prefix)
+        for segment in segments:
+            self.assertTrue(os.path.exists(segment))
+        ctx = multiprocessing.get_context("spawn")
+        result = ctx.Queue()
+        p = ctx.Process(
+            target=share_prepacked_weights_worker, args=(model, prefix, x, result)
+        )
+        p.start()
+        attached, alive, y = result.get(timeout=600)
+        p.join()
+        self.assertEqual(p.exitcode, 0)
+        self.assertTrue(attached)
+        self.assertTrue(alive)
+        self.assertEqual(torch.tensor(y), y_ref, rtol=1e-5, atol=1e-5)
+        # the segments are unlinked with the last reference of any process
+        del ipex_model
+        gc.collect()
+        for segment in segments:
+            self.assertFalse(os.path.exists(segment))
+
     @unittest.skipIf(
         not core.onednn_has_bf16_support(),
         "ipex linear bf16 is not supported on this CPU device",